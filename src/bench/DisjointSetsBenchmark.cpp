@@ -0,0 +1,231 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+/*
+ * Compares the pointer-based DisjointSet with DenseDisjointSets on
+ * a synthetic dataflow, the way VariableAnalyzer unites the definitions
+ * and the uses of local variables.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <QElapsedTimer>
+
+#include <boost/unordered_map.hpp>
+
+#include <nc/common/DenseDisjointSets.h>
+#include <nc/common/DisjointSet.h>
+#include <nc/common/Foreach.h>
+#include <nc/common/make_unique.h>
+
+namespace {
+
+/**
+ * Term of a synthetic dataflow: a write, or a read with its reaching definitions.
+ */
+class SyntheticTerm {
+public:
+    bool isRead; ///< True if the term is read, false if written.
+    std::vector<const SyntheticTerm *> definitions; ///< Reaching definitions of a read term.
+
+    SyntheticTerm(): isRead(false) {}
+};
+
+/**
+ * Generates the terms of a function accessing local variables.
+ *
+ * Terms access a small window of the variables, which slides along the
+ * function, like code using a few variables at a time. A read is reached
+ * by the last one or two writes to its variable, as after an if-else.
+ *
+ * \param count Number of terms.
+ *
+ * \return The terms.
+ */
+std::vector<SyntheticTerm> generateDataflow(std::size_t count) {
+    std::mt19937 random(42);
+
+    const std::size_t variableCount = std::max<std::size_t>(1, count / 16);
+    const std::size_t windowSize = std::min<std::size_t>(variableCount, 32);
+
+    std::vector<SyntheticTerm> terms(count);
+    std::vector<std::vector<const SyntheticTerm *>> lastWrites(variableCount);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        auto windowStart = (i / 64) % (variableCount - windowSize + 1);
+        auto variable = windowStart + random() % windowSize;
+        auto &term = terms[i];
+        auto &writes = lastWrites[variable];
+
+        if (random() % 5 < 2) {
+            term.isRead = false;
+            if (writes.size() == 2) {
+                writes.erase(writes.begin());
+            }
+            writes.push_back(&term);
+        } else {
+            term.isRead = true;
+            if (!writes.empty()) {
+                if (writes.size() == 2 && random() % 4 == 0) {
+                    term.definitions = writes;
+                } else {
+                    term.definitions.push_back(writes.back());
+                }
+            }
+        }
+    }
+
+    return terms;
+}
+
+class TermSet;
+class TermSet: public nc::DisjointSet<TermSet> {};
+
+/**
+ * Unites the terms using a DisjointSet node per term, as VariableAnalyzer did before.
+ *
+ * \return Number of the sets.
+ */
+std::size_t uniteWithDisjointSet(const std::vector<SyntheticTerm> &terms) {
+    boost::unordered_map<const SyntheticTerm *, std::unique_ptr<TermSet>> term2set;
+
+    foreach (const auto &term, terms) {
+        term2set[&term] = std::make_unique<TermSet>();
+    }
+
+    foreach (auto &pair, term2set) {
+        auto term = pair.first;
+        if (term->isRead) {
+            auto termSet = pair.second.get();
+            foreach (auto definition, term->definitions) {
+                termSet->unionSet(term2set[definition].get());
+            }
+        }
+    }
+
+    boost::unordered_map<TermSet *, std::vector<const SyntheticTerm *>> set2terms;
+    foreach (auto &pair, term2set) {
+        set2terms[pair.second->findSet()].push_back(pair.first);
+    }
+
+    return set2terms.size();
+}
+
+/**
+ * Unites the terms using DenseDisjointSets, as VariableAnalyzer does now.
+ *
+ * \return Number of the sets.
+ */
+std::size_t uniteWithDenseDisjointSets(const std::vector<SyntheticTerm> &terms) {
+    std::vector<const SyntheticTerm *> indexedTerms;
+    boost::unordered_map<const SyntheticTerm *, std::size_t> term2index;
+
+    foreach (const auto &term, terms) {
+        term2index[&term] = indexedTerms.size();
+        indexedTerms.push_back(&term);
+    }
+
+    nc::DenseDisjointSets sets(indexedTerms.size());
+
+    for (std::size_t index = 0; index < indexedTerms.size(); ++index) {
+        auto term = indexedTerms[index];
+        if (term->isRead) {
+            foreach (auto definition, term->definitions) {
+                auto i = term2index.find(definition);
+                assert(i != term2index.end());
+                sets.unionSet(index, i->second);
+            }
+        }
+    }
+
+    const std::size_t NO_SET = std::numeric_limits<std::size_t>::max();
+
+    std::vector<std::size_t> set2group(indexedTerms.size(), NO_SET);
+    std::vector<std::vector<const SyntheticTerm *>> groups;
+
+    for (std::size_t index = 0; index < indexedTerms.size(); ++index) {
+        auto &group = set2group[sets.findSet(index)];
+        if (group == NO_SET) {
+            group = groups.size();
+            groups.emplace_back();
+        }
+        groups[group].push_back(indexedTerms[index]);
+    }
+
+    return groups.size();
+}
+
+/**
+ * Runs a function several times.
+ *
+ * \param name Name of the implementation.
+ * \param repeat Number of runs.
+ * \param function Function returning the number of the sets.
+ *
+ * \return Number of the sets computed by the last run.
+ */
+template<class Function>
+std::size_t measure(const char *name, int repeat, Function function) {
+    std::size_t result = 0;
+    qint64 best = std::numeric_limits<qint64>::max();
+    qint64 total = 0;
+
+    for (int i = 0; i < repeat; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+
+        result = function();
+
+        auto elapsed = timer.nsecsElapsed();
+        best = std::min(best, elapsed);
+        total += elapsed;
+    }
+
+    std::cout << name << ": best " << best / 1000 << " us, mean " << total / repeat / 1000 << " us, "
+              << result << " sets" << std::endl;
+
+    return result;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[]) {
+    std::size_t termCount = 100000;
+    int repeat = 5;
+
+    if (argc > 1) {
+        termCount = std::strtoul(argv[1], nullptr, 0);
+    }
+    if (argc > 2) {
+        repeat = std::atoi(argv[2]);
+    }
+    if (argc > 3 || termCount == 0 || repeat <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [TERMS [REPEAT]]" << std::endl
+                  << "Unites TERMS terms of a synthetic dataflow (100000 by default) REPEAT times (5 by default)" << std::endl
+                  << "with the pointer-based and the array-based disjoint sets and reports the timings." << std::endl;
+        return 1;
+    }
+
+    auto terms = generateDataflow(termCount);
+
+    std::cout << "Terms: " << terms.size() << std::endl;
+
+    auto oldSets = measure("DisjointSet", repeat, [&]() { return uniteWithDisjointSet(terms); });
+    auto newSets = measure("DenseDisjointSets", repeat, [&]() { return uniteWithDenseDisjointSets(terms); });
+
+    if (oldSets != newSets) {
+        std::cerr << argv[0] << ": the implementations found different numbers of sets" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,176 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+/*
+ * Measures the throughput of the instruction analyzer with the semantic
+ * template cache off and on, on the code sections of the given files.
+ */
+
+#include <memory>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+
+#include <nc/common/Exception.h>
+#include <nc/common/Foreach.h>
+#include <nc/core/Context.h>
+#include <nc/core/Driver.h>
+#include <nc/core/arch/Architecture.h>
+#include <nc/core/arch/Instructions.h>
+#include <nc/core/image/Image.h>
+#include <nc/core/ir/BasicBlock.h>
+#include <nc/core/ir/Program.h>
+#include <nc/core/irgen/InstructionAnalyzer.h>
+#include <nc/core/irgen/InvalidInstructionException.h>
+
+namespace {
+
+QTextStream qout(stdout, QIODevice::WriteOnly);
+QTextStream qerr(stderr, QIODevice::WriteOnly);
+
+/**
+ * Result of a run of the instruction analyzer.
+ */
+class RunResult {
+public:
+    qint64 nanoseconds; ///< Time spent in the instruction analyzer.
+    std::size_t statements; ///< Number of generated statements.
+    std::size_t templateHits; ///< Number of instructions instantiated from templates.
+
+    RunResult(): nanoseconds(0), statements(0), templateHits(0) {}
+};
+
+/**
+ * Generates the statements for all the instructions of a context.
+ *
+ * \param context Context with disassembled instructions.
+ * \param useCache Whether to use the semantic template cache.
+ *
+ * \return Result of the run.
+ */
+RunResult run(const nc::core::Context &context, bool useCache) {
+    auto instructionAnalyzer = context.image()->platform().architecture()->createInstructionAnalyzer();
+    instructionAnalyzer->templateCache().setEnabled(useCache);
+
+    nc::core::ir::Program program;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    foreach (const auto &instruction, context.instructions()->all()) {
+        try {
+            instructionAnalyzer->createStatements(instruction.get(), &program);
+        } catch (const nc::core::irgen::InvalidInstructionException &) {
+            /* Such instructions are skipped in the same way with and without the cache. */
+        }
+    }
+
+    RunResult result;
+    result.nanoseconds = timer.nsecsElapsed();
+    result.templateHits = instructionAnalyzer->templateCache().hits();
+
+    foreach (auto basicBlock, program.basicBlocks()) {
+        result.statements += basicBlock->statements().size();
+    }
+
+    return result;
+}
+
+/**
+ * Runs the instruction analyzer several times and prints the best run.
+ *
+ * \param context Context with disassembled instructions.
+ * \param useCache Whether to use the semantic template cache.
+ * \param repeat Number of runs.
+ *
+ * \return The best run.
+ */
+RunResult measure(const nc::core::Context &context, bool useCache, int repeat) {
+    RunResult best;
+
+    for (int i = 0; i < repeat; ++i) {
+        auto result = run(context, useCache);
+        if (i == 0 || result.nanoseconds < best.nanoseconds) {
+            best = result;
+        }
+    }
+
+    auto milliseconds = best.nanoseconds / 1000000.0;
+
+    qout << "  cache " << (useCache ? "on: " : "off:") << " " << milliseconds << " ms, "
+         << best.statements << " statements, "
+         << qint64(best.nanoseconds ? best.statements * 1000000000.0 / best.nanoseconds : 0) << " statements per second, "
+         << best.templateHits << " template hits" << endl;
+
+    return best;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    auto args = QCoreApplication::arguments();
+    auto self = args.front();
+
+    int repeat = 3;
+    QStringList files;
+
+    for (int i = 1; i < args.size(); ++i) {
+        if (args[i] == "--repeat" && i + 1 < args.size()) {
+            repeat = args[++i].toInt();
+        } else {
+            files.push_back(args[i]);
+        }
+    }
+
+    if (files.empty() || repeat <= 0) {
+        qerr << "Usage: " << self << " [--repeat N] FILE..." << endl
+             << "Generates the statements for the instructions in the code sections of each FILE" << endl
+             << "N times (3 by default) with the semantic template cache off and on, and reports" << endl
+             << "the best run of each." << endl;
+        return 1;
+    }
+
+    try {
+        RunResult totalOff;
+        RunResult totalOn;
+
+        foreach (const QString &file, files) {
+            nc::core::Context context;
+
+            nc::core::Driver::parse(context, file);
+            nc::core::Driver::disassemble(context);
+
+            qout << file << ": " << context.image()->platform().architecture()->name() << ", "
+                 << context.instructions()->size() << " instructions" << endl;
+
+            auto off = measure(context, false, repeat);
+            auto on = measure(context, true, repeat);
+
+            if (off.statements != on.statements) {
+                qerr << self << ": " << file << ": the cache changed the number of statements" << endl;
+                return 1;
+            }
+
+            totalOff.nanoseconds += off.nanoseconds;
+            totalOff.statements += off.statements;
+            totalOn.nanoseconds += on.nanoseconds;
+            totalOn.statements += on.statements;
+        }
+
+        if (files.size() > 1 && totalOn.nanoseconds) {
+            qout << "Total: " << totalOff.statements << " statements, speedup "
+                 << double(totalOff.nanoseconds) / totalOn.nanoseconds << "x" << endl;
+        }
+    } catch (const nc::Exception &e) {
+        qerr << self << ": " << e.unicodeWhat() << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,52 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+/*
+ * Example of using the decompiler library. Only the installed
+ * header is included, so the program builds against an installed
+ * library in the same way as against the build tree.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <nc/api/Decompiler.h>
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " FILE [ADDRESS]..." << std::endl
+                  << "Decompiles the functions at the given addresses, or the whole FILE." << std::endl;
+        return 1;
+    }
+
+    try {
+        nc::api::Decompiler decompiler{std::string(argv[1])};
+
+        nc::api::Options options;
+        for (int i = 2; i < argc; ++i) {
+            options.functions.push_back(std::strtoull(argv[i], nullptr, 0));
+        }
+        options.jobs = 4;
+        options.timeBudget = 60 * 1000;
+
+        decompiler.run(options);
+
+        std::cout << "// Architecture: " << decompiler.architecture() << std::endl;
+        for (const auto &function : decompiler.functions()) {
+            std::cout << "// " << function.name << ": " << function.basicBlockCount << " basic blocks";
+            if (function.hasSignature) {
+                std::cout << ", " << function.arguments.size() << " arguments";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << decompiler.code();
+    } catch (const nc::api::Error &e) {
+        std::cerr << argv[0] << ": " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/* vim:set et sts=4 sw=4: */
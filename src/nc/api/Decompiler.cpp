@@ -0,0 +1,375 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "Decompiler.h"
+
+#include <nc/config.h>
+
+#include <algorithm>
+#include <map>
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QTextStream>
+#include <QThreadPool>
+
+#include <nc/common/CancellationToken.h>
+#include <nc/common/Exception.h>
+#include <nc/common/Foreach.h>
+#include <nc/common/Parallel.h>
+#include <nc/common/Range.h>
+
+#include <nc/core/Context.h>
+#include <nc/core/Driver.h>
+#include <nc/core/FunctionCache.h>
+#include <nc/core/MasterAnalyzer.h>
+#include <nc/core/arch/Architecture.h>
+#include <nc/core/image/Image.h>
+#include <nc/core/ir/BasicBlock.h>
+#include <nc/core/ir/Function.h>
+#include <nc/core/ir/Functions.h>
+#include <nc/core/ir/Statements.h>
+#include <nc/core/ir/Term.h>
+#include <nc/core/ir/calling/FunctionSignature.h>
+#include <nc/core/ir/calling/Signatures.h>
+#include <nc/core/ir/cgen/NameGenerator.h>
+#include <nc/core/likec/CompilationUnit.h>
+#include <nc/core/likec/FunctionDefinition.h>
+#include <nc/core/likec/Tree.h>
+
+namespace nc {
+namespace api {
+
+namespace {
+
+/**
+ * Results of the analysis of a group of functions.
+ */
+class GroupResult {
+public:
+    std::vector<Function> functions; ///< Analyzed functions.
+    std::string code; ///< Generated code.
+    QString error; ///< Error message, if the analysis failed.
+    bool canceled; ///< True if the analysis was canceled.
+
+    GroupResult(): canceled(false) {}
+};
+
+/**
+ * \param string String.
+ *
+ * \return The string in UTF-8.
+ */
+std::string toUtf8(const QString &string) {
+    auto bytes = string.toUtf8();
+    return std::string(bytes.constData(), bytes.size());
+}
+
+/**
+ * Fills the signature of an API function from the reconstructed one.
+ *
+ * \param signatures Signatures.
+ * \param function API function with the address set.
+ */
+void fillSignature(const core::ir::calling::Signatures &signatures, Function &function) {
+    auto signature = signatures.getSignature(function.address);
+    if (!signature) {
+        return;
+    }
+
+    function.hasSignature = true;
+    foreach (const auto &argument, signature->arguments()) {
+        function.arguments.push_back(toUtf8(argument->toString()));
+    }
+    if (signature->returnValue()) {
+        function.returnValue = toUtf8(signature->returnValue()->toString());
+    }
+    function.variadic = signature->variadic();
+}
+
+/**
+ * Collects the results of the analysis.
+ *
+ * \param context Context after the analysis.
+ * \param result Results of the group to fill.
+ */
+void collectResults(const core::Context &context, GroupResult &result) {
+    const auto &selected = context.selectedFunctions();
+
+    std::map<QString, const core::likec::FunctionDefinition *> name2definition;
+    if (context.tree() && context.tree()->root()) {
+        foreach (const auto &declaration, context.tree()->root()->declarations()) {
+            if (auto definition = declaration->as<core::likec::FunctionDefinition>()) {
+                name2definition[definition->identifier()] = definition;
+            }
+        }
+    }
+
+    core::ir::cgen::NameGenerator nameGenerator(*context.image());
+
+    if (context.functions()) {
+        foreach (const core::ir::Function *irFunction, context.functions()->list()) {
+            if (!irFunction->entry() || !irFunction->entry()->address()) {
+                continue;
+            }
+
+            Function function;
+            function.address = *irFunction->entry()->address();
+
+            if (!selected.empty() && !nc::contains(selected, function.address)) {
+                continue;
+            }
+
+            auto name = nameGenerator.getFunctionName(function.address).name();
+
+            function.name = toUtf8(name);
+            function.basicBlockCount = irFunction->basicBlocks().size();
+
+            if (context.signatures()) {
+                fillSignature(*context.signatures(), function);
+            }
+
+            if (auto definition = nc::find(name2definition, name)) {
+                QString code;
+                QTextStream out(&code);
+                definition->print(out);
+                out.flush();
+                function.code = toUtf8(code);
+            }
+
+            result.functions.push_back(std::move(function));
+        }
+    }
+
+    foreach (const auto &addrAndDefinition, context.cachedDefinitions()) {
+        if (!selected.empty() && !nc::contains(selected, addrAndDefinition.first)) {
+            continue;
+        }
+
+        Function function;
+        function.address = addrAndDefinition.first;
+        function.name = toUtf8(nameGenerator.getFunctionName(function.address).name());
+        if (context.signatures()) {
+            fillSignature(*context.signatures(), function);
+        }
+        function.code = toUtf8(addrAndDefinition.second.definition);
+
+        result.functions.push_back(std::move(function));
+    }
+
+    if (context.tree()) {
+        QString code;
+        QTextStream out(&code);
+        context.tree()->print(out);
+        out.flush();
+        result.code = toUtf8(code);
+    }
+}
+
+/**
+ * Analyzes a group of functions in a context of its own.
+ *
+ * \param image Executable image.
+ * \param functionCache Function cache. Can be nullptr.
+ * \param entries Entry addresses of the functions. Empty vector means the whole program.
+ * \param options Options of the run.
+ * \param cancellationToken Cancellation token.
+ * \param result Results of the group to fill.
+ */
+void analyze(const std::shared_ptr<core::image::Image> &image, const std::shared_ptr<core::FunctionCache> &functionCache,
+             const std::vector<ByteAddr> &entries, const Options &options, const CancellationToken &cancellationToken,
+             GroupResult &result)
+{
+    try {
+        core::Context context;
+        context.setImage(image);
+        context.setFunctionCache(functionCache);
+        context.setCancellationToken(cancellationToken);
+
+        if (entries.empty()) {
+            core::Driver::disassemble(context);
+        } else {
+            core::Driver::disassemble(context, entries, options.depth);
+            context.setSelectedFunctions(entries);
+        }
+        cancellationToken.poll();
+
+        if (options.stage == Options::FUNCTIONS) {
+            auto masterAnalyzer = image->platform().architecture()->masterAnalyzer();
+            masterAnalyzer->createProgram(context);
+            masterAnalyzer->createFunctions(context);
+        } else if (options.stage == Options::DECOMPILATION) {
+            core::Driver::decompile(context);
+        }
+
+        collectResults(context, result);
+    } catch (const CancellationException &) {
+        result.canceled = true;
+    } catch (const nc::Exception &e) {
+        result.error = e.unicodeWhat();
+    } catch (const std::exception &e) {
+        result.error = QString::fromLocal8Bit(e.what());
+    }
+}
+
+} // anonymous namespace
+
+class Decompiler::Impl {
+    Q_DECLARE_TR_FUNCTIONS(Decompiler)
+
+public:
+    std::shared_ptr<core::image::Image> image; ///< Executable image.
+    std::vector<Function> functions; ///< Functions found by the last run.
+    std::string code; ///< Code generated by the last run.
+
+    QMutex mutex; ///< Mutex protecting cancellationToken.
+    CancellationToken cancellationToken; ///< Cancellation token of the current run.
+
+    /**
+     * Parses the image.
+     *
+     * \param source Valid pointer to an I/O device opened for reading.
+     * \param name Name of the image.
+     */
+    void parse(QIODevice *source, const QString &name) {
+        try {
+            core::Context context;
+            core::Driver::parse(context, source, name);
+            image = context.image();
+        } catch (const nc::Exception &e) {
+            throw Error(toUtf8(e.unicodeWhat()));
+        }
+    }
+
+    /**
+     * Runs the pipeline.
+     *
+     * \param options Options of the run.
+     */
+    void run(const Options &options);
+};
+
+void Decompiler::Impl::run(const Options &options) {
+    functions.clear();
+    code.clear();
+
+    CancellationToken token;
+    token.setTimeLimit(static_cast<qint64>(options.timeBudget));
+    {
+        QMutexLocker locker(&mutex);
+        cancellationToken = token;
+    }
+
+    std::shared_ptr<core::FunctionCache> functionCache;
+    if (!options.functionCacheDirectory.empty()) {
+        try {
+            functionCache = std::make_shared<core::FunctionCache>(
+                QString::fromUtf8(options.functionCacheDirectory.c_str()));
+        } catch (const nc::Exception &e) {
+            throw Error(toUtf8(e.unicodeWhat()));
+        }
+    }
+
+    /* Selected functions are split into independently analyzed groups. */
+    std::vector<std::vector<ByteAddr>> groups;
+    if (options.functions.empty()) {
+        groups.resize(1);
+    } else {
+        groups.resize(std::min<std::size_t>(std::max(options.jobs, 1), options.functions.size()));
+        for (std::size_t i = 0; i < options.functions.size(); ++i) {
+            groups[i % groups.size()].push_back(options.functions[i]);
+        }
+    }
+
+    std::vector<GroupResult> results(groups.size());
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(static_cast<int>(groups.size()));
+
+    parallelFor(groups.size(), [&](std::size_t i) {
+        analyze(image, functionCache, groups[i], options, token, results[i]);
+    }, &threadPool);
+
+    foreach (const auto &result, results) {
+        if (!result.error.isEmpty()) {
+            throw Error(toUtf8(result.error));
+        }
+        if (result.canceled) {
+            throw Error(toUtf8(token.timeLimitExceeded() ? tr("Time budget exceeded.") : tr("Decompilation canceled.")));
+        }
+    }
+
+    foreach (auto &result, results) {
+        std::move(result.functions.begin(), result.functions.end(), std::back_inserter(functions));
+        code += result.code;
+    }
+
+    std::sort(functions.begin(), functions.end(), [](const Function &a, const Function &b) {
+        return a.address < b.address;
+    });
+}
+
+Decompiler::Decompiler(const void *data, std::size_t size, const std::string &name):
+    impl_(new Impl)
+{
+    QByteArray bytes(static_cast<const char *>(data), static_cast<int>(size));
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::ReadOnly);
+
+    impl_->parse(&buffer, QString::fromUtf8(name.c_str()));
+}
+
+Decompiler::Decompiler(const std::string &filename):
+    impl_(new Impl)
+{
+    auto name = QString::fromUtf8(filename.c_str());
+
+    QFile file(name);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw Error(toUtf8(Impl::tr("Could not open file \"%1\" for reading.").arg(name)));
+    }
+
+    impl_->parse(&file, name);
+}
+
+Decompiler::~Decompiler() {}
+
+std::string Decompiler::architecture() const {
+    return toUtf8(impl_->image->platform().architecture()->name());
+}
+
+void Decompiler::run(const Options &options) {
+    impl_->run(options);
+}
+
+void Decompiler::cancel() {
+    QMutexLocker locker(&impl_->mutex);
+    impl_->cancellationToken.cancel();
+}
+
+const std::vector<Function> &Decompiler::functions() const {
+    return impl_->functions;
+}
+
+const Function *Decompiler::getFunction(std::uint64_t address) const {
+    auto i = std::lower_bound(impl_->functions.begin(), impl_->functions.end(), address,
+        [](const Function &function, std::uint64_t address) { return function.address < address; });
+
+    if (i != impl_->functions.end() && i->address == address) {
+        return &*i;
+    }
+    return nullptr;
+}
+
+const std::string &Decompiler::code() const {
+    return impl_->code;
+}
+
+} // namespace api
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,181 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+/*
+ * This header is installed for the users of the library,
+ * so it must not include any other headers of the decompiler.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#   if defined(nc_EXPORTS)
+#       define NC_API __declspec(dllexport)
+#   else
+#       define NC_API __declspec(dllimport)
+#   endif
+#else
+#   define NC_API __attribute__((visibility("default")))
+#endif
+
+namespace nc {
+namespace api {
+
+/**
+ * Error reported by the library.
+ */
+class NC_API Error: public std::runtime_error {
+public:
+    /**
+     * Constructor.
+     *
+     * \param message UTF-8 encoded error message.
+     */
+    explicit Error(const std::string &message): std::runtime_error(message) {}
+};
+
+/**
+ * Options of a decompilation run.
+ */
+class Options {
+public:
+    /**
+     * Last stage of the pipeline to run.
+     */
+    enum Stage {
+        DISASSEMBLY,    ///< Disassemble the code.
+        FUNCTIONS,      ///< Also build the intermediate representation and split it into functions.
+        DECOMPILATION   ///< Also reconstruct signatures, variables, types and generate code.
+    };
+
+    Stage stage; ///< Last stage of the pipeline to run.
+
+    /**
+     * Entry addresses of the functions to decompile. If empty, the whole
+     * program is decompiled. Otherwise, only the given functions and their
+     * callees up to the given depth are analyzed.
+     */
+    std::vector<std::uint64_t> functions;
+
+    int depth; ///< Depth of callees to analyze together with the given functions.
+
+    /**
+     * Number of threads decompiling the given functions. The functions are
+     * split into this number of groups, each analyzed independently.
+     * Ignored when the whole program is decompiled.
+     */
+    int jobs;
+
+    /**
+     * Time budget of the run in milliseconds, or 0 for no limit.
+     * When it is exceeded, the run is canceled and throws Error.
+     */
+    std::size_t timeBudget;
+
+    std::string functionCacheDirectory; ///< Directory of the function cache, or empty for no cache.
+
+    Options(): stage(DECOMPILATION), depth(1), jobs(1), timeBudget(0) {}
+};
+
+/**
+ * Results of the analysis of a function.
+ */
+class Function {
+public:
+    std::uint64_t address; ///< Entry address.
+    std::string name; ///< Name, UTF-8 encoded.
+    std::size_t basicBlockCount; ///< Number of basic blocks, 0 if the function came from the function cache.
+
+    bool hasSignature; ///< True if the signature has been reconstructed.
+    std::vector<std::string> arguments; ///< Locations of the arguments, e.g. "[esp+4]".
+    std::string returnValue; ///< Location of the return value, or empty if the function returns nothing.
+    bool variadic; ///< True if the function is variadic.
+
+    std::string code; ///< Generated definition in C, UTF-8 encoded. Empty if not generated.
+
+    Function(): address(0), basicBlockCount(0), hasSignature(false), variadic(false) {}
+};
+
+/**
+ * Decompiler of a single executable image.
+ *
+ * Different instances can be used concurrently from different threads.
+ * A single instance must not be used concurrently, except for cancel().
+ *
+ * All the methods report errors by throwing nc::api::Error.
+ */
+class NC_API Decompiler {
+    class Impl;
+
+    std::unique_ptr<Impl> impl_; ///< Implementation.
+
+public:
+    /**
+     * Parses an executable image from a memory buffer.
+     *
+     * \param data Valid pointer to the contents of the executable file.
+     *             The contents are copied.
+     * \param size Size of the contents.
+     * \param name Name of the image used in messages.
+     */
+    Decompiler(const void *data, std::size_t size, const std::string &name = std::string());
+
+    /**
+     * Parses an executable file.
+     *
+     * \param filename Name of the file, UTF-8 encoded.
+     */
+    explicit Decompiler(const std::string &filename);
+
+    /**
+     * Destructor.
+     */
+    ~Decompiler();
+
+    /**
+     * \return Name of the architecture of the image.
+     */
+    std::string architecture() const;
+
+    /**
+     * Runs the pipeline. Results of the previous run are discarded.
+     *
+     * \param options Options of the run.
+     */
+    void run(const Options &options = Options());
+
+    /**
+     * Cancels the current run. Can be called from any thread.
+     * The run throws Error.
+     */
+    void cancel();
+
+    /**
+     * \return Functions found by the last run, sorted by address.
+     */
+    const std::vector<Function> &functions() const;
+
+    /**
+     * \param address Entry address.
+     *
+     * \return Pointer to the function with the given entry address, or nullptr if there is no such function.
+     */
+    const Function *getFunction(std::uint64_t address) const;
+
+    /**
+     * \return Code generated by the last run, UTF-8 encoded.
+     */
+    const std::string &code() const;
+};
+
+} // namespace api
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
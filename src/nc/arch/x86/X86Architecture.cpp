@@ -56,6 +56,18 @@ X86Architecture::X86Architecture(Mode mode) {
     }
 
     setMaxInstructionSize(X86Instruction::MAX_SIZE);
+
+    addFlag(X86Registers::cf());
+    addFlag(X86Registers::pf());
+    addFlag(X86Registers::af());
+    addFlag(X86Registers::zf());
+    addFlag(X86Registers::sf());
+    addFlag(X86Registers::of());
+    addFlag(X86Registers::less());
+    addFlag(X86Registers::less_or_equal());
+    addFlag(X86Registers::below_or_equal());
+
+    addTemporary(X86Registers::tmp64());
 }
 
 X86Architecture::~X86Architecture() {}
@@ -27,8 +27,10 @@
 #include <boost/range/size.hpp>
 
 #include <nc/common/CheckedCast.h>
+#include <nc/common/Foreach.h>
 #include <nc/common/Unreachable.h>
 
+#include <nc/core/ir/BasicBlock.h>
 #include <nc/core/ir/Program.h>
 #include <nc/core/ir/Statements.h>
 #include <nc/core/ir/Terms.h>
@@ -105,10 +107,34 @@ public:
         ud_set_mode(&ud_obj_, architecture_->bitness());
     }
 
-    void createStatements(const X86Instruction *instr, core::ir::Program *program) {
+    void createStatements(const X86Instruction *instr, core::ir::Program *program,
+                          core::irgen::SemanticTemplateCache &templateCache) {
         assert(instr != nullptr);
         assert(program != nullptr);
 
+        /* Identical bytes decode to identical semantics, modulo the address. */
+        std::string key(reinterpret_cast<const char *>(instr->bytes()), instr->size());
+
+        auto basicBlock = program->getBasicBlockForInstruction(instr);
+        if (templateCache.instantiate(key, instr, basicBlock)) {
+            return;
+        }
+
+        const core::ir::Statement *lastStatement =
+            basicBlock->statements().empty() ? nullptr : basicBlock->statements().back();
+        const core::ir::BasicBlock *lastBasicBlock = program->basicBlocks().back();
+
+        generateStatements(instr, program);
+
+        if (isPositionIndependent() && program->basicBlocks().back() == lastBasicBlock) {
+            templateCache.add(key, basicBlock, lastStatement);
+        } else {
+            templateCache.reject(key);
+        }
+    }
+
+private:
+    void generateStatements(const X86Instruction *instr, core::ir::Program *program) {
         currentInstruction_ = instr;
 
         ud_set_pc(&ud_obj_, instr->addr());
@@ -1214,7 +1240,27 @@ public:
         }
     }
 
-private:
+    /**
+     * \return True if the semantics of the last decoded instruction do not depend on its address.
+     */
+    bool isPositionIndependent() const {
+        foreach (const ud_operand &operand, ud_obj_.operand) {
+            switch (operand.type) {
+                case UD_OP_JIMM:
+                    return false;
+                case UD_OP_REG:
+                case UD_OP_MEM:
+                    if (operand.base == UD_R_RIP || operand.index == UD_R_RIP) {
+                        return false;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        return true;
+    }
+
     bool hasOperand(std::size_t index) const {
         assert(index < boost::size(ud_obj_.operand));
         return ud_obj_.operand[index].type != UD_NONE;
@@ -1506,7 +1552,7 @@ X86InstructionAnalyzer::X86InstructionAnalyzer(const X86Architecture *architectu
 X86InstructionAnalyzer::~X86InstructionAnalyzer() {}
 
 void X86InstructionAnalyzer::doCreateStatements(const core::arch::Instruction *instruction, core::ir::Program *program) {
-    impl_->createStatements(checked_cast<const X86Instruction *>(instruction), program);
+    impl_->createStatements(checked_cast<const X86Instruction *>(instruction), program, templateCache());
 }
 
 } // namespace x86
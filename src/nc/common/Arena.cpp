@@ -0,0 +1,35 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "Arena.h"
+
+namespace nc {
+
+void *Arena::allocateSlow(std::size_t size, std::size_t alignment) {
+    /* Blocks from new[] are aligned for any fundamental type. */
+    auto required = size + alignment - 1;
+
+    if (required > blockSize_ / 4) {
+        /*
+         * A large chunk gets a block of its own, so that the rest of
+         * the current block is not wasted.
+         */
+        blocks_.push_back(std::unique_ptr<char[]>(new char[required]));
+        auto address = (reinterpret_cast<std::uintptr_t>(blocks_.back().get()) + alignment - 1) & ~(alignment - 1);
+
+        bytesAllocated_ += size;
+        bytesReserved_ += required;
+        return reinterpret_cast<char *>(address);
+    }
+
+    blocks_.push_back(std::unique_ptr<char[]>(new char[blockSize_]));
+    current_ = blocks_.back().get();
+    end_ = current_ + blockSize_;
+    bytesReserved_ += blockSize_;
+
+    return allocate(size, alignment);
+}
+
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
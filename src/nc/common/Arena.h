@@ -0,0 +1,109 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+namespace nc {
+
+/**
+ * Bump-pointer memory allocator.
+ *
+ * Memory is handed out from large blocks and is never returned to the
+ * arena individually: all of it is released at once when the arena is
+ * destroyed. Objects placed into the arena must be destroyed before it.
+ */
+class Arena: boost::noncopyable {
+    std::size_t blockSize_; ///< Size of a regular block.
+    std::vector<std::unique_ptr<char[]>> blocks_; ///< Allocated blocks.
+    char *current_; ///< First free byte of the current block.
+    char *end_; ///< End of the current block.
+    std::size_t bytesAllocated_; ///< Number of bytes handed out.
+    std::size_t bytesReserved_; ///< Total size of the allocated blocks.
+    std::size_t bytesReleased_; ///< Number of bytes reported as no longer used.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param blockSize Size of a regular block in bytes.
+     */
+    explicit Arena(std::size_t blockSize = 64 * 1024):
+        blockSize_(blockSize), current_(nullptr), end_(nullptr), bytesAllocated_(0), bytesReserved_(0), bytesReleased_(0)
+    {
+        assert(blockSize > 0);
+    }
+
+    /**
+     * Allocates memory.
+     *
+     * \param size Size of the memory chunk in bytes.
+     * \param alignment Alignment of the memory chunk, a power of two.
+     *
+     * \return Pointer to the allocated memory, valid until the arena is destroyed.
+     */
+    void *allocate(std::size_t size, std::size_t alignment = sizeof(void *)) {
+        assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+        auto address = (reinterpret_cast<std::uintptr_t>(current_) + alignment - 1) & ~(alignment - 1);
+        auto result = reinterpret_cast<char *>(address);
+
+        if (current_ == nullptr || result > end_ || static_cast<std::size_t>(end_ - result) < size) {
+            return allocateSlow(size, alignment);
+        }
+
+        current_ = result + size;
+        bytesAllocated_ += size;
+        return result;
+    }
+
+    /**
+     * Counts a chunk of memory handed out before as no longer used.
+     * The memory itself is not reused until the arena is destroyed.
+     *
+     * \param size Size of the memory chunk in bytes.
+     */
+    void release(std::size_t size) {
+        assert(bytesReleased_ + size <= bytesAllocated_);
+        bytesReleased_ += size;
+    }
+
+    /**
+     * \return Number of bytes handed out by the arena.
+     */
+    std::size_t bytesAllocated() const { return bytesAllocated_; }
+
+    /**
+     * \return Number of bytes the arena has taken from the heap.
+     */
+    std::size_t bytesReserved() const { return bytesReserved_; }
+
+    /**
+     * \return Number of bytes handed out by the arena and released since.
+     */
+    std::size_t bytesReleased() const { return bytesReleased_; }
+
+private:
+    /**
+     * Allocates memory from a new block.
+     *
+     * \param size Size of the memory chunk in bytes.
+     * \param alignment Alignment of the memory chunk.
+     *
+     * \return Pointer to the allocated memory.
+     */
+    void *allocateSlow(std::size_t size, std::size_t alignment);
+};
+
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
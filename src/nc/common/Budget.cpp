@@ -0,0 +1,26 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "Budget.h"
+
+#include "Unreachable.h"
+
+namespace nc {
+
+QString Budget::describe(Limit limit) const {
+    switch (limit) {
+        case NO_LIMIT:
+            return tr("no limit");
+        case TIME:
+            return tr("time limit of %1 ms").arg(maxTime_);
+        case SIZE:
+            return tr("size limit of %1 statements").arg(maxSize_);
+        case ITERATIONS:
+            return tr("limit of %1 iterations").arg(maxIterations_);
+    }
+    unreachable();
+}
+
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
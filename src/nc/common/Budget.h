@@ -0,0 +1,144 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QString>
+
+namespace nc {
+
+/**
+ * Limits on the work an analysis may spend on a single function.
+ *
+ * An analysis checks the limits at the points where it can stop early
+ * and still leave consistent, if less precise, results. The first
+ * exceeded limit is remembered, so that the caller can report it.
+ * Zero limits are not enforced.
+ *
+ * Copies of a budget share the limits, but not the timer.
+ */
+class Budget {
+    Q_DECLARE_TR_FUNCTIONS(Budget)
+
+public:
+    /**
+     * Kinds of limits.
+     */
+    enum Limit {
+        NO_LIMIT,  ///< No limit.
+        TIME,      ///< Wall time.
+        SIZE,      ///< Number of statements in the intermediate representation.
+        ITERATIONS ///< Number of iterations of a fixpoint computation.
+    };
+
+private:
+    qint64 maxTime_; ///< Maximal wall time in milliseconds.
+    std::size_t maxSize_; ///< Maximal number of statements.
+    std::size_t maxIterations_; ///< Maximal number of iterations.
+    QElapsedTimer timer_; ///< Timer measuring the time since start().
+    Limit exceeded_; ///< First exceeded limit since start().
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param maxTime Maximal wall time in milliseconds.
+     * \param maxSize Maximal number of statements.
+     * \param maxIterations Maximal number of iterations.
+     */
+    explicit Budget(qint64 maxTime = 0, std::size_t maxSize = 0, std::size_t maxIterations = 0):
+        maxTime_(maxTime), maxSize_(maxSize), maxIterations_(maxIterations), exceeded_(NO_LIMIT)
+    {}
+
+    /**
+     * \return Maximal wall time in milliseconds, or zero if not limited.
+     */
+    qint64 maxTime() const { return maxTime_; }
+
+    /**
+     * \return Maximal number of statements, or zero if not limited.
+     */
+    std::size_t maxSize() const { return maxSize_; }
+
+    /**
+     * \return Maximal number of iterations, or zero if not limited.
+     */
+    std::size_t maxIterations() const { return maxIterations_; }
+
+    /**
+     * \return True if no limit is set.
+     */
+    bool unlimited() const { return maxTime_ == 0 && maxSize_ == 0 && maxIterations_ == 0; }
+
+    /**
+     * Starts the timer and forgets the exceeded limit.
+     */
+    void start() {
+        timer_.start();
+        exceeded_ = NO_LIMIT;
+    }
+
+    /**
+     * \return True if the time since start() is within the limit.
+     */
+    bool checkTime() {
+        return check(TIME, maxTime_ == 0 || !timer_.isValid() || timer_.elapsed() <= maxTime_);
+    }
+
+    /**
+     * \param size Number of statements.
+     *
+     * \return True if the number is within the limit.
+     */
+    bool checkSize(std::size_t size) {
+        return check(SIZE, maxSize_ == 0 || size <= maxSize_);
+    }
+
+    /**
+     * \param iterations Number of iterations done.
+     *
+     * \return True if the number is within the limit.
+     */
+    bool checkIterations(std::size_t iterations) {
+        return check(ITERATIONS, maxIterations_ == 0 || iterations <= maxIterations_);
+    }
+
+    /**
+     * \return First limit exceeded since start(), or NO_LIMIT.
+     */
+    Limit exceeded() const { return exceeded_; }
+
+    /**
+     * \param limit Kind of a limit.
+     *
+     * \return Human-readable description of the limit, e.g. "time limit of 100 ms".
+     */
+    QString describe(Limit limit) const;
+
+private:
+    /**
+     * Remembers the limit as exceeded if the check failed and no other
+     * limit has been exceeded before.
+     *
+     * \param limit Checked limit.
+     * \param ok Result of the check.
+     *
+     * \return The result of the check.
+     */
+    bool check(Limit limit, bool ok) {
+        if (!ok && exceeded_ == NO_LIMIT) {
+            exceeded_ = limit;
+        }
+        return ok;
+    }
+};
+
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
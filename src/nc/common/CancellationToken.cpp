@@ -32,13 +32,26 @@ CancellationException::CancellationException():
     Exception(tr("Cancellation requested"))
 {}
 
+void CancellationToken::setTimeLimit(qint64 milliseconds) {
+    state_->timeLimit = milliseconds;
+    state_->timer.start();
+}
+
+bool CancellationToken::checkTimeLimit() const {
+    if (timeLimitExceeded()) {
+        state_->cancellationRequested = true;
+        return true;
+    }
+    return false;
+}
+
 #ifndef NC_USE_THREADS
 bool CancellationToken::cancellationRequested() const {
     if (qApp) {
         qApp->processEvents();
     }
 
-    return *cancellationRequested_;
+    return state_->cancellationRequested || (state_->timeLimit != 0 && checkTimeLimit());
 }
 #endif
 
@@ -28,6 +28,7 @@
 #include <memory> /* std::shared_ptr */
 
 #include <QCoreApplication>
+#include <QElapsedTimer>
 
 #include "Exception.h"
 
@@ -50,28 +51,53 @@ public:
  * Class for propagating cancellation notifications.
  */
 class CancellationToken {
-    /** Flag whether the cancellation is requested. */
-    std::shared_ptr<volatile bool> cancellationRequested_;
+    /**
+     * State shared by the copies of a token.
+     */
+    class State {
+    public:
+        volatile bool cancellationRequested; ///< Flag whether the cancellation is requested.
+        qint64 timeLimit; ///< Time in milliseconds after which the cancellation is requested automatically, 0 for no limit.
+        QElapsedTimer timer; ///< Timer started when the time limit was set.
+
+        State(): cancellationRequested(false), timeLimit(0) {}
+    };
+
+    /** Shared state of the token and its copies. */
+    std::shared_ptr<State> state_;
 
 public:
     /**
      * Creates a not canceled token.
      */
     CancellationToken():
-        cancellationRequested_(std::make_shared<bool>(false))
+        state_(std::make_shared<State>())
     {}
 
     /**
      * Sets the cancellation flag for the token and all its copies.
      */
-    void cancel() { *cancellationRequested_ = true; }
+    void cancel() { state_->cancellationRequested = true; }
+
+    /**
+     * Makes the token and all its copies canceled automatically after the given time.
+     * Must not be called while the token is polled by other threads.
+     *
+     * \param milliseconds Time limit in milliseconds, 0 for no limit.
+     */
+    void setTimeLimit(qint64 milliseconds);
+
+    /**
+     * \return True if the time limit is set and exceeded.
+     */
+    bool timeLimitExceeded() const { return state_->timeLimit != 0 && state_->timer.elapsed() > state_->timeLimit; }
 
     /**
      * \return True if the cancellation flag is set and false otherwise.
      */
     bool cancellationRequested() const
 #ifdef NC_USE_THREADS
-    { return *cancellationRequested_; }
+    { return state_->cancellationRequested || (state_->timeLimit != 0 && checkTimeLimit()); }
 #else
     ;
 #endif
@@ -84,6 +110,14 @@ public:
             throw CancellationException();
         }
     }
+
+private:
+    /**
+     * Sets the cancellation flag if the time limit is exceeded.
+     *
+     * \return True if the time limit is exceeded.
+     */
+    bool checkTimeLimit() const;
 };
 
 } // namespace nc
@@ -0,0 +1,107 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace nc {
+
+/**
+ * Disjoint sets of elements numbered by consecutive integers.
+ *
+ * Unlike DisjointSet, the elements are not objects linked by pointers:
+ * the parents and the sizes of the sets are stored in two arrays indexed
+ * by the element number. Finding uses path halving, uniting is by size.
+ */
+class DenseDisjointSets {
+    mutable std::vector<std::size_t> parents_; ///< Parent of each element.
+    std::vector<std::size_t> sizes_; ///< Size of the set, for representatives.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param size Number of elements, each one forming a singleton set.
+     */
+    explicit DenseDisjointSets(std::size_t size = 0) {
+        parents_.reserve(size);
+        sizes_.reserve(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            addElement();
+        }
+    }
+
+    /**
+     * \return Number of elements.
+     */
+    std::size_t size() const { return parents_.size(); }
+
+    /**
+     * Adds an element forming a singleton set.
+     *
+     * \return Number of the new element.
+     */
+    std::size_t addElement() {
+        auto element = parents_.size();
+        parents_.push_back(element);
+        sizes_.push_back(1);
+        return element;
+    }
+
+    /**
+     * \param element Number of an element.
+     *
+     * \return Representative of the set the element belongs to.
+     */
+    std::size_t findSet(std::size_t element) const {
+        assert(element < size());
+
+        while (parents_[element] != element) {
+            parents_[element] = parents_[parents_[element]];
+            element = parents_[element];
+        }
+        return element;
+    }
+
+    /**
+     * Unites the sets two elements belong to.
+     *
+     * \param a Number of an element.
+     * \param b Number of an element.
+     *
+     * \return Representative of the united set.
+     */
+    std::size_t unionSet(std::size_t a, std::size_t b) {
+        a = findSet(a);
+        b = findSet(b);
+
+        if (a == b) {
+            return a;
+        }
+        if (sizes_[a] < sizes_[b]) {
+            std::swap(a, b);
+        }
+
+        parents_[b] = a;
+        sizes_[a] += sizes_[b];
+
+        return a;
+    }
+
+    /**
+     * \param element Number of an element.
+     *
+     * \return Number of elements in the set the element belongs to.
+     */
+    std::size_t setSize(std::size_t element) const { return sizes_[findSet(element)]; }
+};
+
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -82,7 +82,9 @@ private:
 /**
  * The base class for a logger.
  *
- * Logger does the actual logging of messages.
+ * Logger does the actual logging of messages. Analyses running
+ * in parallel log from different threads, so implementations
+ * must be thread-safe.
  */
 class Logger {
 public:
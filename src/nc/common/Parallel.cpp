@@ -0,0 +1,173 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include "Foreach.h"
+#include "Unused.h"
+
+namespace nc {
+
+namespace {
+
+#ifdef NC_USE_THREADS
+/**
+ * Runnable calling a function.
+ */
+class FunctionRunnable: public QRunnable {
+    std::function<void()> function_; ///< Function to call.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param function Valid function to call.
+     */
+    explicit FunctionRunnable(std::function<void()> function): function_(std::move(function)) {}
+
+    void run() override { function_(); }
+};
+
+/**
+ * State of a parallelFor() call shared with the runnables it starts.
+ * A runnable may start after the call has returned: then it finds no
+ * indices left and does not touch the function or the exceptions.
+ */
+class ParallelForState {
+    QMutex mutex_; ///< Mutex protecting the fields below.
+    QWaitCondition idle_; ///< Signaled when the last active runnable is done.
+    const std::function<void(std::size_t)> &function_; ///< Function to call.
+    std::vector<std::exception_ptr> &exceptions_; ///< Exceptions thrown by the calls.
+    std::size_t count_; ///< Number of calls.
+    std::size_t next_; ///< Next index to call the function with.
+    int active_; ///< Number of runnables calling the function.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param function Valid function to call.
+     * \param exceptions Vector for the exceptions thrown by the calls, with an element per index.
+     */
+    ParallelForState(const std::function<void(std::size_t)> &function, std::vector<std::exception_ptr> &exceptions):
+        function_(function), exceptions_(exceptions), count_(exceptions.size()), next_(0), active_(0)
+    {}
+
+    /**
+     * Calls the function with the indices not taken by other threads yet.
+     *
+     * \param runnable Whether the calling thread is one of the runnables.
+     */
+    void work(bool runnable) {
+        QMutexLocker locker(&mutex_);
+
+        if (runnable) {
+            if (next_ >= count_) {
+                return;
+            }
+            ++active_;
+        }
+
+        while (next_ < count_) {
+            auto i = next_++;
+            locker.unlock();
+
+            try {
+                function_(i);
+            } catch (...) {
+                exceptions_[i] = std::current_exception();
+            }
+
+            locker.relock();
+        }
+
+        if (runnable && --active_ == 0) {
+            idle_.wakeAll();
+        }
+    }
+
+    /**
+     * Waits until no runnable calls the function.
+     */
+    void waitForRunnables() {
+        QMutexLocker locker(&mutex_);
+        while (active_ > 0) {
+            idle_.wait(&mutex_);
+        }
+    }
+};
+#endif
+
+} // anonymous namespace
+
+void parallelFor(std::size_t count, const std::function<void(std::size_t)> &function, QThreadPool *threadPool) {
+    assert(function);
+
+#ifdef NC_USE_THREADS
+    if (count <= 1) {
+        if (count == 1) {
+            function(0);
+        }
+        return;
+    }
+
+    if (threadPool == nullptr) {
+        threadPool = QThreadPool::globalInstance();
+    }
+
+    std::vector<std::exception_ptr> exceptions(count);
+    auto state = std::make_shared<ParallelForState>(function, exceptions);
+
+    /*
+     * The calling thread takes part in the work. So the call does not
+     * deadlock when made from a thread of the same pool, and it does not
+     * have to wait for the unrelated work of the pool.
+     */
+    auto nrunnables = std::min(count - 1, static_cast<std::size_t>(std::max(threadPool->maxThreadCount() - 1, 1)));
+    for (std::size_t i = 0; i < nrunnables; ++i) {
+        threadPool->start(new FunctionRunnable([state]() { state->work(true); }));
+    }
+
+    state->work(false);
+    state->waitForRunnables();
+
+    foreach (const auto &exception, exceptions) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+#else
+    NC_UNUSED(threadPool);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        function(i);
+    }
+#endif
+}
+
+void startInThreadPool(QThreadPool &threadPool, std::function<void()> function) {
+    assert(function);
+
+#ifdef NC_USE_THREADS
+    threadPool.start(new FunctionRunnable(std::move(function)));
+#else
+    NC_UNUSED(threadPool);
+    function();
+#endif
+}
+
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,47 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+#include <functional>
+
+#include <QtGlobal>
+
+QT_BEGIN_NAMESPACE
+class QThreadPool;
+QT_END_NAMESPACE
+
+namespace nc {
+
+/**
+ * Calls a function for each index from 0 to count - 1.
+ *
+ * With NC_USE_THREADS, the calls are made concurrently by the calling thread
+ * and the threads of the given thread pool, and the function returns when
+ * all of them are done.
+ * If some calls throw, the exception of the one with the lowest index is
+ * rethrown. Without NC_USE_THREADS, the calls are made in the order of the
+ * indices by the calling thread, and an exception stops the loop.
+ *
+ * \param count Number of calls.
+ * \param function Valid function. It must be safe to call it concurrently with different indices.
+ * \param threadPool Pointer to the thread pool to use. If nullptr, the global thread pool is used.
+ *                   The pool can run other work at the same time, including this function.
+ */
+void parallelFor(std::size_t count, const std::function<void(std::size_t)> &function, QThreadPool *threadPool = nullptr);
+
+/**
+ * Runs a function by a thread of the given thread pool. Without NC_USE_THREADS,
+ * runs it in the calling thread before returning.
+ *
+ * \param threadPool Thread pool.
+ * \param function Valid function. Exceptions thrown by it are not caught.
+ */
+void startInThreadPool(QThreadPool &threadPool, std::function<void()> function);
+
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
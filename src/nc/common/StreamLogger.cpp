@@ -8,7 +8,10 @@
 namespace nc {
 
 void StreamLogger::log(LogLevel level, const QString &text) {
-    stream_ << tr("[%1] %2").arg(level.getName()).arg(text) << endl;
+    auto message = tr("[%1] %2").arg(level.getName()).arg(text);
+
+    QMutexLocker locker(&mutex_);
+    stream_ << message << endl;
 }
 
 } // namespace nc
@@ -6,6 +6,7 @@
 #include <nc/config.h>
 
 #include <QCoreApplication>
+#include <QMutex>
 #include <QTextStream>
 
 #include "Logger.h"
@@ -14,11 +15,13 @@ namespace nc {
 
 /**
  * Logger printing messages to a stream.
+ * Messages can be logged concurrently from different threads.
  */
 class StreamLogger: public nc::Logger {
     Q_DECLARE_TR_FUNCTIONS(StreamLogger)
 
-    QTextStream &stream_;
+    QTextStream &stream_; ///< Stream to print messages to.
+    QMutex mutex_; ///< Mutex serializing the writes to the stream.
 
 public:
     /**
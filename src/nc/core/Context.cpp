@@ -24,11 +24,16 @@
 
 #include "Context.h"
 
+#include <cassert>
+
 #include <nc/common/Foreach.h>
 
+#include <nc/core/FunctionCache.h>
+#include <nc/core/SignatureDatabase.h>
 #include <nc/core/arch/Architecture.h>
 #include <nc/core/arch/Instructions.h>
 #include <nc/core/image/Image.h>
+#include <nc/core/ir/Function.h>
 #include <nc/core/ir/Functions.h>
 #include <nc/core/ir/Program.h>
 #include <nc/core/ir/calling/Conventions.h>
@@ -36,6 +41,7 @@
 #include <nc/core/ir/calling/Signatures.h>
 #include <nc/core/ir/cflow/Graphs.h>
 #include <nc/core/ir/dflow/Dataflows.h>
+#include <nc/core/ir/dflow/DefUseGraphs.h>
 #include <nc/core/ir/liveness/Livenesses.h>
 #include <nc/core/ir/types/Types.h>
 #include <nc/core/ir/vars/Variables.h>
@@ -66,6 +72,15 @@ void Context::setProgram(std::unique_ptr<ir::Program> program) {
 
 void Context::setFunctions(std::unique_ptr<ir::Functions> functions) {
     functions_ = std::move(functions);
+    budgetHits_.clear();
+    overBudgetFunctions_.clear();
+}
+
+void Context::removeCachedFunction(ir::Function *function) {
+    assert(function != nullptr);
+    assert(functions_ != nullptr);
+
+    cachedFunctions_.push_back(functions_->list().erase(function));
 }
 
 void Context::setConventions(std::unique_ptr<ir::calling::Conventions> conventions) {
@@ -84,6 +99,10 @@ void Context::setDataflows(std::unique_ptr<ir::dflow::Dataflows> dataflows) {
     dataflows_ = std::move(dataflows);
 }
 
+void Context::setDefUseGraphs(std::unique_ptr<ir::dflow::DefUseGraphs> defUseGraphs) {
+    defUseGraphs_ = std::move(defUseGraphs);
+}
+
 void Context::setVariables(std::unique_ptr<ir::vars::Variables> variables) {
     variables_ = std::move(variables);
 }
@@ -100,6 +119,18 @@ void Context::setTypes(std::unique_ptr<ir::types::Types> types) {
     types_ = std::move(types);
 }
 
+void Context::addBudgetHit(const ir::Function *function, const QString &description) {
+    assert(function != nullptr);
+
+    foreach (const auto &hit, budgetHits_) {
+        if (hit.first == function && hit.second == description) {
+            return;
+        }
+    }
+    budgetHits_.push_back(std::make_pair(function, description));
+    overBudgetFunctions_.insert(function);
+}
+
 void Context::setTree(std::unique_ptr<likec::Tree> tree) {
     tree_ = std::move(tree);
     Q_EMIT treeChanged();
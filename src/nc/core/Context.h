@@ -25,16 +25,28 @@
 
 #include <nc/config.h>
 
+#include <map>
 #include <memory> /* For std::unique_ptr. */
+#include <utility> /* For std::pair. */
+#include <vector>
 
+#include <QByteArray>
 #include <QObject>
+#include <QString>
 
+#include <boost/unordered_set.hpp>
+
+#include <nc/common/Budget.h>
 #include <nc/common/CancellationToken.h>
 #include <nc/common/LogToken.h>
+#include <nc/common/Types.h>
+#include <nc/core/FunctionCache.h>
 
 namespace nc {
 namespace core {
 
+class SignatureDatabase;
+
 namespace arch {
     class Instructions;
 }
@@ -58,6 +70,7 @@ namespace ir {
     }
     namespace dflow {
         class Dataflows;
+        class DefUseGraphs;
     }
     namespace types {
         class Types;
@@ -84,15 +97,25 @@ class Context: public QObject {
     std::shared_ptr<const arch::Instructions> instructions_; ///< Instructions being decompiled.
     std::unique_ptr<ir::Program> program_; ///< Program.
     std::unique_ptr<ir::Functions> functions_; ///< Functions.
+    std::vector<std::unique_ptr<ir::Function>> cachedFunctions_; ///< Functions removed from functions_, as their definitions were taken from the function cache.
     std::unique_ptr<ir::calling::Conventions> conventions_; ///< Assigned calling conventions.
     std::unique_ptr<ir::calling::Hooks> hooks_; ///< Hooks manager.
     std::unique_ptr<ir::calling::Signatures> signatures_; ///< Signatures.
     std::unique_ptr<ir::dflow::Dataflows> dataflows_; ///< Dataflows.
+    std::unique_ptr<ir::dflow::DefUseGraphs> defUseGraphs_; ///< Def-use graphs.
     std::unique_ptr<ir::vars::Variables> variables_; ///< Reconstructed variables.
     std::unique_ptr<ir::cflow::Graphs> graphs_; ///< Structured graphs.
     std::unique_ptr<ir::liveness::Livenesses> livenesses_; ///< Liveness information.
     std::unique_ptr<ir::types::Types> types_; ///< Information about types.
     std::unique_ptr<likec::Tree> tree_; ///< Abstract syntax tree of the LikeC program.
+    std::vector<ByteAddr> selectedFunctions_; ///< Entry addresses of the functions to generate definitions for.
+    std::shared_ptr<FunctionCache> functionCache_; ///< Cache of function analysis results.
+    std::map<ByteAddr, FunctionCache::Key> functionKeys_; ///< Function cache keys of the functions.
+    std::map<ByteAddr, FunctionCache::Entry> cachedDefinitions_; ///< Function cache entries with the definitions of functions.
+    std::shared_ptr<const SignatureDatabase> signatureDatabase_; ///< Signatures of well-known library functions.
+    Budget budget_; ///< Limits on the analysis of a single function.
+    std::vector<std::pair<const ir::Function *, QString>> budgetHits_; ///< Functions whose analysis exceeded the budget.
+    boost::unordered_set<const ir::Function *> overBudgetFunctions_; ///< Functions having budget hits.
     LogToken logToken_; ///< Log token.
     CancellationToken cancellationToken_; ///< Cancellation token.
 
@@ -223,6 +246,23 @@ public:
      */
     const ir::dflow::Dataflows *dataflows() const { return dataflows_.get(); }
 
+    /**
+     * Sets the def-use graphs of all functions.
+     *
+     * \param[in] defUseGraphs Pointer to the def-use graphs. Can be nullptr.
+     */
+    void setDefUseGraphs(std::unique_ptr<ir::dflow::DefUseGraphs> defUseGraphs);
+
+    /**
+     * \return Pointer to the def-use graphs of all functions. Can be nullptr.
+     */
+    ir::dflow::DefUseGraphs *defUseGraphs() { return defUseGraphs_.get(); }
+
+    /**
+     * \return Pointer to the def-use graphs of all functions. Can be nullptr.
+     */
+    const ir::dflow::DefUseGraphs *defUseGraphs() const { return defUseGraphs_.get(); }
+
     /**
      * Sets the information about reconstructed variables.
      *
@@ -293,6 +333,114 @@ public:
      */
     likec::Tree *tree() const { return tree_.get(); }
 
+    /**
+     * Sets the entry addresses of the functions to generate definitions for.
+     * When the vector is empty, definitions of all functions are generated.
+     *
+     * \param entries Entry addresses of the functions.
+     */
+    void setSelectedFunctions(std::vector<ByteAddr> entries) { selectedFunctions_ = std::move(entries); }
+
+    /**
+     * \return Entry addresses of the functions to generate definitions for.
+     *         Empty vector means all functions.
+     */
+    const std::vector<ByteAddr> &selectedFunctions() const { return selectedFunctions_; }
+
+    /**
+     * Sets the cache of function analysis results.
+     *
+     * \param cache Pointer to the cache. Can be nullptr.
+     */
+    void setFunctionCache(const std::shared_ptr<FunctionCache> &cache) { functionCache_ = cache; }
+
+    /**
+     * \return Pointer to the cache of function analysis results. Can be nullptr.
+     */
+    const std::shared_ptr<FunctionCache> &functionCache() const { return functionCache_; }
+
+    /**
+     * Sets the function cache keys of the functions.
+     *
+     * \param keys Mapping from entry addresses of functions to their keys.
+     */
+    void setFunctionKeys(std::map<ByteAddr, FunctionCache::Key> keys) { functionKeys_ = std::move(keys); }
+
+    /**
+     * \return Mapping from entry addresses of functions to their function cache keys.
+     */
+    const std::map<ByteAddr, FunctionCache::Key> &functionKeys() const { return functionKeys_; }
+
+    /**
+     * Sets the definitions of the functions taken from the function cache.
+     * These functions are not analyzed, their definitions are output verbatim,
+     * preceded by the declarations they depend on.
+     *
+     * \param definitions Mapping from entry addresses of functions to the cache
+     *                    entries with their definitions.
+     */
+    void setCachedDefinitions(std::map<ByteAddr, FunctionCache::Entry> definitions) { cachedDefinitions_ = std::move(definitions); }
+
+    /**
+     * \return Mapping from entry addresses of functions to the function cache
+     *         entries with their definitions.
+     */
+    const std::map<ByteAddr, FunctionCache::Entry> &cachedDefinitions() const { return cachedDefinitions_; }
+
+    /**
+     * Removes a function whose definition was taken from the function cache
+     * from the set of functions, so that it is not analyzed. The function
+     * is kept alive together with the context, as hooks and other parts of
+     * the context may still refer to it.
+     *
+     * \param function Valid pointer to a function from functions().
+     */
+    void removeCachedFunction(ir::Function *function);
+
+    /**
+     * Sets the database of signatures of well-known library functions.
+     *
+     * \param database Pointer to the database. Can be nullptr.
+     */
+    void setSignatureDatabase(const std::shared_ptr<const SignatureDatabase> &database) { signatureDatabase_ = database; }
+
+    /**
+     * \return Pointer to the database of signatures of well-known library functions. Can be nullptr.
+     */
+    const std::shared_ptr<const SignatureDatabase> &signatureDatabase() const { return signatureDatabase_; }
+
+    /**
+     * Sets the limits on the analysis of a single function.
+     *
+     * \param budget Budget with the limits.
+     */
+    void setBudget(const Budget &budget) { budget_ = budget; }
+
+    /**
+     * \return Limits on the analysis of a single function.
+     */
+    const Budget &budget() const { return budget_; }
+
+    /**
+     * Remembers that an analysis of a function exceeded the budget
+     * and was done only partially.
+     *
+     * \param function Valid pointer to the function.
+     * \param description Description of the analysis and of the exceeded limit.
+     */
+    void addBudgetHit(const ir::Function *function, const QString &description);
+
+    /**
+     * \return Functions whose analysis exceeded the budget, with the descriptions
+     *         of the analyses and of the exceeded limits, in the order of occurrence.
+     */
+    const std::vector<std::pair<const ir::Function *, QString>> &budgetHits() const { return budgetHits_; }
+
+    /**
+     * \return Functions whose analysis exceeded the budget at least once.
+     */
+    const boost::unordered_set<const ir::Function *> &overBudgetFunctions() const { return overBudgetFunctions_; }
+
     /**
      * Sets cancellation token.
      *
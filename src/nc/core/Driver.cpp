@@ -17,6 +17,7 @@
 #include <nc/core/input/ParserRepository.h>
 #include <nc/core/ir/Function.h>
 #include <nc/core/ir/Functions.h>
+#include <nc/core/irgen/Slicer.h>
 
 #include "Context.h"
 #include "MasterAnalyzer.h"
@@ -31,13 +32,19 @@ void Driver::parse(Context &context, const QString &filename) {
         throw nc::Exception(tr("Could not open file \"%1\" for reading.").arg(filename));
     }
 
-    context.logToken().info(tr("Choosing a parser for %1...").arg(filename));
+    parse(context, &source, filename);
+}
+
+void Driver::parse(Context &context, QIODevice *source, const QString &name) {
+    assert(source != nullptr);
+
+    context.logToken().info(tr("Choosing a parser for %1...").arg(name));
 
     const input::Parser *suitableParser = nullptr;
 
     foreach(const input::Parser *parser, input::ParserRepository::instance()->parsers()) {
         context.logToken().info(tr("Trying %1 parser...").arg(parser->name()));
-        if (parser->canParse(&source)) {
+        if (parser->canParse(source)) {
             suitableParser = parser;
             break;
         }
@@ -45,12 +52,12 @@ void Driver::parse(Context &context, const QString &filename) {
 
     if (!suitableParser) {
         context.logToken().error(tr("No suitable parser found."));
-        throw nc::Exception(tr("File %1 has unknown format.").arg(filename));
+        throw nc::Exception(tr("File %1 has unknown format.").arg(name));
     }
 
     context.logToken().info(tr("Parsing using %1 parser...").arg(suitableParser->name()));
 
-    suitableParser->parse(&source, context.image().get(), context.logToken());
+    suitableParser->parse(source, context.image().get(), context.logToken());
 
     context.logToken().info(tr("Parsing completed."));
 }
@@ -97,6 +104,23 @@ void Driver::disassemble(Context &context, const image::ByteSource *source, Byte
     }
 }
 
+void Driver::disassemble(Context &context, const std::vector<ByteAddr> &entries, int depth) {
+    context.logToken().info(tr("Disassemble %1 functions and their callees up to depth %2...").arg(entries.size()).arg(depth));
+
+    try {
+        auto newInstructions = std::make_shared<arch::Instructions>(*context.instructions());
+
+        irgen::Slicer(context.image().get(), context.cancellationToken(), context.logToken())
+            .slice(entries, depth, *newInstructions);
+
+        context.setInstructions(newInstructions);
+
+        context.logToken().info(tr("Disassembly completed."));
+    } catch (const CancellationException &) {
+        context.logToken().info(tr("Disassembly canceled."));
+    }
+}
+
 void Driver::decompile(Context &context) {
     try {
         context.image()->platform().architecture()->masterAnalyzer()->decompile(context);
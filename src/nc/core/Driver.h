@@ -5,10 +5,16 @@
 
 #include <nc/config.h>
 
+#include <vector>
+
 #include <nc/common/Types.h>
 
 #include <QCoreApplication> /* For Q_DECLARE_TR_FUNCTIONS. */
 
+QT_BEGIN_NAMESPACE
+class QIODevice;
+QT_END_NAMESPACE
+
 namespace nc {
 namespace core {
 
@@ -34,6 +40,15 @@ public:
      */
     static void parse(Context &context, const QString &filename);
 
+    /**
+     * Parses the contents of an I/O device by the first suitable parser.
+     *
+     * \param context Context.
+     * \param source Valid pointer to an I/O device opened for reading.
+     * \param name Name of the input shown in messages.
+     */
+    static void parse(Context &context, QIODevice *source, const QString &name);
+
     /**
      * Disassembles all code sections.
      *
@@ -59,6 +74,17 @@ public:
      */
     static void disassemble(Context &context, const image::ByteSource *source, ByteAddr begin, ByteAddr end);
 
+    /**
+     * Disassembles the functions starting at given addresses and, transitively,
+     * the functions called from them up to the given call depth.
+     *
+     * \param context Context.
+     * \param entries Entry addresses of the functions.
+     * \param depth Maximal call depth: 0 means only the given functions,
+     *              1 means the given functions and their direct callees, etc.
+     */
+    static void disassemble(Context &context, const std::vector<ByteAddr> &entries, int depth);
+
     /**
      * Performs decompilation by running all the necessary
      * analyses in the given context in the right order.
@@ -0,0 +1,718 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "FunctionCache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring> /* memcmp, memset */
+#include <set>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+
+#include <nc/common/Exception.h>
+#include <nc/common/Foreach.h>
+#include <nc/common/Range.h>
+
+#include <nc/core/arch/Architecture.h>
+#include <nc/core/arch/Disassembler.h>
+#include <nc/core/arch/Instruction.h>
+#include <nc/core/image/Image.h>
+#include <nc/core/image/Relocation.h>
+#include <nc/core/image/Symbol.h>
+#include <nc/core/ir/BasicBlock.h>
+#include <nc/core/ir/Function.h>
+#include <nc/core/ir/Functions.h>
+#include <nc/core/ir/cgen/NameGenerator.h>
+
+namespace nc {
+namespace core {
+
+namespace {
+
+/** Length of a key in hexadecimal notation. */
+const int KEY_HEX_LENGTH = 40;
+
+/**
+ * Distance by which instructions are moved to find out which of their
+ * operands are decoded relative to their address.
+ */
+const ByteAddr PC_SHIFT = 0x10000;
+
+/**
+ * Replaces the bytes patched by relocations with zeroes.
+ *
+ * \param image Executable image.
+ * \param addr Address of the first byte.
+ * \param bytes Bytes starting at the given address.
+ */
+void maskRelocations(const image::Image &image, ByteAddr addr, QByteArray &bytes) {
+    for (int i = 0; i < bytes.size(); ++i) {
+        if (auto relocation = image.getRelocation(addr + i)) {
+            auto size = std::min(static_cast<int>(relocation->size()), bytes.size() - i);
+            memset(bytes.data() + i, 0, size);
+        }
+    }
+}
+
+inline bool isWordChar(QChar c) {
+    return c.isLetterOrNumber() || c == QLatin1Char('_');
+}
+
+/**
+ * Splits the text of an instruction into words and punctuation, dropping whitespace.
+ *
+ * \param instruction Valid pointer to the instruction.
+ *
+ * \return The tokens.
+ */
+QStringList tokenize(const arch::Instruction *instruction) {
+    assert(instruction != nullptr);
+
+    QString text = instruction->toString();
+    QStringList result;
+
+    for (int i = 0; i < text.size();) {
+        if (isWordChar(text[i])) {
+            int j = i + 1;
+            while (j < text.size() && isWordChar(text[j])) {
+                ++j;
+            }
+            result.append(text.mid(i, j - i));
+            i = j;
+        } else {
+            if (!text[i].isSpace()) {
+                result.append(text[i]);
+            }
+            ++i;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * \param token Token of an instruction's text.
+ *
+ * \return The address written in the token, if it is a number.
+ */
+boost::optional<ByteAddr> parseAddress(const QString &token) {
+    bool ok;
+    qulonglong value;
+
+    if (token.startsWith(QLatin1String("0x"), Qt::CaseInsensitive)) {
+        value = token.mid(2).toULongLong(&ok, 16);
+    } else {
+        value = token.toULongLong(&ok, 10);
+        if (!ok) {
+            value = token.toULongLong(&ok, 16);
+        }
+    }
+
+    if (!ok) {
+        return boost::none;
+    }
+    return static_cast<ByteAddr>(value);
+}
+
+/**
+ * \param word Identifier.
+ *
+ * \return The address of the basic block, if the identifier is a label
+ *         named after it, as the ones DefinitionGenerator makes.
+ */
+boost::optional<ByteAddr> parseLabelAddress(const QString &word) {
+    auto parts = word.split(QLatin1Char('_'));
+    if (parts.size() != 3 || parts[0] != QLatin1String("addr")) {
+        return boost::none;
+    }
+
+    bool ok;
+    parts[2].toULongLong(&ok);
+    if (!ok) {
+        return boost::none;
+    }
+
+    auto addr = parts[1].toLongLong(&ok, 16);
+    if (!ok) {
+        return boost::none;
+    }
+    return addr;
+}
+
+/**
+ * Adds the instructions of a basic block to the hash of a function.
+ *
+ * Each instruction is decoded at its address and at an address moved by
+ * PC_SHIFT, and, if it is patched by relocations, from the bytes with the
+ * relocations masked out. The words of its text that come out different
+ * are addresses depending on where the code is located: targets inside
+ * the function are hashed as offsets from its entry, others are replaced
+ * by a placeholder and appended to the references. The remaining words
+ * are hashed as they are.
+ *
+ * Operands that are printed as displacements from the program counter
+ * (e.g. [rip+0x10] on x86-64) do not change when the code is moved and
+ * are hashed as they are: the key then depends on the layout, but
+ * functions with different layouts never share one.
+ *
+ * \param disassembler Disassembler.
+ * \param image Executable image.
+ * \param entry Entry address of the function.
+ * \param basicBlockAddresses Sorted addresses of the function's basic blocks.
+ * \param addr Address of the basic block.
+ * \param bytes Bytes of the basic block.
+ * \param hash Hash of the function.
+ * \param references Addresses outside the function the instructions refer to.
+ */
+void hashInstructions(arch::Disassembler &disassembler, const image::Image &image, ByteAddr entry,
+    const std::vector<ByteAddr> &basicBlockAddresses, ByteAddr addr, const QByteArray &bytes,
+    QCryptographicHash &hash, std::vector<ByteAddr> &references)
+{
+    QByteArray maskedBytes = bytes;
+    maskRelocations(image, addr, maskedBytes);
+
+    for (int offset = 0; offset < bytes.size();) {
+        auto instruction = disassembler.disassembleSingleInstruction(addr + offset, bytes.constData() + offset, bytes.size() - offset);
+        if (!instruction || instruction->size() <= 0) {
+            hash.addData("B");
+            hash.addData(maskedBytes.mid(offset));
+            break;
+        }
+
+        int size = static_cast<int>(instruction->size());
+
+        auto tokens = tokenize(instruction.get());
+
+        QStringList shiftedTokens;
+        if (auto shifted = disassembler.disassembleSingleInstruction(addr + offset + PC_SHIFT, bytes.constData() + offset, size)) {
+            shiftedTokens = tokenize(shifted.get());
+        }
+
+        QStringList maskedTokens = tokens;
+        if (memcmp(bytes.constData() + offset, maskedBytes.constData() + offset, size) != 0) {
+            maskedTokens.clear();
+            if (auto masked = disassembler.disassembleSingleInstruction(addr + offset, maskedBytes.constData() + offset, size)) {
+                maskedTokens = tokenize(masked.get());
+            }
+        }
+
+        if (shiftedTokens.size() != tokens.size() || maskedTokens.size() != tokens.size()) {
+            /* The operands cannot be matched: the bytes are hashed as they are. */
+            hash.addData("B");
+            hash.addData(maskedBytes.mid(offset, size));
+        } else {
+            hash.addData("I");
+            for (int i = 0; i < tokens.size(); ++i) {
+                if (tokens[i] == shiftedTokens[i] && tokens[i] == maskedTokens[i]) {
+                    hash.addData(tokens[i].toUtf8());
+                } else if (auto target = parseAddress(tokens[i])) {
+                    if (std::binary_search(basicBlockAddresses.begin(), basicBlockAddresses.end(), *target)) {
+                        hash.addData("L");
+                        hash.addData(QByteArray::number(static_cast<qlonglong>(*target - entry)));
+                    } else {
+                        hash.addData("X");
+                        references.push_back(*target);
+                    }
+                } else {
+                    hash.addData("?");
+                }
+                hash.addData(" ");
+            }
+        }
+        hash.addData(";");
+
+        offset += size;
+    }
+}
+
+/**
+ * Combines the hashes of the functions' own code with the keys of the
+ * functions they refer to. Strongly connected components of the reference
+ * graph are found by Tarjan's algorithm, which finishes the components
+ * referred to before the components referring to them. Functions of a
+ * component refer to each other by the hashes of their own code and all
+ * include the hash of the whole component.
+ */
+class KeyCombiner {
+    const image::Image &image_; ///< Executable image.
+    const std::map<ByteAddr, QByteArray> &entry2hash_; ///< Hashes of the functions' own code.
+    std::map<ByteAddr, FunctionCache::Key> &keys_; ///< Keys with the references filled in.
+
+    std::map<ByteAddr, std::size_t> entry2index_; ///< Order in which the functions were visited.
+    std::map<ByteAddr, std::size_t> entry2lowlink_; ///< Smallest index reachable from a function.
+    std::vector<ByteAddr> stack_; ///< Visited functions not yet assigned to a component.
+    std::set<ByteAddr> onStack_; ///< Functions in stack_.
+
+public:
+    KeyCombiner(const image::Image &image, const std::map<ByteAddr, QByteArray> &entry2hash,
+                std::map<ByteAddr, FunctionCache::Key> &keys):
+        image_(image), entry2hash_(entry2hash), keys_(keys)
+    {}
+
+    /**
+     * Computes the hashes of all the keys.
+     */
+    void combine() {
+        foreach (const auto &entryAndHash, entry2hash_) {
+            if (!entry2index_.count(entryAndHash.first)) {
+                visit(entryAndHash.first);
+            }
+        }
+    }
+
+private:
+    void visit(ByteAddr entry) {
+        std::size_t index = entry2index_.size();
+        entry2index_[entry] = index;
+        entry2lowlink_[entry] = index;
+        stack_.push_back(entry);
+        onStack_.insert(entry);
+
+        foreach (ByteAddr reference, keys_[entry].references) {
+            if (!entry2hash_.count(reference)) {
+                continue;
+            }
+            if (!entry2index_.count(reference)) {
+                visit(reference);
+                entry2lowlink_[entry] = std::min(entry2lowlink_[entry], entry2lowlink_[reference]);
+            } else if (onStack_.count(reference)) {
+                entry2lowlink_[entry] = std::min(entry2lowlink_[entry], entry2index_[reference]);
+            }
+        }
+
+        if (entry2lowlink_[entry] == index) {
+            auto position = std::find(stack_.begin(), stack_.end(), entry);
+            std::vector<ByteAddr> component(position, stack_.end());
+            stack_.erase(position, stack_.end());
+
+            foreach (ByteAddr member, component) {
+                onStack_.erase(member);
+            }
+
+            finish(component);
+        }
+    }
+
+    void finish(const std::vector<ByteAddr> &component) {
+        bool recursive = component.size() > 1 || nc::contains(keys_[component.front()].references, component.front());
+
+        QByteArray componentHash;
+        if (recursive) {
+            /* Sorting makes the hash independent of the order of visiting. */
+            std::vector<QByteArray> memberHashes;
+            foreach (ByteAddr entry, component) {
+                QCryptographicHash hash(QCryptographicHash::Sha1);
+                addContents(hash, entry, component);
+                memberHashes.push_back(hash.result());
+            }
+            std::sort(memberHashes.begin(), memberHashes.end());
+
+            QCryptographicHash hash(QCryptographicHash::Sha1);
+            foreach (const QByteArray &memberHash, memberHashes) {
+                hash.addData(memberHash);
+            }
+            componentHash = hash.result();
+        }
+
+        foreach (ByteAddr entry, component) {
+            QCryptographicHash hash(QCryptographicHash::Sha1);
+            addContents(hash, entry, component);
+            if (recursive) {
+                hash.addData("C");
+                hash.addData(componentHash);
+            }
+            keys_[entry].hash = hash.result();
+        }
+    }
+
+    /**
+     * Adds the hash of a function's own code and the contributions of
+     * the addresses it refers to.
+     *
+     * \param hash Hash.
+     * \param entry Entry address of the function.
+     * \param component Component of the function.
+     */
+    void addContents(QCryptographicHash &hash, ByteAddr entry, const std::vector<ByteAddr> &component) {
+        hash.addData(nc::find(entry2hash_, entry));
+
+        foreach (ByteAddr reference, keys_[entry].references) {
+            if (entry2hash_.count(reference)) {
+                if (nc::contains(component, reference)) {
+                    hash.addData("R");
+                    hash.addData(nc::find(entry2hash_, reference));
+                } else {
+                    hash.addData("F");
+                    hash.addData(keys_[reference].hash);
+                }
+            } else if (auto relocation = image_.getRelocation(reference)) {
+                hash.addData("S");
+                hash.addData(relocation->symbol()->name().toUtf8());
+            } else if (auto symbol = image_.getSymbol(reference)) {
+                hash.addData("S");
+                hash.addData(symbol->name().toUtf8());
+            } else {
+                hash.addData("?");
+            }
+        }
+    }
+};
+
+} // anonymous namespace
+
+FunctionCache::FunctionCache(const QString &directory, std::size_t capacity):
+    directory_(directory), capacity_(capacity), hits_(0), misses_(0), stores_(0), evictions_(0)
+{
+    if (!QDir().mkpath(directory_)) {
+        throw nc::Exception(tr("Could not create directory \"%1\".").arg(directory_));
+    }
+
+    QFile index(getIndexFileName());
+    if (index.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        while (!index.atEnd()) {
+            auto key = QByteArray::fromHex(index.readLine().trimmed());
+            if (!key.isEmpty() && !key2position_.count(key) && QFile::exists(getEntryFileName(key))) {
+                key2position_[key] = keys_.insert(keys_.end(), key);
+            }
+        }
+    }
+
+    /* Entries missing in the index, e.g. written by a process that did not save it, are the oldest. */
+    foreach (const QString &filename, QDir(directory_).entryList(QDir::Files)) {
+        if (filename.size() == KEY_HEX_LENGTH) {
+            auto key = QByteArray::fromHex(filename.toLatin1());
+            if (!key2position_.count(key)) {
+                key2position_[key] = keys_.insert(keys_.begin(), key);
+            }
+        }
+    }
+
+    while (keys_.size() > capacity_) {
+        remove(keys_.front());
+        ++evictions_;
+    }
+}
+
+FunctionCache::~FunctionCache() {
+    flush();
+}
+
+std::map<ByteAddr, FunctionCache::Key> FunctionCache::computeKeys(const image::Image &image, const ir::Functions &functions) {
+    std::map<ByteAddr, Key> result;
+
+    auto architecture = image.platform().architecture();
+    if (!architecture) {
+        return result;
+    }
+
+    auto disassembler = architecture->createDisassembler();
+
+    /* Hashes of the functions' own code. */
+    std::map<ByteAddr, QByteArray> entry2hash;
+
+    foreach (const ir::Function *function, functions.list()) {
+        if (!function->entry() || !function->entry()->address()) {
+            continue;
+        }
+
+        ByteAddr entry = *function->entry()->address();
+
+        std::vector<const ir::BasicBlock *> basicBlocks;
+        foreach (const ir::BasicBlock *basicBlock, function->basicBlocks()) {
+            if (basicBlock->address() && basicBlock->successorAddress()) {
+                basicBlocks.push_back(basicBlock);
+            }
+        }
+
+        std::sort(basicBlocks.begin(), basicBlocks.end(), [](const ir::BasicBlock *a, const ir::BasicBlock *b) {
+            return *a->address() < *b->address();
+        });
+
+        std::vector<ByteAddr> basicBlockAddresses;
+        basicBlockAddresses.reserve(basicBlocks.size());
+        foreach (const ir::BasicBlock *basicBlock, basicBlocks) {
+            basicBlockAddresses.push_back(*basicBlock->address());
+        }
+
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(architecture->name().toUtf8());
+
+        auto &references = result[entry].references;
+
+        foreach (const ir::BasicBlock *basicBlock, basicBlocks) {
+            ByteAddr begin = *basicBlock->address();
+            ByteAddr end = *basicBlock->successorAddress();
+
+            QByteArray bytes(static_cast<int>(end - begin), '\0');
+            bytes.resize(static_cast<int>(image.readBytes(begin, bytes.data(), bytes.size())));
+
+            /* Offsets relative to the entry keep the key independent of the function's address. */
+            hash.addData(QByteArray::number(static_cast<qlonglong>(begin - entry)));
+            hash.addData(":");
+            hash.addData(QByteArray::number(bytes.size()));
+            hash.addData(":");
+
+            hashInstructions(*disassembler, image, entry, basicBlockAddresses, begin, bytes, hash, references);
+        }
+
+        entry2hash[entry] = hash.result();
+    }
+
+    KeyCombiner(image, entry2hash, result).combine();
+
+    return result;
+}
+
+QString FunctionCache::makePattern(const QString &text, ByteAddr entry, const Key &key,
+                                   const ir::cgen::NameGenerator &nameGenerator)
+{
+    /* Names depending on the addresses, mapped to their placeholders. */
+    std::map<QString, QString> name2placeholder;
+    name2placeholder[nameGenerator.getFunctionName(entry).name()] = QLatin1String("$F;");
+
+    for (std::size_t i = 0; i < key.references.size(); ++i) {
+        name2placeholder.insert(std::make_pair(
+            nameGenerator.getFunctionName(key.references[i]).name(), QString("$f%1;").arg(i)));
+        name2placeholder.insert(std::make_pair(
+            nameGenerator.getGlobalVariableName(key.references[i]).name(), QString("$g%1;").arg(i)));
+    }
+
+    QString result;
+
+    for (int i = 0; i < text.size();) {
+        if (isWordChar(text[i])) {
+            int j = i + 1;
+            while (j < text.size() && isWordChar(text[j])) {
+                ++j;
+            }
+
+            QString word = text.mid(i, j - i);
+            auto placeholder = name2placeholder.find(word);
+
+            if (placeholder != name2placeholder.end()) {
+                result += placeholder->second;
+            } else if (auto addr = parseLabelAddress(word)) {
+                result += QString("addr_$a%1;_%2").arg(static_cast<qlonglong>(*addr - entry)).arg(word.section(QLatin1Char('_'), 2));
+            } else {
+                result += word;
+            }
+
+            i = j;
+        } else {
+            if (text[i] == QLatin1Char('$')) {
+                result += QLatin1Char('$');
+            }
+            result += text[i];
+            ++i;
+        }
+    }
+
+    /* Any other mention of the addresses would be wrong at another address. */
+    QString hexEntry = QString::number(entry, 16);
+    if (result.contains(hexEntry, Qt::CaseInsensitive)) {
+        return QString();
+    }
+    foreach (ByteAddr reference, key.references) {
+        if (result.contains(QString::number(reference, 16), Qt::CaseInsensitive)) {
+            return QString();
+        }
+    }
+
+    return result;
+}
+
+QString FunctionCache::instantiatePattern(const QString &pattern, ByteAddr entry, const Key &key,
+                                          const ir::cgen::NameGenerator &nameGenerator)
+{
+    QString result;
+
+    for (int i = 0; i < pattern.size(); ++i) {
+        if (pattern[i] != QLatin1Char('$')) {
+            result += pattern[i];
+            continue;
+        }
+
+        if (++i == pattern.size()) {
+            return QString();
+        }
+
+        QChar kind = pattern[i];
+        if (kind == QLatin1Char('$')) {
+            result += kind;
+            continue;
+        }
+
+        int end = pattern.indexOf(QLatin1Char(';'), i + 1);
+        if (end < 0) {
+            return QString();
+        }
+
+        QString argument = pattern.mid(i + 1, end - i - 1);
+        i = end;
+
+        bool ok = true;
+
+        if (kind == QLatin1Char('F') && argument.isEmpty()) {
+            result += nameGenerator.getFunctionName(entry).name();
+        } else if (kind == QLatin1Char('f') || kind == QLatin1Char('g')) {
+            auto index = argument.toULongLong(&ok);
+            if (!ok || index >= key.references.size()) {
+                return QString();
+            }
+            if (kind == QLatin1Char('f')) {
+                result += nameGenerator.getFunctionName(key.references[index]).name();
+            } else {
+                result += nameGenerator.getGlobalVariableName(key.references[index]).name();
+            }
+        } else if (kind == QLatin1Char('a')) {
+            auto offset = argument.toLongLong(&ok);
+            if (!ok) {
+                return QString();
+            }
+            result += QString::number(entry + offset, 16);
+        } else {
+            return QString();
+        }
+    }
+
+    return result;
+}
+
+boost::optional<FunctionCache::Entry> FunctionCache::lookup(const QByteArray &key) {
+    QMutexLocker locker(&mutex_);
+
+    if (!key2position_.count(key)) {
+        ++misses_;
+        return boost::none;
+    }
+
+    QFile file(getEntryFileName(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        remove(key);
+        ++misses_;
+        return boost::none;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_4_8);
+
+    quint32 version;
+    in >> version;
+
+    Entry entry;
+    quint32 argumentCount = 0;
+    quint32 declarationCount = 0;
+
+    if (version == FORMAT_VERSION) {
+        in >> argumentCount;
+        for (quint32 i = 0; i < argumentCount && in.status() == QDataStream::Ok; ++i) {
+            ir::MemoryLocation argument;
+            in >> argument;
+            entry.arguments.push_back(argument);
+        }
+        in >> entry.returnValue >> entry.variadic >> entry.definition;
+
+        in >> declarationCount;
+        for (quint32 i = 0; i < declarationCount && in.status() == QDataStream::Ok; ++i) {
+            std::pair<QString, QString> declaration;
+            in >> declaration.first >> declaration.second;
+            entry.declarations.push_back(std::move(declaration));
+        }
+    }
+
+    if (version != FORMAT_VERSION || in.status() != QDataStream::Ok) {
+        file.close();
+        remove(key);
+        ++misses_;
+        return boost::none;
+    }
+
+    touch(key);
+    ++hits_;
+
+    return entry;
+}
+
+void FunctionCache::store(const QByteArray &key, const Entry &entry) {
+    QMutexLocker locker(&mutex_);
+
+    QFile file(getEntryFileName(key));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_8);
+
+    out << FORMAT_VERSION << static_cast<quint32>(entry.arguments.size());
+    foreach (const auto &argument, entry.arguments) {
+        out << argument;
+    }
+    out << entry.returnValue << entry.variadic << entry.definition;
+
+    out << static_cast<quint32>(entry.declarations.size());
+    foreach (const auto &declaration, entry.declarations) {
+        out << declaration.first << declaration.second;
+    }
+
+    touch(key);
+    ++stores_;
+
+    while (keys_.size() > capacity_) {
+        remove(keys_.front());
+        ++evictions_;
+    }
+}
+
+void FunctionCache::flush() {
+    QMutexLocker locker(&mutex_);
+    doFlush();
+}
+
+QString FunctionCache::getEntryFileName(const QByteArray &key) const {
+    return QDir(directory_).filePath(QString::fromLatin1(key.toHex()));
+}
+
+QString FunctionCache::getIndexFileName() const {
+    return QDir(directory_).filePath(QLatin1String("index"));
+}
+
+void FunctionCache::touch(const QByteArray &key) {
+    auto i = key2position_.find(key);
+    if (i != key2position_.end()) {
+        keys_.splice(keys_.end(), keys_, i->second);
+    } else {
+        key2position_[key] = keys_.insert(keys_.end(), key);
+    }
+}
+
+void FunctionCache::remove(const QByteArray &key) {
+    auto i = key2position_.find(key);
+    if (i != key2position_.end()) {
+        keys_.erase(i->second);
+        key2position_.erase(i);
+    }
+    QFile::remove(getEntryFileName(key));
+}
+
+void FunctionCache::doFlush() {
+    QFile index(getIndexFileName());
+    if (!index.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return;
+    }
+
+    foreach (const QByteArray &key, keys_) {
+        index.write(key.toHex());
+        index.write("\n");
+    }
+}
+
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
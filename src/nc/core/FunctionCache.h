@@ -0,0 +1,253 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <utility> /* For std::pair. */
+#include <vector>
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QMutex>
+#include <QString>
+
+#include <boost/optional.hpp>
+
+#include <nc/common/Types.h>
+#include <nc/core/ir/MemoryLocation.h>
+
+namespace nc {
+namespace core {
+
+namespace image {
+    class Image;
+}
+
+namespace ir {
+    class Functions;
+
+    namespace cgen {
+        class NameGenerator;
+    }
+}
+
+/**
+ * On-disk cache of function analysis results, shared between decompilations
+ * of different executables.
+ *
+ * Functions are identified by a content-based key: the hash of the
+ * architecture and the function's instructions, decoded so that branch
+ * targets inside the function become offsets from its entry and the other
+ * addresses that depend on where the code is located (PC-relative operands,
+ * operands patched by relocations) are abstracted away. Each abstracted
+ * address contributes the key of the function at that address, computed
+ * recursively, or the name of the symbol there. A cache entry holds the
+ * reconstructed signature of the function and, optionally, its generated
+ * definition, with the names depending on the addresses replaced by
+ * placeholders, so that it can be reused at another address.
+ *
+ * The cache is a directory with one file per entry and an index file keeping
+ * the order of use. When the number of entries exceeds the capacity, least
+ * recently used entries are evicted.
+ *
+ * The class is thread-safe.
+ */
+class FunctionCache {
+    Q_DECLARE_TR_FUNCTIONS(FunctionCache)
+
+public:
+    /**
+     * Cache key of a function.
+     */
+    class Key {
+    public:
+        QByteArray hash; ///< Hash identifying the function.
+
+        /**
+         * Addresses outside the function its instructions refer to, in the
+         * order they are abstracted away in the hash.
+         */
+        std::vector<ByteAddr> references;
+    };
+
+    /**
+     * Cached results of the analysis of a function.
+     */
+    class Entry {
+    public:
+        std::vector<ir::MemoryLocation> arguments; ///< Memory locations of the arguments.
+        ir::MemoryLocation returnValue; ///< Memory location of the return value.
+        bool variadic; ///< True if the function is variadic.
+        QString definition; ///< Generated definition of the function, as a pattern. Can be empty.
+
+        /**
+         * Declarations the definition depends on, as pairs of identifiers and texts:
+         * prototypes of the called functions and declarations of the global variables.
+         * Both are patterns.
+         */
+        std::vector<std::pair<QString, QString>> declarations;
+
+        Entry(): variadic(false) {}
+    };
+
+    /**
+     * Version of the format of the entries. Entries with other versions are ignored.
+     */
+    static const quint32 FORMAT_VERSION = 3;
+
+private:
+    QString directory_; ///< Directory with the cache files.
+    std::size_t capacity_; ///< Maximal number of entries.
+    mutable QMutex mutex_; ///< Mutex protecting all the fields below.
+    std::list<QByteArray> keys_; ///< Keys of all entries, least recently used first.
+    std::map<QByteArray, std::list<QByteArray>::iterator> key2position_; ///< Mapping from a key to its position in keys_.
+    std::size_t hits_; ///< Number of successful lookups.
+    std::size_t misses_; ///< Number of failed lookups.
+    std::size_t stores_; ///< Number of stored entries.
+    std::size_t evictions_; ///< Number of evicted entries.
+
+public:
+    /**
+     * Opens a cache, creating the directory if it does not exist.
+     *
+     * \param directory Directory with the cache files.
+     * \param capacity Maximal number of entries.
+     *
+     * \throws nc::Exception If the directory could not be created.
+     */
+    FunctionCache(const QString &directory, std::size_t capacity = 10000);
+
+    /**
+     * Destructor. Saves the index.
+     */
+    ~FunctionCache();
+
+    /**
+     * Computes the cache keys of the given functions.
+     *
+     * \param image Executable image.
+     * \param functions Functions.
+     *
+     * \return Mapping from the entry addresses of the functions to their keys.
+     *         Functions without an entry address get no key.
+     */
+    static std::map<ByteAddr, Key> computeKeys(const image::Image &image, const ir::Functions &functions);
+
+    /**
+     * Replaces the names and the addresses in a text generated for a function
+     * that depend on where the function and the code and data it refers to
+     * are located with placeholders.
+     *
+     * \param text Text: the definition of the function or a declaration it depends on.
+     * \param entry Entry address of the function.
+     * \param key Key of the function.
+     * \param nameGenerator Name generator the text was generated with.
+     *
+     * \return The pattern, or a null string if the text depends on the addresses
+     *         in a way the placeholders cannot express.
+     */
+    static QString makePattern(const QString &text, ByteAddr entry, const Key &key,
+                               const ir::cgen::NameGenerator &nameGenerator);
+
+    /**
+     * Substitutes the placeholders in a pattern made by makePattern().
+     *
+     * \param pattern Pattern.
+     * \param entry Entry address of the function.
+     * \param key Key of the function, equal to the one the pattern was made with.
+     * \param nameGenerator Name generator.
+     *
+     * \return The text, or a null string if the pattern is malformed.
+     */
+    static QString instantiatePattern(const QString &pattern, ByteAddr entry, const Key &key,
+                                      const ir::cgen::NameGenerator &nameGenerator);
+
+    /**
+     * Looks up an entry in the cache.
+     *
+     * \param key Key.
+     *
+     * \return The entry, if found.
+     */
+    boost::optional<Entry> lookup(const QByteArray &key);
+
+    /**
+     * Stores an entry in the cache, replacing the existing one.
+     *
+     * \param key Key.
+     * \param entry Entry to store.
+     */
+    void store(const QByteArray &key, const Entry &entry);
+
+    /**
+     * Saves the index of the cache.
+     */
+    void flush();
+
+    /**
+     * \return Number of successful lookups.
+     */
+    std::size_t hits() const { QMutexLocker locker(&mutex_); return hits_; }
+
+    /**
+     * \return Number of failed lookups.
+     */
+    std::size_t misses() const { QMutexLocker locker(&mutex_); return misses_; }
+
+    /**
+     * \return Number of stored entries.
+     */
+    std::size_t stores() const { QMutexLocker locker(&mutex_); return stores_; }
+
+    /**
+     * \return Number of evicted entries.
+     */
+    std::size_t evictions() const { QMutexLocker locker(&mutex_); return evictions_; }
+
+    /**
+     * \return Current number of entries.
+     */
+    std::size_t size() const { QMutexLocker locker(&mutex_); return keys_.size(); }
+
+private:
+    /**
+     * \param key Key.
+     *
+     * \return Name of the file storing the entry with the given key.
+     */
+    QString getEntryFileName(const QByteArray &key) const;
+
+    /**
+     * \return Name of the index file.
+     */
+    QString getIndexFileName() const;
+
+    /**
+     * Marks the key as the most recently used one.
+     *
+     * \param key Key.
+     */
+    void touch(const QByteArray &key);
+
+    /**
+     * Forgets the entry with the given key and deletes its file.
+     *
+     * \param key Key.
+     */
+    void remove(const QByteArray &key);
+
+    /**
+     * Writes the index file. The mutex must be locked.
+     */
+    void doFlush();
+};
+
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -24,18 +24,40 @@
 
 #include "MasterAnalyzer.h"
 
+#include <cassert>
+#include <functional>
+#include <set>
+
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include <boost/optional.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
 #include <nc/common/Foreach.h>
+#include <nc/common/Range.h>
 #include <nc/common/make_unique.h>
 
 #include <nc/core/Context.h>
+#include <nc/core/FunctionCache.h>
+#include <nc/core/SignatureDatabase.h>
 #include <nc/core/arch/Architecture.h>
+#include <nc/core/arch/Instruction.h>
 #include <nc/core/image/Image.h>
+#include <nc/core/image/Relocation.h>
+#include <nc/core/image/Symbol.h>
 #include <nc/core/ir/BasicBlock.h>
 #include <nc/core/ir/CFG.h>
 #include <nc/core/ir/Function.h>
 #include <nc/core/ir/Functions.h>
 #include <nc/core/ir/FunctionsGenerator.h>
+#include <nc/core/ir/Jump.h>
 #include <nc/core/ir/Program.h>
+#include <nc/core/ir/Statements.h>
+#include <nc/core/ir/Terms.h>
+#include <nc/core/ir/calling/ArgumentFactory.h>
+#include <nc/core/ir/calling/Convention.h>
 #include <nc/core/ir/calling/Conventions.h>
 #include <nc/core/ir/calling/Hooks.h>
 #include <nc/core/ir/calling/SignatureAnalyzer.h>
@@ -47,19 +69,242 @@
 #include <nc/core/ir/cgen/NameGenerator.h>
 #include <nc/core/ir/dflow/Dataflows.h>
 #include <nc/core/ir/dflow/DataflowAnalyzer.h>
+#include <nc/core/ir/dflow/DefUseGraphs.h>
 #include <nc/core/ir/liveness/Livenesses.h>
 #include <nc/core/ir/liveness/LivenessAnalyzer.h>
+#include <nc/core/ir/misc/LocalSimplifier.h>
 #include <nc/core/ir/types/TypeAnalyzer.h>
 #include <nc/core/ir/types/Types.h>
 #include <nc/core/ir/vars/VariableAnalyzer.h>
 #include <nc/core/ir/vars/Variables.h>
+#include <nc/core/irgen/CalleeSymbols.h>
 #include <nc/core/irgen/IRGenerator.h>
+#include <nc/core/likec/CompilationUnit.h>
+#include <nc/core/likec/FunctionDefinition.h>
+#include <nc/core/likec/FunctionIdentifier.h>
+#include <nc/core/likec/FunctionPointerType.h>
+#include <nc/core/likec/MemberAccessOperator.h>
+#include <nc/core/likec/StructType.h>
 #include <nc/core/likec/Tree.h>
+#include <nc/core/likec/TreePrinter.h>
+#include <nc/core/likec/Typecast.h>
+#include <nc/core/likec/Types.h>
+#include <nc/core/likec/VariableDeclaration.h>
+#include <nc/core/likec/VariableIdentifier.h>
+#include <nc/core/likec/VerbatimDeclaration.h>
 #include <nc/core/mangling/Demangler.h>
 
 namespace nc {
 namespace core {
 
+namespace {
+
+/**
+ * \param database Signature database.
+ * \param symbol Symbol of a function.
+ *
+ * \return The entry for the function with the given symbol, if any.
+ */
+boost::optional<SignatureDatabase::Entry> lookupSignature(const SignatureDatabase &database, const image::Symbol &symbol) {
+    QString name = symbol.name();
+    const QString &dll = symbol.library();
+
+    if (auto entry = database.lookup(name, dll)) {
+        return entry;
+    }
+
+    /* printf@GLIBC_2.2.5, _CreateFileA@28 */
+    name = name.section(QChar('@'), 0, 0);
+    if (auto entry = database.lookup(name, dll)) {
+        return entry;
+    }
+    if (name.startsWith(QChar('_'))) {
+        return database.lookup(name.mid(1), dll);
+    }
+    return boost::none;
+}
+
+/**
+ * \param function Valid pointer to a function.
+ *
+ * \return Number of statements in the function.
+ */
+std::size_t countStatements(const ir::Function *function) {
+    assert(function != nullptr);
+
+    std::size_t result = 0;
+    foreach (auto basicBlock, function->basicBlocks()) {
+        result += basicBlock->statements().size();
+    }
+    return result;
+}
+
+/**
+ * \param type Pointer to a type. Can be nullptr.
+ *
+ * \return True if the type is or refers to a structural type.
+ */
+bool refersToStructType(const likec::Type *type) {
+    if (type == nullptr) {
+        return false;
+    } else if (type->as<likec::StructType>()) {
+        return true;
+    } else if (auto pointerType = type->as<likec::PointerType>()) {
+        return refersToStructType(pointerType->pointeeType());
+    } else if (auto functionPointerType = type->as<likec::FunctionPointerType>()) {
+        if (refersToStructType(functionPointerType->returnType())) {
+            return true;
+        }
+        foreach (auto argumentType, functionPointerType->argumentTypes()) {
+            if (refersToStructType(argumentType)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Computes the declarations a function definition depends on: prototypes
+ * of the functions it calls and declarations of the global variables it uses.
+ *
+ * Structural types are named in the order of their creation, so the same
+ * name denotes different types in different decompilations. Definitions
+ * using structural types are therefore not self-contained.
+ *
+ * \param definition Valid pointer to a function definition.
+ * \param globals Declarations of global variables.
+ * \param[out] declarations Identifiers and texts of the declarations.
+ *
+ * \return True on success, false if the definition or its dependencies use structural types.
+ */
+bool getDependencies(const likec::FunctionDefinition *definition,
+    const boost::unordered_set<const likec::Declaration *> &globals,
+    std::vector<std::pair<QString, QString>> &declarations)
+{
+    assert(definition != nullptr);
+
+    std::vector<const likec::Declaration *> dependencies;
+    boost::unordered_set<const likec::Declaration *> visited;
+    visited.insert(definition);
+
+    bool usesStructTypes = refersToStructType(definition->type());
+
+    std::function<void(const likec::TreeNode *)> visit = [&](const likec::TreeNode *node) {
+        if (auto declaration = node->as<likec::Declaration>()) {
+            if (auto variableDeclaration = declaration->as<likec::VariableDeclaration>()) {
+                usesStructTypes |= refersToStructType(variableDeclaration->type());
+            }
+        } else if (auto expression = node->as<likec::Expression>()) {
+            const likec::Declaration *dependency = nullptr;
+
+            if (auto functionIdentifier = expression->as<likec::FunctionIdentifier>()) {
+                dependency = functionIdentifier->declaration();
+                usesStructTypes |= refersToStructType(functionIdentifier->declaration()->type());
+            } else if (auto variableIdentifier = expression->as<likec::VariableIdentifier>()) {
+                if (nc::contains(globals, variableIdentifier->declaration())) {
+                    dependency = variableIdentifier->declaration();
+                    usesStructTypes |= refersToStructType(variableIdentifier->declaration()->type());
+                }
+            } else if (auto typecast = expression->as<likec::Typecast>()) {
+                usesStructTypes |= refersToStructType(typecast->type());
+            } else if (expression->as<likec::MemberAccessOperator>()) {
+                usesStructTypes = true;
+            }
+
+            if (dependency && visited.insert(dependency).second) {
+                dependencies.push_back(dependency);
+            }
+        }
+        node->callOnChildren(visit);
+    };
+
+    definition->callOnChildren(visit);
+
+    if (usesStructTypes) {
+        return false;
+    }
+
+    foreach (auto dependency, dependencies) {
+        QString text;
+        QTextStream out(&text);
+        if (auto functionDeclaration = dependency->as<likec::FunctionDeclaration>()) {
+            likec::TreePrinter(out, nullptr).printPrototype(functionDeclaration);
+        } else if (auto functionDefinition = dependency->as<likec::FunctionDefinition>()) {
+            likec::TreePrinter(out, nullptr).printPrototype(functionDefinition);
+        } else {
+            dependency->print(out);
+        }
+        out.flush();
+
+        declarations.push_back(std::make_pair(dependency->identifier(), text));
+    }
+
+    return true;
+}
+
+/**
+ * Replaces the texts of the definition and the declarations in a function
+ * cache entry with patterns that can be instantiated at another address.
+ *
+ * \param entry Function cache entry with the texts.
+ * \param addr Entry address of the function.
+ * \param key Function cache key of the function.
+ * \param nameGenerator Name generator the texts were generated with.
+ *
+ * \return True on success, false if some of the texts cannot be made patterns.
+ */
+bool makeDefinitionPattern(FunctionCache::Entry &entry, ByteAddr addr, const FunctionCache::Key &key,
+    const ir::cgen::NameGenerator &nameGenerator)
+{
+    entry.definition = FunctionCache::makePattern(entry.definition, addr, key, nameGenerator);
+    if (entry.definition.isNull()) {
+        return false;
+    }
+
+    foreach (auto &declaration, entry.declarations) {
+        declaration.first = FunctionCache::makePattern(declaration.first, addr, key, nameGenerator);
+        declaration.second = FunctionCache::makePattern(declaration.second, addr, key, nameGenerator);
+        if (declaration.first.isNull() || declaration.second.isNull()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Instantiates the patterns of the definition and the declarations in
+ * a function cache entry for a function at the given address.
+ *
+ * \param entry Function cache entry with the patterns.
+ * \param addr Entry address of the function.
+ * \param key Function cache key of the function.
+ * \param nameGenerator Name generator.
+ *
+ * \return True on success, false if some of the patterns are malformed.
+ */
+bool instantiateDefinition(FunctionCache::Entry &entry, ByteAddr addr, const FunctionCache::Key &key,
+    const ir::cgen::NameGenerator &nameGenerator)
+{
+    entry.definition = FunctionCache::instantiatePattern(entry.definition, addr, key, nameGenerator);
+    if (entry.definition.isNull()) {
+        return false;
+    }
+
+    foreach (auto &declaration, entry.declarations) {
+        declaration.first = FunctionCache::instantiatePattern(declaration.first, addr, key, nameGenerator);
+        declaration.second = FunctionCache::instantiatePattern(declaration.second, addr, key, nameGenerator);
+        if (declaration.first.isNull() || declaration.second.isNull()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
 MasterAnalyzer::~MasterAnalyzer() {}
 
 void MasterAnalyzer::createProgram(Context &context) const {
@@ -84,6 +329,29 @@ void MasterAnalyzer::createFunctions(Context &context) const {
     context.setFunctions(std::move(functions));
 }
 
+void MasterAnalyzer::simplifyFunctions(Context &context) const {
+    context.logToken().info(tr("Simplifying functions."));
+
+    foreach (auto function, context.functions()->list()) {
+        simplifyFunction(context, function);
+        context.cancellationToken().poll();
+    }
+}
+
+void MasterAnalyzer::simplifyFunction(Context &context, ir::Function *function) const {
+    auto termsBefore = ir::misc::LocalSimplifier::countTerms(function);
+
+    ir::misc::LocalSimplifier(
+        context.image()->platform().architecture(),
+        context.cancellationToken()
+    ).simplify(function);
+
+    auto termsAfter = ir::misc::LocalSimplifier::countTerms(function);
+
+    context.logToken().debug(tr("Simplified %1: %2 terms before, %3 terms after.")
+        .arg(getFunctionName(context, function)).arg(termsBefore).arg(termsAfter));
+}
+
 void MasterAnalyzer::createHooks(Context &context) const {
     context.logToken().info(tr("Creating hooks."));
 
@@ -106,10 +374,199 @@ void MasterAnalyzer::detectCallingConvention(Context &context, const ir::calling
     }
 }
 
+void MasterAnalyzer::lookupSignatureDatabase(Context &context) const {
+    if (!context.signatureDatabase()) {
+        return;
+    }
+
+    context.logToken().info(tr("Looking up known functions in the signature database."));
+
+    using ir::calling::CalleeId;
+
+    const auto &database = *context.signatureDatabase();
+    auto architecture = context.image()->platform().architecture();
+
+    /* Signatures of calls to the callees looked up so far. Nullptr if a callee is not found or is variadic. */
+    boost::unordered_map<CalleeId, std::shared_ptr<ir::calling::CallSignature>> callee2callSignature;
+    std::size_t knownCallees = 0;
+    std::size_t knownCalls = 0;
+
+    auto lookupCallee = [&](const CalleeId &calleeId, const image::Symbol *symbol) -> std::shared_ptr<ir::calling::CallSignature> {
+        if (!symbol || symbol->name().isEmpty()) {
+            return nullptr;
+        }
+
+        auto entry = lookupSignature(database, *symbol);
+        if (!entry) {
+            return nullptr;
+        }
+
+        auto convention = architecture->getCallingConvention(entry->convention);
+        if (!convention) {
+            return nullptr;
+        }
+
+        /*
+         * The database may have been built for another platform of the same architecture,
+         * e.g. with amd64 signatures of functions also existing on Windows. A convention
+         * other than the detected one is trusted only if the callee pops the arguments,
+         * like stdcall, which is never assigned by default.
+         */
+        if (convention != context.hooks()->getConvention(calleeId)) {
+            if (!convention->calleeCleanup()) {
+                return nullptr;
+            }
+            context.conventions()->setConvention(calleeId, convention);
+        }
+        if (convention->calleeCleanup()) {
+            context.conventions()->setStackArgumentsSize(calleeId, entry->stackArgumentsSize);
+        }
+
+        ir::calling::ArgumentFactory createArgument(convention);
+
+        auto signature = std::make_shared<ir::calling::FunctionSignature>();
+        foreach (const auto &argument, entry->arguments) {
+            if (auto term = createArgument(argument)) {
+                signature->arguments().push_back(std::move(term));
+            }
+        }
+        /*
+         * A signature has a single return value term, so of a value returned
+         * in a pair of registers only the low half is known to the analyses.
+         */
+        if (entry->returnValue) {
+            signature->setReturnValue(createArgument(entry->returnValue));
+        }
+        signature->setVariadic(entry->variadic);
+
+        if (calleeId.entryAddress()) {
+            context.signatures()->setSignature(*calleeId.entryAddress(), signature);
+        } else {
+            context.signatures()->setCalleeSignature(*calleeId.callAddress(), signature);
+        }
+        ++knownCallees;
+
+        /* Calls to variadic functions are instrumented speculatively to find their extra arguments. */
+        if (signature->variadic()) {
+            return nullptr;
+        }
+
+        auto callSignature = std::make_shared<ir::calling::CallSignature>();
+        callSignature->arguments() = signature->arguments();
+        callSignature->setReturnValue(signature->returnValue());
+        return callSignature;
+    };
+
+    foreach (const ir::Function *function, context.functions()->list()) {
+        foreach (auto basicBlock, function->basicBlocks()) {
+            foreach (auto statement, basicBlock->statements()) {
+                auto call = statement->asCall();
+                if (!call || !call->instruction()) {
+                    continue;
+                }
+
+                /* These are the callee ids the hooks will compute from the dataflow. */
+                CalleeId calleeId;
+                if (auto address = irgen::evaluateAddress(call->target())) {
+                    calleeId = ir::calling::EntryAddress(*address);
+                } else {
+                    calleeId = ir::calling::CallAddress(call->instruction()->addr());
+                }
+
+                auto i = callee2callSignature.find(calleeId);
+                if (i == callee2callSignature.end()) {
+                    const image::Symbol *symbol;
+                    if (calleeId.entryAddress()) {
+                        symbol = irgen::getFunctionSymbol(*context.image(), *context.program(), *calleeId.entryAddress());
+                    } else {
+                        symbol = irgen::getImportSymbol(*context.image(), call->target());
+                    }
+                    i = callee2callSignature.insert(std::make_pair(calleeId, lookupCallee(calleeId, symbol))).first;
+                }
+
+                if (i->second) {
+                    context.signatures()->setSignature(call, i->second);
+                    ++knownCalls;
+                }
+            }
+        }
+        context.cancellationToken().poll();
+    }
+
+    context.logToken().info(tr("Signature database: %1 known callees, %2 calls with known signatures.")
+        .arg(knownCallees).arg(knownCalls));
+}
+
+void MasterAnalyzer::lookupFunctionCache(Context &context) const {
+    if (!context.functionCache()) {
+        return;
+    }
+
+    context.logToken().info(tr("Looking up functions in the function cache."));
+
+    context.setFunctionKeys(FunctionCache::computeKeys(*context.image(), *context.functions()));
+
+    std::map<ByteAddr, FunctionCache::Entry> cachedDefinitions;
+    std::vector<ir::Function *> cachedFunctions;
+
+    ir::cgen::NameGenerator nameGenerator(*context.image());
+
+    foreach (ir::Function *function, context.functions()->list()) {
+        if (!function->entry() || !function->entry()->address()) {
+            continue;
+        }
+
+        ByteAddr addr = *function->entry()->address();
+
+        const auto &key = nc::find(context.functionKeys(), addr);
+        if (key.hash.isEmpty()) {
+            continue;
+        }
+
+        auto entry = context.functionCache()->lookup(key.hash);
+        if (!entry) {
+            continue;
+        }
+
+        ir::calling::ArgumentFactory createArgument(
+            context.hooks()->getConvention(ir::calling::CalleeId(ir::calling::EntryAddress(addr))));
+
+        auto signature = std::make_shared<ir::calling::FunctionSignature>();
+        foreach (const auto &argument, entry->arguments) {
+            if (auto term = createArgument(argument)) {
+                signature->arguments().push_back(std::move(term));
+            }
+        }
+        if (entry->returnValue) {
+            signature->setReturnValue(createArgument(entry->returnValue));
+        }
+        signature->setVariadic(entry->variadic);
+
+        context.signatures()->setSignature(addr, std::move(signature));
+
+        if (!entry->definition.isEmpty() && instantiateDefinition(*entry, addr, key, nameGenerator)) {
+            cachedDefinitions[addr] = std::move(*entry);
+            cachedFunctions.push_back(function);
+        }
+    }
+
+    foreach (ir::Function *function, cachedFunctions) {
+        context.removeCachedFunction(function);
+    }
+
+    context.logToken().info(tr("Function cache: %1 hits, %2 misses, %3 definitions reused.")
+        .arg(context.functionCache()->hits())
+        .arg(context.functionCache()->misses())
+        .arg(cachedDefinitions.size()));
+
+    context.setCachedDefinitions(std::move(cachedDefinitions));
+}
+
 void MasterAnalyzer::dataflowAnalysis(Context &context) const {
     context.logToken().info(tr("Dataflow analysis."));
 
     context.setDataflows(std::make_unique<ir::dflow::Dataflows>());
+    context.setDefUseGraphs(std::make_unique<ir::dflow::DefUseGraphs>());
 
     foreach (auto function, context.functions()->list()) {
         dataflowAnalysis(context, function);
@@ -124,16 +581,55 @@ void MasterAnalyzer::dataflowAnalysis(Context &context, ir::Function *function)
 
     context.hooks()->instrument(function, dataflow.get());
 
+    auto budget = context.budget();
+    budget.start();
+
     ir::dflow::DataflowAnalyzer(*dataflow, context.image()->platform().architecture(), context.cancellationToken(),
-                                context.logToken()).analyze(ir::CFG(function->basicBlocks()));
+                                context.logToken(), &budget).analyze(ir::CFG(function->basicBlocks()));
+
+    if (budget.exceeded()) {
+        reportBudgetHit(context, function, tr("dataflow analysis stopped at the first fixpoint, dead code is kept: %1 exceeded")
+            .arg(budget.describe(budget.exceeded())));
+    }
 
+    (*context.defUseGraphs())[function] = std::make_unique<ir::dflow::DefUseGraph>(*dataflow);
     context.dataflows()->emplace(function, std::move(dataflow));
 }
 
+void MasterAnalyzer::updateDataflows(Context &context) const {
+    context.logToken().info(tr("Updating dataflow information."));
+
+    auto oldDataflows = std::make_unique<ir::dflow::Dataflows>();
+    oldDataflows->swap(*context.dataflows());
+
+    std::size_t reusedDataflows = 0;
+
+    foreach (auto function, context.functions()->list()) {
+        auto i = oldDataflows->find(function);
+
+        if (i != oldDataflows->end() && context.hooks()->isInstrumentationUpToDate(function, *i->second)) {
+            context.dataflows()->emplace(function, std::move(i->second));
+            ++reusedDataflows;
+        } else {
+            dataflowAnalysis(context, function);
+
+            /* The liveness information was computed on the old dataflow information. */
+            if (context.livenesses()) {
+                context.livenesses()->erase(function);
+            }
+        }
+
+        context.cancellationToken().poll();
+    }
+
+    context.logToken().info(tr("Dataflow analysis repeated for %1 functions, skipped for %2 functions.")
+        .arg(context.functions()->list().size() - reusedDataflows).arg(reusedDataflows));
+}
+
 void MasterAnalyzer::reconstructSignatures(Context &context) const {
     context.logToken().info(tr("Reconstructing function signatures."));
 
-    ir::calling::SignatureAnalyzer(*context.signatures(), *context.dataflows(), *context.hooks(),
+    ir::calling::SignatureAnalyzer(*context.signatures(), *context.dataflows(), *context.defUseGraphs(), *context.hooks(),
         *context.livenesses(), context.cancellationToken(), context.logToken())
         .analyze();
 }
@@ -141,20 +637,31 @@ void MasterAnalyzer::reconstructSignatures(Context &context) const {
 void MasterAnalyzer::reconstructVariables(Context &context) const {
     context.logToken().info(tr("Reconstructing variables."));
 
+    QElapsedTimer timer;
+    timer.start();
+
     std::unique_ptr<ir::vars::Variables> variables(new ir::vars::Variables());
 
     ir::vars::VariableAnalyzer(*variables, *context.dataflows(), context.image()->platform().architecture())
         .analyze();
 
+    context.logToken().debug(tr("Reconstructed %1 variables in %2 ms.")
+        .arg(variables->list().size()).arg(timer.elapsed()));
+
     context.setVariables(std::move(variables));
 }
 
 void MasterAnalyzer::livenessAnalysis(Context &context) const {
     context.logToken().info(tr("Liveness analysis."));
 
-    context.setLivenesses(std::make_unique<ir::liveness::Livenesses>());
+    /* Liveness information computed earlier is kept as a starting point. */
+    if (!context.livenesses()) {
+        context.setLivenesses(std::make_unique<ir::liveness::Livenesses>());
+    }
 
-    foreach (const ir::Function *function, context.functions()->list()) {
+    foreach (ir::Function *function, context.functions()->list()) {
+        /* Liveness is stored as bits indexed by term numbers. */
+        function->numberTerms();
         livenessAnalysis(context, function);
     }
 }
@@ -162,27 +669,40 @@ void MasterAnalyzer::livenessAnalysis(Context &context) const {
 void MasterAnalyzer::livenessAnalysis(Context &context, const ir::Function *function) const {
     context.logToken().info(tr("Liveness analysis of %1.").arg(getFunctionName(context, function)));
 
-    std::unique_ptr<ir::liveness::Liveness> liveness(new ir::liveness::Liveness());
+    std::unique_ptr<ir::liveness::Liveness> liveness(new ir::liveness::Liveness(function->termCount()));
+
+    auto i = context.livenesses()->find(function);
+    auto previous = i != context.livenesses()->end() ? i->second.get() : nullptr;
 
     ir::liveness::LivenessAnalyzer(*liveness, function,
         *context.dataflows()->at(function), context.image()->platform().architecture(),
         context.graphs() ? context.graphs()->at(function).get() : nullptr, *context.hooks(),
         context.signatures(), context.logToken())
-    .analyze();
+    .analyze(previous);
 
-    context.livenesses()->emplace(function, std::move(liveness));
+    (*context.livenesses())[function] = std::move(liveness);
 }
 
 void MasterAnalyzer::reconstructTypes(Context &context) const {
     context.logToken().info(tr("Reconstructing types."));
 
+    QElapsedTimer timer;
+    timer.start();
+
     std::unique_ptr<ir::types::Types> types(new ir::types::Types());
 
-    ir::types::TypeAnalyzer(
+    ir::types::TypeAnalyzer analyzer(
         *types, *context.functions(), *context.dataflows(), *context.variables(),
         *context.livenesses(), *context.hooks(), *context.signatures(),
-        context.cancellationToken())
-    .analyze();
+        context.cancellationToken(), context.logToken(), &context.budget());
+    analyzer.analyze();
+
+    foreach (auto function, analyzer.functionsOverBudget()) {
+        reportBudgetHit(context, function, tr("type reconstruction stopped before reaching a fixpoint: %1 exceeded")
+            .arg(context.budget().describe(Budget::ITERATIONS)));
+    }
+
+    context.logToken().debug(tr("Reconstructed types in %1 ms.").arg(timer.elapsed()));
 
     context.setTypes(std::move(types));
 }
@@ -203,8 +723,20 @@ void MasterAnalyzer::structuralAnalysis(Context &context, const ir::Function *fu
 
     std::unique_ptr<ir::cflow::Graph> graph(new ir::cflow::Graph());
 
+    auto budget = context.budget();
+    budget.start();
+
     ir::cflow::GraphBuilder()(*graph, function);
-    ir::cflow::StructureAnalyzer(*graph, *context.dataflows()->at(function)).analyze();
+
+    /* Too large functions are output with gotos. */
+    if (budget.checkSize(countStatements(function))) {
+        ir::cflow::StructureAnalyzer(*graph, *context.dataflows()->at(function), &budget).analyze();
+    }
+
+    if (budget.exceeded()) {
+        reportBudgetHit(context, function, tr("structural analysis stopped, control flow is expressed with gotos: %1 exceeded")
+            .arg(budget.describe(budget.exceeded())));
+    }
 
     context.graphs()->emplace(function, std::move(graph));
 }
@@ -212,16 +744,150 @@ void MasterAnalyzer::structuralAnalysis(Context &context, const ir::Function *fu
 void MasterAnalyzer::generateTree(Context &context) const {
     context.logToken().info(tr("Generating AST."));
 
+    QElapsedTimer timer;
+    timer.start();
+
     auto tree = std::make_unique<nc::core::likec::Tree>();
 
-    ir::cgen::CodeGenerator(*tree, *context.image(), *context.functions(), *context.hooks(),
-        *context.signatures(), *context.dataflows(), *context.variables(), *context.graphs(),
-        *context.livenesses(), *context.types(), context.cancellationToken())
-        .makeCompilationUnit();
+    ir::cgen::CodeGenerator generator(*tree, *context.image(), *context.functions(), *context.hooks(),
+        *context.signatures(), *context.dataflows(), *context.defUseGraphs(), *context.variables(), *context.graphs(),
+        *context.livenesses(), *context.types(), context.cancellationToken());
+
+    foreach (const auto &hit, context.budgetHits()) {
+        generator.addFunctionComment(hit.first, tr("Decompiled partially: %1.").arg(hit.second));
+    }
+
+    if (context.selectedFunctions().empty()) {
+        generator.makeCompilationUnit();
+    } else {
+        std::vector<const ir::Function *> functions;
+
+        foreach (const ir::Function *function, context.functions()->list()) {
+            if (function->entry() && function->entry()->address() &&
+                nc::contains(context.selectedFunctions(), *function->entry()->address()))
+            {
+                functions.push_back(function);
+            }
+        }
+
+        generator.makeCompilationUnit(functions);
+    }
+
+    if (!context.cachedDefinitions().empty()) {
+        ir::cgen::NameGenerator nameGenerator(*context.image());
+
+        /* The generated part of the tree declares some of the dependencies already. */
+        std::set<QString> declared;
+        foreach (const auto &declaration, tree->root()->declarations()) {
+            declared.insert(declaration->identifier());
+        }
+
+        std::vector<std::unique_ptr<likec::VerbatimDeclaration>> definitions;
+
+        foreach (const auto &addrAndEntry, context.cachedDefinitions()) {
+            if (context.selectedFunctions().empty() ||
+                nc::contains(context.selectedFunctions(), addrAndEntry.first))
+            {
+                auto name = nameGenerator.getFunctionName(addrAndEntry.first).name();
+                declared.insert(name);
+
+                foreach (const auto &declaration, addrAndEntry.second.declarations) {
+                    if (declared.insert(declaration.first).second) {
+                        tree->root()->addDeclaration(
+                            std::make_unique<likec::VerbatimDeclaration>(declaration.first, declaration.second));
+                    }
+                }
+
+                definitions.push_back(
+                    std::make_unique<likec::VerbatimDeclaration>(std::move(name), addrAndEntry.second.definition));
+            }
+        }
+
+        foreach (auto &definition, definitions) {
+            tree->root()->addDeclaration(std::move(definition));
+        }
+    }
+
+    context.logToken().debug(tr("Generated AST in %1 ms, its nodes take %2 KiB of arena memory, %3 KiB of it held by deleted nodes.")
+        .arg(timer.elapsed()).arg(tree->arenaBytesReserved() / 1024).arg(tree->arenaBytesReleased() / 1024));
 
     context.setTree(std::move(tree));
 }
 
+void MasterAnalyzer::updateFunctionCache(Context &context) const {
+    if (!context.functionCache()) {
+        return;
+    }
+
+    context.logToken().info(tr("Updating the function cache."));
+
+    ir::cgen::NameGenerator nameGenerator(*context.image());
+
+    std::map<QString, const likec::FunctionDefinition *> name2definition;
+    boost::unordered_set<const likec::Declaration *> globals;
+    if (context.tree() && context.tree()->root()) {
+        foreach (const auto &declaration, context.tree()->root()->declarations()) {
+            if (auto definition = declaration->as<likec::FunctionDefinition>()) {
+                name2definition[definition->identifier()] = definition;
+            } else if (declaration->as<likec::VariableDeclaration>()) {
+                globals.insert(declaration.get());
+            }
+        }
+    }
+
+    foreach (const ir::Function *function, context.functions()->list()) {
+        /* Partial results would be reused even when there is enough budget for complete ones. */
+        if (!function->entry() || !function->entry()->address() || nc::contains(context.overBudgetFunctions(), function)) {
+            continue;
+        }
+
+        ByteAddr addr = *function->entry()->address();
+
+        const auto &key = nc::find(context.functionKeys(), addr);
+        if (key.hash.isEmpty()) {
+            continue;
+        }
+
+        auto signature = context.signatures()->getSignature(function);
+        if (!signature) {
+            continue;
+        }
+
+        FunctionCache::Entry entry;
+        foreach (const auto &argument, signature->arguments()) {
+            entry.arguments.push_back(ir::calling::getArgumentLocation(argument.get()));
+        }
+        entry.returnValue = ir::calling::getArgumentLocation(signature->returnValue().get());
+        entry.variadic = signature->variadic();
+
+        auto definition = nc::find(name2definition, getFunctionName(context, function));
+        if (definition && getDependencies(definition, globals, entry.declarations)) {
+            QString text;
+            QTextStream out(&text);
+            definition->print(out);
+            out.flush();
+
+            entry.definition = text;
+            if (!makeDefinitionPattern(entry, addr, key, nameGenerator)) {
+                entry.definition.clear();
+                entry.declarations.clear();
+            }
+        }
+
+        context.functionCache()->store(key.hash, entry);
+        context.cancellationToken().poll();
+    }
+
+    context.functionCache()->flush();
+
+    context.logToken().info(tr("Function cache: %1 hits, %2 misses, %3 stores, %4 evictions, %5 entries.")
+        .arg(context.functionCache()->hits())
+        .arg(context.functionCache()->misses())
+        .arg(context.functionCache()->stores())
+        .arg(context.functionCache()->evictions())
+        .arg(context.functionCache()->size()));
+}
+
 void MasterAnalyzer::decompile(Context &context) const {
     context.logToken().info(tr("Decompiling."));
 
@@ -231,12 +897,21 @@ void MasterAnalyzer::decompile(Context &context) const {
     createFunctions(context);
     context.cancellationToken().poll();
 
+    simplifyFunctions(context);
+    context.cancellationToken().poll();
+
     createHooks(context);
     context.cancellationToken().poll();
 
     detectCallingConventions(context);
     context.cancellationToken().poll();
 
+    lookupSignatureDatabase(context);
+    context.cancellationToken().poll();
+
+    lookupFunctionCache(context);
+    context.cancellationToken().poll();
+
     dataflowAnalysis(context);
     context.cancellationToken().poll();
 
@@ -246,7 +921,7 @@ void MasterAnalyzer::decompile(Context &context) const {
     reconstructSignatures(context);
     context.cancellationToken().poll();
 
-    dataflowAnalysis(context);
+    updateDataflows(context);
     context.cancellationToken().poll();
 
     reconstructVariables(context);
@@ -264,9 +939,22 @@ void MasterAnalyzer::decompile(Context &context) const {
     generateTree(context);
     context.cancellationToken().poll();
 
+    updateFunctionCache(context);
+    context.cancellationToken().poll();
+
+    if (!context.budgetHits().empty()) {
+        context.logToken().warning(tr("Budget: %1 functions decompiled partially, %2 limits exceeded.")
+            .arg(context.overBudgetFunctions().size()).arg(context.budgetHits().size()));
+    }
+
     context.logToken().info(tr("Decompilation completed."));
 }
 
+void MasterAnalyzer::reportBudgetHit(Context &context, const ir::Function *function, const QString &description) const {
+    context.logToken().warning(tr("%1: %2.").arg(getFunctionName(context, function)).arg(description));
+    context.addBudgetHit(function, description);
+}
+
 QString MasterAnalyzer::getFunctionName(Context &context, const ir::Function *function) const {
     return ir::cgen::NameGenerator(*context.image()).getFunctionName(function).name();
 }
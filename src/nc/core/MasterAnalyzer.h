@@ -74,6 +74,22 @@ public:
      */
     virtual void createFunctions(Context &context) const;
 
+    /**
+     * Performs cheap local simplifications of all functions
+     * before the dataflow analysis.
+     *
+     * \param context Context.
+     */
+    virtual void simplifyFunctions(Context &context) const;
+
+    /**
+     * Performs cheap local simplifications of the given function.
+     *
+     * \param context Context.
+     * \param function Valid pointer to the function.
+     */
+    virtual void simplifyFunction(Context &context, ir::Function *function) const;
+
     /**
      * Creates the hooks manager.
      *
@@ -91,6 +107,26 @@ public:
      */
     virtual void detectCallingConvention(Context &context, const ir::calling::CalleeId &calleeId) const;
 
+    /**
+     * Looks up the callees of calls to imported and other named functions in the
+     * signature database, if the context has one. The signatures of the found
+     * callees and of the calls to them are set before the dataflow analysis,
+     * so that these calls are instrumented according to the signatures from
+     * the start, and are kept by the signature reconstruction.
+     *
+     * \param context Context.
+     */
+    virtual void lookupSignatureDatabase(Context &context) const;
+
+    /**
+     * Looks up the functions in the function cache, if the context has one.
+     * Signatures of the found functions are set. Functions whose definitions
+     * were found are removed from the list of functions and not analyzed.
+     *
+     * \param context Context.
+     */
+    virtual void lookupFunctionCache(Context &context) const;
+
     /**
      * Performs dataflow analysis of all functions.
      *
@@ -106,6 +142,15 @@ public:
      */
     virtual void dataflowAnalysis(Context &context, ir::Function *function) const;
 
+    /**
+     * Repeats dataflow analysis of the functions whose instrumentation
+     * has changed since their last dataflow analysis, e.g. due to new
+     * signatures. Dataflow information of other functions is kept.
+     *
+     * \param context Context.
+     */
+    virtual void updateDataflows(Context &context) const;
+
     /**
      * Reconstructs signatures of functions.
      *
@@ -164,6 +209,14 @@ public:
      */
     virtual void generateTree(Context &context) const;
 
+    /**
+     * Stores the signatures and the definitions of the analyzed functions
+     * in the function cache, if the context has one.
+     *
+     * \param context Context.
+     */
+    virtual void updateFunctionCache(Context &context) const;
+
     /**
      * Decompiles the assembler program.
      *
@@ -179,6 +232,16 @@ protected:
      * \return Name of the function that can be shown to the user.
      */
     virtual QString getFunctionName(Context &context, const ir::Function *function) const;
+
+    /**
+     * Logs and remembers in the context that an analysis of a function
+     * exceeded the budget.
+     *
+     * \param context Context.
+     * \param function Valid pointer to a function.
+     * \param description Description of the analysis and of the exceeded limit.
+     */
+    void reportBudgetHit(Context &context, const ir::Function *function, const QString &description) const;
 };
 
 } // namespace core
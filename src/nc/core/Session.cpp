@@ -0,0 +1,487 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "Session.h"
+
+#include <algorithm>
+#include <cstring> /* memcpy, memset */
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QTextStream>
+
+#include <boost/unordered_map.hpp>
+
+#include <nc/common/Exception.h>
+#include <nc/common/Foreach.h>
+#include <nc/common/Range.h>
+#include <nc/common/make_unique.h>
+
+#include <nc/core/arch/Architecture.h>
+#include <nc/core/arch/Disassembler.h>
+#include <nc/core/arch/Instruction.h>
+#include <nc/core/arch/Instructions.h>
+#include <nc/core/image/ByteSource.h>
+#include <nc/core/image/Image.h>
+#include <nc/core/image/Relocation.h>
+#include <nc/core/image/Section.h>
+#include <nc/core/image/Symbol.h>
+#include <nc/core/likec/Tree.h>
+
+#include "Context.h"
+
+namespace nc {
+namespace core {
+
+namespace {
+
+/** Magic number identifying session files: "SNWS". */
+const quint32 MAGIC = 0x534e5753;
+
+/** Size of the file header: magic, format version, and size of the metadata. */
+const qint64 HEADER_SIZE = 16;
+
+/** Alignment of the blocks of section contents in the file. */
+const qint64 BLOB_ALIGNMENT = 8;
+
+qint64 align(qint64 offset) {
+    return (offset + BLOB_ALIGNMENT - 1) / BLOB_ALIGNMENT * BLOB_ALIGNMENT;
+}
+
+/**
+ * Session file mapped into memory, or read into memory if mapping is not possible.
+ */
+class MappedFile {
+    Q_DECLARE_TR_FUNCTIONS(MappedFile)
+
+    QFile file_; ///< The file.
+    QByteArray buffer_; ///< Contents of the file, if it could not be mapped.
+    const char *data_; ///< Pointer to the contents of the file.
+    qint64 size_; ///< Size of the file.
+
+public:
+    MappedFile(const QString &filename): file_(filename), data_(nullptr), size_(0) {
+        if (!file_.open(QIODevice::ReadOnly)) {
+            throw nc::Exception(tr("Could not open file \"%1\" for reading.").arg(filename));
+        }
+
+        size_ = file_.size();
+
+        if (size_ > 0) {
+            if (auto data = file_.map(0, size_)) {
+                data_ = reinterpret_cast<const char *>(data);
+            } else {
+                buffer_ = file_.readAll();
+                data_ = buffer_.constData();
+                size_ = buffer_.size();
+            }
+        }
+    }
+
+    const char *data() const { return data_; }
+
+    qint64 size() const { return size_; }
+};
+
+/**
+ * Byte source reading the contents of a section from a mapped session file.
+ */
+class MappedByteSource: public image::ByteSource {
+    std::shared_ptr<const MappedFile> file_; ///< Mapped file keeping the contents alive.
+    const char *data_; ///< Contents of the section.
+    ByteAddr addr_; ///< Address of the first byte of the contents.
+    ByteSize size_; ///< Size of the contents.
+
+public:
+    MappedByteSource(std::shared_ptr<const MappedFile> file, const char *data, ByteAddr addr, ByteSize size):
+        file_(std::move(file)), data_(data), addr_(addr), size_(size)
+    {}
+
+    ByteSize readBytes(ByteAddr addr, void *buf, ByteSize size) const override {
+        auto offset = addr - addr_;
+
+        if (offset < 0 || size <= 0) {
+            return 0;
+        }
+
+        auto copiedSize = std::max(std::min(size, size_ - offset), ByteSize(0));
+        if (copiedSize > 0) {
+            memcpy(buf, data_ + offset, copiedSize);
+        }
+        if (copiedSize < size) {
+            memset(static_cast<char *>(buf) + copiedSize, 0, size - copiedSize);
+        }
+
+        return size;
+    }
+};
+
+} // anonymous namespace
+
+Session::Session(): depth_(0) {}
+
+Session::~Session() {}
+
+QByteArray Session::hashFiles(const QStringList &filenames) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    foreach (const QString &filename, filenames) {
+        QFile file(filename);
+        if (!file.open(QIODevice::ReadOnly)) {
+            throw nc::Exception(tr("Could not open file \"%1\" for reading.").arg(filename));
+        }
+
+        while (!file.atEnd()) {
+            hash.addData(file.read(1 << 20));
+        }
+    }
+
+    return hash.result();
+}
+
+void Session::setInputFiles(const QStringList &filenames) {
+    inputFiles_ = filenames;
+    inputHash_ = hashFiles(filenames);
+}
+
+void Session::capture(const Context &context) {
+    image_ = context.image();
+    instructions_ = context.instructions();
+    selectedFunctions_ = context.selectedFunctions();
+
+    instructionRanges_.clear();
+    if (instructions_) {
+        instructionRanges_.reserve(instructions_->size());
+        foreach (const auto &instruction, instructions_->all()) {
+            instructionRanges_.push_back(std::make_pair(instruction->addr(), instruction->size()));
+        }
+    }
+
+    code_.clear();
+    if (context.tree()) {
+        QTextStream out(&code_);
+        context.tree()->print(out);
+    }
+}
+
+void Session::restore(Context &context) const {
+    if (image_) {
+        context.setImage(image_);
+    }
+    if (hasInstructions()) {
+        context.setInstructions(instructions());
+    }
+    context.setSelectedFunctions(selectedFunctions_);
+}
+
+const std::shared_ptr<const arch::Instructions> &Session::instructions() const {
+    if (!instructions_ && hasInstructions()) {
+        auto corrupted = [&]() {
+            return nc::Exception(tr("The instructions saved in the session do not match its image."));
+        };
+
+        if (!image_ || !image_->platform().architecture()) {
+            throw corrupted();
+        }
+
+        auto instructions = std::make_shared<arch::Instructions>();
+        auto disassembler = image_->platform().architecture()->createDisassembler();
+
+        foreach (const auto &range, instructionRanges_) {
+            auto instruction = disassembler->disassembleSingleInstruction(range.first, image_.get());
+            if (!instruction || instruction->size() != range.second) {
+                throw corrupted();
+            }
+            instructions->add(std::move(instruction));
+        }
+
+        instructions_ = std::move(instructions);
+    }
+    return instructions_;
+}
+
+void Session::save(const QString &filename) const {
+    QByteArray metadata;
+    std::vector<QByteArray> blobs;
+
+    {
+        QDataStream out(&metadata, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_4_8);
+
+        out << inputFiles_ << inputHash_;
+
+        /* Image. */
+        auto image = image_ ? image_ : std::make_shared<image::Image>();
+        const auto &platform = image->platform();
+
+        out << (platform.architecture() ? platform.architecture()->name() : QString())
+            << static_cast<qint32>(platform.operatingSystem())
+            << static_cast<qint32>(platform.intSize());
+
+        boost::unordered_map<const image::Section *, qint32> section2index;
+        qint64 blobOffset = 0;
+
+        out << static_cast<quint32>(image->sections().size());
+        foreach (const image::Section *section, image->sections()) {
+            qint32 index = static_cast<qint32>(section2index.size());
+            section2index[section] = index;
+
+            out << section->name() << static_cast<qint64>(section->addr()) << static_cast<qint64>(section->size())
+                << section->isAllocated() << section->isReadable() << section->isWritable() << section->isExecutable()
+                << section->isCode() << section->isData() << section->isBss();
+
+            QByteArray content;
+            if (!section->isBss()) {
+                content.resize(section->size());
+                content.resize(section->readBytes(section->addr(), content.data(), section->size()));
+            }
+
+            out << static_cast<qint64>(blobOffset) << static_cast<qint64>(content.size());
+
+            blobOffset = align(blobOffset + content.size());
+            blobs.push_back(std::move(content));
+        }
+
+        boost::unordered_map<const image::Symbol *, qint32> symbol2index;
+
+        out << static_cast<quint32>(image->symbols().size());
+        foreach (const image::Symbol *symbol, image->symbols()) {
+            qint32 index = static_cast<qint32>(symbol2index.size());
+            symbol2index[symbol] = index;
+
+            out << static_cast<qint32>(symbol->type()) << symbol->name()
+                << static_cast<bool>(symbol->value()) << static_cast<quint64>(symbol->value() ? *symbol->value() : 0)
+                << (symbol->section() ? nc::find(section2index, symbol->section()) : qint32(-1));
+        }
+
+        out << static_cast<quint32>(image->relocations().size());
+        foreach (const image::Relocation *relocation, image->relocations()) {
+            out << static_cast<qint64>(relocation->address()) << nc::find(symbol2index, relocation->symbol())
+                << static_cast<qint64>(relocation->size()) << static_cast<qint64>(relocation->addend());
+        }
+
+        out << (image->entrypoint() ? true : false) << static_cast<qint64>(image->entrypoint() ? *image->entrypoint() : 0);
+
+        /* Instructions. */
+        out << static_cast<quint32>(instructionRanges_.size());
+        foreach (const auto &range, instructionRanges_) {
+            out << static_cast<qint64>(range.first) << static_cast<qint32>(range.second);
+        }
+
+        /* Functions. */
+        out << static_cast<quint32>(selectedFunctions_.size());
+        foreach (ByteAddr entry, selectedFunctions_) {
+            out << static_cast<qint64>(entry);
+        }
+        out << static_cast<qint32>(depth_);
+
+        /* Generated code. */
+        out << code_ << options_;
+    }
+
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw nc::Exception(tr("Could not open file \"%1\" for writing.").arg(filename));
+    }
+
+    {
+        QDataStream out(&file);
+        out << MAGIC << FORMAT_VERSION << static_cast<quint64>(metadata.size());
+    }
+
+    file.write(metadata);
+    file.write(QByteArray(align(HEADER_SIZE + metadata.size()) - HEADER_SIZE - metadata.size(), '\0'));
+
+    foreach (const QByteArray &blob, blobs) {
+        file.write(blob);
+        file.write(QByteArray(align(blob.size()) - blob.size(), '\0'));
+    }
+
+    if (file.error() != QFile::NoError) {
+        throw nc::Exception(tr("Could not write session file \"%1\": %2.").arg(filename).arg(file.errorString()));
+    }
+}
+
+std::unique_ptr<Session> Session::load(const QString &filename) {
+    auto file = std::make_shared<MappedFile>(filename);
+
+    auto corrupted = [&]() {
+        return nc::Exception(tr("File \"%1\" is not a valid session file.").arg(filename));
+    };
+
+    if (file->size() < HEADER_SIZE) {
+        throw corrupted();
+    }
+
+    quint32 magic, version;
+    quint64 metadataSize;
+    {
+        QByteArray header = QByteArray::fromRawData(file->data(), HEADER_SIZE);
+        QDataStream in(header);
+        in >> magic >> version >> metadataSize;
+    }
+
+    if (magic != MAGIC) {
+        throw corrupted();
+    }
+    if (version != FORMAT_VERSION) {
+        throw nc::Exception(tr("Session file \"%1\" has version %2, but only version %3 is supported.")
+            .arg(filename).arg(version).arg(FORMAT_VERSION));
+    }
+    if (metadataSize > static_cast<quint64>(file->size() - HEADER_SIZE)) {
+        throw corrupted();
+    }
+
+    const char *blobs = file->data() + align(HEADER_SIZE + metadataSize);
+    qint64 blobsSize = file->size() - align(HEADER_SIZE + metadataSize);
+
+    QByteArray metadata = QByteArray::fromRawData(file->data() + HEADER_SIZE, static_cast<int>(metadataSize));
+    QDataStream in(metadata);
+    in.setVersion(QDataStream::Qt_4_8);
+
+    auto result = std::make_unique<Session>();
+
+    in >> result->inputFiles_ >> result->inputHash_;
+
+    /* Image. */
+    auto image = std::make_shared<image::Image>();
+
+    QString architectureName;
+    qint32 operatingSystem, intSize;
+    in >> architectureName >> operatingSystem >> intSize;
+
+    if (!architectureName.isEmpty()) {
+        image->platform().setArchitecture(architectureName);
+    }
+    image->platform().setOperatingSystem(static_cast<image::Platform::OperatingSystem>(operatingSystem));
+    image->platform().setIntSize(intSize);
+
+    std::vector<const image::Section *> sections;
+
+    quint32 sectionCount;
+    in >> sectionCount;
+    for (quint32 i = 0; i < sectionCount && in.status() == QDataStream::Ok; ++i) {
+        QString name;
+        qint64 addr, size;
+        bool isAllocated, isReadable, isWritable, isExecutable, isCode, isData, isBss;
+        qint64 blobOffset, blobSize;
+
+        in >> name >> addr >> size
+           >> isAllocated >> isReadable >> isWritable >> isExecutable
+           >> isCode >> isData >> isBss
+           >> blobOffset >> blobSize;
+
+        if (blobOffset < 0 || blobSize < 0 || blobOffset + blobSize > blobsSize) {
+            throw corrupted();
+        }
+
+        auto section = std::make_unique<image::Section>(name, addr, size);
+        section->setAllocated(isAllocated);
+        section->setReadable(isReadable);
+        section->setWritable(isWritable);
+        section->setExecutable(isExecutable);
+        section->setCode(isCode);
+        section->setData(isData);
+        section->setBss(isBss);
+
+        if (blobSize > 0) {
+            section->setExternalByteSource(std::make_unique<MappedByteSource>(file, blobs + blobOffset, addr, blobSize));
+        }
+
+        sections.push_back(section.get());
+        image->addSection(std::move(section));
+    }
+
+    std::vector<const image::Symbol *> symbols;
+
+    quint32 symbolCount;
+    in >> symbolCount;
+    for (quint32 i = 0; i < symbolCount && in.status() == QDataStream::Ok; ++i) {
+        qint32 type, sectionIndex;
+        QString name;
+        bool hasValue;
+        quint64 value;
+
+        in >> type >> name >> hasValue >> value >> sectionIndex;
+
+        if (sectionIndex >= static_cast<qint32>(sections.size())) {
+            throw corrupted();
+        }
+
+        symbols.push_back(image->addSymbol(std::make_unique<image::Symbol>(
+            static_cast<image::SymbolType::Type>(type),
+            name,
+            hasValue ? boost::optional<ConstantValue>(value) : boost::none,
+            sectionIndex >= 0 ? sections[sectionIndex] : nullptr)));
+    }
+
+    quint32 relocationCount;
+    in >> relocationCount;
+    for (quint32 i = 0; i < relocationCount && in.status() == QDataStream::Ok; ++i) {
+        qint64 address, size, addend;
+        qint32 symbolIndex;
+
+        in >> address >> symbolIndex >> size >> addend;
+
+        if (symbolIndex < 0 || symbolIndex >= static_cast<qint32>(symbols.size())) {
+            throw corrupted();
+        }
+
+        image->addRelocation(std::make_unique<image::Relocation>(address, symbols[symbolIndex], size, addend));
+    }
+
+    bool hasEntrypoint;
+    qint64 entrypoint;
+    in >> hasEntrypoint >> entrypoint;
+    if (hasEntrypoint) {
+        image->setEntryPoint(entrypoint);
+    }
+
+    result->image_ = image;
+
+    /* Instructions are stored as addresses and sizes and decoded on demand. */
+    quint32 instructionCount;
+    in >> instructionCount;
+    for (quint32 i = 0; i < instructionCount && in.status() == QDataStream::Ok; ++i) {
+        qint64 addr;
+        qint32 size;
+        in >> addr >> size;
+
+        if (size <= 0) {
+            throw corrupted();
+        }
+        result->instructionRanges_.push_back(std::make_pair(addr, size));
+    }
+
+    if (!result->instructionRanges_.empty() && !image->platform().architecture()) {
+        throw corrupted();
+    }
+
+    /* Functions. */
+    quint32 selectedCount;
+    in >> selectedCount;
+    for (quint32 i = 0; i < selectedCount && in.status() == QDataStream::Ok; ++i) {
+        qint64 entry;
+        in >> entry;
+        result->selectedFunctions_.push_back(entry);
+    }
+
+    qint32 depth;
+    in >> depth;
+    result->depth_ = depth;
+
+    /* Generated code. */
+    in >> result->code_ >> result->options_;
+
+    if (in.status() != QDataStream::Ok) {
+        throw corrupted();
+    }
+
+    return result;
+}
+
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
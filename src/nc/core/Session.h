@@ -0,0 +1,233 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QString>
+#include <QStringList>
+
+#include <nc/common/Types.h>
+
+namespace nc {
+namespace core {
+
+namespace arch {
+    class Instructions;
+}
+
+namespace image {
+    class Image;
+}
+
+class Context;
+
+/**
+ * Saved state of a decompilation session.
+ *
+ * A session stores the image (sections, symbols, relocations), the
+ * addresses of the disassembled instructions, the functions they were
+ * disassembled for, and the generated C++ code together with the options
+ * it was generated with. It is keyed by a hash of the input files'
+ * contents, so that a session saved for different inputs can be detected.
+ *
+ * The results of the analyses (functions, signatures, types, the syntax
+ * tree) are not stored: restoring a session gives the image and the
+ * instructions, and decompilation starts over from them. The generated
+ * code can only be printed as is.
+ *
+ * The on-disk format is versioned. Loading a session maps the file into
+ * memory, and the contents of the sections are read directly from the
+ * mapping. Instructions are decoded from the mapped sections only when
+ * they are asked for, so that reusing the saved code costs no decoding.
+ */
+class Session {
+    Q_DECLARE_TR_FUNCTIONS(Session)
+
+    QStringList inputFiles_; ///< Names of the input files.
+    QByteArray inputHash_; ///< Hash of the contents of the input files.
+    std::shared_ptr<image::Image> image_; ///< Executable image.
+    std::vector<std::pair<ByteAddr, SmallByteSize>> instructionRanges_; ///< Addresses and sizes of the instructions.
+    mutable std::shared_ptr<const arch::Instructions> instructions_; ///< Disassembled instructions, decoded lazily.
+    std::vector<ByteAddr> selectedFunctions_; ///< Entries of the selected functions.
+    int depth_; ///< Call depth the selected functions were disassembled with.
+    QString code_; ///< Generated C++ code.
+    QStringList options_; ///< Options affecting the output the code was generated with.
+
+public:
+    /**
+     * Version of the on-disk format. Sessions with other versions are rejected.
+     */
+    static const quint32 FORMAT_VERSION = 3;
+
+    /**
+     * Constructs an empty session.
+     */
+    Session();
+
+    /**
+     * Destructor.
+     */
+    ~Session();
+
+    /**
+     * Computes the hash of the contents of the given files.
+     *
+     * \param filenames Names of the files.
+     *
+     * \return The hash.
+     */
+    static QByteArray hashFiles(const QStringList &filenames);
+
+    /**
+     * \return Names of the input files.
+     */
+    const QStringList &inputFiles() const { return inputFiles_; }
+
+    /**
+     * \return Hash of the contents of the input files.
+     */
+    const QByteArray &inputHash() const { return inputHash_; }
+
+    /**
+     * Sets the names of the input files and computes the hash of their contents.
+     *
+     * \param filenames Names of the files.
+     */
+    void setInputFiles(const QStringList &filenames);
+
+    /**
+     * \param filenames Names of the input files.
+     *
+     * \return True if the session was saved for the files with the same contents.
+     */
+    bool matches(const QStringList &filenames) const { return hashFiles(filenames) == inputHash_; }
+
+    /**
+     * \return Pointer to the executable image. Can be nullptr.
+     */
+    const std::shared_ptr<image::Image> &image() const { return image_; }
+
+    /**
+     * \return True if the session contains disassembled instructions.
+     */
+    bool hasInstructions() const { return !instructionRanges_.empty(); }
+
+    /**
+     * Decodes the instructions from the image on the first call.
+     *
+     * \return Pointer to the disassembled instructions. Can be nullptr.
+     *
+     * \throws nc::Exception If the saved instructions do not match the image.
+     */
+    const std::shared_ptr<const arch::Instructions> &instructions() const;
+
+    /**
+     * \return Entries of the functions selected for decompilation.
+     *         Empty vector means all functions.
+     */
+    const std::vector<ByteAddr> &selectedFunctions() const { return selectedFunctions_; }
+
+    /**
+     * \return Call depth the selected functions were disassembled with.
+     */
+    int depth() const { return depth_; }
+
+    /**
+     * Sets the call depth the selected functions were disassembled with.
+     * The depth is a part of the key under which the instructions are reused.
+     *
+     * \param depth Call depth.
+     */
+    void setDepth(int depth) { depth_ = depth; }
+
+    /**
+     * \param functions Entries of the functions to decompile. Empty vector means all functions.
+     * \param depth Call depth to disassemble the functions with.
+     *
+     * \return True if the saved instructions were disassembled for
+     *         the same functions and depth and can be reused.
+     */
+    bool isReusableFor(const std::vector<ByteAddr> &functions, int depth) const {
+        return hasInstructions() && selectedFunctions_ == functions && (functions.empty() || depth_ == depth);
+    }
+
+    /**
+     * \param functions Entries of the functions to decompile. Empty vector means all functions.
+     * \param depth Call depth to disassemble the functions with.
+     * \param options Options affecting the output, as given to setOptions().
+     *
+     * \return True if the saved code was generated for the same functions,
+     *         depth, and options and can be printed instead of decompiling.
+     */
+    bool isCodeReusableFor(const std::vector<ByteAddr> &functions, int depth, const QStringList &options) const {
+        return isReusableFor(functions, depth) && !code_.isEmpty() && options_ == options;
+    }
+
+    /**
+     * \return Generated C++ code. Empty if decompilation was not done.
+     */
+    const QString &code() const { return code_; }
+
+    /**
+     * \return Options affecting the output the code was generated with.
+     */
+    const QStringList &options() const { return options_; }
+
+    /**
+     * Sets the options affecting the output the code was generated with:
+     * signature databases, function caches, and the limits of the analyses.
+     * The session stores them and compares them as a whole, so the caller
+     * decides on their format. Empty list means the default options.
+     *
+     * \param options Options.
+     */
+    void setOptions(const QStringList &options) { options_ = options; }
+
+    /**
+     * Captures the state of the given context.
+     *
+     * \param context Context.
+     */
+    void capture(const Context &context);
+
+    /**
+     * Sets the image, the instructions and the selected functions
+     * of the given context to the ones stored in the session.
+     *
+     * \param context Context.
+     */
+    void restore(Context &context) const;
+
+    /**
+     * Saves the session to a file.
+     *
+     * \param filename Name of the file.
+     *
+     * \throws nc::Exception If the file could not be written.
+     */
+    void save(const QString &filename) const;
+
+    /**
+     * Loads a session from a file.
+     *
+     * \param filename Name of the file.
+     *
+     * \return Valid pointer to the loaded session.
+     *
+     * \throws nc::Exception If the file could not be read or has a wrong format.
+     */
+    static std::unique_ptr<Session> load(const QString &filename);
+};
+
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,304 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "SignatureDatabase.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring> /* memchr */
+#include <map>
+
+#include <QtEndian>
+
+#include <nc/common/Exception.h>
+#include <nc/common/Foreach.h>
+
+namespace nc {
+namespace core {
+
+namespace {
+
+/** Magic number the file starts with: "NCSD". */
+const quint32 MAGIC = 0x4453434e;
+
+/** Size of the header: magic, version, number of entries, offsets of the three tables. */
+const std::size_t HEADER_SIZE = 6 * 4;
+
+/**
+ * Size of an entry record: offsets of the function name, the DLL name, and
+ * the convention name, index of the first location, number of arguments,
+ * flags, and size of the arguments popped by the callee.
+ */
+const std::size_t ENTRY_SIZE = 7 * 4;
+
+/** Size of a location record: domain, size in bits, and address in bits. */
+const std::size_t LOCATION_SIZE = 4 + 4 + 8;
+
+/** Entry flags. */
+enum {
+    VARIADIC = 1,          ///< The function is variadic.
+    RETURN_VALUE = 2,      ///< The first location of the entry is the return value.
+    RETURN_VALUE_HIGH = 4  ///< The location after the return value is the high half of it.
+};
+
+quint32 readUInt32(const uchar *data) {
+    return qFromLittleEndian<quint32>(data);
+}
+
+void appendUInt32(QByteArray &out, quint32 value) {
+    uchar bytes[4];
+    qToLittleEndian(value, bytes);
+    out.append(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+}
+
+void appendInt64(QByteArray &out, qint64 value) {
+    uchar bytes[8];
+    qToLittleEndian(value, bytes);
+    out.append(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+}
+
+/**
+ * Compares the keys of two entries.
+ *
+ * \return Negative, zero, or positive value when the first key
+ *         is less than, equal to, or greater than the second one.
+ */
+int compareKeys(const char *name1, const char *dll1, const char *name2, const char *dll2) {
+    if (int result = qstrcmp(name1, name2)) {
+        return result;
+    }
+    return qstrcmp(dll1, dll2);
+}
+
+} // anonymous namespace
+
+SignatureDatabase::SignatureDatabase(const QString &filename):
+    file_(filename), data_(nullptr), size_(0), entryCount_(0), entriesOffset_(0), locationsOffset_(0), stringsOffset_(0)
+{
+    if (!file_.open(QIODevice::ReadOnly)) {
+        throw nc::Exception(tr("Could not open file \"%1\" for reading.").arg(filename));
+    }
+
+    size_ = static_cast<std::size_t>(file_.size());
+    data_ = file_.map(0, file_.size());
+    if (!data_) {
+        buffer_ = file_.readAll();
+        data_ = reinterpret_cast<const uchar *>(buffer_.constData());
+        size_ = buffer_.size();
+    }
+
+    if (size_ < HEADER_SIZE || readUInt32(data_) != MAGIC) {
+        throw nc::Exception(tr("File \"%1\" is not a signature database.").arg(filename));
+    }
+    if (readUInt32(data_ + 4) != FORMAT_VERSION) {
+        throw nc::Exception(tr("Signature database \"%1\" has unsupported version %2.")
+            .arg(filename).arg(readUInt32(data_ + 4)));
+    }
+
+    entryCount_ = readUInt32(data_ + 8);
+    entriesOffset_ = readUInt32(data_ + 12);
+    locationsOffset_ = readUInt32(data_ + 16);
+    stringsOffset_ = readUInt32(data_ + 20);
+
+    if (entriesOffset_ < HEADER_SIZE ||
+        static_cast<quint64>(entriesOffset_) + static_cast<quint64>(entryCount_) * ENTRY_SIZE > locationsOffset_ ||
+        locationsOffset_ > stringsOffset_ ||
+        stringsOffset_ > size_)
+    {
+        throw nc::Exception(tr("Signature database \"%1\" is corrupted.").arg(filename));
+    }
+}
+
+boost::optional<SignatureDatabase::Entry> SignatureDatabase::lookup(const QString &name, const QString &dll) const {
+    auto nameBytes = name.toUtf8();
+    auto dllBytes = dll.toLower().toUtf8();
+
+    auto hasName = [&](std::size_t index) {
+        return index < entryCount_ && qstrcmp(getString(readUInt32(getEntryRecord(index))), nameBytes.constData()) == 0;
+    };
+    auto getDll = [&](std::size_t index) {
+        return getString(readUInt32(getEntryRecord(index) + 4));
+    };
+
+    /* Entries with the same name are adjacent, the one without a DLL goes first. */
+    auto index = findFirst(nameBytes.constData(), dllBytes.constData());
+    if (hasName(index) && (dllBytes.isEmpty() || qstrcmp(getDll(index), dllBytes.constData()) == 0)) {
+        return readEntry(index);
+    }
+
+    /* Fall back to the entry not bound to a DLL. */
+    if (!dllBytes.isEmpty()) {
+        index = findFirst(nameBytes.constData(), "");
+        if (hasName(index) && qstrcmp(getDll(index), "") == 0) {
+            return readEntry(index);
+        }
+    }
+
+    return boost::none;
+}
+
+std::size_t SignatureDatabase::findFirst(const char *name, const char *dll) const {
+    std::size_t first = 0;
+    std::size_t count = entryCount_;
+
+    while (count > 0) {
+        auto half = count / 2;
+        auto record = getEntryRecord(first + half);
+        auto entryName = getString(readUInt32(record));
+        auto entryDll = getString(readUInt32(record + 4));
+
+        if (entryName && entryDll && compareKeys(entryName, entryDll, name, dll) < 0) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+
+    return first;
+}
+
+const uchar *SignatureDatabase::getEntryRecord(std::size_t index) const {
+    assert(index < entryCount_);
+    return data_ + entriesOffset_ + index * ENTRY_SIZE;
+}
+
+const char *SignatureDatabase::getString(quint32 offset) const {
+    if (offset >= size_ - stringsOffset_) {
+        return nullptr;
+    }
+    auto string = data_ + stringsOffset_ + offset;
+    if (!memchr(string, 0, size_ - stringsOffset_ - offset)) {
+        return nullptr;
+    }
+    return reinterpret_cast<const char *>(string);
+}
+
+boost::optional<SignatureDatabase::Entry> SignatureDatabase::readEntry(std::size_t index) const {
+    auto record = getEntryRecord(index);
+
+    auto name = getString(readUInt32(record));
+    auto dll = getString(readUInt32(record + 4));
+    auto convention = getString(readUInt32(record + 8));
+    quint64 firstLocation = readUInt32(record + 12);
+    quint64 argumentCount = readUInt32(record + 16);
+    auto flags = readUInt32(record + 20);
+    auto stackArgumentsSize = readUInt32(record + 24);
+
+    quint64 locationCount = argumentCount + ((flags & RETURN_VALUE) ? 1 : 0) + ((flags & RETURN_VALUE_HIGH) ? 1 : 0);
+    if (!name || !dll || !convention ||
+        firstLocation + locationCount > (stringsOffset_ - locationsOffset_) / LOCATION_SIZE)
+    {
+        return boost::none;
+    }
+
+    auto readLocation = [&](quint64 location) {
+        auto locationRecord = data_ + locationsOffset_ + location * LOCATION_SIZE;
+        return ir::MemoryLocation(
+            static_cast<ir::Domain>(qFromLittleEndian<qint32>(locationRecord)),
+            qFromLittleEndian<qint64>(locationRecord + 8),
+            readUInt32(locationRecord + 4));
+    };
+
+    Entry entry;
+    entry.name = QString::fromUtf8(name);
+    entry.dll = QString::fromUtf8(dll);
+    entry.convention = QString::fromUtf8(convention);
+    entry.variadic = flags & VARIADIC;
+    entry.stackArgumentsSize = stackArgumentsSize;
+
+    if (flags & RETURN_VALUE) {
+        entry.returnValue = readLocation(firstLocation++);
+    }
+    if (flags & RETURN_VALUE_HIGH) {
+        entry.returnValueHigh = readLocation(firstLocation++);
+    }
+    entry.arguments.reserve(argumentCount);
+    for (quint64 i = 0; i < argumentCount; ++i) {
+        entry.arguments.push_back(readLocation(firstLocation + i));
+    }
+
+    return entry;
+}
+
+void SignatureDatabase::write(const QString &filename, std::vector<Entry> entries) {
+    foreach (auto &entry, entries) {
+        entry.dll = entry.dll.toLower();
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return compareKeys(a.name.toUtf8().constData(), a.dll.toUtf8().constData(),
+                           b.name.toUtf8().constData(), b.dll.toUtf8().constData()) < 0;
+    });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.name == b.name && a.dll == b.dll;
+    }), entries.end());
+
+    QByteArray records;
+    QByteArray locations;
+    QByteArray strings(1, '\0');
+    std::map<QByteArray, quint32> string2offset;
+    string2offset[QByteArray()] = 0;
+
+    auto addString = [&](const QString &string) -> quint32 {
+        auto bytes = string.toUtf8();
+        auto i = string2offset.find(bytes);
+        if (i != string2offset.end()) {
+            return i->second;
+        }
+        quint32 offset = strings.size();
+        strings.append(bytes).append('\0');
+        string2offset[bytes] = offset;
+        return offset;
+    };
+
+    auto addLocation = [&](const ir::MemoryLocation &location) {
+        appendUInt32(locations, static_cast<quint32>(location.domain()));
+        appendUInt32(locations, static_cast<quint32>(location.size()));
+        appendInt64(locations, location.addr());
+    };
+
+    foreach (const auto &entry, entries) {
+        appendUInt32(records, addString(entry.name));
+        appendUInt32(records, addString(entry.dll));
+        appendUInt32(records, addString(entry.convention));
+        appendUInt32(records, locations.size() / LOCATION_SIZE);
+        appendUInt32(records, entry.arguments.size());
+        appendUInt32(records, (entry.variadic ? VARIADIC : 0) | (entry.returnValue ? RETURN_VALUE : 0) |
+                              (entry.returnValue && entry.returnValueHigh ? RETURN_VALUE_HIGH : 0));
+        appendUInt32(records, entry.stackArgumentsSize);
+
+        if (entry.returnValue) {
+            addLocation(entry.returnValue);
+            if (entry.returnValueHigh) {
+                addLocation(entry.returnValueHigh);
+            }
+        }
+        foreach (const auto &argument, entry.arguments) {
+            addLocation(argument);
+        }
+    }
+
+    QByteArray header;
+    appendUInt32(header, MAGIC);
+    appendUInt32(header, FORMAT_VERSION);
+    appendUInt32(header, entries.size());
+    appendUInt32(header, HEADER_SIZE);
+    appendUInt32(header, HEADER_SIZE + records.size());
+    appendUInt32(header, HEADER_SIZE + records.size() + locations.size());
+
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        file.write(header) != header.size() ||
+        file.write(records) != records.size() ||
+        file.write(locations) != locations.size() ||
+        file.write(strings) != strings.size())
+    {
+        throw nc::Exception(tr("Could not write file \"%1\".").arg(filename));
+    }
+}
+
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,152 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+#include <vector>
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QFile>
+#include <QString>
+
+#include <boost/optional.hpp>
+
+#include <nc/common/Types.h>
+#include <nc/core/ir/MemoryLocation.h>
+
+namespace nc {
+namespace core {
+
+/**
+ * Read-only database of signatures of well-known library functions,
+ * e.g. of the C library or the Windows API.
+ *
+ * Entries are identified by the name of the function and, for functions
+ * imported from Windows DLLs, by the lowercased name of the DLL. An entry
+ * gives the calling convention of the function and the memory locations
+ * of its arguments and return value under this convention.
+ *
+ * The database is a single file, mapped into memory when possible.
+ * All the numbers in it are little-endian. The file starts with a header:
+ * magic, format version, number of entries, and offsets of the entry table,
+ * the location table, and the string table. Entries are fixed-size records
+ * sorted by name and DLL name, so that lookup is a binary search working
+ * directly on the mapped bytes. Strings are zero-terminated UTF-8.
+ *
+ * The class is thread-safe.
+ */
+class SignatureDatabase {
+    Q_DECLARE_TR_FUNCTIONS(SignatureDatabase)
+
+public:
+    /**
+     * Signature of a function.
+     */
+    class Entry {
+    public:
+        QString name; ///< Name of the function.
+        QString dll; ///< Lowercased name of the DLL exporting the function. Can be empty.
+        QString convention; ///< Name of the calling convention.
+        std::vector<ir::MemoryLocation> arguments; ///< Memory locations of the arguments.
+        ir::MemoryLocation returnValue; ///< Memory location of the return value.
+        ir::MemoryLocation returnValueHigh; ///< Memory location of the high half of the return value, if it is returned in a pair of registers.
+        bool variadic; ///< True if the function is variadic.
+        ByteSize stackArgumentsSize; ///< Size of the arguments popped by the callee, or zero.
+
+        Entry(): variadic(false), stackArgumentsSize(0) {}
+    };
+
+    /**
+     * Version of the file format. Files with other versions are rejected.
+     */
+    static const quint32 FORMAT_VERSION = 1;
+
+private:
+    QFile file_; ///< Database file.
+    QByteArray buffer_; ///< Contents of the file, if it could not be mapped.
+    const uchar *data_; ///< Contents of the file.
+    std::size_t size_; ///< Size of the file.
+    std::size_t entryCount_; ///< Number of entries.
+    std::size_t entriesOffset_; ///< Offset of the entry table.
+    std::size_t locationsOffset_; ///< Offset of the location table.
+    std::size_t stringsOffset_; ///< Offset of the string table.
+
+public:
+    /**
+     * Opens a database.
+     *
+     * \param filename Name of the database file.
+     *
+     * \throws nc::Exception If the file could not be read or is not a valid database.
+     */
+    explicit SignatureDatabase(const QString &filename);
+
+    /**
+     * \return Number of entries.
+     */
+    std::size_t size() const { return entryCount_; }
+
+    /**
+     * Looks up the signature of a function.
+     *
+     * \param name Name of the function.
+     * \param dll Name of the DLL exporting the function, or empty string
+     *            if the function is not imported from a DLL.
+     *
+     * \return The entry with the given function and DLL names or, if there is
+     *         none, the entry with the given function name and no DLL name.
+     *         When the DLL name is empty, any entry with the given function
+     *         name is acceptable. DLL names are compared case-insensitively.
+     */
+    boost::optional<Entry> lookup(const QString &name, const QString &dll = QString()) const;
+
+    /**
+     * Writes a database file.
+     *
+     * \param filename Name of the file.
+     * \param entries Entries to write. If several entries have the same
+     *                function and DLL names, the first one is kept.
+     *
+     * \throws nc::Exception If the file could not be written.
+     */
+    static void write(const QString &filename, std::vector<Entry> entries);
+
+private:
+    /**
+     * \param name Name of a function in UTF-8.
+     * \param dll Lowercased name of a DLL in UTF-8.
+     *
+     * \return Index of the first entry whose key is not less than the given one.
+     */
+    std::size_t findFirst(const char *name, const char *dll) const;
+
+    /**
+     * \param index Index of an entry.
+     *
+     * \return Pointer to the record of the entry.
+     */
+    const uchar *getEntryRecord(std::size_t index) const;
+
+    /**
+     * \param offset Offset of a string in the string table.
+     *
+     * \return Pointer to the string, or nullptr if the offset is invalid.
+     */
+    const char *getString(quint32 offset) const;
+
+    /**
+     * \param index Index of an entry.
+     *
+     * \return The entry, if it is well-formed.
+     */
+    boost::optional<Entry> readEntry(std::size_t index) const;
+};
+
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
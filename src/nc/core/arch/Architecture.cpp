@@ -89,6 +89,18 @@ void Architecture::addCallingConvention(std::unique_ptr<ir::calling::Convention>
     conventions_.push_back(std::move(convention));
 }
 
+void Architecture::addFlag(const Register *flag) {
+    assert(flag != nullptr);
+
+    mFlags.push_back(flag);
+}
+
+void Architecture::addTemporary(const Register *temporary) {
+    assert(temporary != nullptr);
+
+    mTemporaries.push_back(temporary);
+}
+
 const ir::calling::Convention *Architecture::getCallingConvention(const QString &name) const {
     foreach (auto convention, conventions()) {
         if (convention->name() == name) {
@@ -136,6 +136,23 @@ public:
      */
     const ir::calling::Convention *getCallingConvention(const QString &name) const;
 
+    /**
+     * Condition flags are written by most arithmetic instructions and read
+     * by few. Writes to them that are never read are removed right after
+     * generating the intermediate representation.
+     *
+     * \return List of the registers holding condition flags.
+     */
+    const std::vector<const Register *> &flags() const { return mFlags; }
+
+    /**
+     * Temporary registers hold intermediate values within the semantics
+     * of a single instruction and are never live across instructions.
+     *
+     * \return List of the temporary registers.
+     */
+    const std::vector<const Register *> &temporaries() const { return mTemporaries; }
+
 protected:
     /**
      * Sets the name of the architecture.
@@ -175,6 +192,20 @@ protected:
      */
     void addCallingConvention(std::unique_ptr<ir::calling::Convention> convention);
 
+    /**
+     * Adds a register to the list of condition flags.
+     *
+     * \param flag Valid pointer to the register.
+     */
+    void addFlag(const Register *flag);
+
+    /**
+     * Adds a register to the list of temporary registers.
+     *
+     * \param temporary Valid pointer to the register.
+     */
+    void addTemporary(const Register *temporary);
+
 private:
     /** Name of the architecture. */
     QString mName;
@@ -193,6 +224,12 @@ private:
 
     /** Calling conventions. */
     std::vector<std::unique_ptr<ir::calling::Convention>> conventions_;
+
+    /** Registers holding condition flags. */
+    std::vector<const Register *> mFlags;
+
+    /** Temporary registers. */
+    std::vector<const Register *> mTemporaries;
 };
 
 } // namespace arch
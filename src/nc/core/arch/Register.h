@@ -28,6 +28,7 @@
 #include <boost/noncopyable.hpp>
 #include <QString>
 #include <nc/core/ir/MemoryLocation.h>
+#include <nc/core/ir/MemoryLocationHandle.h>
 
 namespace nc { namespace core { namespace arch {
 
@@ -35,6 +36,8 @@ namespace nc { namespace core { namespace arch {
  * Register.
  * 
  * Registers are immutable.
+ * The memory location of a register is interned in the SharedMemoryLocationTable
+ * once, so that accesses to the register are created without looking it up.
  */
 class Register: public boost::noncopyable {
 public:
@@ -49,7 +52,7 @@ public:
         number_(number),
         lowercaseName_(name.toLower()),
         uppercaseName_(name.toUpper()),
-        memoryLocation_(memoryLocation)
+        memoryLocation_(ir::SharedMemoryLocationTable::instance().intern(memoryLocation))
     {
         assert(number >= 0);
     }
@@ -72,7 +75,12 @@ public:
     /**
      * \return                         Corresponding abstract memory location of the register.
      */
-    const ir::MemoryLocation &memoryLocation() const { return memoryLocation_; }
+    const ir::MemoryLocation &memoryLocation() const { return ir::SharedMemoryLocationTable::instance().get(memoryLocation_); }
+
+    /**
+     * \return                         Handle of the memory location of the register in the SharedMemoryLocationTable.
+     */
+    ir::MemoryLocationHandle memoryLocationHandle() const { return memoryLocation_; }
 
     /**
      * \return Register size in bits.
@@ -83,7 +91,7 @@ private:
     int number_; ///< Register number.
     QString lowercaseName_; ///< Lowercase register name.
     QString uppercaseName_; ///< Uppercase register name.
-    ir::MemoryLocation memoryLocation_; ///< Corresponding abstract memory location of the register.
+    ir::MemoryLocationHandle memoryLocation_; ///< Handle of the corresponding abstract memory location of the register.
 };
 
 }}} // namespace nc::core::arch
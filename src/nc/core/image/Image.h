@@ -162,6 +162,13 @@ public:
      */
     const Relocation *addRelocation(std::unique_ptr<Relocation> relocation);
 
+    /**
+     * \return List of all relocations.
+     */
+    const std::vector<const Relocation *> &relocations() const {
+        return reinterpret_cast<const std::vector<const Relocation *> &>(relocations_);
+    }
+
     /**
      * \param address Virtual address.
      *
@@ -69,6 +69,7 @@ private:
     QString name_; ///< Name of the symbol.
     boost::optional<ConstantValue> value_; ///< Value of the symbol.
     const Section *section_; ///< Section referenced by the symbol.
+    QString library_; ///< Name of the library the symbol is imported from.
 
 public:
     /**
@@ -78,9 +79,11 @@ public:
      * \param name Name of the symbol.
      * \param value Value of the symbol.
      * \param section Pointer to the section referenced by the symbol.
+     * \param library Name of the library the symbol is imported from, if known.
      */
-    Symbol(SymbolType type, QString name, const boost::optional<ConstantValue> &value, const Section *section = nullptr):
-        type_(type), name_(std::move(name)), value_(value), section_(section)
+    Symbol(SymbolType type, QString name, const boost::optional<ConstantValue> &value, const Section *section = nullptr,
+           QString library = QString()):
+        type_(type), name_(std::move(name)), value_(value), section_(section), library_(std::move(library))
     {}
 
     /**
@@ -102,6 +105,12 @@ public:
      * \return Pointer to the section references by the symbol. Can be nullptr.
      */
     const Section *section() const { return section_; }
+
+    /**
+     * \return Name of the library the symbol is imported from, e.g. "KERNEL32.dll".
+     *         Empty string if unknown.
+     */
+    const QString &library() const { return library_; }
 };
 
 } // namespace image
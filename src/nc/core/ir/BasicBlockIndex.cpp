@@ -0,0 +1,158 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "BasicBlockIndex.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <nc/common/Unused.h>
+
+#include "BasicBlock.h"
+
+namespace nc {
+namespace core {
+namespace ir {
+
+void BasicBlockIndex::insert(BasicBlock *basicBlock) {
+    assert(basicBlock != nullptr);
+    assert(basicBlock->address() && basicBlock->successorAddress() && "Basic block must be memory-bound.");
+    assert(getBasicBlockStartingAt(*basicBlock->address()) == nullptr);
+
+    Entry entry(*basicBlock->address(), *basicBlock->successorAddress(), basicBlock);
+
+    /*
+     * Merging costs O(n), inserting into the buffer O(buffer size).
+     * A buffer of O(sqrt(n)) entries balances the two.
+     */
+    auto maxRecentEntries = std::max<std::size_t>(64, static_cast<std::size_t>(std::sqrt(static_cast<double>(entries_.size()))));
+
+    if (recentEntries_.size() >= maxRecentEntries) {
+        flush();
+    }
+
+    recentEntries_.insert(std::upper_bound(recentEntries_.begin(), recentEntries_.end(), entry), entry);
+}
+
+void BasicBlockIndex::update(const BasicBlock *basicBlock) {
+    assert(basicBlock != nullptr);
+    assert(basicBlock->address() && basicBlock->successorAddress() && "Basic block must be memory-bound.");
+
+    auto update = [&](std::vector<Entry> &entries) -> bool {
+        auto index = findStartingAt(entries, *basicBlock->address());
+        if (index != entries.size()) {
+            assert(entries[index].basicBlock == basicBlock);
+            entries[index].end = *basicBlock->successorAddress();
+            return true;
+        }
+        return false;
+    };
+
+    if (!update(recentEntries_)) {
+        bool updated = update(entries_);
+        assert(updated && "Basic block must be in the index.");
+        NC_UNUSED(updated);
+    }
+}
+
+void BasicBlockIndex::erase(const BasicBlock *basicBlock) {
+    assert(basicBlock != nullptr);
+    assert(basicBlock->address() && "Basic block must be memory-bound.");
+
+    auto erase = [&](std::vector<Entry> &entries) -> bool {
+        auto index = findStartingAt(entries, *basicBlock->address());
+        if (index != entries.size()) {
+            assert(entries[index].basicBlock == basicBlock);
+            entries.erase(entries.begin() + index);
+            return true;
+        }
+        return false;
+    };
+
+    if (!erase(recentEntries_)) {
+        bool erased = erase(entries_);
+        assert(erased && "Basic block must be in the index.");
+        NC_UNUSED(erased);
+    }
+}
+
+void BasicBlockIndex::erase(const boost::unordered_set<const BasicBlock *> &basicBlocks) {
+    auto erase = [&](std::vector<Entry> &entries) {
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const Entry &entry) -> bool {
+            return basicBlocks.find(entry.basicBlock) != basicBlocks.end();
+        }), entries.end());
+    };
+
+    auto oldSize = size();
+
+    erase(entries_);
+    erase(recentEntries_);
+
+    assert(oldSize - size() == basicBlocks.size() && "Basic blocks must be in the index.");
+    NC_UNUSED(oldSize);
+}
+
+BasicBlock *BasicBlockIndex::getBasicBlockStartingAt(ByteAddr address) const {
+    auto index = findStartingAt(entries_, address);
+    if (index != entries_.size()) {
+        return entries_[index].basicBlock;
+    }
+    index = findStartingAt(recentEntries_, address);
+    if (index != recentEntries_.size()) {
+        return recentEntries_[index].basicBlock;
+    }
+    return nullptr;
+}
+
+BasicBlock *BasicBlockIndex::getBasicBlockCovering(ByteAddr address) const {
+    if (auto entry = findCovering(entries_, address)) {
+        return entry->basicBlock;
+    }
+    if (auto entry = findCovering(recentEntries_, address)) {
+        return entry->basicBlock;
+    }
+    return nullptr;
+}
+
+void BasicBlockIndex::flush() {
+    if (recentEntries_.empty()) {
+        return;
+    }
+
+    auto middle = entries_.size();
+    entries_.insert(entries_.end(), recentEntries_.begin(), recentEntries_.end());
+    std::inplace_merge(entries_.begin(), entries_.begin() + middle, entries_.end());
+
+    recentEntries_.clear();
+}
+
+std::size_t BasicBlockIndex::findStartingAt(const std::vector<Entry> &entries, ByteAddr address) {
+    auto i = std::lower_bound(entries.begin(), entries.end(), address, [](const Entry &entry, ByteAddr address) {
+        return entry.start < address;
+    });
+    if (i != entries.end() && i->start == address) {
+        return static_cast<std::size_t>(i - entries.begin());
+    }
+    return entries.size();
+}
+
+const BasicBlockIndex::Entry *BasicBlockIndex::findCovering(const std::vector<Entry> &entries, ByteAddr address) {
+    /* Basic blocks do not overlap: only the last one starting at or before the address can cover it. */
+    auto i = std::upper_bound(entries.begin(), entries.end(), address, [](ByteAddr address, const Entry &entry) {
+        return address < entry.start;
+    });
+    if (i != entries.begin()) {
+        --i;
+        if (address < i->end) {
+            return &*i;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
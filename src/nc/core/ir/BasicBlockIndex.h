@@ -0,0 +1,128 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/unordered_set.hpp>
+
+#include <nc/common/Types.h>
+
+namespace nc {
+namespace core {
+namespace ir {
+
+class BasicBlock;
+
+/**
+ * Index of memory-bound basic blocks by their address ranges.
+ *
+ * Basic blocks of a program do not overlap, so the index is just a vector of
+ * address ranges sorted by their start addresses. Insertions go to a small
+ * sorted buffer, which is merged into the main vector once it grows large
+ * enough. Lookups are binary searches in both vectors. Compared to a
+ * node-based map, this needs no allocations per basic block and touches
+ * much less memory.
+ */
+class BasicBlockIndex {
+    /**
+     * Address range of a basic block.
+     */
+    class Entry {
+    public:
+        ByteAddr start; ///< Address of the basic block.
+        ByteAddr end; ///< Successor address of the basic block.
+        BasicBlock *basicBlock; ///< The basic block.
+
+        Entry(ByteAddr start, ByteAddr end, BasicBlock *basicBlock):
+            start(start), end(end), basicBlock(basicBlock)
+        {}
+
+        bool operator<(const Entry &that) const { return start < that.start; }
+    };
+
+    std::vector<Entry> entries_; ///< Entries sorted by start address.
+    std::vector<Entry> recentEntries_; ///< Recently inserted entries, sorted by start address.
+
+public:
+    /**
+     * Adds a memory-bound basic block to the index.
+     * No basic block starting at the same address must be in the index.
+     *
+     * \param basicBlock Valid pointer to a memory-bound basic block.
+     */
+    void insert(BasicBlock *basicBlock);
+
+    /**
+     * Updates the end of the address range of a basic block in the index
+     * after the basic block's successor address has been changed.
+     *
+     * \param basicBlock Valid pointer to a memory-bound basic block in the index.
+     */
+    void update(const BasicBlock *basicBlock);
+
+    /**
+     * Removes a basic block from the index.
+     *
+     * \param basicBlock Valid pointer to a memory-bound basic block in the index.
+     */
+    void erase(const BasicBlock *basicBlock);
+
+    /**
+     * Removes a set of basic blocks from the index in a single pass.
+     *
+     * \param basicBlocks Valid pointers to memory-bound basic blocks in the index.
+     */
+    void erase(const boost::unordered_set<const BasicBlock *> &basicBlocks);
+
+    /**
+     * \param address Address.
+     *
+     * \return Pointer to the basic block starting at the given address. Can be nullptr.
+     */
+    BasicBlock *getBasicBlockStartingAt(ByteAddr address) const;
+
+    /**
+     * \param address Address.
+     *
+     * \return Pointer to the basic block covering the given address. Can be nullptr.
+     */
+    BasicBlock *getBasicBlockCovering(ByteAddr address) const;
+
+    /**
+     * \return Number of basic blocks in the index.
+     */
+    std::size_t size() const { return entries_.size() + recentEntries_.size(); }
+
+private:
+    /**
+     * Merges the recently inserted entries into the main vector.
+     */
+    void flush();
+
+    /**
+     * \param entries Entries sorted by start address.
+     * \param address Address.
+     *
+     * \return Index of the entry with the given start address, or entries.size() if there is none.
+     */
+    static std::size_t findStartingAt(const std::vector<Entry> &entries, ByteAddr address);
+
+    /**
+     * \param entries Entries sorted by start address.
+     * \param address Address.
+     *
+     * \return Pointer to the entry whose address range includes the given address. Can be nullptr.
+     */
+    static const Entry *findCovering(const std::vector<Entry> &entries, ByteAddr address);
+};
+
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -24,12 +24,15 @@
 
 #include "Function.h"
 
+#include <functional>
+
 #include <QTextStream>
 
 #include <nc/common/Foreach.h>
 
 #include "BasicBlock.h"
 #include "CFG.h"
+#include "Jump.h"
 #include "Statements.h"
 #include "Term.h"
 
@@ -37,7 +40,7 @@ namespace nc {
 namespace core {
 namespace ir {
 
-Function::Function(): entry_(nullptr) {}
+Function::Function(): entry_(nullptr), termCount_(0) {}
 
 Function::~Function() {}
 
@@ -46,6 +49,49 @@ void Function::addBasicBlock(std::unique_ptr<BasicBlock> basicBlock) {
     basicBlocks_.push_back(std::move(basicBlock));
 }
 
+void Function::numberTerms() {
+    std::function<void(Term *)> number = [&](Term *term) {
+        if (term->index() == Term::NO_INDEX) {
+            term->setIndex(termCount_++);
+        }
+        term->callOnChildren(number);
+    };
+
+    /* The function owns its statements and their terms. */
+    auto numberTerm = [&](const Term *term) {
+        if (term) {
+            number(const_cast<Term *>(term));
+        }
+    };
+
+    foreach (auto basicBlock, basicBlocks()) {
+        foreach (auto statement, basicBlock->statements()) {
+            switch (statement->kind()) {
+                case Statement::ASSIGNMENT:
+                    numberTerm(statement->asAssignment()->left());
+                    numberTerm(statement->asAssignment()->right());
+                    break;
+                case Statement::JUMP:
+                    numberTerm(statement->asJump()->condition());
+                    numberTerm(statement->asJump()->thenTarget().address());
+                    numberTerm(statement->asJump()->elseTarget().address());
+                    break;
+                case Statement::CALL:
+                    numberTerm(statement->asCall()->target());
+                    break;
+                case Statement::TOUCH:
+                    numberTerm(statement->asTouch()->term());
+                    break;
+                case Statement::REMEMBER_REACHING_DEFINITIONS:
+                    numberTerm(statement->as<RememberReachingDefinitions>()->stackPointer());
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
 bool Function::isEmpty() const {
     foreach (auto basicBlock, basicBlocks()) {
         if (!basicBlock->statements().empty()) {
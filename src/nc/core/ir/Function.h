@@ -26,6 +26,7 @@
 #include <nc/config.h>
 
 #include <cassert>
+#include <cstddef>
 #include <memory>
 
 #include <boost/noncopyable.hpp>
@@ -49,6 +50,7 @@ public:
 private:
     BasicBlock *entry_; ///< Entry basic block.
     BasicBlocks basicBlocks_; ///< All basic blocks of the function.
+    std::size_t termCount_; ///< Number of terms numbered by numberTerms().
 
 public:
     /**
@@ -101,6 +103,19 @@ public:
      */
     void addBasicBlock(std::unique_ptr<BasicBlock> basicBlock);
 
+    /**
+     * Numbers the terms of the function's statements which have not been
+     * numbered yet, continuing the numbering. Terms keep their numbers,
+     * so the numbers of the terms removed from the function are never reused.
+     */
+    void numberTerms();
+
+    /**
+     * \return Number of terms numbered so far, i.e. a bound on Term::index()
+     *         of the numbered terms of this function.
+     */
+    std::size_t termCount() const { return termCount_; }
+
     /**
      * \return True iff this function has no statements in its basic blocks.
      */
@@ -24,6 +24,7 @@
 
 #include "MemoryLocation.h"
 
+#include <QDataStream>
 #include <QTextStream>
 
 namespace nc {
@@ -34,6 +35,25 @@ void MemoryLocation::print(QTextStream &out) const {
     out << "<" << domain_ << ":" << addr_ << ".." << (addr_ + size_ - 1) << ">";
 }
 
+QDataStream &operator<<(QDataStream &out, const MemoryLocation &memoryLocation) {
+    return out << static_cast<qint32>(memoryLocation.domain())
+               << static_cast<qint64>(memoryLocation.addr())
+               << static_cast<qint64>(memoryLocation.size());
+}
+
+QDataStream &operator>>(QDataStream &in, MemoryLocation &memoryLocation) {
+    qint32 domain;
+    qint64 addr, size;
+    in >> domain >> addr >> size;
+
+    if (size > 0) {
+        memoryLocation = MemoryLocation(domain, addr, size);
+    } else {
+        memoryLocation = MemoryLocation();
+    }
+    return in;
+}
+
 } // namespace ir
 } // namespace core
 } // namespace nc
@@ -36,6 +36,10 @@
 
 #include "MemoryDomain.h"
 
+QT_BEGIN_NAMESPACE
+class QDataStream;
+QT_END_NAMESPACE
+
 namespace nc { namespace core { namespace ir {
 
 /**
@@ -240,6 +244,26 @@ inline std::size_t hash_value(const MemoryLocation &value) {
     return std::hash<MemoryLocation>()(value);
 }
 
+/**
+ * Writes a memory location to a data stream.
+ *
+ * \param out Data stream.
+ * \param memoryLocation Memory location, possibly invalid.
+ *
+ * \return out
+ */
+QDataStream &operator<<(QDataStream &out, const MemoryLocation &memoryLocation);
+
+/**
+ * Reads a memory location from a data stream.
+ *
+ * \param in Data stream.
+ * \param memoryLocation Memory location to read into.
+ *
+ * \return in
+ */
+QDataStream &operator>>(QDataStream &in, MemoryLocation &memoryLocation);
+
 }}} // namespace nc::core::ir
 
 /* vim:set et sts=4 sw=4: */
@@ -0,0 +1,94 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "MemoryLocationHandle.h"
+
+#include <QMutexLocker>
+
+#include <nc/common/Exception.h>
+
+namespace nc { namespace core { namespace ir {
+
+MemoryLocationTable::MemoryLocationTable():
+    locations_(1),
+    indices_(0, IndexTraits(&locations_), IndexTraits(&locations_))
+{}
+
+MemoryLocationHandle MemoryLocationTable::intern(const MemoryLocation &memoryLocation) {
+    if (!memoryLocation) {
+        return MemoryLocationHandle();
+    }
+
+    auto i = indices_.find(memoryLocation, IndexTraits(&locations_), IndexTraits(&locations_));
+    if (i != indices_.end()) {
+        return MemoryLocationHandle(*i);
+    }
+
+    assert(locations_.size() < UINT32_MAX);
+
+    auto index = static_cast<std::uint32_t>(locations_.size());
+    locations_.push_back(memoryLocation);
+    indices_.insert(index);
+
+    return MemoryLocationHandle(index);
+}
+
+void MemoryLocationTable::clear() {
+    indices_.clear();
+    locations_.resize(1);
+}
+
+SharedMemoryLocationTable::SharedMemoryLocationTable():
+    size_(1),
+    indices_(0, IndexTraits(this), IndexTraits(this))
+{
+    for (auto &segment : segments_) {
+        segment.store(nullptr, std::memory_order_relaxed);
+    }
+    segments_[0].store(new MemoryLocation[SEGMENT_SIZE], std::memory_order_release);
+}
+
+SharedMemoryLocationTable::~SharedMemoryLocationTable() {
+    for (auto &segment : segments_) {
+        delete[] segment.load(std::memory_order_relaxed);
+    }
+}
+
+SharedMemoryLocationTable &SharedMemoryLocationTable::instance() {
+    static SharedMemoryLocationTable table;
+    return table;
+}
+
+MemoryLocationHandle SharedMemoryLocationTable::intern(const MemoryLocation &memoryLocation) {
+    if (!memoryLocation) {
+        return MemoryLocationHandle();
+    }
+
+    QMutexLocker locker(&mutex_);
+
+    auto i = indices_.find(memoryLocation, IndexTraits(this), IndexTraits(this));
+    if (i != indices_.end()) {
+        return MemoryLocationHandle(*i);
+    }
+
+    if (size_ == SEGMENT_SIZE * SEGMENT_COUNT) {
+        throw nc::Exception("too many distinct memory locations of registers and terms");
+    }
+
+    auto index = size_;
+    auto segment = segments_[index >> SEGMENT_BITS].load(std::memory_order_relaxed);
+    if (!segment) {
+        segment = new MemoryLocation[SEGMENT_SIZE];
+    }
+    segment[index & (SEGMENT_SIZE - 1)] = memoryLocation;
+    segments_[index >> SEGMENT_BITS].store(segment, std::memory_order_release);
+
+    indices_.insert(index);
+    ++size_;
+
+    return MemoryLocationHandle(index);
+}
+
+}}} // namespace nc::core::ir
+
+/* vim:set et sts=4 sw=4: */
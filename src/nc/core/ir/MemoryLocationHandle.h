@@ -0,0 +1,213 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+
+#include <QMutex>
+
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_set.hpp>
+
+#include "MemoryLocation.h"
+
+namespace nc { namespace core { namespace ir {
+
+/**
+ * Compact handle of a memory location interned in a MemoryLocationTable
+ * or in the SharedMemoryLocationTable.
+ *
+ * A handle is the 32-bit index of the location in the table, so it is
+ * a sixth of the size of the memory location itself. Every distinct
+ * location is stored in a table once; therefore, two handles obtained
+ * from the same table are equal if and only if their locations are equal.
+ * Index 0 is reserved for the invalid memory location, so that
+ * a default-constructed handle refers to MemoryLocation() in every table.
+ */
+class MemoryLocationHandle {
+    std::uint32_t index_; ///< Index of the memory location in its table.
+
+    friend class MemoryLocationTable;
+    friend class SharedMemoryLocationTable;
+
+    /**
+     * Constructs a handle of an interned memory location.
+     *
+     * \param index Index of the memory location in its table.
+     */
+    explicit MemoryLocationHandle(std::uint32_t index): index_(index) {}
+
+public:
+    /**
+     * Constructs a handle of the invalid memory location.
+     */
+    MemoryLocationHandle(): index_(0) {}
+
+    /**
+     * \return Index of the memory location in its table.
+     */
+    std::uint32_t index() const { return index_; }
+
+    /**
+     * \return True if the handle references a valid memory location.
+     */
+    explicit operator bool() const { return index_ != 0; }
+
+    bool operator==(const MemoryLocationHandle &that) const { return index_ == that.index_; }
+    bool operator!=(const MemoryLocationHandle &that) const { return index_ != that.index_; }
+};
+
+/**
+ * Boost hash function for memory location handles.
+ */
+inline std::size_t hash_value(const MemoryLocationHandle &value) {
+    return value.index();
+}
+
+/**
+ * Table of interned memory locations.
+ *
+ * The table keeps a single copy of every distinct location in a deque,
+ * so that references to the locations stay valid when new ones are
+ * interned, and finds the index of a location through a hash set of
+ * the indices. It is meant to be owned by the object holding the handles,
+ * e.g. a Dataflow, and is not thread-safe.
+ */
+class MemoryLocationTable: boost::noncopyable {
+    /**
+     * Hash function and equality of the indices in the table,
+     * also accepting memory locations that are not interned yet.
+     */
+    class IndexTraits {
+        const std::deque<MemoryLocation> *locations_; ///< Interned locations.
+
+    public:
+        explicit IndexTraits(const std::deque<MemoryLocation> *locations): locations_(locations) {}
+
+        std::size_t operator()(std::uint32_t index) const { return hash_value((*locations_)[index]); }
+        std::size_t operator()(const MemoryLocation &location) const { return hash_value(location); }
+
+        bool operator()(std::uint32_t a, std::uint32_t b) const { return a == b; }
+        bool operator()(const MemoryLocation &a, std::uint32_t b) const { return a == (*locations_)[b]; }
+        bool operator()(std::uint32_t a, const MemoryLocation &b) const { return (*locations_)[a] == b; }
+    };
+
+    std::deque<MemoryLocation> locations_; ///< Interned locations, indexed by the handles.
+    boost::unordered_set<std::uint32_t, IndexTraits, IndexTraits> indices_; ///< Indices of the valid locations.
+
+public:
+    /**
+     * Constructs a table with the invalid memory location only.
+     */
+    MemoryLocationTable();
+
+    /**
+     * Interns a memory location.
+     *
+     * \param memoryLocation Memory location.
+     *
+     * \return Handle of the memory location, valid until the table is cleared or destroyed.
+     */
+    MemoryLocationHandle intern(const MemoryLocation &memoryLocation);
+
+    /**
+     * \param handle Handle obtained from this table.
+     *
+     * \return The memory location referenced by the handle.
+     */
+    const MemoryLocation &get(MemoryLocationHandle handle) const {
+        assert(handle.index() < locations_.size());
+        return locations_[handle.index()];
+    }
+
+    /**
+     * \return Number of interned valid memory locations.
+     */
+    std::size_t size() const { return indices_.size(); }
+
+    /**
+     * Forgets all the interned locations, invalidating all the handles
+     * except the one of the invalid location.
+     */
+    void clear();
+};
+
+/**
+ * Process-wide table of the memory locations of registers and of
+ * other memory locations accessed by terms.
+ *
+ * Terms referencing memory locations outlive any single analysis,
+ * so the locations they reference are interned in this table, which
+ * is never cleared. Only the locations of registers and of a few
+ * other places, like stack arguments, get there, so that the table
+ * stays small. Locations are stored in segments that are allocated
+ * on demand and never moved, so that a location is read by its handle
+ * without taking the lock that interning takes.
+ */
+class SharedMemoryLocationTable: boost::noncopyable {
+    static const std::uint32_t SEGMENT_BITS = 10;
+    static const std::uint32_t SEGMENT_SIZE = 1 << SEGMENT_BITS;
+    static const std::uint32_t SEGMENT_COUNT = 1 << 10;
+
+    /**
+     * Hash function and equality of the indices in the table,
+     * also accepting memory locations that are not interned yet.
+     */
+    class IndexTraits {
+        const SharedMemoryLocationTable *table_; ///< The table.
+
+    public:
+        explicit IndexTraits(const SharedMemoryLocationTable *table): table_(table) {}
+
+        std::size_t operator()(std::uint32_t index) const { return hash_value(table_->get(MemoryLocationHandle(index))); }
+        std::size_t operator()(const MemoryLocation &location) const { return hash_value(location); }
+
+        bool operator()(std::uint32_t a, std::uint32_t b) const { return a == b; }
+        bool operator()(const MemoryLocation &a, std::uint32_t b) const { return a == table_->get(MemoryLocationHandle(b)); }
+        bool operator()(std::uint32_t a, const MemoryLocation &b) const { return table_->get(MemoryLocationHandle(a)) == b; }
+    };
+
+    std::atomic<MemoryLocation *> segments_[SEGMENT_COUNT]; ///< Segments of the table.
+    QMutex mutex_; ///< Mutex protecting the fields below.
+    std::uint32_t size_; ///< Number of interned locations, including the invalid one.
+    boost::unordered_set<std::uint32_t, IndexTraits, IndexTraits> indices_; ///< Indices of the valid locations.
+
+    SharedMemoryLocationTable();
+    ~SharedMemoryLocationTable();
+
+public:
+    /**
+     * \return The table.
+     */
+    static SharedMemoryLocationTable &instance();
+
+    /**
+     * Interns a memory location.
+     *
+     * \param memoryLocation Memory location.
+     *
+     * \return Handle of the memory location.
+     *
+     * \throws nc::Exception If the table is full.
+     */
+    MemoryLocationHandle intern(const MemoryLocation &memoryLocation);
+
+    /**
+     * \param handle Handle obtained from this table.
+     *
+     * \return The memory location referenced by the handle.
+     */
+    const MemoryLocation &get(MemoryLocationHandle handle) const {
+        return segments_[handle.index() >> SEGMENT_BITS].load(std::memory_order_acquire)[handle.index() & (SEGMENT_SIZE - 1)];
+    }
+};
+
+}}} // namespace nc::core::ir
+
+/* vim:set et sts=4 sw=4: */
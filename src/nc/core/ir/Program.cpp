@@ -24,7 +24,7 @@
 
 #include "Program.h"
 
-#include <algorithm> /* std::find_if */
+#include <algorithm> /* std::find_if, std::sort, std::unique */
 #include <cassert>
 
 #include <QTextStream>
@@ -36,61 +36,146 @@
 #include <nc/core/arch/Instruction.h>
 
 #include "CFG.h"
+#include "Jump.h"
 #include "Statement.h"
 
 namespace nc {
 namespace core {
 namespace ir {
 
-Program::Program() {}
+Program::Program(): deferringBasicBlocks_(false) {}
 
 Program::~Program() {}
 
-void Program::addRange(BasicBlock *basicBlock) {
-    assert(basicBlock != nullptr);
-    assert(basicBlock->address() && basicBlock->successorAddress() && "Basic block must be memory-bound.");
-    range2basicBlock_[AddrRange(*basicBlock->address(), *basicBlock->successorAddress())] = basicBlock;
+BasicBlock *Program::createBasicBlock() {
+    return takeOwnership(std::make_unique<BasicBlock>());
 }
 
-void Program::removeRange(BasicBlock *basicBlock) {
-    assert(basicBlock != nullptr);
-    assert(basicBlock->address() && basicBlock->successorAddress() && "Basic block must be memory-bound.");
-    range2basicBlock_.erase(AddrRange(*basicBlock->address(), *basicBlock->successorAddress()));
+BasicBlock *Program::createBasicBlock(ByteAddr address) {
+    if (BasicBlock *result = getBasicBlockStartingAt(address)) {
+        return result;
+    } else if (deferringBasicBlocks_) {
+        auto &placeholder = deferredBasicBlocks_[address];
+        if (!placeholder) {
+            placeholder = std::make_unique<BasicBlock>(address);
+        }
+        return placeholder.get();
+    } else {
+        return startBasicBlock(address);
+    }
 }
 
-BasicBlock *Program::getBasicBlockStartingAt(ByteAddr address) const {
-    return nc::find(start2basicBlock_, address);
+BasicBlock *Program::startBasicBlock(ByteAddr address) {
+    assert(!getBasicBlockStartingAt(address));
+
+    if (BasicBlock *basicBlock = getBasicBlockCovering(address)) {
+        return splitBasicBlock(basicBlock, &address, &address + 1);
+    } else {
+        return takeOwnership(std::make_unique<BasicBlock>(address));
+    }
 }
 
-BasicBlock *Program::getBasicBlockCovering(ByteAddr address) const {
-    return nc::find(range2basicBlock_, AddrRange(address, address + 1));
+void Program::createBasicBlocks(std::vector<ByteAddr> addresses) {
+    std::sort(addresses.begin(), addresses.end());
+    addresses.erase(std::unique(addresses.begin(), addresses.end()), addresses.end());
+
+    std::size_t i = 0;
+    while (i < addresses.size()) {
+        ByteAddr address = addresses[i];
+
+        if (getBasicBlockStartingAt(address)) {
+            ++i;
+        } else if (BasicBlock *basicBlock = getBasicBlockCovering(address)) {
+            /* Cut the basic block at all the addresses inside it at once. */
+            std::size_t j = i + 1;
+            while (j < addresses.size() && addresses[j] < *basicBlock->successorAddress()) {
+                ++j;
+            }
+            splitBasicBlock(basicBlock, &addresses[i], &addresses[0] + j);
+            i = j;
+        } else {
+            takeOwnership(std::make_unique<BasicBlock>(address));
+            ++i;
+        }
+    }
 }
 
-BasicBlock *Program::createBasicBlock() {
-    return takeOwnership(std::make_unique<BasicBlock>());
+void Program::deferBasicBlocks() {
+    assert(!deferringBasicBlocks_);
+    deferringBasicBlocks_ = true;
 }
 
-BasicBlock *Program::createBasicBlock(ByteAddr address) {
-    if (BasicBlock *result = getBasicBlockStartingAt(address)) {
-        return result;
-    } else if (BasicBlock *basicBlock = getBasicBlockCovering(address)) {
-        removeRange(basicBlock);
+void Program::createDeferredBasicBlocks() {
+    assert(deferringBasicBlocks_);
+    deferringBasicBlocks_ = false;
 
-        auto iterator = std::find_if(basicBlock->statements().begin(), basicBlock->statements().end(), [address](const Statement *statement) {
-            return statement->instruction()->addr() >= address;
-        });
+    if (deferredBasicBlocks_.empty()) {
+        return;
+    }
 
-        BasicBlock *result = takeOwnership(basicBlock->split(iterator, address));
+    std::vector<ByteAddr> leaders;
+    leaders.reserve(deferredBasicBlocks_.size());
+    foreach (const auto &item, deferredBasicBlocks_) {
+        leaders.push_back(item.first);
+    }
+    createBasicBlocks(std::move(leaders));
 
-        addRange(basicBlock);
-        addRange(result);
+    boost::unordered_map<const BasicBlock *, BasicBlock *> replacements;
+    foreach (const auto &item, deferredBasicBlocks_) {
+        replacements[item.second.get()] = getBasicBlockStartingAt(item.first);
+    }
 
-        return result;
-    } else {
-        BasicBlock *result = takeOwnership(std::make_unique<BasicBlock>(address));
-        addRange(result);
-        return result;
+    auto redirect = [&](JumpTarget &target) {
+        if (target.basicBlock()) {
+            if (auto replacement = nc::find(replacements, target.basicBlock())) {
+                target.setBasicBlock(replacement);
+            }
+        }
+    };
+
+    foreach (auto basicBlock, basicBlocks_) {
+        if (auto jump = basicBlock->getJump()) {
+            redirect(jump->thenTarget());
+            redirect(jump->elseTarget());
+        }
+    }
+
+    deferredBasicBlocks_.clear();
+}
+
+BasicBlock *Program::splitBasicBlock(BasicBlock *basicBlock, const ByteAddr *begin, const ByteAddr *end) {
+    assert(basicBlock != nullptr);
+    assert(basicBlock->address() && basicBlock->successorAddress() && "Basic block must be memory-bound.");
+    assert(begin < end);
+    assert(*basicBlock->address() < *begin && *(end - 1) < *basicBlock->successorAddress());
+
+    /* Find the first statement of each piece in a single pass over the statements. */
+    std::vector<BasicBlock::Statements::const_iterator> positions;
+    positions.reserve(end - begin);
+
+    auto iterator = basicBlock->statements().begin();
+    for (auto address = begin; address != end; ++address) {
+        iterator = std::find_if(iterator, basicBlock->statements().end(), [address](const Statement *statement) {
+            return statement->instruction()->addr() >= *address;
+        });
+        positions.push_back(iterator);
+    }
+
+    /* Cut the pieces off starting from the last one, so that each statement is moved once. */
+    std::vector<std::unique_ptr<BasicBlock>> pieces(end - begin);
+    for (std::size_t i = pieces.size(); i > 0; --i) {
+        pieces[i - 1] = basicBlock->split(positions[i - 1], begin[i - 1]);
     }
+    basicBlockIndex_.update(basicBlock);
+
+    BasicBlock *result = nullptr;
+    foreach (auto &piece, pieces) {
+        BasicBlock *newBasicBlock = takeOwnership(std::move(piece));
+        if (!result) {
+            result = newBasicBlock;
+        }
+    }
+    return result;
 }
 
 BasicBlock *Program::getBasicBlockForInstruction(const arch::Instruction *instruction) {
@@ -101,19 +186,54 @@ BasicBlock *Program::getBasicBlockForInstruction(const arch::Instruction *instru
         /* Maybe this instruction stands next to an existing basic block? */
         result = getBasicBlockCovering(instruction->addr() - 1);
 
-        /* No? Create a new block. */
-        if (!result) {
-            result = createBasicBlock(instruction->addr());
+        /* No? Or somebody wants a basic block to start here? Create a new block. */
+        if (!result || nc::contains(deferredBasicBlocks_, instruction->addr())) {
+            result = startBasicBlock(instruction->addr());
         }
     }
 
-    removeRange(result);
-    result->setSuccessorAddress(instruction->endAddr());
-    addRange(result);
+    setSuccessorAddress(result, instruction->endAddr());
 
     return result;
 }
 
+BasicBlock *Program::adoptBasicBlock(std::unique_ptr<BasicBlock> basicBlock) {
+    assert(basicBlock != nullptr);
+
+    return takeOwnership(std::move(basicBlock));
+}
+
+std::unique_ptr<BasicBlock> Program::eraseBasicBlock(BasicBlock *basicBlock) {
+    assert(basicBlock != nullptr);
+
+    if (basicBlock->address()) {
+        basicBlockIndex_.erase(basicBlock);
+    }
+    return basicBlocks_.erase(basicBlock);
+}
+
+void Program::eraseBasicBlocks(const std::vector<BasicBlock *> &basicBlocks) {
+    boost::unordered_set<const BasicBlock *> memoryBound;
+    foreach (auto basicBlock, basicBlocks) {
+        assert(basicBlock != nullptr);
+        if (basicBlock->address()) {
+            memoryBound.insert(basicBlock);
+        }
+    }
+    basicBlockIndex_.erase(memoryBound);
+
+    foreach (auto basicBlock, basicBlocks) {
+        basicBlocks_.erase(basicBlock);
+    }
+}
+
+void Program::setSuccessorAddress(BasicBlock *basicBlock, ByteAddr successorAddress) {
+    assert(basicBlock != nullptr);
+
+    basicBlock->setSuccessorAddress(successorAddress);
+    basicBlockIndex_.update(basicBlock);
+}
+
 BasicBlock *Program::takeOwnership(std::unique_ptr<BasicBlock> basicBlock) {
     assert(basicBlock != nullptr);
 
@@ -121,8 +241,7 @@ BasicBlock *Program::takeOwnership(std::unique_ptr<BasicBlock> basicBlock) {
     basicBlocks_.push_back(std::move(basicBlock));
 
     if (result->address()) {
-        assert(getBasicBlockStartingAt(*result->address()) == nullptr);
-        start2basicBlock_[*result->address()] = result;
+        basicBlockIndex_.insert(result);
     }
 
     return result;
@@ -23,7 +23,7 @@
 
 #pragma once
 
-#include <map>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <boost/unordered_map.hpp>
@@ -34,6 +34,7 @@
 #include <nc/common/RangeClass.h>
 
 #include "BasicBlock.h"
+#include "BasicBlockIndex.h"
 
 namespace nc {
 namespace core {
@@ -52,20 +53,16 @@ public:
     typedef nc::ilist<BasicBlock> BasicBlocks;
 
 private:
-    typedef Range<ByteAddr> AddrRange;
-
-    class ToTheLeft {
-    public:
-        bool operator()(const AddrRange &a, const AddrRange &b) const {
-            return a.end() <= b.start() && a != b;
-        }
-    };
-
     BasicBlocks basicBlocks_; ///< Basic blocks.
-    std::map<AddrRange, BasicBlock *, ToTheLeft> range2basicBlock_; ///< Mapping of a range of addresses to the basic block covering the range.
-    boost::unordered_map<ByteAddr, BasicBlock *> start2basicBlock_; ///< Mapping of an address to the basic block at this address.
+    BasicBlockIndex basicBlockIndex_; ///< Index of memory-bound basic blocks by their address ranges.
     boost::unordered_set<ByteAddr> calledAddresses_; ///< Addresses having calls to them.
 
+    /** Whether creation of memory-bound basic blocks is deferred until createDeferredBasicBlocks(). */
+    bool deferringBasicBlocks_;
+
+    /** Placeholders returned by createBasicBlock(ByteAddr) while creation is deferred, by their addresses (leaders). */
+    boost::unordered_map<ByteAddr, std::unique_ptr<BasicBlock>> deferredBasicBlocks_;
+
 public:
     /**
      * Constructor.
@@ -95,14 +92,18 @@ public:
      *
      * \return Pointer to the basic block starting at the given address. Can be nullptr.
      */
-    BasicBlock *getBasicBlockStartingAt(ByteAddr address) const;
+    BasicBlock *getBasicBlockStartingAt(ByteAddr address) const {
+        return basicBlockIndex_.getBasicBlockStartingAt(address);
+    }
 
     /**
      * \param address       Address.
      *
      * \return Pointer to the basic block covering the given address. Can be nullptr.
      */
-    BasicBlock *getBasicBlockCovering(ByteAddr address) const;
+    BasicBlock *getBasicBlockCovering(ByteAddr address) const {
+        return basicBlockIndex_.getBasicBlockCovering(address);
+    }
 
     /**
      * \return Valid pointer to a newly created non-memory-bound basic block.
@@ -119,9 +120,37 @@ public:
      *         blocks, and the one with the higher address is returned. If the
      *         given address is not covered by any existing block, a new empty
      *         memory-bound block is created and returned.
+     *
+     *         While creation of basic blocks is deferred, the address is only
+     *         remembered as a leader and a placeholder is returned, unless
+     *         a basic block starts at the address already.
      */
     BasicBlock *createBasicBlock(ByteAddr address);
 
+    /**
+     * Makes sure that there is a memory-bound basic block starting at each
+     * of the given addresses. The effect is the same as of calling
+     * createBasicBlock(ByteAddr) for each address, but each existing basic
+     * block is cut into pieces at once, instead of being split repeatedly.
+     *
+     * \param[in] addresses Start addresses of the basic blocks (leaders), in any order.
+     */
+    void createBasicBlocks(std::vector<ByteAddr> addresses);
+
+    /**
+     * Starts collecting the leaders requested via createBasicBlock(ByteAddr)
+     * instead of cutting basic blocks at them one by one. Instructions
+     * starting at a collected leader still get a basic block of their own.
+     */
+    void deferBasicBlocks();
+
+    /**
+     * Creates the basic blocks starting at the leaders collected since the
+     * call to deferBasicBlocks() in a single pass, redirects the jumps to the
+     * placeholders to them, and stops deferring.
+     */
+    void createDeferredBasicBlocks();
+
     /**
      * \param[in] instruction An instruction.
      *
@@ -130,6 +159,45 @@ public:
      */
     BasicBlock *getBasicBlockForInstruction(const arch::Instruction *instruction);
 
+    /**
+     * Takes ownership of a basic block created in another program.
+     * A memory-bound basic block must not overlap with the basic blocks
+     * of this program.
+     *
+     * \param basicBlock Valid pointer to the basic block.
+     *
+     * \return Pointer to the basic block that was given.
+     */
+    BasicBlock *adoptBasicBlock(std::unique_ptr<BasicBlock> basicBlock);
+
+    /**
+     * Removes a basic block from the program.
+     * No jumps in the remaining basic blocks must refer to it.
+     *
+     * \param basicBlock Valid pointer to a basic block of this program.
+     *
+     * \return Pointer to the removed basic block.
+     */
+    std::unique_ptr<BasicBlock> eraseBasicBlock(BasicBlock *basicBlock);
+
+    /**
+     * Removes a set of basic blocks from the program at once.
+     * No jumps in the remaining basic blocks must refer to them.
+     * Unlike calling eraseBasicBlock() for each basic block, this takes
+     * time linear in the number of basic blocks in the program.
+     *
+     * \param basicBlocks Valid pointers to distinct basic blocks of this program.
+     */
+    void eraseBasicBlocks(const std::vector<BasicBlock *> &basicBlocks);
+
+    /**
+     * Changes the address of the end of a memory-bound basic block.
+     *
+     * \param basicBlock Valid pointer to a memory-bound basic block of this program.
+     * \param successorAddress New successor address of the basic block.
+     */
+    void setSuccessorAddress(BasicBlock *basicBlock, ByteAddr successorAddress);
+
     /**
      * \return Addresses being arguments of calls.
      */
@@ -158,7 +226,8 @@ public:
 
 private:
     /**
-     * Takes ownership of given basic block.
+     * Takes ownership of given basic block and, if it is memory-bound,
+     * adds it to the index of basic blocks.
      *
      * \param basicBlock Valid pointer to a basic block.
      *
@@ -167,19 +236,28 @@ private:
     BasicBlock *takeOwnership(std::unique_ptr<BasicBlock> basicBlock);
 
     /**
-     * Maps the memory range occupied by given basic block to this basic block.
-     * getBasicBlockCovering() will only return a basic block if addRange() was called on it.
+     * Creates a memory-bound basic block starting at the given address,
+     * splitting the basic block covering the address, if any.
+     * No basic block must start at the address.
      *
-     * \param basicBlock Valid pointer to a basic block.
+     * \param address Start address of the basic block.
+     *
+     * \return Valid pointer to the created basic block.
      */
-    void addRange(BasicBlock *basicBlock);
+    BasicBlock *startBasicBlock(ByteAddr address);
 
     /**
-     * Unmaps the memory range occupied by given basic block to this basic block.
+     * Splits a memory-bound basic block at the given addresses.
      *
-     * \param basicBlock Valid pointer to a basic block.
+     * \param basicBlock Valid pointer to a memory-bound basic block.
+     * \param begin Pointer to the first address to split at.
+     * \param end Pointer past the last address to split at.
+     *
+     * Addresses must be sorted, unique, and lie strictly inside the basic block.
+     *
+     * \return Valid pointer to the basic block starting at the first address.
      */
-    void removeRange(BasicBlock *basicBlock);
+    BasicBlock *splitBasicBlock(BasicBlock *basicBlock, const ByteAddr *begin, const ByteAddr *end);
 };
 
 } // namespace ir
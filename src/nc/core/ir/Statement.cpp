@@ -29,10 +29,14 @@ namespace core {
 namespace ir {
 
 std::unique_ptr<Statement> Statement::clone() const {
+    return clone(instruction());
+}
+
+std::unique_ptr<Statement> Statement::clone(const arch::Instruction *instruction) const {
     auto result = doClone();
 
-    if (instruction()) {
-        result->setInstruction(instruction());
+    if (instruction) {
+        result->setInstruction(instruction);
     }
 
     return result;
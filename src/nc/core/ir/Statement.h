@@ -52,6 +52,7 @@ class Callback;
 class Halt;
 class InlineAssembly;
 class Jump;
+class RememberReachingDefinitions;
 class Term;
 class Touch;
 
@@ -137,6 +138,16 @@ public:
      */
     std::unique_ptr<Statement> clone() const;
 
+    /**
+     * Clones the statement and sets the instruction of the clone
+     * to the given one.
+     *
+     * \param instruction Pointer to the instruction. Can be nullptr.
+     *
+     * \returns Valid pointer to the clone.
+     */
+    std::unique_ptr<Statement> clone(const arch::Instruction *instruction) const;
+
     /* The following functions are defined in Statements.h. */
 
     inline const Assignment *asAssignment() const;
@@ -174,5 +185,6 @@ NC_REGISTER_STATEMENT_CLASS(nc::core::ir::Call,           nc::core::ir::Statemen
 NC_REGISTER_STATEMENT_CLASS(nc::core::ir::Halt,           nc::core::ir::Statement::HALT)
 NC_REGISTER_STATEMENT_CLASS(nc::core::ir::Touch,          nc::core::ir::Statement::TOUCH)
 NC_REGISTER_STATEMENT_CLASS(nc::core::ir::Callback,       nc::core::ir::Statement::CALLBACK)
+NC_REGISTER_STATEMENT_CLASS(nc::core::ir::RememberReachingDefinitions, nc::core::ir::Statement::REMEMBER_REACHING_DEFINITIONS)
 
 /* vim:set et sts=4 sw=4: */
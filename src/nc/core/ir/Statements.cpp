@@ -26,6 +26,7 @@
 
 #include <QTextStream>
 
+#include <nc/common/Foreach.h>
 #include <nc/common/Unreachable.h>
 #include <nc/common/make_unique.h>
 
@@ -125,12 +126,45 @@ void Callback::print(QTextStream &out) const {
     out << "callback" << endl;
 }
 
+RememberReachingDefinitions::RememberReachingDefinitions(std::vector<MemoryLocation> memoryLocations, std::unique_ptr<Term> stackPointer):
+    Statement(REMEMBER_REACHING_DEFINITIONS), selective_(true), memoryLocations_(std::move(memoryLocations)),
+    stackPointer_(std::move(stackPointer))
+{
+    if (stackPointer_) {
+        stackPointer_->setStatement(this);
+    }
+}
+
+bool RememberReachingDefinitions::remembers(const MemoryLocation &memoryLocation) const {
+    if (!selective()) {
+        return true;
+    }
+    foreach (const auto &location, memoryLocations()) {
+        if (location.covers(memoryLocation)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 std::unique_ptr<Statement> RememberReachingDefinitions::doClone() const {
-    return std::make_unique<RememberReachingDefinitions>();
+    if (selective()) {
+        return std::make_unique<RememberReachingDefinitions>(memoryLocations(),
+            stackPointer() ? stackPointer()->clone() : nullptr);
+    } else {
+        return std::make_unique<RememberReachingDefinitions>();
+    }
 }
 
 void RememberReachingDefinitions::print(QTextStream &out) const {
-    out << "remember_reaching_definitions" << endl;
+    out << "remember_reaching_definitions";
+    if (selective()) {
+        out << " of";
+        foreach (const auto &memoryLocation, memoryLocations()) {
+            out << ' ' << memoryLocation;
+        }
+    }
+    out << endl;
 }
 
 } // namespace ir
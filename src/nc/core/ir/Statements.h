@@ -30,6 +30,7 @@
 
 #include <QString>
 
+#include "MemoryLocation.h"
 #include "Statement.h"
 #include "Term.h"
 
@@ -192,10 +193,57 @@ protected:
 
 /**
  * DataflowAnalyzer remembers definitions reaching this statement.
+ *
+ * The statement can be selective: then only the definitions of memory
+ * locations overlapping with the given ones are remembered. Given memory
+ * locations in the stack domain are relative to the value of the stack
+ * pointer term owned by the statement, and are ignored if this value is
+ * not a stack offset.
  */
 class RememberReachingDefinitions: public Statement {
+    bool selective_; ///< True if only the definitions of the given memory locations are remembered.
+    std::vector<MemoryLocation> memoryLocations_; ///< Memory locations whose definitions are remembered.
+    std::unique_ptr<Term> stackPointer_; ///< Term reading the stack pointer.
+
 public:
-    RememberReachingDefinitions(): Statement(REMEMBER_REACHING_DEFINITIONS) {}
+    /**
+     * Constructs a statement remembering all reaching definitions.
+     */
+    RememberReachingDefinitions():
+        Statement(REMEMBER_REACHING_DEFINITIONS), selective_(false), stackPointer_(nullptr)
+    {}
+
+    /**
+     * Constructs a selective statement.
+     *
+     * \param memoryLocations Memory locations whose definitions must be remembered.
+     * \param stackPointer Term reading the stack pointer. Can be nullptr.
+     */
+    RememberReachingDefinitions(std::vector<MemoryLocation> memoryLocations, std::unique_ptr<Term> stackPointer);
+
+    /**
+     * \return True if only the definitions of memoryLocations() are remembered,
+     *         false if all reaching definitions are remembered.
+     */
+    bool selective() const { return selective_; }
+
+    /**
+     * \return Memory locations whose definitions are remembered, if the statement is selective.
+     */
+    const std::vector<MemoryLocation> &memoryLocations() const { return memoryLocations_; }
+
+    /**
+     * \param memoryLocation Memory location, relative to the stack pointer
+     *                       if it is in the stack domain.
+     *
+     * \return True if all the definitions of the memory location are remembered.
+     */
+    bool remembers(const MemoryLocation &memoryLocation) const;
+
+    /**
+     * \return Pointer to the term reading the stack pointer. Can be nullptr.
+     */
+    const Term *stackPointer() const { return stackPointer_.get(); }
 
     void print(QTextStream &out) const override;
 
@@ -26,6 +26,7 @@
 #include <nc/config.h>
 
 #include <cassert>
+#include <cstddef>
 #include <memory>
 
 #include <boost/noncopyable.hpp>
@@ -76,9 +77,15 @@ public:
         WRITE,     ///< Term is written.
     };
 
+    /**
+     * Number of a term that has not been numbered yet.
+     */
+    static const std::size_t NO_INDEX = static_cast<std::size_t>(-1);
+
 private:
     const Statement *statement_; ///< Statement that this term belongs to.
     SmallBitSize size_; ///< Size of this term's value in bits.
+    std::size_t index_; ///< Number of the term in its function, or NO_INDEX.
 
 public:
     /**
@@ -88,7 +95,7 @@ public:
      * \param[in] size Size of this term's value in bits.
      */
     Term(int kind, SmallBitSize size):
-        kind_(kind), statement_(nullptr), size_(size)
+        kind_(kind), statement_(nullptr), size_(size), index_(NO_INDEX)
     {
         assert(size != 0);
     }
@@ -112,6 +119,22 @@ public:
      */
     void setStatement(const Statement *statement);
 
+    /**
+     * \return Number of the term among the terms of its function, assigned
+     *         by Function::numberTerms(), or NO_INDEX.
+     *
+     * Terms of a function are numbered densely, so that analyses can keep
+     * per-term information in arrays instead of hash tables.
+     */
+    std::size_t index() const { return index_; }
+
+    /**
+     * Sets the number of the term among the terms of its function.
+     *
+     * \param index Number.
+     */
+    void setIndex(std::size_t index) { index_ = index; }
+
     /**
      * \return Term's access type.
      */
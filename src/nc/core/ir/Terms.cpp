@@ -54,17 +54,25 @@ void Intrinsic::print(QTextStream &out) const {
 }
 
 MemoryLocationAccess::MemoryLocationAccess(const MemoryLocation &memoryLocation):
-    Term(MEMORY_LOCATION_ACCESS, memoryLocation.size<SmallBitSize>()), memoryLocation_(memoryLocation)
+    Term(MEMORY_LOCATION_ACCESS, memoryLocation.size<SmallBitSize>()),
+    memoryLocation_(SharedMemoryLocationTable::instance().intern(memoryLocation))
 {}
 
+MemoryLocationAccess::MemoryLocationAccess(MemoryLocationHandle memoryLocation):
+    Term(MEMORY_LOCATION_ACCESS, SharedMemoryLocationTable::instance().get(memoryLocation).size<SmallBitSize>()),
+    memoryLocation_(memoryLocation)
+{
+    assert(memoryLocation);
+}
+
 std::unique_ptr<Term> MemoryLocationAccess::doClone() const {
-    return std::make_unique<MemoryLocationAccess>(memoryLocation());
+    return std::make_unique<MemoryLocationAccess>(memoryLocation_);
 }
 
 void MemoryLocationAccess::doCallOnChildren(const std::function<void(Term *)> &) {}
 
 void MemoryLocationAccess::print(QTextStream &out) const {
-    out << memoryLocation_;
+    out << memoryLocation();
 }
 
 Dereference::Dereference(std::unique_ptr<Term> address, Domain domain, SmallBitSize size):
@@ -27,6 +27,7 @@
 
 #include <nc/common/SizedValue.h>
 
+#include "MemoryLocationHandle.h"
 #include "Term.h"
 
 namespace nc {
@@ -109,7 +110,7 @@ protected:
  * Reference to some abstract memory location (e.g. register).
  */
 class MemoryLocationAccess: public Term {
-    MemoryLocation memoryLocation_; ///< Accessed memory location.
+    MemoryLocationHandle memoryLocation_; ///< Handle of the accessed memory location in the SharedMemoryLocationTable.
 
 public:
     /**
@@ -119,10 +120,22 @@ public:
      */
     MemoryLocationAccess(const MemoryLocation &memoryLocation);
 
+    /**
+     * Class constructor.
+     *
+     * \param[in] memoryLocation Handle of a valid referenced memory location in the SharedMemoryLocationTable.
+     */
+    MemoryLocationAccess(MemoryLocationHandle memoryLocation);
+
     /**
      * \return Referenced memory location.
      */
-    const MemoryLocation &memoryLocation() const { return memoryLocation_; }
+    const MemoryLocation &memoryLocation() const { return SharedMemoryLocationTable::instance().get(memoryLocation_); }
+
+    /**
+     * \return Handle of the referenced memory location in the SharedMemoryLocationTable.
+     */
+    MemoryLocationHandle memoryLocationHandle() const { return memoryLocation_; }
 
     void print(QTextStream &out) const override;
 
@@ -0,0 +1,71 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "ArgumentFactory.h"
+
+#include <climits> /* CHAR_BIT */
+
+#include <nc/common/make_unique.h>
+
+#include <nc/core/ir/Terms.h>
+
+#include "Convention.h"
+
+namespace nc {
+namespace core {
+namespace ir {
+namespace calling {
+
+ArgumentFactory::ArgumentFactory(const Convention *convention) {
+    if (convention) {
+        stackPointer_ = convention->stackPointer();
+    }
+}
+
+std::shared_ptr<Term> ArgumentFactory::operator()(const MemoryLocation &memoryLocation) const {
+    if (memoryLocation.domain() == MemoryDomain::STACK) {
+        if (stackPointer_) {
+            return std::make_shared<Dereference>(
+                std::make_unique<BinaryOperator>(
+                    BinaryOperator::ADD,
+                    std::make_unique<MemoryLocationAccess>(stackPointer_),
+                    std::make_unique<Constant>(SizedValue(
+                        stackPointer_.size<SmallBitSize>(),
+                        memoryLocation.addr() / CHAR_BIT)),
+                    stackPointer_.size<SmallBitSize>()),
+                MemoryDomain::MEMORY,
+                memoryLocation.size<SmallBitSize>()
+            );
+        } else {
+            return nullptr;
+        }
+    } else {
+        return std::make_shared<MemoryLocationAccess>(memoryLocation);
+    }
+}
+
+MemoryLocation getArgumentLocation(const Term *term) {
+    if (!term) {
+        return MemoryLocation();
+    }
+    if (auto access = term->asMemoryLocationAccess()) {
+        return access->memoryLocation();
+    }
+    if (auto dereference = term->asDereference()) {
+        if (auto binary = dereference->address()->asBinaryOperator()) {
+            if (binary->operatorKind() == BinaryOperator::ADD && binary->left()->asMemoryLocationAccess()) {
+                if (auto constant = binary->right()->asConstant()) {
+                    return MemoryLocation(MemoryDomain::STACK, constant->value().signedValue() * CHAR_BIT, term->size());
+                }
+            }
+        }
+    }
+    return MemoryLocation();
+}
+
+} // namespace calling
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
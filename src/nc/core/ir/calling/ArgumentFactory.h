@@ -0,0 +1,64 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <memory>
+
+#include <nc/core/ir/MemoryLocation.h>
+
+namespace nc {
+namespace core {
+namespace ir {
+
+class Term;
+
+namespace calling {
+
+class Convention;
+
+/**
+ * Factory of terms representing function arguments and return values in signatures.
+ *
+ * Locations on the stack are represented by *(sp + offset) terms,
+ * all other locations by memory location accesses.
+ */
+class ArgumentFactory {
+    MemoryLocation stackPointer_; ///< Stack pointer of the calling convention.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param convention Pointer to the calling convention. Can be nullptr.
+     */
+    explicit ArgumentFactory(const Convention *convention);
+
+    /**
+     * \param memoryLocation Valid memory location.
+     *
+     * \return Term representing an argument residing in the given location.
+     *         Can be nullptr if the location is on the stack, but the stack
+     *         pointer is unknown.
+     */
+    std::shared_ptr<Term> operator()(const MemoryLocation &memoryLocation) const;
+};
+
+/**
+ * Inverse of ArgumentFactory.
+ *
+ * \param term Pointer to a term representing an argument or a return value. Can be nullptr.
+ *
+ * \return The memory location of the argument or the return value,
+ *         or an invalid memory location if the term has an unexpected form.
+ */
+MemoryLocation getArgumentLocation(const Term *term);
+
+} // namespace calling
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
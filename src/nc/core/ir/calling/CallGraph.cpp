@@ -0,0 +1,124 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "CallGraph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace nc {
+namespace core {
+namespace ir {
+namespace calling {
+
+std::size_t CallGraph::addNode(const CalleeId &calleeId) {
+    auto i = id2node_.find(calleeId);
+    if (i != id2node_.end()) {
+        return i->second;
+    }
+
+    auto node = nodes_.size();
+    nodes_.push_back(calleeId);
+    callees_.emplace_back();
+    callers_.emplace_back();
+    id2node_[calleeId] = node;
+
+    return node;
+}
+
+void CallGraph::addCall(std::size_t caller, std::size_t callee) {
+    assert(caller < size());
+    assert(callee < size());
+
+    if (edges_.insert(std::make_pair(caller, callee)).second) {
+        callees_[caller].push_back(callee);
+        callers_[callee].push_back(caller);
+    }
+}
+
+const std::size_t *CallGraph::getNode(const CalleeId &calleeId) const {
+    auto i = id2node_.find(calleeId);
+    if (i != id2node_.end()) {
+        return &i->second;
+    }
+    return nullptr;
+}
+
+std::vector<std::vector<std::size_t>> CallGraph::computeComponents() const {
+    /*
+     * Tarjan's algorithm, with an explicit stack instead of recursion:
+     * call chains in real programs can be deep enough to overflow the native stack.
+     * A component is emitted only after all the components reachable from it,
+     * which is exactly the bottom-up order.
+     */
+    const std::size_t UNVISITED = std::numeric_limits<std::size_t>::max();
+
+    std::vector<std::vector<std::size_t>> result;
+
+    std::vector<std::size_t> index(size(), UNVISITED);
+    std::vector<std::size_t> lowlink(size());
+    std::vector<bool> onStack(size());
+    std::vector<std::size_t> stack;
+    std::vector<std::pair<std::size_t, std::size_t>> path; // Node and the index of its next callee to visit.
+    std::size_t nextIndex = 0;
+
+    auto enter = [&](std::size_t node) {
+        index[node] = lowlink[node] = nextIndex++;
+        stack.push_back(node);
+        onStack[node] = true;
+        path.push_back(std::make_pair(node, 0));
+    };
+
+    for (std::size_t root = 0; root < size(); ++root) {
+        if (index[root] != UNVISITED) {
+            continue;
+        }
+
+        enter(root);
+
+        while (!path.empty()) {
+            auto node = path.back().first;
+            const auto &callees = callees_[node];
+
+            if (path.back().second < callees.size()) {
+                auto callee = callees[path.back().second++];
+
+                if (index[callee] == UNVISITED) {
+                    enter(callee);
+                } else if (onStack[callee]) {
+                    lowlink[node] = std::min(lowlink[node], index[callee]);
+                }
+            } else {
+                path.pop_back();
+
+                if (!path.empty()) {
+                    auto caller = path.back().first;
+                    lowlink[caller] = std::min(lowlink[caller], lowlink[node]);
+                }
+
+                if (lowlink[node] == index[node]) {
+                    result.emplace_back();
+                    auto &component = result.back();
+
+                    std::size_t member;
+                    do {
+                        member = stack.back();
+                        stack.pop_back();
+                        onStack[member] = false;
+                        component.push_back(member);
+                    } while (member != node);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+} // namespace calling
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,106 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+#include "CalleeId.h"
+
+namespace nc {
+namespace core {
+namespace ir {
+namespace calling {
+
+/**
+ * Call graph over callee ids.
+ *
+ * Nodes are numbered by consecutive integers in the order they are added.
+ * There is an edge from the callee id of a function to the callee id
+ * of each call in this function.
+ */
+class CallGraph {
+    std::vector<CalleeId> nodes_; ///< Callee ids of the nodes.
+    boost::unordered_map<CalleeId, std::size_t> id2node_; ///< Mapping from a callee id to its node.
+    std::vector<std::vector<std::size_t>> callees_; ///< Callees of each node.
+    std::vector<std::vector<std::size_t>> callers_; ///< Callers of each node.
+    boost::unordered_set<std::pair<std::size_t, std::size_t>> edges_; ///< All the edges, as (caller, callee) pairs.
+
+public:
+    /**
+     * Adds a node for the given callee id, if there is none yet.
+     *
+     * \param calleeId Callee id.
+     *
+     * \return Node of the callee id.
+     */
+    std::size_t addNode(const CalleeId &calleeId);
+
+    /**
+     * Adds an edge between two nodes, if there is none yet.
+     *
+     * \param caller Node of the calling function.
+     * \param callee Node of the called function.
+     */
+    void addCall(std::size_t caller, std::size_t callee);
+
+    /**
+     * \param calleeId Callee id.
+     *
+     * \return Pointer to the node of the callee id. Can be nullptr.
+     */
+    const std::size_t *getNode(const CalleeId &calleeId) const;
+
+    /**
+     * \param node Node.
+     *
+     * \return Callee id of the node.
+     */
+    const CalleeId &getCalleeId(std::size_t node) const { return nodes_[node]; }
+
+    /**
+     * \param node Node.
+     *
+     * \return Nodes called by the given node.
+     */
+    const std::vector<std::size_t> &getCallees(std::size_t node) const { return callees_[node]; }
+
+    /**
+     * \param node Node.
+     *
+     * \return Nodes calling the given node.
+     */
+    const std::vector<std::size_t> &getCallers(std::size_t node) const { return callers_[node]; }
+
+    /**
+     * \return Number of nodes.
+     */
+    std::size_t size() const { return nodes_.size(); }
+
+    /**
+     * \return Number of edges.
+     */
+    std::size_t edgeCount() const { return edges_.size(); }
+
+    /**
+     * Computes strongly connected components of the graph.
+     *
+     * \return Strongly connected components, bottom-up: each component
+     *         comes after all the components called from it.
+     */
+    std::vector<std::vector<std::size_t>> computeComponents() const;
+};
+
+} // namespace calling
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -85,7 +85,23 @@ CallHook::CallHook(const Convention *convention, const CallSignature *signature,
             addReturnValueWrite(std::move(clone));
         }
     } else {
-        auto snapshotStatement = std::make_unique<RememberReachingDefinitions>();
+        /*
+         * Signature analysis only looks at the definitions of the locations
+         * through which arguments can be passed. Remembering the definitions
+         * of these locations only saves a lot of memory.
+         */
+        std::vector<MemoryLocation> argumentLocations;
+        foreach (const auto &group, convention->argumentGroups()) {
+            argumentLocations.insert(argumentLocations.end(), group.begin(), group.end());
+        }
+        std::unique_ptr<Term> snapshotStackPointer;
+        if (stackPointer_) {
+            argumentLocations.push_back(convention->stackArgumentsLocation());
+            snapshotStackPointer = std::make_unique<MemoryLocationAccess>(convention->stackPointer());
+        }
+
+        auto snapshotStatement = std::make_unique<RememberReachingDefinitions>(std::move(argumentLocations),
+                                                                               std::move(snapshotStackPointer));
         snapshotStatement_ = snapshotStatement.get();
         statements.push_back(std::move(snapshotStatement));
 
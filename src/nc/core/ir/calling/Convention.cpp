@@ -24,6 +24,8 @@
 
 #include "Convention.h"
 
+#include <climits>
+
 #include <nc/common/Foreach.h>
 #include <nc/common/Range.h>
 #include <nc/common/Unused.h>
@@ -40,6 +42,7 @@ Convention::Convention(QString name):
     name_(std::move(name)),
     firstArgumentOffset_(0),
     argumentAlignment_(0),
+    maxStackArgumentsSize_(256 * CHAR_BIT),
     calleeCleanup_(false)
 {}
 
@@ -32,6 +32,7 @@
 
 #include <nc/common/ilist.h>
 
+#include <nc/core/ir/MemoryDomain.h>
 #include <nc/core/ir/MemoryLocation.h>
 
 namespace nc {
@@ -57,6 +58,7 @@ private:
 
     BitSize firstArgumentOffset_; ///< Offset of the first argument in a function's stack frame.
     BitSize argumentAlignment_; ///< Alignment of stack arguments in bits.
+    BitSize maxStackArgumentsSize_; ///< Size of the stack area above the first argument remembered at call sites, in bits.
 
     std::vector<std::vector<MemoryLocation>> argumentGroups_; ///< Groups of locations through which arguments of different kinds can be passed.
     std::vector<MemoryLocation> returnValueLocations_; ///< List of memory locations that can be used for passing return values.
@@ -105,6 +107,22 @@ public:
      */
     BitSize argumentAlignment() const { return argumentAlignment_; }
 
+    /**
+     * \return Size of the stack area above the first argument, in bits,
+     *         whose definitions are remembered at call sites with unknown
+     *         signatures. It does not limit the arguments that a function
+     *         can take.
+     */
+    BitSize maxStackArgumentsSize() const { return maxStackArgumentsSize_; }
+
+    /**
+     * \return Memory location of the stack area whose definitions are
+     *         remembered at call sites with unknown signatures.
+     */
+    MemoryLocation stackArgumentsLocation() const {
+        return MemoryLocation(MemoryDomain::STACK, firstArgumentOffset_, maxStackArgumentsSize_);
+    }
+
     /**
      * \return List of possible argument locations.
      */
@@ -176,6 +194,14 @@ protected:
      */
     void setArgumentAlignment(BitSize argumentAlignment) { argumentAlignment_ = argumentAlignment; };
 
+    /**
+     * Sets the size of the stack area above the first argument
+     * whose definitions are remembered at call sites.
+     *
+     * \param[in] maxStackArgumentsSize Size in bits.
+     */
+    void setMaxStackArgumentsSize(BitSize maxStackArgumentsSize) { maxStackArgumentsSize_ = maxStackArgumentsSize; }
+
     /**
      * Adds a list of locations which can contain arguments of a certain kind,
      * e.g. integer arguments or floating-point arguments.
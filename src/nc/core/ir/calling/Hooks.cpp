@@ -146,9 +146,56 @@ void Hooks::deinstrument(Function *function) {
     }
 }
 
+bool Hooks::isInstrumentationUpToDate(const Function *function, const dflow::Dataflow &dataflow) const {
+    assert(function != nullptr);
+
+    if (function->entry()) {
+        auto key = std::make_tuple(function, getConvention(getCalleeId(function)), getSignature(function));
+        if (nc::find(entryHooks_, key).get() != nc::find(lastEntryHooks_, function)) {
+            return false;
+        }
+    }
+
+    foreach (auto basicBlock, function->basicBlocks()) {
+        foreach (auto statement, basicBlock->statements()) {
+            if (auto call = statement->asCall()) {
+                auto calleeId = getCalleeId(call, dataflow);
+                auto key = std::make_tuple(call, getConvention(calleeId), signatures_.getSignature(call).get(),
+                                           conventions_.getStackArgumentsSize(calleeId));
+                if (nc::find(callHooks_, key).get() != nc::find(lastCallHooks_, call)) {
+                    return false;
+                }
+            } else if (auto jump = statement->asJump()) {
+                const ReturnHook *returnHook = nullptr;
+                if (dflow::isReturn(jump, dataflow)) {
+                    auto key = std::make_tuple(jump, getConvention(getCalleeId(function)), getSignature(function));
+                    returnHook = nc::find(returnHooks_, key).get();
+                }
+                if (returnHook != nc::find(lastReturnHooks_, jump)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+const FunctionSignature *Hooks::getSignature(const Function *function) const {
+    assert(function != nullptr);
+
+    if (auto signature = signatures_.getSignature(function).get()) {
+        return signature;
+    }
+    if (function->entry() && function->entry()->address()) {
+        return signatures_.getSignature(*function->entry()->address()).get();
+    }
+    return nullptr;
+}
+
 void Hooks::instrumentEntry(Function *function) {
     auto convention = getConvention(getCalleeId(function));
-    auto signature = signatures_.getSignature(function).get();
+    auto signature = getSignature(function);
     auto &entryHook = entryHooks_[std::make_tuple(function, convention, signature)];
 
     if (!entryHook) {
@@ -215,7 +262,7 @@ void Hooks::deinstrumentCall(Call *call) {
 void Hooks::instrumentReturn(Jump *jump) {
     auto function = jump->basicBlock()->function();
     auto convention = getConvention(getCalleeId(function));
-    auto signature = signatures_.getSignature(function).get();
+    auto signature = getSignature(function);
     auto &returnHook = returnHooks_[std::make_tuple(jump, convention, signature)];
 
     if (!returnHook) {
@@ -195,7 +195,29 @@ public:
      */
     void deinstrument(Function *function);
 
+    /**
+     * Checks whether instrumenting the function anew would insert the same
+     * hooks as the ones inserted during the last dataflow analysis of it.
+     * If so, this dataflow information is still valid.
+     *
+     * \param function Valid pointer to an instrumented function.
+     * \param dataflow Dataflow information computed for the function.
+     *
+     * \return True if the hooks in the function's entry, calls, and returns
+     *         would stay the same, false otherwise.
+     */
+    bool isInstrumentationUpToDate(const Function *function, const dflow::Dataflow &dataflow) const;
+
 private:
+    /**
+     * \param function Valid pointer to a function.
+     *
+     * \return Pointer to the signature of the function or, if it is not set,
+     *         to the signature of the function at the address of its entry.
+     *         Can be nullptr.
+     */
+    const FunctionSignature *getSignature(const Function *function) const;
+
     /**
      * Creates an EntryHook (if not done yet) and instruments the function with it.
      * If the function was previously instrumented, deinstruments it.
@@ -3,11 +3,16 @@
 
 #include "SignatureAnalyzer.h"
 
+#include <algorithm>
 #include <cstdint> /* uintptr_t */
 
+#include <QElapsedTimer>
+#include <QThreadPool>
+
 #include <boost/range/adaptor/map.hpp>
 
 #include <nc/common/Foreach.h>
+#include <nc/common/Parallel.h>
 #include <nc/common/make_unique.h>
 
 #include <nc/core/ir/BasicBlock.h>
@@ -17,11 +22,12 @@
 #include <nc/core/ir/Statements.h>
 #include <nc/core/ir/Terms.h>
 #include <nc/core/ir/dflow/Dataflows.h>
-#include <nc/core/ir/dflow/Uses.h>
+#include <nc/core/ir/dflow/DefUseGraphs.h>
 #include <nc/core/ir/dflow/Value.h>
 #include <nc/core/ir/dflow/Utils.h>
 #include <nc/core/ir/liveness/Livenesses.h>
 
+#include "ArgumentFactory.h"
 #include "CallHook.h"
 #include "Convention.h"
 #include "Conventions.h"
@@ -35,18 +41,29 @@ namespace core {
 namespace ir {
 namespace calling {
 
-SignatureAnalyzer::SignatureAnalyzer(Signatures &signatures, const dflow::Dataflows &dataflows, const Hooks &hooks,
+namespace {
+
+/** Maximal number of times the arguments and the return value of a callee id are computed. */
+const std::size_t MAX_EVALUATIONS = 8;
+
+/** Number of callee ids computed by a single job. */
+const std::size_t JOB_SIZE = 64;
+
+} // anonymous namespace
+
+SignatureAnalyzer::SignatureAnalyzer(Signatures &signatures, const dflow::Dataflows &dataflows,
+                                     const dflow::DefUseGraphs &defUseGraphs, const Hooks &hooks,
                                      const liveness::Livenesses &livenesses, const CancellationToken &canceled,
                                      const LogToken &log)
-    : signatures_(signatures), dataflows_(dataflows), hooks_(hooks), livenesses_(livenesses), canceled_(canceled),
-      log_(log) {
+    : signatures_(signatures), dataflows_(dataflows), defUseGraphs_(defUseGraphs), hooks_(hooks),
+      livenesses_(livenesses), canceled_(canceled), log_(log) {
 }
 
 SignatureAnalyzer::~SignatureAnalyzer() {}
 
 void SignatureAnalyzer::analyze() {
     computeMappings();
-    computeUses();
+    computeFixedArgumentsAndReturnValues();
     computeArgumentsAndReturnValues();
     computeSignatures();
 }
@@ -56,7 +73,10 @@ void SignatureAnalyzer::computeMappings() {
         auto function = functionAndDataflow.first;
         auto &dataflow = *functionAndDataflow.second;
 
-        id2referrers_[getCalleeId(function)].functions.push_back(function);
+        auto functionId = getCalleeId(function);
+        auto functionNode = callGraph_.addNode(functionId);
+
+        id2referrers_[functionId].functions.push_back(function);
 
         foreach (auto basicBlock, function->basicBlocks()) {
             foreach (auto statement, basicBlock->statements()) {
@@ -65,6 +85,9 @@ void SignatureAnalyzer::computeMappings() {
 
                     id2referrers_[id].calls.push_back(call);
                     function2calls_[function].push_back(call);
+                    call2calleeId_[call] = id;
+
+                    callGraph_.addCall(functionNode, callGraph_.addNode(id));
 
                     foreach (const auto &locationAndTerm, hooks_.getCallHook(call)->speculativeReturnValueTerms()) {
                         speculativeReturnValueTerm2calleeId_[locationAndTerm.second] = id;
@@ -86,35 +109,192 @@ void SignatureAnalyzer::computeMappings() {
     }
 }
 
-void SignatureAnalyzer::computeUses() {
-    foreach (const auto &functionAndDataflow, dataflows_) {
-        function2uses_[functionAndDataflow.first] = std::make_unique<dflow::Uses>(*functionAndDataflow.second);
+void SignatureAnalyzer::computeFixedArgumentsAndReturnValues() {
+    foreach (const CalleeId &calleeId, id2referrers_ | boost::adaptors::map_keys) {
+        auto signature = getKnownSignature(calleeId);
+        if (!signature) {
+            continue;
+        }
+
+        auto &arguments = id2arguments_[calleeId];
+        foreach (const auto &argument, signature->arguments()) {
+            if (auto memoryLocation = getArgumentLocation(argument.get())) {
+                arguments.push_back(memoryLocation);
+            }
+        }
+
+        id2returnValue_[calleeId] = getArgumentLocation(signature->returnValue().get());
+
+        fixedIds_.insert(calleeId);
+    }
+}
+
+const FunctionSignature *SignatureAnalyzer::getKnownSignature(const CalleeId &calleeId) const {
+    if (auto entryAddress = calleeId.entryAddress()) {
+        return signatures_.getSignature(*entryAddress).get();
+    } else if (auto callAddress = calleeId.callAddress()) {
+        return signatures_.getCalleeSignature(*callAddress).get();
     }
+    return nullptr;
 }
 
 void SignatureAnalyzer::computeArgumentsAndReturnValues() {
-    int niterations = 0;
+    QElapsedTimer timer;
+    timer.start();
 
-    bool changed;
-    do {
-        changed = false;
+    auto components = callGraph_.computeComponents();
 
-        foreach (const CalleeId &calleeId, id2referrers_ | boost::adaptors::map_keys) {
-            if (computeArguments(calleeId)) {
-                changed = true;
-            }
-            if (computeReturnValue(calleeId)) {
-                changed = true;
+    /*
+     * The level of a component is zero if it calls no other components,
+     * and one plus the maximal level of the components it calls otherwise.
+     * Components of the same level do not call each other.
+     */
+    std::vector<std::size_t> node2component(callGraph_.size());
+    std::vector<std::size_t> node2level(callGraph_.size());
+    std::size_t nlevels = 0;
+    std::size_t largestComponentSize = 0;
+
+    for (std::size_t i = 0; i < components.size(); ++i) {
+        std::size_t level = 0;
+        foreach (auto node, components[i]) {
+            node2component[node] = i;
+        }
+        foreach (auto node, components[i]) {
+            foreach (auto callee, callGraph_.getCallees(node)) {
+                if (node2component[callee] != i) {
+                    level = std::max(level, node2level[callee] + 1);
+                }
             }
         }
+        foreach (auto node, components[i]) {
+            node2level[node] = level;
+        }
+        nlevels = std::max(nlevels, level + 1);
+        largestComponentSize = std::max(largestComponentSize, components[i].size());
+    }
+
+    /* Callee ids waiting to be computed, by levels. */
+    std::vector<std::vector<std::size_t>> worklists(nlevels);
+    std::vector<bool> queued(callGraph_.size());
+    std::vector<std::size_t> nevaluations(callGraph_.size());
+    std::vector<bool> reconstructed(callGraph_.size());
+    std::size_t level = 0;
+    std::size_t nunstable = 0;
+
+    for (std::size_t node = 0; node < callGraph_.size(); ++node) {
+        reconstructed[node] = isReconstructed(callGraph_.getCalleeId(node));
+    }
+
+    auto enqueue = [&](std::size_t node) {
+        if (!reconstructed[node] || queued[node]) {
+            return;
+        }
+        if (nevaluations[node] == MAX_EVALUATIONS) {
+            ++nunstable;
+            reconstructed[node] = false;
+            return;
+        }
+        queued[node] = true;
+        worklists[node2level[node]].push_back(node);
+        level = std::min(level, node2level[node]);
+    };
+
+    auto enqueueFunction = [&](const Function *function) {
+        enqueue(*callGraph_.getNode(getCalleeId(function)));
+        foreach (auto call, nc::find(function2calls_, function)) {
+            enqueue(*callGraph_.getNode(nc::find(call2calleeId_, call)));
+        }
+    };
+
+    foreach (const auto &component, components) {
+        foreach (auto node, component) {
+            enqueue(node);
+        }
+    }
 
-        if (++niterations > 3) {
-            log_.warning(tr("Fixpoint was not reached after %1 iterations while reconstructing arguments. Giving up.").arg(niterations));
+    /* Reused by all the rounds, so that the threads are not started anew. */
+    QThreadPool threadPool;
+
+    std::size_t nrounds = 0;
+    std::size_t ntotalEvaluations = 0;
+
+    while (true) {
+        while (level < nlevels && worklists[level].empty()) {
+            ++level;
+        }
+        if (level == nlevels) {
             break;
         }
 
+        /*
+         * All the callee ids of the lowest level waiting in the worklist are
+         * computed from the same estimates, and only then the results are stored.
+         * So, the result does not depend on the order and the number of threads.
+         */
+        std::vector<CalleeId> calleeIds;
+        calleeIds.reserve(worklists[level].size());
+        foreach (auto node, worklists[level]) {
+            queued[node] = false;
+            ++nevaluations[node];
+            calleeIds.push_back(callGraph_.getCalleeId(node));
+        }
+        worklists[level].clear();
+
+        std::vector<Estimate> estimates(calleeIds.size());
+
+        parallelFor((calleeIds.size() + JOB_SIZE - 1) / JOB_SIZE, [&](std::size_t job) {
+            auto end = std::min((job + 1) * JOB_SIZE, calleeIds.size());
+            for (auto i = job * JOB_SIZE; i < end; ++i) {
+                computeArguments(calleeIds[i], estimates[i]);
+                computeReturnValue(calleeIds[i], estimates[i]);
+            }
+        }, &threadPool);
+
+        for (std::size_t i = 0; i < calleeIds.size(); ++i) {
+            const auto &calleeId = calleeIds[i];
+
+            if (setArguments(calleeId, estimates[i])) {
+                /* Arguments of a callee id are used for computing the arguments of its callers. */
+                foreach (auto caller, callGraph_.getCallers(*callGraph_.getNode(calleeId))) {
+                    enqueue(caller);
+                }
+            }
+
+            if (setReturnValue(calleeId, estimates[i])) {
+                /*
+                 * The return value of a callee id determines which definitions and uses
+                 * are taken into account in the functions with speculative return value
+                 * terms for this callee id: the function itself and its callers.
+                 */
+                const auto &referrers = nc::find(id2referrers_, calleeId);
+                foreach (auto function, referrers.functions) {
+                    enqueueFunction(function);
+                }
+                foreach (auto call, referrers.calls) {
+                    enqueueFunction(call->basicBlock()->function());
+                }
+            }
+        }
+
+        ntotalEvaluations += calleeIds.size();
+        ++nrounds;
+
         canceled_.poll();
-    } while (changed);
+    }
+
+    if (nunstable > 0) {
+        log_.warning(tr("Fixpoint was not reached for %1 functions after %2 iterations while reconstructing arguments. Giving up.")
+            .arg(nunstable).arg(MAX_EVALUATIONS));
+    }
+
+    log_.debug(tr("Reconstructed arguments of %1 functions with %2 calls between them in %3 strongly connected components "
+                  "(the largest one has %4 functions) by %5 evaluations in %6 rounds in %7 ms.")
+        .arg(callGraph_.size()).arg(callGraph_.edgeCount()).arg(components.size()).arg(largestComponentSize)
+        .arg(ntotalEvaluations).arg(nrounds).arg(timer.elapsed()));
+}
+
+bool SignatureAnalyzer::isReconstructed(const CalleeId &calleeId) const {
+    return calleeId && !nc::contains(fixedIds_, calleeId) && hooks_.conventions().getConvention(calleeId);
 }
 
 namespace {
@@ -137,13 +317,10 @@ bool isHomogeneous(const Container &container) {
 
 } // anonymous namespace
 
-bool SignatureAnalyzer::computeArguments(const CalleeId &calleeId) {
-    assert(calleeId);
+void SignatureAnalyzer::computeArguments(const CalleeId &calleeId, Estimate &estimate) const {
+    assert(isReconstructed(calleeId));
 
     auto convention = hooks_.conventions().getConvention(calleeId);
-    if (!convention) {
-        return false;
-    }
 
     const auto &referrers = nc::find(id2referrers_, calleeId);
 
@@ -180,8 +357,8 @@ bool SignatureAnalyzer::computeArguments(const CalleeId &calleeId) {
         }
     };
 
-    std::vector<MemoryLocation> arguments;
-    boost::unordered_map<const Call *, std::vector<MemoryLocation>> extraArguments;
+    auto &arguments = estimate.arguments;
+    auto &extraArguments = estimate.extraArguments;
 
     foreach (auto &locationAndPlacement, placements) {
         if (auto location = getArgumentLocation(locationAndPlacement.second)) {
@@ -210,16 +387,20 @@ bool SignatureAnalyzer::computeArguments(const CalleeId &calleeId) {
                 }),
             callArguments.end());
     }
+}
+
+bool SignatureAnalyzer::setArguments(const CalleeId &calleeId, Estimate &estimate) {
+    assert(calleeId);
 
     bool changed = false;
 
     auto &oldArguments = id2arguments_[calleeId];
-    if (oldArguments != arguments) {
-        oldArguments = std::move(arguments);
+    if (oldArguments != estimate.arguments) {
+        oldArguments = std::move(estimate.arguments);
         changed = true;
     }
 
-    foreach (auto &callAndLocations, extraArguments) {
+    foreach (auto &callAndLocations, estimate.extraArguments) {
         auto &oldExtraArguments = call2extraArguments_[callAndLocations.first];
         if (oldExtraArguments != callAndLocations.second) {
             oldExtraArguments = std::move(callAndLocations.second);
@@ -230,13 +411,10 @@ bool SignatureAnalyzer::computeArguments(const CalleeId &calleeId) {
     return changed;
 }
 
-bool SignatureAnalyzer::computeReturnValue(const CalleeId &calleeId) {
-    assert(calleeId);
+void SignatureAnalyzer::computeReturnValue(const CalleeId &calleeId, Estimate &estimate) const {
+    assert(isReconstructed(calleeId));
 
     auto convention = hooks_.conventions().getConvention(calleeId);
-    if (!convention) {
-        return false;
-    }
 
     const auto &referrers = nc::find(id2referrers_, calleeId);
 
@@ -269,20 +447,22 @@ bool SignatureAnalyzer::computeReturnValue(const CalleeId &calleeId) {
         }
     }
 
-    MemoryLocation returnValueLocation;
-
     if (!placements.empty()) {
         auto it = std::max_element(placements.begin(), placements.end(),
             [](const std::pair<MemoryLocation, Placement> &a, const std::pair<MemoryLocation, Placement> &b){
                 return a.second.votes < b.second.votes;
         });
 
-        returnValueLocation = it->second.location;
+        estimate.returnValue = it->second.location;
     }
+}
+
+bool SignatureAnalyzer::setReturnValue(const CalleeId &calleeId, const Estimate &estimate) {
+    assert(calleeId);
 
     auto &oldReturnValueLocation = id2returnValue_[calleeId];
-    if (oldReturnValueLocation != returnValueLocation) {
-        oldReturnValueLocation = returnValueLocation;
+    if (oldReturnValueLocation != estimate.returnValue) {
+        oldReturnValueLocation = estimate.returnValue;
         return true;
     } else {
         return false;
@@ -297,8 +477,13 @@ class StackOffsetFixer {
 public:
     StackOffsetFixer(const Term *stackPointer, const dflow::Dataflow &dataflow) {
         if (stackPointer) {
-            auto value = dataflow.getValue(stackPointer);
-            if (value->isStackOffset()) {
+            /*
+             * Dataflow::getValue() inserts missing values, which is not safe
+             * when several functions are analyzed concurrently.
+             */
+            auto term = stackPointer->source() ? stackPointer->source() : stackPointer;
+            auto value = nc::find(dataflow.term2value(), term).get();
+            if (value && value->isStackOffset()) {
                 stackOffset_ = value->stackOffset() * CHAR_BIT;
             }
         }
@@ -331,7 +516,7 @@ public:
 
 } // anonymous namespace
 
-std::vector<MemoryLocation> SignatureAnalyzer::getUndefinedUses(const Function *function) {
+std::vector<MemoryLocation> SignatureAnalyzer::getUndefinedUses(const Function *function) const {
     assert(function != nullptr);
 
     auto &dataflow = *dataflows_.at(function);
@@ -345,7 +530,7 @@ std::vector<MemoryLocation> SignatureAnalyzer::getUndefinedUses(const Function *
      */
     foreach (const auto &termAndLocation, dataflow.term2location()) {
         auto term = termAndLocation.first;
-        const auto &memoryLocation = termAndLocation.second;
+        const auto &memoryLocation = dataflow.memoryLocations().get(termAndLocation.second);
 
         if (memoryLocation && term->isRead() && dataflow.getDefinitions(term).empty() && intersect(term, memoryLocation)) {
             result.push_back(memoryLocation);
@@ -359,19 +544,25 @@ std::vector<MemoryLocation> SignatureAnalyzer::getUndefinedUses(const Function *
      * to be used for passing an argument.
      */
     foreach (auto call, nc::find(function2calls_, function)) {
-        const auto &callArguments = nc::find(id2arguments_, getCalleeId(call, dataflow));
+        const auto &callArguments = nc::find(id2arguments_, nc::find(call2calleeId_, call));
         if (callArguments.empty()) {
             continue;
         }
 
         auto callHook = hooks_.getCallHook(call);
         auto fixer = StackOffsetFixer(callHook->stackPointer(), dataflow);
-        auto &reachingDefinitions = dataflow.getDefinitions(callHook->snapshotStatement());
+        auto snapshot = callHook->snapshotStatement()->as<RememberReachingDefinitions>();
+        auto &reachingDefinitions = dataflow.getDefinitions(snapshot);
 
         foreach (auto memoryLocation, callArguments) {
+            /* Whether the locations not remembered at the call are defined is unknown. */
+            if (!snapshot->remembers(memoryLocation)) {
+                continue;
+            }
+
             memoryLocation = fixer.addStackOffset(memoryLocation);
 
-            if (memoryLocation && reachingDefinitions.projected(memoryLocation).empty()) {
+            if (memoryLocation && !reachingDefinitions.definesPartOf(memoryLocation)) {
                 result.push_back(memoryLocation);
             }
         }
@@ -380,7 +571,7 @@ std::vector<MemoryLocation> SignatureAnalyzer::getUndefinedUses(const Function *
     return result;
 }
 
-std::vector<MemoryLocation> SignatureAnalyzer::getUnusedDefines(const Call *call) {
+std::vector<MemoryLocation> SignatureAnalyzer::getUnusedDefines(const Call *call) const {
     assert(call != nullptr);
 
     std::vector<MemoryLocation> result;
@@ -388,12 +579,14 @@ std::vector<MemoryLocation> SignatureAnalyzer::getUnusedDefines(const Call *call
     auto callHook = hooks_.getCallHook(call);
     auto function = call->basicBlock()->function();
     auto &dataflow = *dataflows_.at(function);
-    auto &uses = *function2uses_.at(function);
+    auto &uses = *defUseGraphs_.at(function);
     auto fixer = StackOffsetFixer(callHook->stackPointer(), dataflow);
 
-    foreach (const auto &chunk, dataflow.getDefinitions(callHook->snapshotStatement()).chunks()) {
+    const auto &definitions = dataflow.getDefinitions(callHook->snapshotStatement());
+
+    foreach (const auto &chunk, definitions.chunks()) {
         foreach (const Term *term, chunk.definitions()) {
-            if (intersect(term, chunk.location())) {
+            if (intersect(term, definitions.getLocation(chunk))) {
                 bool used = false;
                 foreach (const auto &use, uses.getUses(term)) {
                     if (intersect(use.term(), use.location())) {
@@ -402,7 +595,7 @@ std::vector<MemoryLocation> SignatureAnalyzer::getUnusedDefines(const Call *call
                     }
                 }
                 if (!used) {
-                    if (auto memoryLocation = fixer.removeStackOffset(chunk.location())) {
+                    if (auto memoryLocation = fixer.removeStackOffset(definitions.getLocation(chunk))) {
                         result.push_back(memoryLocation);
                     }
                 }
@@ -413,14 +606,14 @@ std::vector<MemoryLocation> SignatureAnalyzer::getUnusedDefines(const Call *call
     return result;
 }
 
-std::vector<MemoryLocation> SignatureAnalyzer::getUsedReturnValueLocations(const Call *call) {
+std::vector<MemoryLocation> SignatureAnalyzer::getUsedReturnValueLocations(const Call *call) const {
     assert(call != nullptr);
 
     std::vector<MemoryLocation> result;
 
     auto callHook = hooks_.getCallHook(call);
     auto function = call->basicBlock()->function();
-    auto &uses = *function2uses_.at(function);
+    auto &uses = *defUseGraphs_.at(function);
 
     foreach (const auto &locationAndTerm, callHook->speculativeReturnValueTerms()) {
         MemoryLocation usedPart;
@@ -437,7 +630,7 @@ std::vector<MemoryLocation> SignatureAnalyzer::getUsedReturnValueLocations(const
     return result;
 }
 
-std::vector<MemoryLocation> SignatureAnalyzer::getUnusedReturnValueLocations(const Jump *jump) {
+std::vector<MemoryLocation> SignatureAnalyzer::getUnusedReturnValueLocations(const Jump *jump) const {
     assert(jump != nullptr);
 
     std::vector<MemoryLocation> result;
@@ -445,15 +638,17 @@ std::vector<MemoryLocation> SignatureAnalyzer::getUnusedReturnValueLocations(con
     auto returnHook = hooks_.getReturnHook(jump);
     auto function = jump->basicBlock()->function();
     auto &dataflow = *dataflows_.at(function);
-    auto &uses = *function2uses_.at(function);
+    auto &uses = *defUseGraphs_.at(function);
     auto &liveness = *livenesses_.at(function);
 
     foreach (const auto &locationAndTerm, returnHook->speculativeReturnValueTerms()) {
         MemoryLocation unusedPart;
 
-        foreach (const auto &chunk, dataflow.getDefinitions(locationAndTerm.second).chunks()) {
+        const auto &definitions = dataflow.getDefinitions(locationAndTerm.second);
+
+        foreach (const auto &chunk, definitions.chunks()) {
             foreach (const Term *definition, chunk.definitions()) {
-                if (auto intersection = intersect(definition, chunk.location())) {
+                if (auto intersection = intersect(definition, definitions.getLocation(chunk))) {
                     bool used = false;
                     foreach (const auto &use, uses.getUses(definition)) {
                         if (use.term() != locationAndTerm.second && intersect(use.term(), use.location()) &&
@@ -478,7 +673,7 @@ std::vector<MemoryLocation> SignatureAnalyzer::getUnusedReturnValueLocations(con
     return result;
 }
 
-MemoryLocation SignatureAnalyzer::intersect(const Term *term, const MemoryLocation &memoryLocation) {
+MemoryLocation SignatureAnalyzer::intersect(const Term *term, const MemoryLocation &memoryLocation) const {
     assert(term);
     assert(memoryLocation);
 
@@ -496,40 +691,61 @@ void SignatureAnalyzer::computeSignatures() {
     }
 }
 
+
 namespace {
 
-class ArgumentFactory {
-    MemoryLocation stackPointer_;
-public:
+/**
+ * \return True if the two terms describe the same argument or return value.
+ */
+bool isSameArgument(const std::shared_ptr<const Term> &a, const std::shared_ptr<const Term> &b) {
+    if (a == b) {
+        return true;
+    }
+    if (!a || !b || a->kind() != b->kind()) {
+        return false;
+    }
+    auto location = getArgumentLocation(a.get());
+    return location && location == getArgumentLocation(b.get());
+}
 
-    ArgumentFactory(const Convention *convention) {
-        if (convention) {
-            stackPointer_ = convention->stackPointer();
+template<class Signature>
+bool isSameArgumentsAndReturnValue(const Signature &a, const Signature &b) {
+    if (a.arguments().size() != b.arguments().size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.arguments().size(); ++i) {
+        if (!isSameArgument(a.arguments()[i], b.arguments()[i])) {
+            return false;
         }
     }
+    return isSameArgument(a.returnValue(), b.returnValue());
+}
 
-    std::shared_ptr<Term> operator()(const MemoryLocation &memoryLocation) const {
-        if (memoryLocation.domain() == MemoryDomain::STACK) {
-            if (stackPointer_) {
-                return std::make_shared<Dereference>(
-                    std::make_unique<BinaryOperator>(
-                        BinaryOperator::ADD,
-                        std::make_unique<MemoryLocationAccess>(stackPointer_),
-                        std::make_unique<Constant>(SizedValue(
-                            stackPointer_.size<SmallBitSize>(),
-                            memoryLocation.addr() / CHAR_BIT)),
-                        stackPointer_.size<SmallBitSize>()),
-                    MemoryDomain::MEMORY,
-                    memoryLocation.size<SmallBitSize>()
-                );
-            } else {
-                return nullptr;
-            }
-        } else {
-            return std::make_shared<MemoryLocationAccess>(memoryLocation);
-        }
+bool isEquivalent(const FunctionSignature &a, const FunctionSignature &b) {
+    return a.variadic() == b.variadic() && isSameArgumentsAndReturnValue(a, b);
+}
+
+bool isEquivalent(const CallSignature &a, const CallSignature &b) {
+    return isSameArgumentsAndReturnValue(a, b);
+}
+
+/**
+ * Replaces the signature by the old one, if they are equivalent.
+ * Hooks are created for particular signature objects, so keeping
+ * the old objects keeps the hooks, and the dataflow computed
+ * with them, valid.
+ *
+ * \param[in,out] signature Valid pointer to a new signature.
+ * \param[in] oldSignature Pointer to the old signature. Can be nullptr.
+ */
+template<class Signature>
+void keepOldSignature(std::shared_ptr<Signature> &signature, const std::shared_ptr<Signature> &oldSignature) {
+    assert(signature != nullptr);
+
+    if (oldSignature && isEquivalent(*oldSignature, *signature)) {
+        signature = oldSignature;
     }
-};
+}
 
 } // anonymous namespace
 
@@ -540,6 +756,10 @@ void SignatureAnalyzer::computeSignatures(const CalleeId &calleeId) {
     auto convention = hooks_.conventions().getConvention(calleeId);
     auto argumentFactory = ArgumentFactory(convention);
 
+    if (nc::contains(fixedIds_, calleeId)) {
+        functionSignature->setVariadic(getKnownSignature(calleeId)->variadic());
+    }
+
     foreach (const auto &memoryLocation, nc::find(id2arguments_, calleeId)) {
         if (auto term = argumentFactory(memoryLocation)) {
             functionSignature->arguments().push_back(term);
@@ -550,14 +770,10 @@ void SignatureAnalyzer::computeSignatures(const CalleeId &calleeId) {
         functionSignature->setReturnValue(std::make_shared<MemoryLocationAccess>(returnValueLocation));
     }
 
-    if (calleeId.entryAddress()) {
-        signatures_.setSignature(*calleeId.entryAddress(), functionSignature);
-    }
-
     const auto &referrers = nc::find(id2referrers_, calleeId);
-    foreach (auto function, referrers.functions) {
-        signatures_.setSignature(function, functionSignature);
-    }
+
+    std::vector<std::pair<const Call *, std::shared_ptr<CallSignature>>> callSignatures;
+    callSignatures.reserve(referrers.calls.size());
 
     foreach (auto call, referrers.calls) {
         auto callSignature = std::make_shared<CallSignature>();
@@ -571,7 +787,26 @@ void SignatureAnalyzer::computeSignatures(const CalleeId &calleeId) {
         }
         callSignature->setReturnValue(functionSignature->returnValue());
 
-        signatures_.setSignature(call, callSignature);
+        keepOldSignature(callSignature, signatures_.getSignature(call));
+        callSignatures.push_back(std::make_pair(call, std::move(callSignature)));
+    }
+
+    if (calleeId.entryAddress()) {
+        keepOldSignature(functionSignature, signatures_.getSignature(*calleeId.entryAddress()));
+    } else if (!referrers.functions.empty()) {
+        keepOldSignature(functionSignature, signatures_.getSignature(referrers.functions.front()));
+    }
+
+    if (calleeId.entryAddress()) {
+        signatures_.setSignature(*calleeId.entryAddress(), functionSignature);
+    }
+
+    foreach (auto function, referrers.functions) {
+        signatures_.setSignature(function, functionSignature);
+    }
+
+    foreach (auto &callAndSignature, callSignatures) {
+        signatures_.setSignature(callAndSignature.first, std::move(callAndSignature.second));
     }
 }
 
@@ -10,12 +10,14 @@
 #include <QCoreApplication>
 
 #include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
 
 #include <nc/common/CancellationToken.h>
 #include <nc/common/LogToken.h>
 
 #include <nc/core/ir/MemoryLocation.h>
 
+#include "CallGraph.h"
 #include "CalleeId.h"
 
 namespace nc {
@@ -30,7 +32,7 @@ class Term;
 
 namespace dflow {
     class Dataflows;
-    class Uses;
+    class DefUseGraphs;
 }
 
 namespace liveness {
@@ -52,6 +54,7 @@ class SignatureAnalyzer {
 
     Signatures &signatures_;
     const dflow::Dataflows &dataflows_;
+    const dflow::DefUseGraphs &defUseGraphs_;
     const Hooks &hooks_;
     const liveness::Livenesses &livenesses_;
     const CancellationToken &canceled_;
@@ -66,6 +69,12 @@ class SignatureAnalyzer {
     /** Mapping from a callee id to the functions, calls, and returns with this id. */
     boost::unordered_map<CalleeId, Referrers> id2referrers_;
 
+    /** Mapping from a call to the callee id of the called function. */
+    boost::unordered_map<const Call *, CalleeId> call2calleeId_;
+
+    /** Call graph over callee ids. */
+    CallGraph callGraph_;
+
     /** Mapping from a function to the list of calls in it.*/
     boost::unordered_map<const Function *, std::vector<const Call *>> function2calls_;
 
@@ -75,9 +84,6 @@ class SignatureAnalyzer {
     /** Mapping of terms that represent potential return values in the hooks to callee ids. */
     boost::unordered_map<const Term *, CalleeId> speculativeReturnValueTerm2calleeId_;
 
-    /** Mapping from a function to the term use information for this function. */
-    boost::unordered_map<const Function *, std::unique_ptr<dflow::Uses>> function2uses_;
-
     /** Mapping from a callee id to the list of its formal arguments. */
     boost::unordered_map<CalleeId, std::vector<MemoryLocation>> id2arguments_;
 
@@ -88,18 +94,33 @@ class SignatureAnalyzer {
     /** Mapping from a callee id to the estimated return value location. */
     boost::unordered_map<CalleeId, MemoryLocation> id2returnValue_;
 
+    /** Callee ids whose signatures were known before the analysis and are not recomputed. */
+    boost::unordered_set<CalleeId> fixedIds_;
+
+    /**
+     * Arguments and return value of a callee id computed from the current
+     * estimates for the other callee ids, before they are stored.
+     */
+    struct Estimate {
+        std::vector<MemoryLocation> arguments;
+        boost::unordered_map<const Call *, std::vector<MemoryLocation>> extraArguments;
+        MemoryLocation returnValue;
+    };
+
 public:
     /**
      * Constructor.
      *
      * \param signatures An object where to store reconstructed signatures.
      * \param dataflows Dataflows.
+     * \param defUseGraphs Def-use graphs of the functions.
      * \param hooks Hooks manager.
      * \param livenesses Livenesses.
      * \param canceled Cancellation token.
      * \param log Log token.
      */
-    SignatureAnalyzer(Signatures &signatures, const dflow::Dataflows &dataflows, const Hooks &hooks,
+    SignatureAnalyzer(Signatures &signatures, const dflow::Dataflows &dataflows,
+                      const dflow::DefUseGraphs &defUseGraphs, const Hooks &hooks,
                       const liveness::Livenesses &livenesses, const CancellationToken &canceled, const LogToken &log);
 
     /**
@@ -116,34 +137,77 @@ private:
     void computeMappings();
 
     /**
-     * Precomputes uses information.
+     * Takes the arguments and return values of the callee ids
+     * whose signatures are already known (see getKnownSignature()).
+     * These signatures are kept as they are.
      */
-    void computeUses();
+    void computeFixedArgumentsAndReturnValues();
 
     /**
-     * Computes locations of arguments for all functions.
+     * \param calleeId Callee id.
+     *
+     * \return Pointer to the signature set before the analysis for the entry
+     *         address or the call address of the callee id. Can be nullptr.
+     */
+    const FunctionSignature *getKnownSignature(const CalleeId &calleeId) const;
+
+    /**
+     * Computes locations of arguments and return values for all functions.
+     *
+     * Strongly connected components of the call graph are processed
+     * bottom-up, so that the arguments of callees are mostly known by the
+     * time their callers are analyzed. A callee id is recomputed only
+     * when an estimate it depends on has changed. Components not calling
+     * each other are analyzed concurrently.
      */
     void computeArgumentsAndReturnValues();
 
     /**
-     * Recomputes arguments of the function with the given callee id
+     * \param[in] calleeId Callee id.
+     *
+     * \return True if the arguments and the return value of the callee id
+     *         must be reconstructed, false if they are fixed or cannot be
+     *         reconstructed at all.
+     */
+    bool isReconstructed(const CalleeId &calleeId) const;
+
+    /**
+     * Computes arguments of the function with the given callee id
      * by looking at the function's body and calls to it.
      *
      * \param[in] calleeId Valid callee id.
+     * \param[out] estimate Where to store the arguments and the extra arguments of calls.
+     */
+    void computeArguments(const CalleeId &calleeId, Estimate &estimate) const;
+
+    /**
+     * Computes the return value of the function with the given callee id
+     * by looking at the call and return sites.
+     *
+     * \param[in] calleeId Valid callee id.
+     * \param[out] estimate Where to store the return value.
+     */
+    void computeReturnValue(const CalleeId &calleeId, Estimate &estimate) const;
+
+    /**
+     * Stores the arguments and the extra arguments of calls from the estimate.
+     *
+     * \param[in] calleeId Valid callee id.
+     * \param[in] estimate Estimate. Its arguments are moved from.
      *
      * \return True if the arguments have changed, false otherwise.
      */
-    bool computeArguments(const CalleeId &calleeId);
+    bool setArguments(const CalleeId &calleeId, Estimate &estimate);
 
     /**
-     * Recomputes the return value of the function with the given callee id
-     * by looking at the call and return sites.
+     * Stores the return value from the estimate.
      *
      * \param[in] calleeId Valid callee id.
+     * \param[in] estimate Estimate.
      *
      * \return True if the return value has changed, false otherwise.
      */
-    bool computeReturnValue(const CalleeId &calleeId);
+    bool setReturnValue(const CalleeId &calleeId, const Estimate &estimate);
 
     /**
      * \param[in] function Valid pointer to a function.
@@ -151,7 +215,7 @@ private:
      * \return Memory locations in the function that are read in the function,
      *         but whose value is not defined before it is read.
      */
-    std::vector<MemoryLocation> getUndefinedUses(const Function *function);
+    std::vector<MemoryLocation> getUndefinedUses(const Function *function) const;
 
     /**
      * \param[in] call Valid pointer to a call statement.
@@ -159,7 +223,7 @@ private:
      * \return Memory locations that are defined before the call, but never used.
      *         Stack offsets are fixed up in accordance to the reaching stack pointer value.
      */
-    std::vector<MemoryLocation> getUnusedDefines(const Call *call);
+    std::vector<MemoryLocation> getUnusedDefines(const Call *call) const;
 
     /**
      * \param[in] call Valid pointer to a call statement.
@@ -167,7 +231,7 @@ private:
      * \return List of memory locations within the locations where the
      *         return value can be passed, which are read after the call.
      */
-    std::vector<MemoryLocation> getUsedReturnValueLocations(const Call *call);
+    std::vector<MemoryLocation> getUsedReturnValueLocations(const Call *call) const;
 
     /**
      * \param[in] jump Valid pointer to a return jump.
@@ -176,7 +240,7 @@ private:
      *         return value can be passed, which are written before the
      *         return and never read.
      */
-    std::vector<MemoryLocation> getUnusedReturnValueLocations(const Jump *jump);
+    std::vector<MemoryLocation> getUnusedReturnValueLocations(const Jump *jump) const;
 
     /**
      * \param term Valid pointer to a term.
@@ -186,7 +250,7 @@ private:
      *         If it is, then the intersection of the currently assumed return
      *         value location and memoryLocation is returned.
      */
-    MemoryLocation intersect(const Term *term, const MemoryLocation &memoryLocation);
+    MemoryLocation intersect(const Term *term, const MemoryLocation &memoryLocation) const;
 
     /**
      * Computes and sets signatures for all callee ids.
@@ -32,6 +32,13 @@ class Signatures {
     /** Mapping from a call to its signature. */
     boost::unordered_map<const Call *, std::shared_ptr<CallSignature>> call2signature_;
 
+    /**
+     * Mapping from an address of a call instruction to the signature of the function
+     * called by it, for callees known only by the call, e.g. imported functions
+     * called through an import table.
+     */
+    boost::unordered_map<ByteAddr, std::shared_ptr<FunctionSignature>> callAddr2calleeSignature_;
+
 public:
     /**
      * \param addr Address of a function.
@@ -93,6 +100,25 @@ public:
         assert(call != nullptr);
         call2signature_[call] = std::move(signature);
     }
+
+    /**
+     * \param callAddr Address of a call instruction.
+     *
+     * \return Pointer to the signature of the function called by this instruction. Can be nullptr.
+     */
+    const std::shared_ptr<FunctionSignature> &getCalleeSignature(ByteAddr callAddr) const {
+        return nc::find(callAddr2calleeSignature_, callAddr);
+    }
+
+    /**
+     * Sets the signature of the function called by a call instruction.
+     *
+     * \param callAddr Address of the call instruction.
+     * \param signature Pointer to the signature. Can be nullptr.
+     */
+    void setCalleeSignature(ByteAddr callAddr, std::shared_ptr<FunctionSignature> signature) {
+        callAddr2calleeSignature_[callAddr] = std::move(signature);
+    }
 };
 
 } // namespace calling
@@ -29,6 +29,7 @@
 
 #include <boost/unordered_map.hpp>
 
+#include <nc/common/Budget.h>
 #include <nc/common/Foreach.h>
 #include <nc/common/Range.h>
 #include <nc/common/make_unique.h>
@@ -62,6 +63,13 @@ void StructureAnalyzer::analyze(Region *region) {
     do {
         changed = false;
 
+        /*
+         * Each reduction leaves the graph consistent, so we can stop at any of them.
+         */
+        if (budget_ && !budget_->checkTime()) {
+            return;
+        }
+
         /*
          * Classify edges, sort nodes topologically.
          */
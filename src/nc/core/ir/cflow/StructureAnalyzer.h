@@ -28,6 +28,9 @@
 #include <memory>
 
 namespace nc {
+
+class Budget;
+
 namespace core {
 namespace ir {
 
@@ -52,15 +55,21 @@ class StructureAnalyzer {
     /** Dataflow information. */
     const dflow::Dataflow &dataflow_;
 
+    /** Budget of the analysis. Can be nullptr. */
+    Budget *budget_;
+
 public:
     /**
      * Class constructor.
      *
      * \param graph Graph to analyze.
      * \param dataflow Dataflow information.
+     * \param budget Budget of the analysis. Can be nullptr. When the budget
+     *               is exceeded, the analysis stops reducing regions, and the
+     *               nodes not reduced so far are output with gotos.
      */
-    StructureAnalyzer(Graph &graph, const dflow::Dataflow &dataflow):
-        graph_(graph), dataflow_(dataflow)
+    StructureAnalyzer(Graph &graph, const dflow::Dataflow &dataflow, Budget *budget = nullptr):
+        graph_(graph), dataflow_(dataflow), budget_(budget)
     {}
 
     /**
@@ -24,6 +24,8 @@
 
 #include "CodeGenerator.h"
 
+#include <cassert>
+
 #include <nc/common/CancellationToken.h>
 #include <nc/common/Foreach.h>
 #include <nc/common/Range.h>
@@ -55,12 +57,33 @@ namespace core {
 namespace ir {
 namespace cgen {
 
+void CodeGenerator::addFunctionComment(const Function *function, const QString &comment) {
+    assert(function != nullptr);
+
+    auto &result = functionComments_[function];
+    if (!result.isEmpty()) {
+        result += '\n';
+    }
+    result += comment;
+}
+
+const QString &CodeGenerator::getFunctionComment(const Function *function) const {
+    assert(function != nullptr);
+
+    return nc::find(functionComments_, function);
+}
+
 void CodeGenerator::makeCompilationUnit() {
+    std::vector<const Function *> functions(this->functions().list().begin(), this->functions().list().end());
+    makeCompilationUnit(functions);
+}
+
+void CodeGenerator::makeCompilationUnit(const std::vector<const Function *> &functions) {
     tree().setPointerSize(image().platform().architecture()->bitness());
     tree().setIntSize(image().platform().intSize());
     tree().setRoot(std::make_unique<likec::CompilationUnit>());
 
-    foreach (const Function *function, functions().list()) {
+    foreach (const Function *function, functions) {
         makeFunctionDefinition(function);
         cancellationToken().poll();
     }
@@ -241,6 +264,9 @@ likec::FunctionDeclaration *CodeGenerator::makeFunctionDeclaration(ByteAddr addr
 }
 
 likec::FunctionDefinition *CodeGenerator::makeFunctionDefinition(const Function *function) {
+    /* Nodes of a function are allocated together and freed with the tree. */
+    likec::TreeNode::ArenaScope scope(tree().makeArena());
+
     DefinitionGenerator generator(*this, function, cancellationToken());
     tree().root()->addDeclaration(generator.createDefinition());
     return generator.definition();
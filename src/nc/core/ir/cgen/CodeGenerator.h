@@ -73,6 +73,7 @@ namespace cflow {
 
 namespace dflow {
     class Dataflows;
+    class DefUseGraphs;
 }
 
 namespace liveness {
@@ -101,6 +102,7 @@ class CodeGenerator: boost::noncopyable {
     const calling::Hooks &hooks_;
     const calling::Signatures &signatures_;
     const dflow::Dataflows &dataflows_;
+    const dflow::DefUseGraphs &defUseGraphs_;
     const vars::Variables &variables_;
     const cflow::Graphs &graphs_;
     const liveness::Livenesses &livenesses_;
@@ -120,6 +122,9 @@ class CodeGenerator: boost::noncopyable {
     /** Mapping of functions to their declarations. */
     boost::unordered_map<const calling::FunctionSignature *, likec::FunctionDeclaration *> signature2declaration_;
 
+    /** Additional comments for the definitions of functions. */
+    boost::unordered_map<const Function *, QString> functionComments_;
+
 public:
 
     /**
@@ -131,6 +136,7 @@ public:
      * \param[in] hooks Hooks manager.
      * \param[in] signatures Signatures of functions.
      * \param[in] dataflows Dataflow information for all functions.
+     * \param[in] defUseGraphs Def-use graphs of all functions.
      * \param[in] variables Information about reconstructed variables.
      * \param[in] graphs Reduced control-flow graphs.
      * \param[in] livenesses Liveness information for all functions.
@@ -138,12 +144,13 @@ public:
      * \param[in] cancellationToken Cancellation token.
      */
     CodeGenerator(likec::Tree &tree, const image::Image &image, const Functions &functions, const calling::Hooks &hooks,
-        const calling::Signatures &signatures, const dflow::Dataflows &dataflows, const vars::Variables &variables,
+        const calling::Signatures &signatures, const dflow::Dataflows &dataflows,
+        const dflow::DefUseGraphs &defUseGraphs, const vars::Variables &variables,
         const cflow::Graphs &graphs, const liveness::Livenesses &livenesses, const types::Types &types,
         const CancellationToken &cancellationToken
     ):
         tree_(tree), image_(image), functions_(functions), hooks_(hooks), signatures_(signatures),
-        dataflows_(dataflows), variables_(variables), graphs_(graphs), livenesses_(livenesses),
+        dataflows_(dataflows), defUseGraphs_(defUseGraphs), variables_(variables), graphs_(graphs), livenesses_(livenesses),
         types_(types), cancellationToken_(cancellationToken), nameGenerator_(image)
     {}
 
@@ -177,6 +184,11 @@ public:
      */
     const ir::dflow::Dataflows &dataflows() const { return dataflows_; }
 
+    /**
+     * \return Def-use graphs of all functions.
+     */
+    const ir::dflow::DefUseGraphs &defUseGraphs() const { return defUseGraphs_; }
+
     /**
      * \return Reconstructed variables.
      */
@@ -204,11 +216,35 @@ public:
 
     const NameGenerator &nameGenerator() const { return nameGenerator_; }
 
+    /**
+     * Adds a line to the comment of the definition of the function.
+     *
+     * \param function Valid pointer to a function.
+     * \param comment Comment line.
+     */
+    void addFunctionComment(const Function *function, const QString &comment);
+
+    /**
+     * \param function Valid pointer to a function.
+     *
+     * \return Additional comment for the definition of the function, or an empty string.
+     */
+    const QString &getFunctionComment(const Function *function) const;
+
     /**
      * Translates input program into LikeC compilation unit.
      */
     void makeCompilationUnit();
 
+    /**
+     * Translates input program into LikeC compilation unit containing
+     * definitions only of the given functions. Other functions get
+     * declared on demand, as the callees of the defined ones.
+     *
+     * \param functions Valid pointers to the functions to generate definitions for.
+     */
+    void makeCompilationUnit(const std::vector<const Function *> &functions);
+
     /**
      * Creates high-level type object from given type traits.
      *
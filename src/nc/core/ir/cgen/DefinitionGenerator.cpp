@@ -53,7 +53,7 @@
 #include <nc/core/ir/cflow/Graphs.h>
 #include <nc/core/ir/cflow/Switch.h>
 #include <nc/core/ir/dflow/Dataflows.h>
-#include <nc/core/ir/dflow/Uses.h>
+#include <nc/core/ir/dflow/DefUseGraphs.h>
 #include <nc/core/ir/dflow/Utils.h>
 #include <nc/core/ir/dflow/Value.h>
 #include <nc/core/ir/liveness/Livenesses.h>
@@ -102,7 +102,7 @@ DefinitionGenerator::DefinitionGenerator(CodeGenerator &parent, const Function *
     dataflow_(*parent.dataflows().at(function)),
     graph_(*parent.graphs().at(function)),
     liveness_(*parent.livenesses().at(function)),
-    uses_(std::make_unique<dflow::Uses>(dataflow_)),
+    defUseGraph_(*parent.defUseGraphs().at(function)),
     cfg_(std::make_unique<CFG>(function->basicBlocks())),
     dominators_(std::make_unique<Dominators>(*cfg_, canceled)),
     hookStatements_(getHookStatements(function, dataflow_, parent.hooks())),
@@ -125,6 +125,14 @@ std::unique_ptr<likec::FunctionDefinition> DefinitionGenerator::createDefinition
     auto functionDefinition = std::make_unique<likec::FunctionDefinition>(tree(),
         std::move(nameAndComment.name()), makeReturnType(), signature()->variadic());
 
+    const auto &extraComment = parent().getFunctionComment(function_);
+    if (!extraComment.isEmpty()) {
+        if (!nameAndComment.comment().isEmpty()) {
+            nameAndComment.comment() += '\n';
+        }
+        nameAndComment.comment() += extraComment;
+    }
+
     functionDefinition->setComment(std::move(nameAndComment.comment()));
 
     setDefinition(functionDefinition.get());
@@ -1259,7 +1267,7 @@ bool DefinitionGenerator::computeIsSubstituted(const Term *write) {
 
     std::size_t nuses = 0;
 
-    foreach (const auto &use, uses_->getUses(write)) {
+    foreach (const auto &use, defUseGraph_.getUses(write)) {
         auto read = use.term();
 
         if (liveness_.isLive(read)) {
@@ -63,7 +63,7 @@ namespace cflow {
 
 namespace dflow {
     class Dataflow;
-    class Uses;
+    class DefUseGraph;
 }
 
 namespace vars {
@@ -86,7 +86,7 @@ class DefinitionGenerator: public DeclarationGenerator {
     const dflow::Dataflow &dataflow_;
     const cflow::Graph &graph_;
     const liveness::Liveness &liveness_;
-    std::unique_ptr<dflow::Uses> uses_;
+    const dflow::DefUseGraph &defUseGraph_;
     std::unique_ptr<CFG> cfg_;
     std::unique_ptr<Dominators> dominators_;
     boost::unordered_set<const Statement *> hookStatements_;
@@ -31,10 +31,19 @@ namespace core {
 namespace ir {
 namespace dflow {
 
-Dataflow::Dataflow() {}
+Dataflow::Dataflow(): fixpointConfirmed_(true) {}
 
 Dataflow::~Dataflow() {}
 
+void Dataflow::clear() {
+    term2value_.clear();
+    term2location_.clear();
+    term2definitions_.clear();
+    statement2definitions_.clear();
+    memoryLocations_.clear();
+    fixpointConfirmed_ = true;
+}
+
 Value *Dataflow::getValue(const Term *term) {
     assert(term != nullptr);
 
@@ -32,6 +32,7 @@
 #include <nc/common/Range.h>
 
 #include <nc/core/ir/MemoryLocation.h>
+#include <nc/core/ir/MemoryLocationHandle.h>
 #include <nc/core/ir/Term.h>
 
 #include "ReachingDefinitions.h"
@@ -47,11 +48,14 @@ class Value;
  * This class contains results of dataflow and constant propagation and folding analysis.
  */
 class Dataflow {
+    /** Memory locations referenced by the handles stored in this object. */
+    MemoryLocationTable memoryLocations_;
+
     /** Mapping from a term to a description of its value. */
     boost::unordered_map<const Term *, std::unique_ptr<Value>> term2value_;
 
-    /** Mapping from a term to its memory location. */
-    boost::unordered_map<const Term *, MemoryLocation> term2location_;
+    /** Mapping from a term to the handle of its memory location. */
+    boost::unordered_map<const Term *, MemoryLocationHandle> term2location_;
 
     /** Mapping from a term to the reaching definitions. */
     boost::unordered_map<const Term *, ReachingDefinitions> term2definitions_;
@@ -59,6 +63,9 @@ class Dataflow {
     /** Mapping from a statement to the reaching definitions. */
     boost::unordered_map<const Statement *, ReachingDefinitions> statement2definitions_;
 
+    /** Whether the fixpoint was confirmed by the additional passes of the analysis. */
+    bool fixpointConfirmed_;
+
 public:
     /**
      * Constructor.
@@ -70,6 +77,12 @@ public:
      */
     ~Dataflow();
 
+    /**
+     * Forgets all the information, keeping the allocated hash tables,
+     * so that the object can be reused for analyzing another piece of code.
+     */
+    void clear();
+
     /**
      * \param[in] term Valid pointer to a term.
      *
@@ -106,7 +119,7 @@ public:
      */
     const ir::MemoryLocation &getMemoryLocation(const Term *term) const {
         assert(term != nullptr);
-        return nc::find(term2location_, term);
+        return memoryLocations_.get(nc::find(term2location_, term));
     }
 
     /**
@@ -119,18 +132,34 @@ public:
      */
     const MemoryLocation &setMemoryLocation(const Term *term, const MemoryLocation &memoryLocation) {
         assert(term != nullptr);
-        return (term2location_[term] = memoryLocation);
+
+        /* The location of a term rarely changes between iterations: then the table is not consulted. */
+        auto &handle = term2location_[term];
+        if (memoryLocations_.get(handle) != memoryLocation) {
+            handle = memoryLocations_.intern(memoryLocation);
+        }
+        return memoryLocations_.get(handle);
     }
 
     /**
-     * \return Mapping from a term to its memory location.
+     * \return Table of the memory locations referenced by the handles stored in this object.
      */
-    boost::unordered_map<const Term *, MemoryLocation> &term2location() { return term2location_; };
+    MemoryLocationTable &memoryLocations() { return memoryLocations_; }
 
     /**
-     * \return Mapping from a term to its memory location.
+     * \return Table of the memory locations referenced by the handles stored in this object.
      */
-    const boost::unordered_map<const Term *, MemoryLocation> &term2location() const { return term2location_; };
+    const MemoryLocationTable &memoryLocations() const { return memoryLocations_; }
+
+    /**
+     * \return Mapping from a term to the handle of its memory location.
+     */
+    boost::unordered_map<const Term *, MemoryLocationHandle> &term2location() { return term2location_; };
+
+    /**
+     * \return Mapping from a term to the handle of its memory location.
+     */
+    const boost::unordered_map<const Term *, MemoryLocationHandle> &term2location() const { return term2location_; };
 
     /**
      * \param[in] term Valid pointer to a read term.
@@ -183,6 +212,21 @@ public:
         assert(statement != nullptr);
         return nc::find(statement2definitions_, statement);
     }
+
+    /**
+     * \return True if the fixpoint was confirmed by the additional passes
+     *         that let the memory locations of terms settle. If not, the
+     *         reaching definitions are still complete, but dead code must
+     *         not be removed based on them.
+     */
+    bool fixpointConfirmed() const { return fixpointConfirmed_; }
+
+    /**
+     * Sets whether the fixpoint was confirmed by the additional passes.
+     *
+     * \param confirmed Whether the fixpoint was confirmed.
+     */
+    void setFixpointConfirmed(bool confirmed) { fixpointConfirmed_ = confirmed; }
 };
 
 } // namespace dflow
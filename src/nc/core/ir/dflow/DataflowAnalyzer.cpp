@@ -24,6 +24,7 @@
 
 #include "DataflowAnalyzer.h"
 
+#include <boost/optional.hpp>
 #include <boost/unordered_map.hpp>
 
 #include <nc/common/CancellationToken.h>
@@ -39,6 +40,7 @@
 #include <nc/core/ir/Terms.h>
 
 #include "Dataflow.h"
+#include "Utils.h"
 #include "Value.h"
 
 namespace nc {
@@ -62,6 +64,17 @@ void remove_if(Map &map, Pred pred) {
     }
 }
 
+/**
+ * \return Approximate size of the reaching definitions in memory, in bytes.
+ */
+std::size_t getMemorySize(const ReachingDefinitions &definitions) {
+    std::size_t result = definitions.chunks().size() * sizeof(ReachingDefinitions::Chunk);
+    foreach (const auto &chunk, definitions.chunks()) {
+        result += chunk.definitions().size() * sizeof(const Term *);
+    }
+    return result;
+}
+
 } // anonymous namespace
 
 void DataflowAnalyzer::analyze(const CFG &cfg) {
@@ -81,7 +94,25 @@ void DataflowAnalyzer::analyze(const CFG &cfg) {
     int niterations = 0;
     int nfixpoints = 0;
 
+    /*
+     * Once the budget is spent, the analysis stops at the first fixpoint,
+     * without the passes confirming it. Stopping before the fixpoint would
+     * lose the definitions coming along back edges.
+     */
+    bool overBudget = false;
+    if (budget_ && budget_->maxSize()) {
+        std::size_t size = 0;
+        foreach (auto basicBlock, cfg.basicBlocks()) {
+            size += basicBlock->statements().size();
+        }
+        overBudget = !budget_->checkSize(size);
+    }
+
     while (nfixpoints++ < 3) {
+        /* Only the snapshots taken during the last pass are kept. */
+        rememberedSize_ = 0;
+        reachingSize_ = 0;
+
         /*
          * Run abstract interpretation on all basic blocks.
          */
@@ -90,7 +121,7 @@ void DataflowAnalyzer::analyze(const CFG &cfg) {
 
             /* Merge reaching definitions from predecessors. */
             foreach (const BasicBlock *predecessor, cfg.getPredecessors(basicBlock)) {
-                definitions.merge(outDefinitions[predecessor]);
+                definitions.merge(outDefinitions[predecessor], dataflow().memoryLocations());
             }
 
             /* Remove definitions that do not cover the memory location that they define. */
@@ -124,9 +155,21 @@ void DataflowAnalyzer::analyze(const CFG &cfg) {
             break;
         }
 
+        /*
+         * Have we spent the budget?
+         */
+        if (budget_ && !overBudget) {
+            overBudget = !budget_->checkIterations(niterations + 1) || !budget_->checkTime();
+        }
+        if (overBudget && nfixpoints > 0) {
+            break;
+        }
+
         canceled_.poll();
     }
 
+    dataflow().setFixpointConfirmed(!overBudget);
+
     /*
      * Remove information about terms that disappeared.
      * Terms can disappear if e.g. a call is deinstrumented during the analysis.
@@ -141,6 +184,10 @@ void DataflowAnalyzer::analyze(const CFG &cfg) {
     remove_if(dataflow().term2value(), disappeared);
     remove_if(dataflow().term2location(), disappeared);
     remove_if(dataflow().term2definitions(), disappeared);
+
+    if (reachingSize_ > 0) {
+        log_.debug(tr("Call site snapshots take %1 bytes instead of %2 bytes.").arg(rememberedSize_).arg(reachingSize_));
+    }
 }
 
 void DataflowAnalyzer::execute(const Statement *statement, ReachingDefinitions &definitions) {
@@ -198,7 +245,37 @@ void DataflowAnalyzer::execute(const Statement *statement, ReachingDefinitions &
             break;
         }
         case Statement::REMEMBER_REACHING_DEFINITIONS: {
-            dataflow_.getDefinitions(statement) = definitions;
+            auto remember = statement->as<RememberReachingDefinitions>();
+            auto &snapshot = dataflow_.getDefinitions(statement);
+
+            if (!remember->selective()) {
+                snapshot = definitions;
+                break;
+            }
+
+            boost::optional<BitSize> stackOffset;
+            if (remember->stackPointer()) {
+                auto value = computeValue(remember->stackPointer(), definitions);
+                if (value->isStackOffset()) {
+                    stackOffset = value->stackOffset() * CHAR_BIT;
+                }
+            }
+
+            std::vector<MemoryLocation> memoryLocations;
+            memoryLocations.reserve(remember->memoryLocations().size());
+
+            foreach (const auto &memoryLocation, remember->memoryLocations()) {
+                if (memoryLocation.domain() != MemoryDomain::STACK) {
+                    memoryLocations.push_back(memoryLocation);
+                } else if (stackOffset) {
+                    memoryLocations.push_back(memoryLocation.shifted(*stackOffset));
+                }
+            }
+
+            definitions.selectOverlapping(memoryLocations, snapshot);
+
+            rememberedSize_ += getMemorySize(snapshot);
+            reachingSize_ += getMemorySize(definitions);
             break;
         }
         default:
@@ -312,7 +389,7 @@ const ReachingDefinitions &DataflowAnalyzer::computeReachingDefinitions(const Te
     auto &termDefinitions = dataflow().getDefinitions(term);
 
     if (isTracked(memoryLocation)) {
-        definitions.project(memoryLocation, termDefinitions);
+        definitions.project(memoryLocation, termDefinitions, dataflow().memoryLocations());
     } else {
         termDefinitions.clear();
     }
@@ -344,21 +421,22 @@ Value *DataflowAnalyzer::computeValue(const Term *term, const MemoryLocation &me
     AbstractValue abstractValue(value->abstractValue().size(), 0, 0);
 
     foreach (const auto &chunk, definitions.chunks()) {
-        assert(memoryLocation.covers(chunk.location()));
+        const auto &chunkLocation = definitions.getLocation(chunk);
+        assert(memoryLocation.covers(chunkLocation));
 
         /*
          * Mask of bits inside abstractValue which are covered by chunk's location.
          */
-        auto mask = bitMask<ConstantValue>(chunk.location().size());
+        auto mask = bitMask<ConstantValue>(chunkLocation.size());
         if (byteOrder == ByteOrder::LittleEndian) {
-            mask = bitShift(mask, chunk.location().addr() - memoryLocation.addr());
+            mask = bitShift(mask, chunkLocation.addr() - memoryLocation.addr());
         } else {
-            mask = bitShift(mask, memoryLocation.endAddr() - chunk.location().endAddr());
+            mask = bitShift(mask, memoryLocation.endAddr() - chunkLocation.endAddr());
         }
 
         foreach (auto definition, chunk.definitions()) {
             auto definitionLocation = dataflow().getMemoryLocation(definition);
-            assert(definitionLocation.covers(chunk.location()));
+            assert(definitionLocation.covers(chunkLocation));
 
             auto definitionValue = dataflow().getValue(definition);
             auto definitionAbstractValue = definitionValue->abstractValue();
@@ -392,11 +470,11 @@ Value *DataflowAnalyzer::computeValue(const Term *term, const MemoryLocation &me
     const std::vector<const Term *> *lowerBitsDefinitions = nullptr;
 
     if (byteOrder == ByteOrder::LittleEndian) {
-        if (definitions.chunks().front().location().addr() == memoryLocation.addr()) {
+        if (definitions.getLocation(definitions.chunks().front()).addr() == memoryLocation.addr()) {
             lowerBitsDefinitions = &definitions.chunks().front().definitions();
         }
     } else {
-        if (definitions.chunks().back().location().endAddr() == memoryLocation.endAddr()) {
+        if (definitions.getLocation(definitions.chunks().back()).endAddr() == memoryLocation.endAddr()) {
             lowerBitsDefinitions = &definitions.chunks().back().definitions();
         }
     }
@@ -422,7 +500,7 @@ Value *DataflowAnalyzer::computeValue(const Term *term, const MemoryLocation &me
     /*
      * Merge return address flag.
      */
-    if (definitions.chunks().front().location() == memoryLocation) {
+    if (definitions.getLocation(definitions.chunks().front()) == memoryLocation) {
         foreach (auto definition, definitions.chunks().front().definitions()) {
             auto definitionValue = dataflow().getValue(definition);
             if (definitionValue->isNotReturnAddress()) {
@@ -540,65 +618,19 @@ Value *DataflowAnalyzer::computeValue(const BinaryOperator *binary, const Reachi
 }
 
 AbstractValue DataflowAnalyzer::apply(const UnaryOperator *unary, const AbstractValue &a) {
-    switch (unary->operatorKind()) {
-        case UnaryOperator::NOT:
-            return ~a;
-        case UnaryOperator::NEGATION:
-            return -a;
-        case UnaryOperator::SIGN_EXTEND:
-            return dflow::AbstractValue(a).signExtend(unary->size());
-        case UnaryOperator::ZERO_EXTEND:
-            return dflow::AbstractValue(a).zeroExtend(unary->size());
-        case UnaryOperator::TRUNCATE:
-            return dflow::AbstractValue(a).resize(unary->size());
-        default:
-            log_.warning(tr("%1: Unknown unary operator kind: %2.").arg(Q_FUNC_INFO).arg(unary->operatorKind()));
-            return dflow::AbstractValue();
+    if (auto result = dflow::apply(unary, a)) {
+        return *result;
     }
+    log_.warning(tr("%1: Unknown unary operator kind: %2.").arg(Q_FUNC_INFO).arg(unary->operatorKind()));
+    return AbstractValue();
 }
 
 AbstractValue DataflowAnalyzer::apply(const BinaryOperator *binary, const AbstractValue &a, const AbstractValue &b) {
-    switch (binary->operatorKind()) {
-        case BinaryOperator::AND:
-            return a & b;
-        case BinaryOperator::OR:
-            return a | b;
-        case BinaryOperator::XOR:
-            return a ^ b;
-        case BinaryOperator::SHL:
-            return a << b;
-        case BinaryOperator::SHR:
-            return a.asUnsigned() >> b;
-        case BinaryOperator::SAR:
-            return a.asSigned() >> b;
-        case BinaryOperator::ADD:
-            return a + b;
-        case BinaryOperator::SUB:
-            return a - b;
-        case BinaryOperator::MUL:
-            return a * b;
-        case BinaryOperator::SIGNED_DIV:
-            return a.asSigned() / b;
-        case BinaryOperator::SIGNED_REM:
-            return a.asSigned() % b;
-        case BinaryOperator::UNSIGNED_DIV:
-            return a.asUnsigned() / b;
-        case BinaryOperator::UNSIGNED_REM:
-            return a.asUnsigned() % b;
-        case BinaryOperator::EQUAL:
-            return a == b;
-        case BinaryOperator::SIGNED_LESS:
-            return a.asSigned() < b;
-        case BinaryOperator::SIGNED_LESS_OR_EQUAL:
-            return a.asSigned() <= b;
-        case BinaryOperator::UNSIGNED_LESS:
-            return a.asUnsigned() < b;
-        case BinaryOperator::UNSIGNED_LESS_OR_EQUAL:
-            return a.asUnsigned() <= b;
-        default:
-            log_.warning(tr("%1: Unknown binary operator kind: %2.").arg(Q_FUNC_INFO).arg(binary->operatorKind()));
-            return dflow::AbstractValue();
+    if (auto result = dflow::apply(binary, a, b)) {
+        return *result;
     }
+    log_.warning(tr("%1: Unknown binary operator kind: %2.").arg(Q_FUNC_INFO).arg(binary->operatorKind()));
+    return AbstractValue();
 }
 
 void DataflowAnalyzer::handleWrite(const Term *term, const MemoryLocation &memoryLocation, ReachingDefinitions &definitions) {
@@ -609,13 +641,13 @@ void DataflowAnalyzer::handleWrite(const Term *term, const MemoryLocation &memor
     );
 
     if (isTracked(memoryLocation)) {
-        definitions.addDefinition(memoryLocation, term);
+        definitions.addDefinition(nc::find(dataflow().term2location(), term), term, dataflow().memoryLocations());
     }
 }
 
 void DataflowAnalyzer::handleKill(const MemoryLocation &memoryLocation, ReachingDefinitions &definitions) {
     if (isTracked(memoryLocation)) {
-        definitions.killDefinitions(memoryLocation);
+        definitions.killDefinitions(memoryLocation, dataflow().memoryLocations());
     }
 }
 
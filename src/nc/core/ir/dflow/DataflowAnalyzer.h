@@ -27,10 +27,12 @@
 
 #include <QCoreApplication>
 
+#include <nc/common/Budget.h>
 #include <nc/common/CancellationToken.h>
 #include <nc/common/LogToken.h>
 
 #include <cassert>
+#include <cstddef>
 
 namespace nc {
 
@@ -66,6 +68,13 @@ class DataflowAnalyzer {
     const arch::Architecture *architecture_; ///< Valid pointer to architecture description.
     const CancellationToken &canceled_;
     const LogToken &log_;
+    Budget *budget_; ///< Budget of the analysis. Can be nullptr.
+
+    /** Size in bytes of the definitions remembered by selective snapshot statements. */
+    std::size_t rememberedSize_;
+
+    /** Size in bytes of all the definitions reaching selective snapshot statements. */
+    std::size_t reachingSize_;
 
 public:
     /**
@@ -75,10 +84,15 @@ public:
      * \param architecture  Valid pointer to architecture description.
      * \param canceled      Cancellation token.
      * \param log           Log token.
+     * \param budget        Budget of the analysis. Can be nullptr.
+     *                      When the budget is exceeded, the analysis stops
+     *                      at the first fixpoint, without confirming it, and
+     *                      marks the dataflow information accordingly.
      */
     DataflowAnalyzer(Dataflow &dataflow, const arch::Architecture *architecture,
-        const CancellationToken &canceled, const LogToken &log):
-        dataflow_(dataflow), architecture_(architecture), canceled_(canceled), log_(log)
+        const CancellationToken &canceled, const LogToken &log, Budget *budget = nullptr):
+        dataflow_(dataflow), architecture_(architecture), canceled_(canceled), log_(log), budget_(budget),
+        rememberedSize_(0), reachingSize_(0)
     {
         assert(architecture != nullptr);
     }
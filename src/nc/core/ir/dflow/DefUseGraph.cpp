@@ -0,0 +1,64 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "DefUseGraph.h"
+
+#include <nc/common/Foreach.h>
+
+#include "Dataflow.h"
+
+namespace nc {
+namespace core {
+namespace ir {
+namespace dflow {
+
+DefUseGraph::DefUseGraph(const Dataflow &dataflow) {
+    /*
+     * Count the uses of each definition.
+     */
+    std::vector<std::size_t> counts;
+
+    foreach (auto &termAndDefinitions, dataflow.term2definitions()) {
+        foreach (const auto &chunk, termAndDefinitions.second.chunks()) {
+            foreach (const Term *definition, chunk.definitions()) {
+                auto i = term2index_.find(definition);
+                if (i == term2index_.end()) {
+                    term2index_.insert(std::make_pair(definition, counts.size()));
+                    counts.push_back(1);
+                } else {
+                    ++counts[i->second];
+                }
+            }
+        }
+    }
+
+    /*
+     * Compute the offsets of the ranges.
+     */
+    offsets_.reserve(counts.size() + 1);
+    offsets_.push_back(0);
+    foreach (auto count, counts) {
+        offsets_.push_back(offsets_.back() + count);
+    }
+
+    /*
+     * Fill the ranges, in the same order as the definitions were counted.
+     */
+    std::vector<std::size_t> next(offsets_.begin(), offsets_.end() - 1);
+    uses_.resize(offsets_.back());
+
+    foreach (auto &termAndDefinitions, dataflow.term2definitions()) {
+        foreach (const auto &chunk, termAndDefinitions.second.chunks()) {
+            foreach (const Term *definition, chunk.definitions()) {
+                uses_[next[term2index_[definition]]++] = Use(termAndDefinitions.second.getLocation(chunk), termAndDefinitions.first);
+            }
+        }
+    }
+}
+
+} // namespace dflow
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
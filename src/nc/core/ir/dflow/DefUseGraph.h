@@ -0,0 +1,106 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include <boost/range/iterator_range.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <nc/core/ir/MemoryLocation.h>
+#include <nc/core/ir/Term.h>
+
+namespace nc {
+namespace core {
+namespace ir {
+namespace dflow {
+
+class Dataflow;
+
+/**
+ * Information about which term is being read by which terms.
+ *
+ * The graph is stored in compressed sparse row format: the uses
+ * of all the definitions are kept in one array, the uses of each
+ * definition occupying a contiguous range of it.
+ */
+class DefUseGraph {
+public:
+    /**
+     * Information about a use of a definition: a memory location
+     * being read and a term reading this memory location.
+     */
+    class Use {
+        MemoryLocation location_;
+        const Term *term_;
+
+    public:
+        Use(): term_(nullptr) {}
+
+        Use(const MemoryLocation &location, const Term *term):
+            location_(location), term_(term)
+        {}
+
+        const MemoryLocation &location() const { return location_; }
+        const Term *term() const { return term_; }
+    };
+
+    /**
+     * Range of uses of a definition.
+     */
+    typedef boost::iterator_range<const Use *> UseRange;
+
+private:
+    /** Mapping from a write term to the number of its range of uses. */
+    boost::unordered_map<const Term *, std::size_t> term2index_;
+
+    /** Uses of i-th definition are uses_[offsets_[i]] to uses_[offsets_[i + 1] - 1]. */
+    std::vector<std::size_t> offsets_;
+
+    /** Uses of all definitions. */
+    std::vector<Use> uses_;
+
+public:
+    /**
+     * Constructs use information from dataflow information.
+     *
+     * \param dataflow Dataflow.
+     */
+    explicit
+    DefUseGraph(const Dataflow &dataflow);
+
+    /**
+     * \param[in] term Valid pointer to a write term.
+     *
+     * \return Range of term's uses.
+     */
+    UseRange getUses(const Term *term) const {
+        assert(term != nullptr);
+        assert(term->isWrite());
+
+        auto i = term2index_.find(term);
+        if (i == term2index_.end()) {
+            return UseRange();
+        }
+
+        auto begin = uses_.data();
+        return UseRange(begin + offsets_[i->second], begin + offsets_[i->second + 1]);
+    }
+
+    /**
+     * \return Total number of uses of all definitions.
+     */
+    std::size_t size() const { return uses_.size(); }
+};
+
+} // namespace dflow
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
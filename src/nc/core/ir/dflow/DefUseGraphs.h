@@ -0,0 +1,32 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <memory>
+
+#include <boost/unordered_map.hpp>
+
+#include "DefUseGraph.h"
+
+namespace nc {
+namespace core {
+namespace ir {
+
+class Function;
+
+namespace dflow {
+
+/**
+ * Mapping from a function to its def-use graph.
+ */
+class DefUseGraphs: public boost::unordered_map<const Function *, std::unique_ptr<const DefUseGraph>> {};
+
+} // namespace dflow
+} // namespace ir
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
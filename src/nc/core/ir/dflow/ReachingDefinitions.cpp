@@ -38,24 +38,29 @@ namespace core {
 namespace ir {
 namespace dflow {
 
-void ReachingDefinitions::addDefinition(const MemoryLocation &mloc, const Term *term) {
-    assert(mloc);
+void ReachingDefinitions::addDefinition(MemoryLocationHandle handle, const Term *term, MemoryLocationTable &table) {
+    assert(handle);
+
+    const auto &mloc = table.get(handle);
 
-    killDefinitions(mloc);
+    killDefinitions(mloc, table);
     
     auto i = std::lower_bound(chunks_.begin(), chunks_.end(), mloc,
-        [](const Chunk &a, const MemoryLocation &b) -> bool {
-            return a.location() < b;
+        [this](const Chunk &a, const MemoryLocation &b) -> bool {
+            return getLocation(a) < b;
         });
 
-    chunks_.insert(i, Chunk(mloc, std::vector<const Term *>(1, term)));
+    chunks_.insert(i, Chunk(handle, std::vector<const Term *>(1, term)));
 
     selfTest();
 }
 
-void ReachingDefinitions::killDefinitions(const MemoryLocation &mloc) {
+void ReachingDefinitions::killDefinitions(const MemoryLocation &mloc, MemoryLocationTable &table) {
     assert(mloc);
 
+    assert(table_ == &table || chunks_.empty());
+    table_ = &table;
+
     if (chunks_.empty()) {
         return;
     }
@@ -64,23 +69,25 @@ void ReachingDefinitions::killDefinitions(const MemoryLocation &mloc) {
     result.reserve(chunks_.size() + 1);
 
     foreach (auto &chunk, chunks_) {
-        if (!mloc.overlaps(chunk.location())) {
+        const auto &location = getLocation(chunk);
+
+        if (!mloc.overlaps(location)) {
             result.push_back(std::move(chunk));
         } else {
-            if (chunk.location().addr() < mloc.addr()) {
-                if (mloc.endAddr() < chunk.location().endAddr()) {
+            if (location.addr() < mloc.addr()) {
+                if (mloc.endAddr() < location.endAddr()) {
                     result.push_back(Chunk(
-                        MemoryLocation(mloc.domain(), chunk.location().addr(), mloc.addr() - chunk.location().addr()),
+                        table.intern(MemoryLocation(mloc.domain(), location.addr(), mloc.addr() - location.addr())),
                         chunk.definitions()));
                 } else {
                     result.push_back(Chunk(
-                        MemoryLocation(mloc.domain(), chunk.location().addr(), mloc.addr() - chunk.location().addr()),
+                        table.intern(MemoryLocation(mloc.domain(), location.addr(), mloc.addr() - location.addr())),
                         std::move(chunk.definitions())));
                 }
             }
-            if (mloc.endAddr() < chunk.location().endAddr()) {
+            if (mloc.endAddr() < location.endAddr()) {
                 result.push_back(Chunk(
-                    MemoryLocation(mloc.domain(), mloc.endAddr(), chunk.location().endAddr() - mloc.endAddr()),
+                    table.intern(MemoryLocation(mloc.domain(), mloc.endAddr(), location.endAddr() - mloc.endAddr())),
                     std::move(chunk.definitions())));
             }
         }
@@ -91,19 +98,25 @@ void ReachingDefinitions::killDefinitions(const MemoryLocation &mloc) {
     selfTest();
 }
 
-void ReachingDefinitions::project(const MemoryLocation &mloc, ReachingDefinitions &result) const {
+void ReachingDefinitions::project(const MemoryLocation &mloc, ReachingDefinitions &result, MemoryLocationTable &table) const {
     assert(mloc);
+    assert(table_ == &table || chunks_.empty());
 
     result.clear();
+    result.table_ = &table;
 
     foreach (const auto &chunk, chunks_) {
-        if (chunk.location().domain() == mloc.domain()) {
-            auto addr = std::max(chunk.location().addr(), mloc.addr());
-            auto endAddr = std::min(chunk.location().endAddr(), mloc.endAddr());
+        const auto &location = getLocation(chunk);
+
+        if (location.domain() == mloc.domain()) {
+            auto addr = std::max(location.addr(), mloc.addr());
+            auto endAddr = std::min(location.endAddr(), mloc.endAddr());
 
-            if (addr < endAddr) {
+            if (addr == location.addr() && endAddr == location.endAddr()) {
+                result.chunks_.push_back(chunk);
+            } else if (addr < endAddr) {
                 result.chunks_.push_back(Chunk(
-                    MemoryLocation(mloc.domain(), addr, endAddr - addr),
+                    table.intern(MemoryLocation(mloc.domain(), addr, endAddr - addr)),
                     chunk.definitions()));
             }
         }
@@ -112,22 +125,52 @@ void ReachingDefinitions::project(const MemoryLocation &mloc, ReachingDefinition
     result.selfTest();
 }
 
+bool ReachingDefinitions::definesPartOf(const MemoryLocation &mloc) const {
+    foreach (const auto &chunk, chunks_) {
+        if (getLocation(chunk).overlaps(mloc)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReachingDefinitions::selectOverlapping(const std::vector<MemoryLocation> &memoryLocations, ReachingDefinitions &result) const {
+    result.clear();
+    result.table_ = table_;
+
+    foreach (const auto &chunk, chunks_) {
+        foreach (const auto &memoryLocation, memoryLocations) {
+            if (getLocation(chunk).overlaps(memoryLocation)) {
+                result.chunks_.push_back(chunk);
+                break;
+            }
+        }
+    }
+
+    result.selfTest();
+}
+
 std::vector<MemoryLocation> ReachingDefinitions::getDefinedMemoryLocationsWithin(Domain domain) const {
     std::vector<MemoryLocation> result;
     result.reserve(chunks_.size());
 
     foreach (const auto &chunk, chunks_) {
-        if (chunk.location().domain() == domain) {
-            result.push_back(chunk.location());
+        const auto &location = getLocation(chunk);
+        if (location.domain() == domain) {
+            result.push_back(location);
         }
     }
 
     return result;
 }
 
-void ReachingDefinitions::merge(const ReachingDefinitions &those) {
+void ReachingDefinitions::merge(const ReachingDefinitions &those, MemoryLocationTable &table) {
     selfTest();
 
+    assert(table_ == &table || chunks_.empty());
+    assert(those.table_ == &table || those.chunks_.empty());
+    table_ = &table;
+
     std::vector<Chunk> result;
     result.reserve(chunks_.size() + those.chunks_.size());
 
@@ -137,12 +180,17 @@ void ReachingDefinitions::merge(const ReachingDefinitions &those) {
     auto j = those.chunks_.begin();
     auto jend = those.chunks_.end();
 
+    /* Locations that were not cut keep the handle, saving a lookup in the table. */
+    auto handle = [&table](const MemoryLocation &location, const Chunk &chunk) -> MemoryLocationHandle {
+        return location == table.get(chunk.location()) ? chunk.location() : table.intern(location);
+    };
+
     while (i != iend || j != jend) {
-        auto a = i != iend ? i->location() : MemoryLocation();
-        auto b = j != jend ? j->location() : MemoryLocation();
+        auto a = i != iend ? table.get(i->location()) : MemoryLocation();
+        auto b = j != jend ? table.get(j->location()) : MemoryLocation();
 
         if (!result.empty()) {
-            const auto &c = result.back().location();
+            const auto &c = table.get(result.back().location());
             if (c.domain() == a.domain() && c.endAddr() > a.addr()) {
                 a = MemoryLocation(a.domain(), c.endAddr(), a.endAddr() - c.endAddr());
             }
@@ -152,40 +200,40 @@ void ReachingDefinitions::merge(const ReachingDefinitions &those) {
         }
 
         if (!b) {
-            result.push_back(Chunk(a, i->definitions()));
+            result.push_back(Chunk(handle(a, *i), i->definitions()));
             ++i;
         } else if (!a) {
-            result.push_back(Chunk(b, j->definitions()));
+            result.push_back(Chunk(handle(b, *j), j->definitions()));
             ++j;
         } else if (a.domain() < b.domain()) {
-            result.push_back(Chunk(a, i->definitions()));
+            result.push_back(Chunk(handle(a, *i), i->definitions()));
             ++i;
         } else if (b.domain() < a.domain()) {
-            result.push_back(Chunk(b, j->definitions()));
+            result.push_back(Chunk(handle(b, *j), j->definitions()));
             ++j;
         } else if (a.endAddr() <= b.addr()) {
-            result.push_back(Chunk(a, i->definitions()));
+            result.push_back(Chunk(handle(a, *i), i->definitions()));
             ++i;
         } else if (b.endAddr() <= a.addr()) {
-            result.push_back(Chunk(b, j->definitions()));
+            result.push_back(Chunk(handle(b, *j), j->definitions()));
             ++j;
         } else if (a.addr() < b.addr()) {
-            result.push_back(Chunk(MemoryLocation(a.domain(), a.addr(), b.addr() - a.addr()), i->definitions()));
+            result.push_back(Chunk(table.intern(MemoryLocation(a.domain(), a.addr(), b.addr() - a.addr())), i->definitions()));
         } else if (b.addr() < a.addr()) {
-            result.push_back(Chunk(MemoryLocation(b.domain(), b.addr(), a.addr() - b.addr()), j->definitions()));
+            result.push_back(Chunk(table.intern(MemoryLocation(b.domain(), b.addr(), a.addr() - b.addr())), j->definitions()));
         } else {
             std::vector<const Term *> merged;
             merged.reserve(i->definitions().size() + j->definitions().size());
             std::set_union(i->definitions().begin(), i->definitions().end(), j->definitions().begin(), j->definitions().end(), std::back_inserter(merged));
 
             if (a.size() < b.size()) {
-                result.push_back(Chunk(a, std::move(merged)));
+                result.push_back(Chunk(handle(a, *i), std::move(merged)));
                 ++i;
             } else if (b.size() < a.size()) {
-                result.push_back(Chunk(b, std::move(merged)));
+                result.push_back(Chunk(handle(b, *j), std::move(merged)));
                 ++j;
             } else {
-                result.push_back(Chunk(a, std::move(merged)));
+                result.push_back(Chunk(handle(a, *i), std::move(merged)));
                 ++i;
                 ++j;
             }
@@ -200,7 +248,7 @@ void ReachingDefinitions::merge(const ReachingDefinitions &those) {
 void ReachingDefinitions::print(QTextStream &out) const {
     out << '{';
     foreach (const auto &chunk, chunks_) {
-        out << chunk.location() << ':';
+        out << getLocation(chunk) << ':';
         foreach (const Term *term, chunk.definitions()) {
             out << ' ' << *term;
         }
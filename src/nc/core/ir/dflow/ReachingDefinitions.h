@@ -33,6 +33,7 @@
 #include <nc/common/Printable.h>
 
 #include <nc/core/ir/MemoryLocation.h>
+#include <nc/core/ir/MemoryLocationHandle.h>
 
 namespace nc {
 namespace core {
@@ -44,6 +45,13 @@ namespace dflow {
 
 /**
  * Reaching definitions.
+ *
+ * Chunks store 32-bit handles of memory locations interned in a MemoryLocationTable,
+ * normally the one of the Dataflow the definitions are stored in.
+ * The methods producing new locations take this table as an argument
+ * and remember it, so that getLocation() can resolve the handles later.
+ * Reaching definitions are compared by handles; therefore, only
+ * the ones using the same table can be compared.
  */
 class ReachingDefinitions: public PrintableBase<ReachingDefinitions> {
 public:
@@ -51,7 +59,7 @@ public:
      * Memory location and the list of terms defining this memory location.
      */
     class Chunk {
-        MemoryLocation location_; ///< Memory location.
+        MemoryLocationHandle location_; ///< Handle of the memory location.
         std::vector<const Term *> definitions_; ///< Terms defining this memory location.
 
         public:
@@ -59,19 +67,19 @@ public:
         /*
          * Constructor.
          *
-         * \param location      Valid memory location.
+         * \param location      Handle of a valid memory location.
          * \param definitions   List of terms defining this memory location.
          */
-        Chunk(const MemoryLocation &location, std::vector<const Term *> definitions):
+        Chunk(MemoryLocationHandle location, std::vector<const Term *> definitions):
             location_(location), definitions_(std::move(definitions))
         {
             assert(location);
         }
 
         /**
-         * \return Memory location.
+         * \return Handle of the memory location.
          */
-        const MemoryLocation &location() const { return location_; }
+        MemoryLocationHandle location() const { return location_; }
 
         /**
          * \return List of terms defining the memory location.
@@ -102,7 +110,18 @@ private:
      */
     std::vector<Chunk> chunks_;
 
+    /**
+     * Table where the memory locations of the chunks are interned.
+     * Can be nullptr if there were never any chunks.
+     */
+    const MemoryLocationTable *table_;
+
 public:
+    /**
+     * Constructs empty reaching definitions.
+     */
+    ReachingDefinitions(): table_(nullptr) {}
+
     /**
      * \return Pairs of memory locations and vectors of terms defining them.
      *         The pairs are sorted by memory location.
@@ -110,6 +129,16 @@ public:
      */
     const std::vector<Chunk> &chunks() const { return chunks_; }
 
+    /**
+     * \param chunk One of the chunks().
+     *
+     * \return Memory location of the chunk.
+     */
+    const MemoryLocation &getLocation(const Chunk &chunk) const {
+        assert(table_ != nullptr);
+        return table_->get(chunk.location());
+    }
+
     /**
      * \return True if the list of pairs (chunks) is empty, false otherwise.
      */
@@ -123,17 +152,19 @@ public:
     /**
      * Adds a definition of memory location, removing all previous definitions of overlapping memory locations.
      *
-     * \param[in] memoryLocation Memory location.
+     * \param[in] memoryLocation Handle of the memory location.
      * \param[in] term Term which is the definition.
+     * \param[in] table Table of memory locations.
      */
-    void addDefinition(const MemoryLocation &memoryLocation, const Term *term);
+    void addDefinition(MemoryLocationHandle memoryLocation, const Term *term, MemoryLocationTable &table);
 
     /**
      * Kills definitions of given memory location.
      *
      * \param[in] memoryLocation Memory location.
+     * \param[in] table Table where the locations of the cut chunks are interned.
      */
-    void killDefinitions(const MemoryLocation &memoryLocation);
+    void killDefinitions(const MemoryLocation &memoryLocation, MemoryLocationTable &table);
 
     /**
      * Computes a subset of reaching definitions defining (parts of)
@@ -141,22 +172,26 @@ public:
      *
      * \param[in]  memoryLocation   Memory location.
      * \param[out] result           Resulting reaching definitions.
+     * \param[in]  table            Table where the locations of the cut chunks are interned.
      */
-    void project(const MemoryLocation &memoryLocation, ReachingDefinitions &result) const;
+    void project(const MemoryLocation &memoryLocation, ReachingDefinitions &result, MemoryLocationTable &table) const;
 
     /**
-     * \param[in]  memoryLocation   Memory location.
+     * \param[in] memoryLocation Memory location.
      *
-     * \return A subset of reaching definitions defining (parts of)
-     * given memory location.
+     * \return True if some part of the given memory location has a reaching definition.
+     */
+    bool definesPartOf(const MemoryLocation &memoryLocation) const;
+
+    /**
+     * Computes a subset of reaching definitions consisting of the chunks
+     * overlapping with any of the given memory locations. Unlike project(),
+     * the chunks are copied as they are, not cut to the given locations.
      *
-     * \note Prefer using project() as it does less memory allocations.
+     * \param[in]  memoryLocations  Memory locations.
+     * \param[out] result           Resulting reaching definitions.
      */
-    ReachingDefinitions projected(const MemoryLocation &memoryLocation) const {
-        ReachingDefinitions result;
-        project(memoryLocation, result);
-        return result;
-    }
+    void selectOverlapping(const std::vector<MemoryLocation> &memoryLocations, ReachingDefinitions &result) const;
 
     /**
      * \return All defined memory locations in the domain.
@@ -169,15 +204,19 @@ public:
      * Adds given reaching definitions to the list of known reaching definitions.
      *
      * \param[in] those Reaching definitions.
+     * \param[in] table Table where the locations of the cut chunks are interned.
      */
-    void merge(const ReachingDefinitions &those);
+    void merge(const ReachingDefinitions &those, MemoryLocationTable &table);
 
     /**
      * \return True, if these and given reaching definitions are the same.
      *
      * \param[in] those Reaching definitions.
      */
-    bool operator==(const ReachingDefinitions &those) const { return chunks_ == those.chunks_; }
+    bool operator==(const ReachingDefinitions &those) const {
+        assert(table_ == those.table_ || chunks_.empty() || those.chunks_.empty());
+        return chunks_ == those.chunks_;
+    }
 
     /**
      * \return True, if these and given reaching definitions are different.
@@ -199,7 +238,7 @@ public:
         foreach (auto &chunk, chunks_) {
             chunk.definitions().erase(
                 std::remove_if(chunk.definitions().begin(), chunk.definitions().end(),
-                    [&](const Term *term) -> bool { return pred(chunk.location(), term); }),
+                    [&](const Term *term) -> bool { return pred(getLocation(chunk), term); }),
                 chunk.definitions().end());
         }
         chunks_.erase(
@@ -219,7 +258,7 @@ private:
     void selfTest() const {
 #ifndef NDEBUG
         for (std::size_t i = 1; i < chunks_.size(); ++i) {
-            assert(chunks_[i-1].location() < chunks_[i].location());
+            assert(getLocation(chunks_[i-1]) < getLocation(chunks_[i]));
         }
 #endif
     }
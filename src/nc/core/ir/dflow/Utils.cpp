@@ -61,7 +61,7 @@ const Term *getFirstCopy(const Term *term, const Dataflow &dataflow) {
             auto &definitions = dataflow.getDefinitions(term);
 
             if (definitions.chunks().size() == 1 &&
-                definitions.chunks().front().location() == dataflow.getMemoryLocation(term) &&
+                definitions.getLocation(definitions.chunks().front()) == dataflow.getMemoryLocation(term) &&
                 definitions.chunks().front().definitions().size() == 1)
             {
                 term = definitions.chunks().front().definitions().front();
@@ -92,6 +92,70 @@ bool isReturnAddress(const Term *term, const Dataflow &dataflow) {
     return dataflow.getValue(term)->isReturnAddress();
 }
 
+boost::optional<AbstractValue> apply(const UnaryOperator *unary, const AbstractValue &a) {
+    assert(unary != nullptr);
+
+    switch (unary->operatorKind()) {
+        case UnaryOperator::NOT:
+            return ~a;
+        case UnaryOperator::NEGATION:
+            return -a;
+        case UnaryOperator::SIGN_EXTEND:
+            return AbstractValue(a).signExtend(unary->size());
+        case UnaryOperator::ZERO_EXTEND:
+            return AbstractValue(a).zeroExtend(unary->size());
+        case UnaryOperator::TRUNCATE:
+            return AbstractValue(a).resize(unary->size());
+        default:
+            return boost::none;
+    }
+}
+
+boost::optional<AbstractValue> apply(const BinaryOperator *binary, const AbstractValue &a, const AbstractValue &b) {
+    assert(binary != nullptr);
+
+    switch (binary->operatorKind()) {
+        case BinaryOperator::AND:
+            return a & b;
+        case BinaryOperator::OR:
+            return a | b;
+        case BinaryOperator::XOR:
+            return a ^ b;
+        case BinaryOperator::SHL:
+            return a << b;
+        case BinaryOperator::SHR:
+            return a.asUnsigned() >> b;
+        case BinaryOperator::SAR:
+            return a.asSigned() >> b;
+        case BinaryOperator::ADD:
+            return a + b;
+        case BinaryOperator::SUB:
+            return a - b;
+        case BinaryOperator::MUL:
+            return a * b;
+        case BinaryOperator::SIGNED_DIV:
+            return a.asSigned() / b;
+        case BinaryOperator::SIGNED_REM:
+            return a.asSigned() % b;
+        case BinaryOperator::UNSIGNED_DIV:
+            return a.asUnsigned() / b;
+        case BinaryOperator::UNSIGNED_REM:
+            return a.asUnsigned() % b;
+        case BinaryOperator::EQUAL:
+            return a == b;
+        case BinaryOperator::SIGNED_LESS:
+            return a.asSigned() < b;
+        case BinaryOperator::SIGNED_LESS_OR_EQUAL:
+            return a.asSigned() <= b;
+        case BinaryOperator::UNSIGNED_LESS:
+            return a.asUnsigned() < b;
+        case BinaryOperator::UNSIGNED_LESS_OR_EQUAL:
+            return a.asUnsigned() <= b;
+        default:
+            return boost::none;
+    }
+}
+
 } // namespace dflow
 } // namespace ir
 } // namespace core
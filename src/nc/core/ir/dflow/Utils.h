@@ -25,13 +25,19 @@
 
 #include <nc/config.h>
 
+#include <boost/optional.hpp>
+
+#include "AbstractValue.h"
+
 namespace nc {
 namespace core {
 namespace ir {
 
+class BinaryOperator;
 class Jump;
 class JumpTarget;
 class Term;
+class UnaryOperator;
 
 namespace dflow {
 
@@ -69,6 +75,29 @@ bool isReturnAddress(const JumpTarget &target, const Dataflow &dataflow);
  */
 bool isReturnAddress(const Term *term, const Dataflow &dataflow);
 
+/**
+ * Applies a unary operator to an abstract value.
+ *
+ * \param[in] unary     Valid pointer to the unary operator.
+ * \param[in] a         Operand value.
+ *
+ * \return Resulting abstract value, its size being equal to unary->size(),
+ *         or boost::none if the kind of the operator is unknown.
+ */
+boost::optional<AbstractValue> apply(const UnaryOperator *unary, const AbstractValue &a);
+
+/**
+ * Applies a binary operator to abstract values.
+ *
+ * \param[in] binary    Valid pointer to the binary operator.
+ * \param[in] a         Left operand's value.
+ * \param[in] b         Right operand's value.
+ *
+ * \return Resulting abstract value, its size being equal to binary->size(),
+ *         or boost::none if the kind of the operator is unknown.
+ */
+boost::optional<AbstractValue> apply(const BinaryOperator *binary, const AbstractValue &a, const AbstractValue &b);
+
 } // namespace dflow
 } // namespace ir
 } // namespace core
@@ -5,26 +5,36 @@
 
 #include <nc/config.h>
 
-#include <boost/unordered_set.hpp>
+#include <cassert>
+#include <cstddef>
+#include <vector>
 
-#include <nc/common/Range.h>
+#include <nc/core/ir/Term.h>
 
 namespace nc {
 namespace core {
 namespace ir {
-
-class Term;
-
 namespace liveness {
 
 /**
  * Set of terms producing actual high-level code.
+ *
+ * The set is a bit vector indexed by the numbers of the terms in their
+ * function, see Function::numberTerms().
  */
 class Liveness {
-    boost::unordered_set<const Term *> liveTermSet_; ///< The set of live terms.
+    std::vector<bool> live_; ///< Liveness flags, indexed by term numbers.
     std::vector<const Term *> liveTermList_; ///< The list of live terms.
+    std::vector<const Term *> roots_; ///< Terms made live by the analysis directly, not through the other terms.
 
 public:
+    /**
+     * Constructor.
+     *
+     * \param termCount Number of the terms in the function, as returned by Function::termCount().
+     */
+    explicit Liveness(std::size_t termCount = 0): live_(termCount) {}
+
     /**
      * \param[in] term Term.
      *
@@ -32,22 +42,41 @@ public:
      */
     bool isLive(const Term *term) const {
         assert(term != nullptr);
-        return nc::contains(liveTermSet_, term);
+        auto index = term->index();
+        return index < live_.size() && live_[index];
     }
 
     /**
      * Marks a term as live.
      *
-     * \param[in] term Valid pointer to a term.
+     * \param[in] term Valid pointer to a numbered term.
      */
     void makeLive(const Term *term) {
         assert(term != nullptr);
+        assert(term->index() != Term::NO_INDEX && "Term must be numbered.");
 
-        if (liveTermSet_.insert(term).second) {
+        auto index = term->index();
+        if (index >= live_.size()) {
+            live_.resize(index + 1);
+        }
+        if (!live_[index]) {
+            live_[index] = true;
             liveTermList_.push_back(term);
-        };
+        }
     }
 
+    /**
+     * \return Terms made live directly by the liveness analysis.
+     */
+    const std::vector<const Term *> &roots() const { return roots_; }
+
+    /**
+     * Sets the terms made live directly by the liveness analysis.
+     *
+     * \param roots Terms.
+     */
+    void setRoots(std::vector<const Term *> roots) { roots_ = std::move(roots); }
+
     /**
      * \return The list of live terms, sorted by the order of adding.
      *
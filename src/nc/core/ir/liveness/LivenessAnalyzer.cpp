@@ -24,6 +24,7 @@
 
 #include "LivenessAnalyzer.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include <nc/common/Foreach.h>
@@ -62,7 +63,9 @@ LivenessAnalyzer::LivenessAnalyzer(Liveness &liveness, const Function *function,
     signatures_(signatures), log_(log)
 {}
 
-void LivenessAnalyzer::analyze() {
+bool LivenessAnalyzer::analyze(const Liveness *previous) {
+    roots_.clear();
+
     computeInvisibleJumps();
 
     foreach (const BasicBlock *basicBlock, function_->basicBlocks()) {
@@ -70,6 +73,24 @@ void LivenessAnalyzer::analyze() {
             computeLiveness(statement);
         }
     }
+
+    /*
+     * Liveness is monotonic in the set of roots: if the old roots are
+     * still roots, all the terms live before are still live.
+     */
+    bool reused = previous && rootsInclude(*previous);
+    if (reused) {
+        liveness_ = *previous;
+    }
+
+    foreach (auto root, roots_) {
+        makeLive(root);
+    }
+
+    liveness_.setRoots(std::move(roots_));
+    roots_.clear();
+
+    return reused;
 }
 
 void LivenessAnalyzer::computeInvisibleJumps() {
@@ -86,7 +107,7 @@ void LivenessAnalyzer::computeInvisibleJumps() {
                     invisibleJumps_.push_back(witch->boundsCheckNode()->basicBlock()->getJump());
                 }
                 invisibleJumps_.push_back(witch->switchNode()->basicBlock()->getJump());
-                makeLive(witch->switchTerm());
+                addRoot(witch->switchTerm());
             }
         }
     }
@@ -102,8 +123,9 @@ void LivenessAnalyzer::computeLiveness(const Statement *statement) {
             auto assignment = statement->asAssignment();
             auto memoryLocation = dataflow_.getMemoryLocation(assignment->left());
 
-            if (!memoryLocation || architecture_->isGlobalMemory(memoryLocation)) {
-                makeLive(assignment->left());
+            /* Without a confirmed fixpoint, no assignment is considered dead. */
+            if (!memoryLocation || architecture_->isGlobalMemory(memoryLocation) || !dataflow_.fixpointConfirmed()) {
+                addRoot(assignment->left());
             }
             break;
         }
@@ -112,20 +134,20 @@ void LivenessAnalyzer::computeLiveness(const Statement *statement) {
 
             if (!std::binary_search(invisibleJumps_.begin(), invisibleJumps_.end(), jump)) {
                 if (jump->condition()) {
-                    makeLive(jump->condition());
+                    addRoot(jump->condition());
                 }
                 if (jump->thenTarget().address() && !dflow::isReturnAddress(jump->thenTarget(), dataflow_)) {
-                    makeLive(jump->thenTarget().address());
+                    addRoot(jump->thenTarget().address());
                 }
                 if (jump->elseTarget().address() && !dflow::isReturnAddress(jump->elseTarget(), dataflow_)) {
-                    makeLive(jump->elseTarget().address());
+                    addRoot(jump->elseTarget().address());
                 }
 
                 if (signatures_ && dflow::isReturn(jump, dataflow_)) {
                     if (auto signature = signatures_->getSignature(function_)) {
                         if (signature->returnValue()) {
                             if (auto returnHook = hooks_.getReturnHook(jump)) {
-                                makeLive(returnHook->getReturnValueTerm(signature->returnValue().get()));
+                                addRoot(returnHook->getReturnValueTerm(signature->returnValue().get()));
                             }
                         }
                     }
@@ -136,13 +158,13 @@ void LivenessAnalyzer::computeLiveness(const Statement *statement) {
         case Statement::CALL: {
             const Call *call = statement->asCall();
 
-            makeLive(call->target());
+            addRoot(call->target());
 
             if (signatures_) {
                 if (auto signature = signatures_->getSignature(call)) {
                     if (auto callHook = hooks_.getCallHook(call)) {
                         foreach (const auto &argument, signature->arguments()) {
-                            makeLive(callHook->getArgumentTerm(argument.get()));
+                            addRoot(callHook->getArgumentTerm(argument.get()));
                         }
                     }
                 }
@@ -164,6 +186,26 @@ void LivenessAnalyzer::computeLiveness(const Statement *statement) {
     }
 }
 
+bool LivenessAnalyzer::rootsInclude(const Liveness &previous) const {
+    /* Mark the current roots by their numbers. */
+    std::vector<bool> isRoot(function_->termCount());
+
+    foreach (auto root, roots_) {
+        assert(root->index() < isRoot.size() && "Terms must be numbered.");
+        if (root->index() < isRoot.size()) {
+            isRoot[root->index()] = true;
+        }
+    }
+
+    foreach (auto root, previous.roots()) {
+        if (root->index() >= isRoot.size() || !isRoot[root->index()]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void LivenessAnalyzer::propagateLiveness(const Term *term) {
     assert(term != nullptr);
 
@@ -182,12 +224,12 @@ void LivenessAnalyzer::propagateLiveness(const Term *term) {
             if (term->isRead()) {
                 foreach (auto &chunk, dataflow_.getDefinitions(term).chunks()) {
                     foreach (const Term *definition, chunk.definitions()) {
-                        makeLive(definition);
+                        enqueue(definition);
                     }
                 }
             } else if (term->isWrite()) {
                 if (auto source = term->source()) {
-                    makeLive(source);
+                    enqueue(source);
                 }
             }
             break;
@@ -196,29 +238,29 @@ void LivenessAnalyzer::propagateLiveness(const Term *term) {
             if (term->isRead()) {
                 foreach (auto &chunk, dataflow_.getDefinitions(term).chunks()) {
                     foreach (const Term *definition, chunk.definitions()) {
-                        makeLive(definition);
+                        enqueue(definition);
                     }
                 }
             } else if (term->isWrite()) {
                 if (auto source = term->source()) {
-                    makeLive(source);
+                    enqueue(source);
                 }
             }
 
             if (!dataflow_.getMemoryLocation(term)) {
-                makeLive(term->asDereference()->address());
+                enqueue(term->asDereference()->address());
             }
             break;
         }
         case Term::UNARY_OPERATOR: {
             const UnaryOperator *unary = term->asUnaryOperator();
-            makeLive(unary->operand());
+            enqueue(unary->operand());
             break;
         }
         case Term::BINARY_OPERATOR: {
             const BinaryOperator *binary = term->asBinaryOperator();
-            makeLive(binary->left());
-            makeLive(binary->right());
+            enqueue(binary->left());
+            enqueue(binary->right());
             break;
         }
         default:
@@ -227,14 +269,42 @@ void LivenessAnalyzer::propagateLiveness(const Term *term) {
     }
 }
 
+void LivenessAnalyzer::addRoot(const Term *term) {
+    assert(term != nullptr);
+    roots_.push_back(term);
+}
+
 void LivenessAnalyzer::makeLive(const Term *term) {
     assert(term != nullptr);
-    if (!liveness_.isLive(term)) {
-        liveness_.makeLive(term);
-        propagateLiveness(term);
+    assert(worklist_.empty());
+
+    /*
+     * Depth-first traversal with an explicit stack: chains of definitions
+     * and uses can be long enough to overflow the native one. Terms used
+     * by a term are pushed in reverse order, so that the terms are made
+     * live in the same order as by the recursive traversal.
+     */
+    worklist_.push_back(term);
+
+    while (!worklist_.empty()) {
+        auto next = worklist_.back();
+        worklist_.pop_back();
+
+        if (!liveness_.isLive(next)) {
+            liveness_.makeLive(next);
+
+            auto size = worklist_.size();
+            propagateLiveness(next);
+            std::reverse(worklist_.begin() + size, worklist_.end());
+        }
     }
 }
 
+void LivenessAnalyzer::enqueue(const Term *term) {
+    assert(term != nullptr);
+    worklist_.push_back(term);
+}
+
 } // namespace liveness
 } // namespace ir
 } // namespace core
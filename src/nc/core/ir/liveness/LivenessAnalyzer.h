@@ -85,6 +85,8 @@ class LivenessAnalyzer {
     const calling::Signatures *signatures_;
     const LogToken &log_;
     std::vector<const Jump *> invisibleJumps_;
+    std::vector<const Term *> roots_; ///< Terms made live directly.
+    std::vector<const Term *> worklist_; ///< Terms to be made live, the next one at the back.
 
 public:
     /**
@@ -106,8 +108,16 @@ public:
 
     /**
      * Computes the set of used terms.
+     *
+     * \param previous Pointer to the liveness information computed earlier
+     *                 for the same function and the same dataflow information.
+     *                 Can be nullptr. If the terms made live directly then are
+     *                 still made live directly, the analysis starts from the
+     *                 previous result instead of from scratch.
+     *
+     * \return True if the analysis started from the previous result.
      */
-    void analyze();
+    bool analyze(const Liveness *previous = nullptr);
 
 private:
     /**
@@ -116,12 +126,21 @@ private:
     void computeInvisibleJumps();
 
     /**
-     * Computes liveness of statement's terms based on the statement's kind.
+     * Computes the terms of the statement made live directly,
+     * based on the statement's kind.
      *
      * \param[in] statement Statement.
      */
     void computeLiveness(const Statement *statement);
 
+    /**
+     * \param previous Liveness information.
+     *
+     * \return True if all the terms made live directly in the previous
+     *         liveness information are made live directly now.
+     */
+    bool rootsInclude(const Liveness &previous) const;
+
     /**
      * Marks as used all the terms, used by given term in order to generate code.
      *
@@ -129,12 +148,26 @@ private:
      */
     void propagateLiveness(const Term *term);
 
+    /**
+     * Adds a term to the terms made live directly.
+     *
+     * \param[in] term Valid pointer to a term.
+     */
+    void addRoot(const Term *term);
+
     /**
      * If given term is not used, marks it as used and propagates liveness further.
      *
      * \param[in] term Term.
      */
     void makeLive(const Term *term);
+
+    /**
+     * Schedules a term used by the term being processed to be made live.
+     *
+     * \param[in] term Valid pointer to a term.
+     */
+    void enqueue(const Term *term);
 };
 
 } // namespace liveness
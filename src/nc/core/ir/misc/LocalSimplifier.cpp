@@ -0,0 +1,482 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "LocalSimplifier.h"
+
+#include <cassert>
+#include <functional>
+
+#include <boost/unordered_map.hpp>
+
+#include <nc/common/Foreach.h>
+#include <nc/common/Unreachable.h>
+#include <nc/common/make_unique.h>
+
+#include <nc/core/arch/Architecture.h>
+#include <nc/core/arch/Register.h>
+#include <nc/core/ir/BasicBlock.h>
+#include <nc/core/ir/Function.h>
+#include <nc/core/ir/Jump.h>
+#include <nc/core/ir/Statements.h>
+#include <nc/core/ir/Terms.h>
+#include <nc/core/ir/dflow/AbstractValue.h>
+#include <nc/core/ir/dflow/Utils.h>
+
+namespace nc {
+namespace core {
+namespace ir {
+namespace misc {
+
+namespace {
+
+/**
+ * Memory accesses done by a term or a statement.
+ */
+class Accesses {
+public:
+    std::vector<const MemoryLocationAccess *> reads; ///< Reads of memory locations.
+    std::vector<MemoryLocation> writes; ///< Written memory locations.
+    bool readsMemory; ///< True if memory is read via a dereference.
+    bool writesMemory; ///< True if memory is written via a dereference.
+
+    Accesses(): readsMemory(false), writesMemory(false) {}
+
+    /**
+     * \param memoryLocation Memory location.
+     *
+     * \return True if any of the read memory locations overlaps with the given one.
+     */
+    bool isRead(const MemoryLocation &memoryLocation) const {
+        foreach (auto access, reads) {
+            if (access->memoryLocation().overlaps(memoryLocation)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * Adds the memory accesses done by a term and its subterms.
+ *
+ * \param[in] term Valid pointer to a term.
+ * \param[out] accesses Accesses.
+ */
+void collectAccesses(const Term *term, Accesses &accesses) {
+    switch (term->kind()) {
+        case Term::INT_CONST:
+        case Term::INTRINSIC:
+            break;
+        case Term::MEMORY_LOCATION_ACCESS: {
+            auto access = term->asMemoryLocationAccess();
+            if (access->isRead()) {
+                accesses.reads.push_back(access);
+            } else if (access->isWrite()) {
+                accesses.writes.push_back(access->memoryLocation());
+            }
+            break;
+        }
+        case Term::DEREFERENCE: {
+            auto dereference = term->asDereference();
+            if (dereference->isRead()) {
+                accesses.readsMemory = true;
+            } else if (dereference->isWrite()) {
+                accesses.writesMemory = true;
+            }
+            collectAccesses(dereference->address(), accesses);
+            break;
+        }
+        case Term::UNARY_OPERATOR:
+            collectAccesses(term->asUnaryOperator()->operand(), accesses);
+            break;
+        case Term::BINARY_OPERATOR:
+            collectAccesses(term->asBinaryOperator()->left(), accesses);
+            collectAccesses(term->asBinaryOperator()->right(), accesses);
+            break;
+        default:
+            unreachable();
+    }
+}
+
+/**
+ * Calls a function on all terms of a statement, including subterms.
+ *
+ * \param statement Valid pointer to a statement.
+ * \param fun Function to call.
+ */
+template<class F>
+void callOnTerms(const Statement *statement, F fun) {
+    std::function<void(const Term *)> visit = [&](const Term *term) {
+        fun(term);
+        term->callOnChildren(visit);
+    };
+
+    switch (statement->kind()) {
+        case Statement::INLINE_ASSEMBLY:
+        case Statement::HALT:
+        case Statement::CALLBACK:
+            break;
+        case Statement::REMEMBER_REACHING_DEFINITIONS:
+            if (auto stackPointer = statement->as<RememberReachingDefinitions>()->stackPointer()) {
+                visit(stackPointer);
+            }
+            break;
+        case Statement::ASSIGNMENT:
+            visit(statement->asAssignment()->left());
+            visit(statement->asAssignment()->right());
+            break;
+        case Statement::JUMP: {
+            auto jump = statement->asJump();
+            if (jump->condition()) {
+                visit(jump->condition());
+            }
+            if (jump->thenTarget().address()) {
+                visit(jump->thenTarget().address());
+            }
+            if (jump->elseTarget().address()) {
+                visit(jump->elseTarget().address());
+            }
+            break;
+        }
+        case Statement::CALL:
+            visit(statement->asCall()->target());
+            break;
+        case Statement::TOUCH:
+            visit(statement->asTouch()->term());
+            break;
+        default:
+            unreachable();
+    }
+}
+
+/**
+ * \param term Valid pointer to a term.
+ *
+ * \return True if the term has an operator whose operands are all constants.
+ */
+bool isFoldable(const Term *term) {
+    switch (term->kind()) {
+        case Term::INT_CONST:
+        case Term::INTRINSIC:
+        case Term::MEMORY_LOCATION_ACCESS:
+            return false;
+        case Term::DEREFERENCE:
+            return isFoldable(term->asDereference()->address());
+        case Term::UNARY_OPERATOR: {
+            auto operand = term->asUnaryOperator()->operand();
+            return operand->asConstant() || isFoldable(operand);
+        }
+        case Term::BINARY_OPERATOR: {
+            auto binary = term->asBinaryOperator();
+            return (binary->left()->asConstant() && binary->right()->asConstant()) ||
+                   isFoldable(binary->left()) || isFoldable(binary->right());
+        }
+        default:
+            unreachable();
+    }
+}
+
+/**
+ * Replaces an operator by a constant if its value is known exactly.
+ *
+ * \param term Valid pointer to a term.
+ *
+ * \return Valid pointer to the resulting term.
+ */
+std::unique_ptr<Term> fold(std::unique_ptr<Term> term) {
+    dflow::AbstractValue value;
+
+    if (auto unary = term->asUnaryOperator()) {
+        if (auto operand = unary->operand()->asConstant()) {
+            if (auto result = dflow::apply(unary, operand->value())) {
+                value = *result;
+            }
+        }
+    } else if (auto binary = term->asBinaryOperator()) {
+        auto left = binary->left()->asConstant();
+        auto right = binary->right()->asConstant();
+        if (left && right) {
+            if (auto result = dflow::apply(binary, left->value(), right->value())) {
+                value = *result;
+            }
+        }
+    }
+
+    if (value.isConcrete() && value.size() == term->size()) {
+        return std::make_unique<Constant>(value.asConcrete());
+    }
+    return term;
+}
+
+/**
+ * Creates a copy of a term with constants folded and, optionally,
+ * one of the subterms replaced by another term.
+ *
+ * \param term Valid pointer to a term.
+ * \param target Pointer to the subterm to replace. Can be nullptr.
+ * \param replacement Pointer to the term to use instead of the target.
+ *                    Must be valid if target is not nullptr.
+ *
+ * \return Valid pointer to the copy.
+ */
+std::unique_ptr<Term> rebuild(const Term *term, const Term *target, const Term *replacement) {
+    if (term == target) {
+        assert(replacement != nullptr);
+        assert(replacement->size() == target->size());
+        return rebuild(replacement, nullptr, nullptr);
+    }
+
+    switch (term->kind()) {
+        case Term::INT_CONST:
+        case Term::INTRINSIC:
+        case Term::MEMORY_LOCATION_ACCESS:
+            return term->clone();
+        case Term::DEREFERENCE: {
+            auto dereference = term->asDereference();
+            return std::make_unique<Dereference>(
+                rebuild(dereference->address(), target, replacement), dereference->domain(), dereference->size());
+        }
+        case Term::UNARY_OPERATOR: {
+            auto unary = term->asUnaryOperator();
+            return fold(std::make_unique<UnaryOperator>(
+                unary->operatorKind(), rebuild(unary->operand(), target, replacement), unary->size()));
+        }
+        case Term::BINARY_OPERATOR: {
+            auto binary = term->asBinaryOperator();
+            return fold(std::make_unique<BinaryOperator>(
+                binary->operatorKind(),
+                rebuild(binary->left(), target, replacement),
+                rebuild(binary->right(), target, replacement),
+                binary->size()));
+        }
+        default:
+            unreachable();
+    }
+}
+
+/**
+ * Creates a copy of an assignment or a touch statement with constants folded
+ * and, optionally, one of the subterms replaced by another term.
+ *
+ * \param statement Valid pointer to an assignment or a touch statement.
+ * \param target Pointer to the subterm to replace. Can be nullptr.
+ * \param replacement Pointer to the term to use instead of the target.
+ *                    Must be valid if target is not nullptr.
+ *
+ * \return Valid pointer to the copy.
+ */
+std::unique_ptr<Statement> rebuild(const Statement *statement, const Term *target, const Term *replacement) {
+    std::unique_ptr<Statement> result;
+
+    if (auto assignment = statement->asAssignment()) {
+        result = std::make_unique<Assignment>(
+            rebuild(assignment->left(), target, replacement),
+            rebuild(assignment->right(), target, replacement));
+    } else if (auto touch = statement->asTouch()) {
+        result = std::make_unique<Touch>(rebuild(touch->term(), target, replacement), touch->accessType());
+    } else {
+        unreachable();
+    }
+
+    result->setInstruction(statement->instruction());
+    return result;
+}
+
+/**
+ * Replaces a statement in a basic block by another one.
+ *
+ * \param basicBlock Valid pointer to the basic block containing the statement.
+ * \param statement Valid pointer to the statement being replaced.
+ * \param replacement Valid pointer to the new statement.
+ *
+ * \return Valid pointer to the new statement.
+ */
+Statement *replace(BasicBlock *basicBlock, Statement *statement, std::unique_ptr<Statement> replacement) {
+    auto result = basicBlock->insertAfter(statement, std::move(replacement));
+    basicBlock->erase(statement);
+    return result;
+}
+
+} // anonymous namespace
+
+LocalSimplifier::LocalSimplifier(const arch::Architecture *architecture, const CancellationToken &canceled):
+    canceled_(canceled)
+{
+    assert(architecture != nullptr);
+
+    foreach (const arch::Register *temporary, architecture->temporaries()) {
+        temporaries_.push_back(temporary->memoryLocation());
+    }
+}
+
+void LocalSimplifier::simplify(Function *function) const {
+    assert(function != nullptr);
+
+    /* Fold constants and remove self-assignments. */
+    foreach (BasicBlock *basicBlock, function->basicBlocks()) {
+        std::vector<Statement *> statements(basicBlock->statements().begin(), basicBlock->statements().end());
+
+        foreach (Statement *statement, statements) {
+            if (auto assignment = statement->asAssignment()) {
+                auto left = assignment->left()->asMemoryLocationAccess();
+                auto right = assignment->right()->asMemoryLocationAccess();
+
+                if (left && right && left->memoryLocation() == right->memoryLocation()) {
+                    basicBlock->erase(statement);
+                } else if (isFoldable(assignment->left()) || isFoldable(assignment->right())) {
+                    replace(basicBlock, statement, rebuild(statement, nullptr, nullptr));
+                }
+            } else if (auto touch = statement->asTouch()) {
+                if (isFoldable(touch->term())) {
+                    replace(basicBlock, statement, rebuild(statement, nullptr, nullptr));
+                }
+            }
+        }
+    }
+
+    canceled_.poll();
+
+    if (temporaries_.empty()) {
+        return;
+    }
+
+    /* Compute the number of statements generated from each instruction. */
+    boost::unordered_map<const arch::Instruction *, std::size_t> instructionSizes;
+
+    foreach (const BasicBlock *basicBlock, function->basicBlocks()) {
+        foreach (const Statement *statement, basicBlock->statements()) {
+            if (statement->instruction()) {
+                ++instructionSizes[statement->instruction()];
+            }
+        }
+    }
+
+    /* Propagate temporaries within the instructions not split between basic blocks. */
+    foreach (BasicBlock *basicBlock, function->basicBlocks()) {
+        std::vector<std::vector<Statement *>> sequences;
+
+        foreach (Statement *statement, basicBlock->statements()) {
+            if (sequences.empty() || sequences.back().front()->instruction() != statement->instruction()) {
+                sequences.push_back(std::vector<Statement *>());
+            }
+            sequences.back().push_back(statement);
+        }
+
+        foreach (auto &statements, sequences) {
+            auto instruction = statements.front()->instruction();
+            if (instruction && statements.size() == instructionSizes[instruction]) {
+                propagateTemporaries(basicBlock, statements);
+            }
+        }
+
+        canceled_.poll();
+    }
+}
+
+void LocalSimplifier::propagateTemporaries(BasicBlock *basicBlock, std::vector<Statement *> &statements) const {
+    std::size_t i = 0;
+    while (i < statements.size()) {
+        auto definition = statements[i]->asAssignment();
+        auto access = definition ? definition->left()->asMemoryLocationAccess() : nullptr;
+
+        if (!access || !isTemporary(access->memoryLocation())) {
+            ++i;
+            continue;
+        }
+
+        const MemoryLocation &temporary = access->memoryLocation();
+
+        Accesses valueAccesses;
+        collectAccesses(definition->right(), valueAccesses);
+
+        /*
+         * The value can be moved to the place of its use as long as
+         * nothing it depends on is overwritten in between.
+         */
+        bool movable = !valueAccesses.isRead(temporary);
+        bool live = false;
+        std::size_t readCount = 0;
+        const Term *use = nullptr;
+        std::size_t useIndex = 0;
+
+        for (std::size_t j = i + 1; j < statements.size(); ++j) {
+            auto assignment = statements[j]->asAssignment();
+            if (!assignment) {
+                live = true;
+                break;
+            }
+
+            Accesses accesses;
+            collectAccesses(assignment->left(), accesses);
+            collectAccesses(assignment->right(), accesses);
+
+            foreach (auto read, accesses.reads) {
+                if (read->memoryLocation().overlaps(temporary)) {
+                    if (readCount == 0 && movable && read->memoryLocation() == temporary) {
+                        use = read;
+                        useIndex = j;
+                    }
+                    ++readCount;
+                }
+            }
+
+            bool killed = false;
+            foreach (const auto &write, accesses.writes) {
+                if (write.covers(temporary)) {
+                    killed = true;
+                } else if (write.overlaps(temporary)) {
+                    live = true;
+                }
+                if (valueAccesses.isRead(write)) {
+                    movable = false;
+                }
+            }
+            if (accesses.writesMemory && valueAccesses.readsMemory) {
+                movable = false;
+            }
+
+            if (killed || live) {
+                break;
+            }
+        }
+
+        if (live) {
+            ++i;
+        } else if (readCount == 0) {
+            basicBlock->erase(statements[i]);
+            statements.erase(statements.begin() + i);
+        } else if (readCount == 1 && use) {
+            statements[useIndex] = replace(basicBlock, statements[useIndex],
+                                           rebuild(statements[useIndex], use, definition->right()));
+            basicBlock->erase(statements[i]);
+            statements.erase(statements.begin() + i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+bool LocalSimplifier::isTemporary(const MemoryLocation &memoryLocation) const {
+    foreach (const auto &temporary, temporaries_) {
+        if (temporary.covers(memoryLocation)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t LocalSimplifier::countTerms(const Function *function) {
+    assert(function != nullptr);
+
+    std::size_t result = 0;
+    foreach (const BasicBlock *basicBlock, function->basicBlocks()) {
+        foreach (const Statement *statement, basicBlock->statements()) {
+            callOnTerms(statement, [&](const Term *) { ++result; });
+        }
+    }
+    return result;
+}
+
+}}}} // namespace nc::core::ir::misc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,99 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <nc/common/CancellationToken.h>
+#include <nc/core/ir/MemoryLocation.h>
+
+namespace nc {
+namespace core {
+
+namespace arch {
+    class Architecture;
+}
+
+namespace ir {
+
+class BasicBlock;
+class Function;
+class Statement;
+class Term;
+
+namespace misc {
+
+/**
+ * Cheap local cleanup of the intermediate representation of a function,
+ * done before the dataflow analysis.
+ *
+ * Instruction analyzers describe the semantics of instructions using
+ * temporary registers and constant subexpressions. Dataflow analysis
+ * tracks each of these terms with full values and reaching definitions,
+ * although most of them could be removed by looking at a single basic block.
+ * The class, working on one basic block at a time:
+ * - folds operators applied to constants;
+ * - removes self-assignments;
+ * - forwards the values of temporary registers read exactly once into the
+ *   place of the read;
+ * - removes writes to temporary registers that are never read.
+ *
+ * Temporary registers are assumed to be dead after the last statement
+ * generated from the instruction which wrote them. Instructions whose
+ * statements do not form a contiguous sequence within a single basic block
+ * (e.g. conditional moves, rep-prefixed instructions) are left untouched.
+ */
+class LocalSimplifier {
+    std::vector<MemoryLocation> temporaries_; ///< Memory locations of temporary registers.
+    const CancellationToken &canceled_; ///< Cancellation token.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param[in] architecture Valid pointer to the architecture.
+     * \param[in] canceled Cancellation token.
+     */
+    LocalSimplifier(const arch::Architecture *architecture, const CancellationToken &canceled);
+
+    /**
+     * Simplifies the statements of a function.
+     *
+     * \param[in,out] function Valid pointer to the function.
+     */
+    void simplify(Function *function) const;
+
+    /**
+     * \param[in] function Valid pointer to a function.
+     *
+     * \return Number of terms, including subterms, in the statements of the function.
+     */
+    static std::size_t countTerms(const Function *function);
+
+private:
+    /**
+     * Removes writes to temporary registers from a sequence of statements
+     * generated from a single instruction, forwarding the written values
+     * when they are read exactly once.
+     *
+     * \param[in,out] basicBlock Valid pointer to the basic block containing the statements.
+     * \param[in,out] statements Statements generated from one instruction, in the order of execution.
+     */
+    void propagateTemporaries(BasicBlock *basicBlock, std::vector<Statement *> &statements) const;
+
+    /**
+     * \param memoryLocation Memory location.
+     *
+     * \return True if the memory location belongs to a temporary register.
+     */
+    bool isTemporary(const MemoryLocation &memoryLocation) const;
+};
+
+}}}} // namespace nc::core::ir::misc
+
+/* vim:set et sts=4 sw=4: */
@@ -30,6 +30,8 @@
 
 #include <nc/common/Foreach.h>
 
+#include "Types.h"
+
 namespace nc {
 namespace core {
 namespace ir {
@@ -38,34 +40,34 @@ namespace types {
 void Type::updateSize(SmallBitSize size) {
     if (size && (!size_ || size < size_)) {
         size_ = size;
-        changed_ = true;
+        setChanged();
     }
 }
 
 void Type::makeInteger() {
     if (!isInteger_) {
         isInteger_ = true;
-        changed_ = true;
+        setChanged();
     }
 }
 
 void Type::makeFloat() {
     if (!isFloat_) {
         isFloat_ = true;
-        changed_ = true;
+        setChanged();
     }
 }
 
 void Type::makePointer(Type *pointee) {
     if (!isPointer_) {
         isPointer_ = true;
-        changed_ = true;
+        setChanged();
     }
 
     if (pointee) {
         if (!pointee_) {
             pointee_ = pointee;
-            changed_ = true;
+            setChanged();
         } else {
             pointee_->unionSet(pointee);
         }
@@ -75,14 +77,14 @@ void Type::makePointer(Type *pointee) {
 void Type::makeSigned() {
     if (!isSigned_) {
         isSigned_ = true;
-        changed_ = true;
+        setChanged();
     }
 }
 
 void Type::makeUnsigned() {
     if (!isUnsigned_) {
         isUnsigned_ = true;
-        changed_ = true;
+        setChanged();
     }
 }
 
@@ -105,7 +107,7 @@ void Type::updateFactor(ConstantValue increment) {
     factor_ = gcd(increment, factor_);
 
     if (oldFactor != factor_) {
-        changed_ = true;
+        setChanged();
     }
 }
 
@@ -120,6 +122,13 @@ void Type::addOffset(ByteSize offset, Type *typeTraits) {
 }
 #endif
 
+void Type::setChanged() {
+    changed_ = true;
+    if (changeLog_) {
+        changeLog_->push_back(this);
+    }
+}
+
 bool Type::changed() {
     if (changed_) {
         changed_ = false;
@@ -129,17 +138,32 @@ bool Type::changed() {
     }
 }
 
+Type *Type::findSet() {
+    return types_->findSet(this);
+}
+
+const Type *Type::findSet() const {
+    return types_->findSet(this);
+}
+
 void Type::unionSet(Type *that) {
     Type *thisSet = this->findSet();
     Type *thatSet = that->findSet();
 
-    DisjointSet<Type>::unionSet(that);
+    types_->unionSet(thisSet, thatSet);
 
     if (findSet() == thisSet) {
         thisSet->join(thatSet);
     } else {
         thatSet->join(thisSet);
     }
+
+    if (thisSet != thatSet) {
+        auto absorbed = findSet() == thisSet ? thatSet : thisSet;
+        if (absorbed->changeLog_) {
+            absorbed->changeLog_->push_back(absorbed);
+        }
+    }
 }
 
 void Type::join(Type *that) {
@@ -25,11 +25,14 @@
 
 #include <nc/config.h>
 
+#include <vector>
+
 #ifdef NC_STRUCT_RECOVERY
 #include <map>
 #endif
 
-#include <nc/common/DisjointSet.h>
+#include <cstddef>
+
 #include <nc/common/Printable.h>
 #include <nc/common/Types.h>
 
@@ -38,12 +41,19 @@ namespace core {
 namespace ir {
 namespace types {
 
-class Type;
+class Types;
 
 /**
  * Information about a type of a term.
+ *
+ * Type traits of terms are united into sets, each set having a representative
+ * storing the properties of the whole set. The sets are maintained by the
+ * owning Types object.
  */
-class Type: public DisjointSet<Type>, public PrintableBase<Type> {
+class Type: public PrintableBase<Type> {
+    Types *types_; ///< Owner of the type traits.
+    std::size_t index_; ///< Number of the type traits in the owner.
+
     SmallBitSize size_; ///< Type size in bits.
 
     bool isInteger_; ///< Type is integer.
@@ -63,21 +73,42 @@ class Type: public DisjointSet<Type>, public PrintableBase<Type> {
 
     bool changed_; ///< Type properties have changed since last call to changed().
 
+    std::vector<Type *> *changeLog_; ///< Vector where to record this type when it changes. Can be nullptr.
+
     public:
 
     /**
      * Class constructor.
+     *
+     * \param types Valid pointer to the owner of the type traits.
+     * \param index Number of the type traits in the owner.
      */
-    Type():
+    Type(Types *types, std::size_t index):
+        types_(types), index_(index),
         size_(0),
         isInteger_(false), isFloat_(false), isPointer_(false), pointee_(0),
-        isSigned_(false), isUnsigned_(false), factor_(0), changed_(false)
+        isSigned_(false), isUnsigned_(false), factor_(0), changed_(false), changeLog_(nullptr)
     { 
 #ifdef NC_STRUCT_RECOVERY
         addOffset(0, this); 
 #endif
     }
 
+    /**
+     * \return Number of the type traits in the owning Types object.
+     */
+    std::size_t index() const { return index_; }
+
+    /**
+     * \return Valid pointer to the representative of the set this type belongs to.
+     */
+    Type *findSet();
+
+    /**
+     * \return Valid pointer to the representative of the set this type belongs to.
+     */
+    const Type *findSet() const;
+
     /**
      * \return Type size in bits.
      */
@@ -184,6 +215,14 @@ class Type: public DisjointSet<Type>, public PrintableBase<Type> {
      */
     bool changed();
 
+    /**
+     * Sets the vector to which this type appends itself each time its
+     * properties change, or it stops being the representative of its set.
+     *
+     * \param changeLog Pointer to the vector. Can be nullptr.
+     */
+    void setChangeLog(std::vector<Type *> *changeLog) { changeLog_ = changeLog; }
+
     /**
      * Merges this and that types together.
      *
@@ -204,6 +243,12 @@ class Type: public DisjointSet<Type>, public PrintableBase<Type> {
      * \param out Output stream.
      */
     void print(QTextStream &out) const;
+
+private:
+    /**
+     * Marks the type as changed.
+     */
+    void setChanged();
 };
 
 } // namespace types
@@ -24,8 +24,12 @@
 
 #include "TypeAnalyzer.h"
 
+#include <deque>
+
+#include <nc/common/Budget.h>
 #include <nc/common/CancellationToken.h>
 #include <nc/common/Foreach.h>
+#include <nc/common/LogToken.h>
 
 #include <nc/core/ir/BasicBlock.h>
 #include <nc/core/ir/Function.h>
@@ -58,21 +62,161 @@ void TypeAnalyzer::analyze() {
     uniteArgumentTypes();
     markStackPointersAsPointers();
 
+    computeDependencies();
+
+    /*
+     * Each type appends itself to the change log when its properties change
+     * or when it is united into another type. Both kinds of events affect
+     * the terms depending on the type.
+     */
+    std::vector<Type *> changeLog;
+    types_.setChangeLog(&changeLog);
+
     /*
      * Recompute types until reaching fixpoint.
+     * Initially, all the terms are in the worklist.
+     */
+    std::deque<std::size_t> queue;
+    std::vector<bool> queued(terms_.size(), true);
+    for (std::size_t i = 0; i < terms_.size(); ++i) {
+        queue.push_back(i);
+    }
+
+    std::size_t nevaluations = 0;
+
+    /*
+     * Number of recomputations of its terms each function can afford.
      */
-    bool changed;
-    do {
-        changed = false;
+    bool limited = budget_ && budget_->maxIterations();
+    std::vector<std::size_t> allowances(functionsOfTerms_.size());
+    std::vector<bool> overBudget(functionsOfTerms_.size());
+    if (limited) {
+        foreach (auto function, termFunctions_) {
+            allowances[function] += budget_->maxIterations();
+        }
+    }
+
+    while (!queue.empty()) {
+        auto index = queue.front();
+        queue.pop_front();
+        queued[index] = false;
+
+        if (limited) {
+            auto function = termFunctions_[index];
+            if (allowances[function] == 0) {
+                overBudget[function] = true;
+                continue;
+            }
+            --allowances[function];
+        }
 
-        foreach (const Function *function, functions_.list()) {
-            while (analyze(function)) {
-                changed = true;
-                canceled_.poll();
+        analyze(terms_[index]);
+        ++nevaluations;
+
+        foreach (Type *type, changeLog) {
+            auto i = dependents_.find(type);
+            if (i == dependents_.end()) {
+                continue;
+            }
+
+            foreach (auto dependent, i->second) {
+                if (!queued[dependent]) {
+                    queued[dependent] = true;
+                    queue.push_back(dependent);
+                }
+            }
+
+            /*
+             * The type has been united into another one.
+             * Its dependents now depend on the representative.
+             */
+            auto representative = type->findSet();
+            if (representative != type) {
+                auto dependents = std::move(i->second);
+                dependents_.erase(i);
+
+                auto &representativeDependents = dependents_[representative];
+                if (representativeDependents.size() < dependents.size()) {
+                    representativeDependents.swap(dependents);
+                }
+                representativeDependents.insert(representativeDependents.end(), dependents.begin(), dependents.end());
             }
+        }
+        changeLog.clear();
+
+        if (nevaluations % 1024 == 0) {
             canceled_.poll();
         }
-    } while (changed);
+    }
+
+    types_.setChangeLog(nullptr);
+
+    for (std::size_t i = 0; i < overBudget.size(); ++i) {
+        if (overBudget[i]) {
+            functionsOverBudget_.push_back(functionsOfTerms_[i]);
+        }
+    }
+
+    log_.debug(tr("Recomputed types of %1 terms %2 times in total.").arg(terms_.size()).arg(nevaluations));
+
+    terms_.clear();
+    termFunctions_.clear();
+    functionsOfTerms_.clear();
+    dependents_.clear();
+}
+
+void TypeAnalyzer::computeDependencies() {
+    std::vector<Type *> types;
+
+    foreach (const Function *function, functions_.list()) {
+        const auto &liveness = *livenesses_.at(function);
+        functionsOfTerms_.push_back(function);
+
+        foreach (const Term *term, liveness.liveTerms()) {
+            types.clear();
+            if (!getInvolvedTypes(term, types)) {
+                continue;
+            }
+
+            auto index = terms_.size();
+            terms_.push_back(term);
+            termFunctions_.push_back(functionsOfTerms_.size() - 1);
+
+            foreach (const Type *type, types) {
+                auto &dependents = dependents_[type];
+                if (dependents.empty() || dependents.back() != index) {
+                    dependents.push_back(index);
+                }
+            }
+        }
+        canceled_.poll();
+    }
+}
+
+bool TypeAnalyzer::getInvolvedTypes(const Term *term, std::vector<Type *> &types) {
+    switch (term->kind()) {
+        case Term::DEREFERENCE: {
+            auto dereference = term->asDereference();
+            types.push_back(types_.getType(dereference->address()));
+            types.push_back(types_.getType(dereference));
+            return true;
+        }
+        case Term::UNARY_OPERATOR: {
+            auto unary = term->asUnaryOperator();
+            types.push_back(types_.getType(unary));
+            types.push_back(types_.getType(unary->operand()));
+            return true;
+        }
+        case Term::BINARY_OPERATOR: {
+            auto binary = term->asBinaryOperator();
+            types.push_back(types_.getType(binary));
+            types.push_back(types_.getType(binary->left()));
+            types.push_back(types_.getType(binary->right()));
+            return true;
+        }
+        default:
+            return false;
+    }
 }
 
 void TypeAnalyzer::uniteTypesOfAssignedTerms() {
@@ -162,29 +306,6 @@ void TypeAnalyzer::markStackPointersAsPointers() {
     }
 }
 
-bool TypeAnalyzer::analyze(const Function *function) {
-    const auto &liveness = *livenesses_.at(function);
-
-    /*
-     * Going in both directions makes the process
-     * converge much faster on some examples.
-     */
-    foreach (const Term *term, liveness.liveTerms()) {
-        analyze(term);
-    }
-    reverse_foreach (const Term *term, liveness.liveTerms()) {
-        analyze(term);
-    }
-
-    bool changed = false;
-    foreach (const Term *term, liveness.liveTerms()) {
-        if (types_.getType(term)->changed()) {
-            changed = true;
-        }
-    }
-    return changed;
-}
-
 void TypeAnalyzer::analyze(const Term *term) {
     switch (term->kind()) {
         case Term::INT_CONST: /* FALLTHROUGH */
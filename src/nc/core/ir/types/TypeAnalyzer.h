@@ -25,9 +25,18 @@
 
 #include <nc/config.h>
 
+#include <QCoreApplication>
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
 namespace nc {
 
+class Budget;
 class CancellationToken;
+class LogToken;
 
 namespace core {
 namespace ir {
@@ -57,12 +66,19 @@ namespace vars {
 
 namespace types {
 
+class Type;
 class Types;
 
 /**
  * This class performs interprocedural reconstruction of types.
+ *
+ * Types of terms are recomputed using a worklist: a term is recomputed
+ * again only when some of the types it reads has changed, or has been
+ * united with another type.
  */
 class TypeAnalyzer {
+    Q_DECLARE_TR_FUNCTIONS(TypeAnalyzer)
+
     Types &types_; ///< Information about terms' types.
     const Functions &functions_; ///< Intermediate representations of functions.
     const dflow::Dataflows &dataflows_; ///< Dataflow information.
@@ -70,7 +86,24 @@ class TypeAnalyzer {
     const liveness::Livenesses &livenesses_; ///< Set of terms producing actual high-level code.
     const calling::Hooks &hooks_; ///< Hooks manager.
     const calling::Signatures &signatures_; ///< Signatures of functions.
-    const CancellationToken &canceled_;
+    const CancellationToken &canceled_; ///< Cancellation token.
+    const LogToken &log_; ///< Log token.
+    const Budget *budget_; ///< Budget of a single function. Can be nullptr.
+
+    /** Terms whose types are recomputed. */
+    std::vector<const Term *> terms_;
+
+    /** Functions the terms in terms_ belong to. */
+    std::vector<const Function *> functionsOfTerms_;
+
+    /** Indices of the functions in functionsOfTerms_ the terms in terms_ belong to. */
+    std::vector<std::size_t> termFunctions_;
+
+    /** Functions whose terms were not recomputed until fixpoint because of the budget. */
+    std::vector<const Function *> functionsOverBudget_;
+
+    /** Mapping from a type to the indices of terms in terms_ depending on it. */
+    boost::unordered_map<const Type *, std::vector<std::size_t>> dependents_;
 
 public:
     /**
@@ -84,14 +117,19 @@ public:
      * \param[in] hooks Hooks manager.
      * \param[in] signatures Signatures of functions.
      * \param[in] canceled Cancellation token.
+     * \param[in] log Log token.
+     * \param[in] budget Budget of a single function. Can be nullptr.
+     *                   The terms of a function are recomputed at most
+     *                   budget->maxIterations() times on average.
      */
     TypeAnalyzer(Types &types, const Functions &functions, const dflow::Dataflows &dataflows,
         const vars::Variables &variables, const liveness::Livenesses &livenesses,
         const calling::Hooks &hooks, const calling::Signatures &signatures,
-        const CancellationToken &canceled
+        const CancellationToken &canceled, const LogToken &log, const Budget *budget = nullptr
     ):
         types_(types), functions_(functions), dataflows_(dataflows), variables_(variables),
-        livenesses_(livenesses), hooks_(hooks), signatures_(signatures), canceled_(canceled)
+        livenesses_(livenesses), hooks_(hooks), signatures_(signatures), canceled_(canceled),
+        log_(log), budget_(budget)
     {}
 
     /**
@@ -99,6 +137,12 @@ public:
      */
     void analyze();
 
+    /**
+     * \return Functions whose types were not recomputed until fixpoint
+     *         because their budget was exceeded.
+     */
+    const std::vector<const Function *> &functionsOverBudget() const { return functionsOverBudget_; }
+
 private:
     /**
      * Unites types of terms assigned to each other.
@@ -122,13 +166,19 @@ private:
     void markStackPointersAsPointers();
 
     /**
-     * Recomputes types of terms in the given function.
-     *
-     * \param function Valid pointer to a function.
+     * Fills terms_ with the live terms of all functions whose types are
+     * recomputed, termFunctions_ with the functions they belong to,
+     * and dependents_ with the terms depending on each type.
+     */
+    void computeDependencies();
+
+    /**
+     * \param term Valid pointer to a term.
+     * \param[out] types Types read and modified when recomputing the type of the term.
      *
-     * \return True if types changed, false otherwise.
+     * \return True if the type of the term is recomputed at all, false otherwise.
      */
-    bool analyze(const Function *function);
+    bool getInvolvedTypes(const Term *term, std::vector<Type *> &types);
 
     /**
      * Recomputes type of the given term.
@@ -24,6 +24,10 @@
 
 #include "Types.h"
 
+#include <cassert>
+
+#include <nc/common/Foreach.h>
+
 #include <nc/core/ir/Term.h>
 
 #include "Type.h"
@@ -33,25 +37,47 @@ namespace core {
 namespace ir {
 namespace types {
 
-Types::Types() {}
+Types::Types(): changeLog_(nullptr) {}
 
 Types::~Types() {}
 
 Type *Types::getType(const Term *term) {
-    auto &type = types_[term];
-    if (!type) {
-        type.reset(new Type());
-        type->updateSize(term->size());
-        return type.get();
-    } else {
-        return type->findSet();
+    auto i = term2type_.find(term);
+    if (i != term2type_.end()) {
+        return &types_[sets_.findSet(i->second)];
     }
+
+    auto index = sets_.addElement();
+    assert(index == types_.size());
+
+    types_.emplace_back(this, index);
+    term2type_[term] = index;
+
+    auto type = &types_.back();
+    type->setChangeLog(changeLog_);
+    type->updateSize(term->size());
+    return type;
 }
 
 const Type *Types::getType(const Term *term) const {
     return const_cast<Types *>(this)->getType(term);
 }
 
+void Types::setChangeLog(std::vector<Type *> *changeLog) {
+    changeLog_ = changeLog;
+    foreach (auto &type, types_) {
+        type.setChangeLog(changeLog);
+    }
+}
+
+Type *Types::findSet(const Type *type) const {
+    return const_cast<Type *>(&types_[sets_.findSet(type->index())]);
+}
+
+Type *Types::unionSet(const Type *a, const Type *b) {
+    return &types_[sets_.unionSet(a->index(), b->index())];
+}
+
 }}}} // namespace nc::core::ir::types
 
 /* vim:set et sts=4 sw=4: */
@@ -23,8 +23,16 @@
 
 #pragma once
 
+#include <cstddef>
+#include <deque>
+#include <vector>
+
 #include <boost/unordered_map.hpp>
 
+#include <nc/common/DenseDisjointSets.h>
+
+#include "Type.h"
+
 namespace nc {
 namespace core {
 namespace ir {
@@ -33,13 +41,17 @@ class Term;
 
 namespace types {
 
-class Type;
-
 /**
  * Information about types of terms.
+ *
+ * Type traits are stored contiguously and numbered in the order of creation.
+ * Sets of united type traits are kept in a DenseDisjointSets over these numbers.
  */
 class Types {
-    mutable boost::unordered_map<const Term *, std::unique_ptr<Type> > types_; ///< Mapping of terms to their type traits.
+    std::deque<Type> types_; ///< Type traits, by their numbers.
+    boost::unordered_map<const Term *, std::size_t> term2type_; ///< Mapping of terms to the numbers of their type traits.
+    DenseDisjointSets sets_; ///< Sets of united type traits.
+    std::vector<Type *> *changeLog_; ///< Change log given to the type traits. Can be nullptr.
 
     public:
 
@@ -68,9 +80,30 @@ class Types {
     const Type *getType(const Term *term) const;
 
     /**
-     * \return Mapping of terms to their type traits.
+     * Sets the change log of all existing and future type traits.
+     *
+     * \param changeLog Pointer to the vector. Can be nullptr.
+     *
+     * \see Type::setChangeLog()
+     */
+    void setChangeLog(std::vector<Type *> *changeLog);
+
+    /**
+     * \param type Valid pointer to type traits owned by this object.
+     *
+     * \return Valid pointer to the representative of the set the type traits belong to.
+     */
+    Type *findSet(const Type *type) const;
+
+    /**
+     * Unites the sets of two type traits owned by this object.
+     *
+     * \param a Valid pointer to type traits.
+     * \param b Valid pointer to type traits.
+     *
+     * \return Valid pointer to the representative of the united set.
      */
-    boost::unordered_map<const Term *, std::unique_ptr<Type> > &map() { return types_; };
+    Type *unionSet(const Type *a, const Type *b);
 };
 
 }}}} // namespace nc::core::ir::types
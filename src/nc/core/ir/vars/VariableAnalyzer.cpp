@@ -24,9 +24,9 @@
 
 #include "VariableAnalyzer.h"
 
-#include <boost/range/adaptor/map.hpp>
+#include <limits>
 
-#include <nc/common/DisjointSet.h>
+#include <nc/common/DenseDisjointSets.h>
 #include <nc/common/Foreach.h>
 #include <nc/common/make_unique.h>
 
@@ -42,13 +42,6 @@ namespace core {
 namespace ir {
 namespace vars {
 
-namespace {
-
-class TermSet;
-class TermSet: public DisjointSet<TermSet> {};
-
-} // anonymous namespace
-
 void VariableAnalyzer::analyze() {
     std::vector<Variable::TermAndLocation> globalMemoryAccesses;
 
@@ -58,20 +51,24 @@ void VariableAnalyzer::analyze() {
     foreach (const auto &functionAndDataflow, dataflows_) {
         const auto &dataflow = *functionAndDataflow.second;
 
-        boost::unordered_map<const Term *, std::unique_ptr<TermSet>> term2set;
+        std::vector<const Term *> terms;
+        boost::unordered_map<const Term *, std::size_t> term2index;
 
         /*
-         * Make a set for each read or write term which has a memory location.
+         * Number each read or write term which has a memory location.
+         * The numbering follows the iteration order of the hash table,
+         * so the order of the created variables is unspecified.
          */
         foreach (const auto &termAndLocation, dataflow.term2location()) {
             const auto &term = termAndLocation.first;
-            const auto &location = termAndLocation.second;
+            const auto &location = dataflow.memoryLocations().get(termAndLocation.second);
 
             if ((term->isRead() || term->isWrite()) && location) {
                 if (architecture_->isGlobalMemory(location)) {
                     globalMemoryAccesses.push_back(Variable::TermAndLocation(term, location));
                 } else {
-                    term2set[term] = std::make_unique<TermSet>();
+                    term2index[term] = terms.size();
+                    terms.push_back(term);
                 }
             }
         }
@@ -79,16 +76,19 @@ void VariableAnalyzer::analyze() {
         /*
          * Join sets of definitions and uses.
          */
-        foreach (auto &pair, term2set) {
-            auto term = pair.first;
+        DenseDisjointSets sets(terms.size());
 
-            if (term->isRead()) {
-                auto termSet = pair.second.get();
+        for (std::size_t index = 0; index < terms.size(); ++index) {
+            auto term = terms[index];
 
+            if (term->isRead()) {
                 foreach (const auto &chunk, dataflow.getDefinitions(term).chunks()) {
                     foreach (const Term *def, chunk.definitions()) {
                         assert(dataflow.getMemoryLocation(term).overlaps(dataflow.getMemoryLocation(def)));
-                        termSet->unionSet(term2set[def].get());
+
+                        auto i = term2index.find(def);
+                        assert(i != term2index.end());
+                        sets.unionSet(index, i->second);
                     }
                 }
             }
@@ -97,18 +97,26 @@ void VariableAnalyzer::analyze() {
         /*
          * Compute the terms belonging to each set.
          */
-        boost::unordered_map<TermSet *, std::vector<Variable::TermAndLocation>> set2termsAndLocations;
-        foreach (auto &termAndSet, term2set) {
-            const Term *term = termAndSet.first;
-            TermSet *set = termAndSet.second->findSet();
+        const std::size_t NO_VARIABLE = std::numeric_limits<std::size_t>::max();
+
+        std::vector<std::size_t> set2variable(terms.size(), NO_VARIABLE);
+        std::vector<std::vector<Variable::TermAndLocation>> variablesTermsAndLocations;
+
+        for (std::size_t index = 0; index < terms.size(); ++index) {
+            auto &variable = set2variable[sets.findSet(index)];
+            if (variable == NO_VARIABLE) {
+                variable = variablesTermsAndLocations.size();
+                variablesTermsAndLocations.emplace_back();
+            }
 
-            set2termsAndLocations[set].push_back(Variable::TermAndLocation(term, dataflow.getMemoryLocation(term)));
+            auto term = terms[index];
+            variablesTermsAndLocations[variable].push_back(Variable::TermAndLocation(term, dataflow.getMemoryLocation(term)));
         }
 
         /*
          * Create local variables.
          */
-        foreach (auto &termsAndLocations, set2termsAndLocations | boost::adaptors::map_values) {
+        foreach (auto &termsAndLocations, variablesTermsAndLocations) {
             variables_.addVariable(std::make_unique<Variable>(Variable::LOCAL, std::move(termsAndLocations)));
         }
     }
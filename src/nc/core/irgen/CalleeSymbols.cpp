@@ -0,0 +1,75 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "CalleeSymbols.h"
+
+#include <cassert>
+
+#include <nc/core/image/Image.h>
+#include <nc/core/image/Relocation.h>
+#include <nc/core/image/Symbol.h>
+#include <nc/core/ir/BasicBlock.h>
+#include <nc/core/ir/Jump.h>
+#include <nc/core/ir/Program.h>
+#include <nc/core/ir/Statements.h>
+#include <nc/core/ir/Terms.h>
+
+namespace nc {
+namespace core {
+namespace irgen {
+
+boost::optional<ByteAddr> evaluateAddress(const ir::Term *term) {
+    assert(term != nullptr);
+
+    if (auto constant = term->asConstant()) {
+        return constant->value().value();
+    } else if (auto binary = term->asBinaryOperator()) {
+        if (binary->operatorKind() == ir::BinaryOperator::ADD || binary->operatorKind() == ir::BinaryOperator::SUB) {
+            auto left = evaluateAddress(binary->left());
+            auto right = evaluateAddress(binary->right());
+
+            if (left && right) {
+                return binary->operatorKind() == ir::BinaryOperator::ADD ? *left + *right : *left - *right;
+            }
+        }
+    }
+    return boost::none;
+}
+
+const image::Symbol *getImportSymbol(const image::Image &image, const ir::Term *target) {
+    assert(target != nullptr);
+
+    if (auto dereference = target->asDereference()) {
+        if (auto slot = evaluateAddress(dereference->address())) {
+            if (auto relocation = image.getRelocation(*slot)) {
+                return relocation->symbol();
+            }
+        }
+    }
+    return nullptr;
+}
+
+const image::Symbol *getFunctionSymbol(const image::Image &image, const ir::Program &program, ByteAddr address) {
+    if (auto symbol = image.getSymbol(address)) {
+        return symbol;
+    }
+
+    /* Maybe a thunk jumping through an import table? */
+    if (auto basicBlock = program.getBasicBlockStartingAt(address)) {
+        if (auto jump = basicBlock->getJump()) {
+            if (jump->isUnconditional() && jump->thenTarget().address() &&
+                jump->instruction() == basicBlock->statements().front()->instruction())
+            {
+                return getImportSymbol(image, jump->thenTarget().address());
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+} // namespace irgen
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,59 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <boost/optional.hpp>
+
+#include <nc/common/Types.h>
+
+namespace nc {
+namespace core {
+
+namespace image {
+    class Image;
+    class Symbol;
+}
+
+namespace ir {
+    class Program;
+    class Term;
+}
+
+namespace irgen {
+
+/**
+ * \param term Valid pointer to a term.
+ *
+ * \return Value of the term if it is a constant expression of additions
+ *         and subtractions.
+ */
+boost::optional<ByteAddr> evaluateAddress(const ir::Term *term);
+
+/**
+ * \param image Executable image.
+ * \param target Valid pointer to the term giving the target address of a call or a jump.
+ *
+ * \return Pointer to the symbol of the imported function whose address the target
+ *         loads from an import table entry. nullptr if unknown.
+ */
+const image::Symbol *getImportSymbol(const image::Image &image, const ir::Term *target);
+
+/**
+ * \param image Executable image.
+ * \param program Program.
+ * \param address Address of a function's entry.
+ *
+ * \return Pointer to the symbol of the function: the symbol at this address or,
+ *         if the function is a thunk jumping to an imported function, the symbol
+ *         of the imported function. nullptr if unknown.
+ */
+const image::Symbol *getFunctionSymbol(const image::Image &image, const ir::Program &program, ByteAddr address);
+
+} // namespace irgen
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,280 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "DeadFlagEliminator.h"
+
+#include <cassert>
+#include <climits> /* CHAR_BIT */
+
+#include <boost/unordered_set.hpp>
+
+#include <nc/common/Foreach.h>
+#include <nc/common/Range.h>
+#include <nc/common/Unreachable.h>
+
+#include <nc/core/arch/Architecture.h>
+#include <nc/core/arch/Register.h>
+#include <nc/core/ir/BasicBlock.h>
+#include <nc/core/ir/Jump.h>
+#include <nc/core/ir/Program.h>
+#include <nc/core/ir/Statements.h>
+#include <nc/core/ir/Terms.h>
+
+namespace nc {
+namespace core {
+namespace irgen {
+
+DeadFlagEliminator::DeadFlagEliminator(const arch::Architecture *architecture, const CancellationToken &canceled):
+    allFlags_(0), canceled_(canceled)
+{
+    assert(architecture != nullptr);
+    assert(architecture->flags().size() <= sizeof(FlagSet) * CHAR_BIT);
+
+    foreach (const arch::Register *flag, architecture->flags()) {
+        allFlags_ = (allFlags_ << 1) | 1;
+        flags_.push_back(flag->memoryLocation());
+        if (!nc::contains(domains_, flag->memoryLocation().domain())) {
+            domains_.push_back(flag->memoryLocation().domain());
+        }
+    }
+}
+
+std::size_t DeadFlagEliminator::eliminate(ir::Program *program) {
+    assert(program != nullptr);
+
+    if (flags_.empty()) {
+        return 0;
+    }
+
+    /* Compute predecessors of basic blocks. */
+    boost::unordered_map<const ir::BasicBlock *, std::vector<const ir::BasicBlock *>> predecessors;
+
+    foreach (const ir::BasicBlock *basicBlock, program->basicBlocks()) {
+        if (basicBlock->statements().empty()) {
+            continue;
+        }
+        if (auto jump = basicBlock->statements().back()->asJump()) {
+            auto addPredecessor = [&](const ir::JumpTarget &target) {
+                if (target.basicBlock()) {
+                    predecessors[target.basicBlock()].push_back(basicBlock);
+                } else if (target.table()) {
+                    foreach (const auto &entry, *target.table()) {
+                        if (entry.basicBlock()) {
+                            predecessors[entry.basicBlock()].push_back(basicBlock);
+                        }
+                    }
+                }
+            };
+
+            addPredecessor(jump->thenTarget());
+            addPredecessor(jump->elseTarget());
+        }
+    }
+
+    /* Compute flags live at the beginnings of basic blocks. */
+    std::vector<const ir::BasicBlock *> queue(program->basicBlocks().begin(), program->basicBlocks().end());
+    boost::unordered_set<const ir::BasicBlock *> queued(queue.begin(), queue.end());
+
+    while (!queue.empty()) {
+        const ir::BasicBlock *basicBlock = queue.back();
+        queue.pop_back();
+        queued.erase(basicBlock);
+
+        FlagSet live = getLiveOutFlags(basicBlock);
+        for (auto i = basicBlock->statements().rbegin(); i != basicBlock->statements().rend(); ++i) {
+            live = transfer(*i, live);
+        }
+
+        auto &liveIn = liveIn_[basicBlock];
+        if (live != liveIn) {
+            liveIn = live;
+
+            foreach (const ir::BasicBlock *predecessor, nc::find(predecessors, basicBlock)) {
+                if (queued.insert(predecessor).second) {
+                    queue.push_back(predecessor);
+                }
+            }
+        }
+
+        canceled_.poll();
+    }
+
+    /* Remove dead assignments. */
+    std::size_t result = 0;
+
+    foreach (ir::BasicBlock *basicBlock, program->basicBlocks()) {
+        std::vector<ir::Statement *> deadStatements;
+
+        FlagSet live = getLiveOutFlags(basicBlock);
+        for (auto i = basicBlock->statements().rbegin(); i != basicBlock->statements().rend(); ++i) {
+            if (isDead(*i, live)) {
+                deadStatements.push_back(*i);
+            } else {
+                live = transfer(*i, live);
+            }
+        }
+
+        foreach (ir::Statement *statement, deadStatements) {
+            basicBlock->erase(statement);
+        }
+
+        result += deadStatements.size();
+    }
+
+    return result;
+}
+
+DeadFlagEliminator::FlagSet DeadFlagEliminator::getOverlappedFlags(const ir::MemoryLocation &memoryLocation) const {
+    FlagSet result = 0;
+    if (nc::contains(domains_, memoryLocation.domain())) {
+        for (std::size_t i = 0; i < flags_.size(); ++i) {
+            if (flags_[i].overlaps(memoryLocation)) {
+                result |= FlagSet(1) << i;
+            }
+        }
+    }
+    return result;
+}
+
+DeadFlagEliminator::FlagSet DeadFlagEliminator::getCoveredFlags(const ir::MemoryLocation &memoryLocation) const {
+    FlagSet result = 0;
+    if (nc::contains(domains_, memoryLocation.domain())) {
+        for (std::size_t i = 0; i < flags_.size(); ++i) {
+            if (memoryLocation.covers(flags_[i])) {
+                result |= FlagSet(1) << i;
+            }
+        }
+    }
+    return result;
+}
+
+bool DeadFlagEliminator::isFlag(const ir::MemoryLocation &memoryLocation) const {
+    if (nc::contains(domains_, memoryLocation.domain())) {
+        foreach (const auto &flag, flags_) {
+            if (flag.covers(memoryLocation)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+DeadFlagEliminator::FlagSet DeadFlagEliminator::getReadFlags(const ir::Term *term) const {
+    assert(term != nullptr);
+
+    switch (term->kind()) {
+        case ir::Term::INT_CONST:
+        case ir::Term::INTRINSIC:
+            return 0;
+        case ir::Term::MEMORY_LOCATION_ACCESS:
+            return term->isRead() ? getOverlappedFlags(term->asMemoryLocationAccess()->memoryLocation()) : 0;
+        case ir::Term::DEREFERENCE:
+            /* Flags are registers: dereferences never access them. */
+            return getReadFlags(term->asDereference()->address());
+        case ir::Term::UNARY_OPERATOR:
+            return getReadFlags(term->asUnaryOperator()->operand());
+        case ir::Term::BINARY_OPERATOR:
+            return getReadFlags(term->asBinaryOperator()->left()) |
+                   getReadFlags(term->asBinaryOperator()->right());
+        default:
+            unreachable();
+    }
+}
+
+DeadFlagEliminator::FlagSet DeadFlagEliminator::getLiveFlags(const ir::JumpTarget &target) const {
+    if (target.basicBlock()) {
+        return nc::find(liveIn_, target.basicBlock());
+    } else if (target.table()) {
+        FlagSet result = 0;
+        foreach (const auto &entry, *target.table()) {
+            if (entry.basicBlock()) {
+                result |= nc::find(liveIn_, entry.basicBlock());
+            } else {
+                return allFlags_;
+            }
+        }
+        return result;
+    } else if (target.address()) {
+        return allFlags_;
+    } else {
+        return 0;
+    }
+}
+
+DeadFlagEliminator::FlagSet DeadFlagEliminator::getLiveOutFlags(const ir::BasicBlock *basicBlock) const {
+    if (!basicBlock->statements().empty()) {
+        const ir::Statement *last = basicBlock->statements().back();
+
+        if (auto jump = last->asJump()) {
+            return getLiveFlags(jump->thenTarget()) | getLiveFlags(jump->elseTarget());
+        } else if (last->is<ir::Halt>()) {
+            return 0;
+        }
+    }
+
+    /* Control flows to an unknown place. */
+    return allFlags_;
+}
+
+DeadFlagEliminator::FlagSet DeadFlagEliminator::transfer(const ir::Statement *statement, FlagSet live) const {
+    switch (statement->kind()) {
+        case ir::Statement::INLINE_ASSEMBLY:
+        case ir::Statement::CALLBACK:
+        case ir::Statement::REMEMBER_REACHING_DEFINITIONS:
+            return allFlags_;
+        case ir::Statement::ASSIGNMENT: {
+            auto assignment = statement->asAssignment();
+            if (auto access = assignment->left()->asMemoryLocationAccess()) {
+                live &= ~getCoveredFlags(access->memoryLocation());
+            } else {
+                live |= getReadFlags(assignment->left());
+            }
+            return live | getReadFlags(assignment->right());
+        }
+        case ir::Statement::JUMP: {
+            /* The jump's targets are accounted for in getLiveOutFlags(). */
+            auto jump = statement->asJump();
+            if (jump->condition()) {
+                live |= getReadFlags(jump->condition());
+            }
+            if (jump->thenTarget().address()) {
+                live |= getReadFlags(jump->thenTarget().address());
+            }
+            if (jump->elseTarget().address()) {
+                live |= getReadFlags(jump->elseTarget().address());
+            }
+            return live;
+        }
+        case ir::Statement::CALL:
+            /* The callee can read anything. */
+            return allFlags_;
+        case ir::Statement::HALT:
+            return 0;
+        case ir::Statement::TOUCH: {
+            auto touch = statement->asTouch();
+            if (touch->term()->isWrite()) {
+                if (auto access = touch->term()->asMemoryLocationAccess()) {
+                    return live & ~getCoveredFlags(access->memoryLocation());
+                }
+            }
+            return live | getReadFlags(touch->term());
+        }
+        default:
+            unreachable();
+    }
+}
+
+bool DeadFlagEliminator::isDead(const ir::Statement *statement, FlagSet live) const {
+    if (auto assignment = statement->asAssignment()) {
+        if (auto access = assignment->left()->asMemoryLocationAccess()) {
+            return isFlag(access->memoryLocation()) && !(getOverlappedFlags(access->memoryLocation()) & live);
+        }
+    }
+    return false;
+}
+
+} // namespace irgen
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,139 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
+#include <nc/common/CancellationToken.h>
+#include <nc/core/ir/MemoryLocation.h>
+
+namespace nc {
+namespace core {
+
+namespace arch {
+    class Architecture;
+}
+
+namespace ir {
+    class BasicBlock;
+    class JumpTarget;
+    class Program;
+    class Statement;
+    class Term;
+}
+
+namespace irgen {
+
+/**
+ * Removes assignments to condition flags that are overwritten before being read.
+ *
+ * Instruction analyzers describe all the flags affected by an instruction,
+ * but most of them are overwritten by the next arithmetic instruction.
+ * The class computes which flags are live at the end of each basic block
+ * by a backward dataflow analysis over the program's control flow graph and
+ * removes the dead assignments. Calls, inline assembly, and jumps to unknown
+ * targets are assumed to read all the flags.
+ */
+class DeadFlagEliminator {
+    /** Set of flags, one bit per flag. */
+    typedef unsigned long long FlagSet;
+
+    /** Set of all flags. */
+    FlagSet allFlags_;
+
+    const CancellationToken &canceled_; ///< Cancellation token.
+    std::vector<ir::MemoryLocation> flags_; ///< Memory locations of the flags.
+    std::vector<ir::Domain> domains_; ///< Domains of the flags' memory locations.
+    boost::unordered_map<const ir::BasicBlock *, FlagSet> liveIn_; ///< Flags live at the beginning of basic blocks.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param[in] architecture Valid pointer to the architecture.
+     * \param[in] canceled Cancellation token.
+     */
+    DeadFlagEliminator(const arch::Architecture *architecture, const CancellationToken &canceled);
+
+    /**
+     * Removes dead assignments to flags from the program.
+     *
+     * \param[in,out] program Valid pointer to the program.
+     *
+     * \return Number of removed statements.
+     */
+    std::size_t eliminate(ir::Program *program);
+
+private:
+    /**
+     * \param memoryLocation Memory location.
+     *
+     * \return Flags overlapping with the memory location.
+     */
+    FlagSet getOverlappedFlags(const ir::MemoryLocation &memoryLocation) const;
+
+    /**
+     * \param memoryLocation Memory location.
+     *
+     * \return Flags covered by the memory location.
+     */
+    FlagSet getCoveredFlags(const ir::MemoryLocation &memoryLocation) const;
+
+    /**
+     * \param memoryLocation Memory location.
+     *
+     * \return True if the memory location belongs to a single flag.
+     */
+    bool isFlag(const ir::MemoryLocation &memoryLocation) const;
+
+    /**
+     * \param term Valid pointer to a term.
+     *
+     * \return Flags read by the term and its subterms.
+     */
+    FlagSet getReadFlags(const ir::Term *term) const;
+
+    /**
+     * \param target Jump target.
+     *
+     * \return Flags live at the jump target.
+     */
+    FlagSet getLiveFlags(const ir::JumpTarget &target) const;
+
+    /**
+     * \param basicBlock Valid pointer to a basic block.
+     *
+     * \return Flags live at the end of the basic block.
+     */
+    FlagSet getLiveOutFlags(const ir::BasicBlock *basicBlock) const;
+
+    /**
+     * Computes the flags live before a statement.
+     *
+     * \param statement Valid pointer to a statement.
+     * \param live Flags live after the statement.
+     *
+     * \return Flags live before the statement.
+     */
+    FlagSet transfer(const ir::Statement *statement, FlagSet live) const;
+
+    /**
+     * \param statement Valid pointer to a statement.
+     * \param live Flags live after the statement.
+     *
+     * \return True if the statement is an assignment to a flag which is not live.
+     */
+    bool isDead(const ir::Statement *statement, FlagSet live) const;
+};
+
+} // namespace irgen
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
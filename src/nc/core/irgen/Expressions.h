@@ -334,17 +334,23 @@ class MemoryLocationExpression: public ExpressionBase<MemoryLocationExpression>
 public:
     MemoryLocationExpression(const ir::MemoryLocation &memoryLocation):
         base_type(memoryLocation.size()),
+        mMemoryLocation(ir::SharedMemoryLocationTable::instance().intern(memoryLocation))
+    {}
+
+    MemoryLocationExpression(ir::MemoryLocationHandle memoryLocation):
+        base_type(ir::SharedMemoryLocationTable::instance().get(memoryLocation).size()),
         mMemoryLocation(memoryLocation)
     {}
 
     MemoryLocationExpression(const MemoryLocationExpression &that):
         base_type(that),
-        mMemoryLocation(that.memoryLocation())
+        mMemoryLocation(that.mMemoryLocation)
     {}
 
-    const ir::MemoryLocation &memoryLocation() const { return mMemoryLocation; }
+    const ir::MemoryLocation &memoryLocation() const { return ir::SharedMemoryLocationTable::instance().get(mMemoryLocation); }
+    ir::MemoryLocationHandle memoryLocationHandle() const { return mMemoryLocation; }
 private:
-    ir::MemoryLocation mMemoryLocation;
+    ir::MemoryLocationHandle mMemoryLocation;
 };
 
 /**
@@ -488,7 +494,7 @@ term(std::unique_ptr<ir::Term> term) {
 inline
 MemoryLocationExpression
 regizter(const arch::Register *reg) {
-    return MemoryLocationExpression(reg->memoryLocation());
+    return MemoryLocationExpression(reg->memoryLocationHandle());
 }
 
 template<class E>
@@ -923,7 +929,7 @@ protected:
      * \returns                        Newly created term for the given expression.
      */
     std::unique_ptr<ir::Term> doCreateTerm(MemoryLocationExpression &expression) const {
-        return std::make_unique<ir::MemoryLocationAccess>(expression.memoryLocation());
+        return std::make_unique<ir::MemoryLocationAccess>(expression.memoryLocationHandle());
     }
 
     /**
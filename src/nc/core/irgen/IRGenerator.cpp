@@ -27,30 +27,28 @@
 #include <cassert>
 #include <queue>
 
+#include <QElapsedTimer>
+
 #include <boost/range/algorithm_ext/is_sorted.hpp>
 #include <boost/unordered_set.hpp>
 
 #include <nc/common/Foreach.h>
+#include <nc/common/Parallel.h>
 #include <nc/common/Range.h>
 #include <nc/common/make_unique.h>
 
 #include <nc/core/arch/Architecture.h>
-#include <nc/core/arch/Disassembler.h>
 #include <nc/core/arch/Instructions.h>
 #include <nc/core/image/Image.h>
-#include <nc/core/image/Reader.h>
-#include <nc/core/image/Section.h>
 #include <nc/core/ir/Jump.h>
 #include <nc/core/ir/Program.h>
 #include <nc/core/ir/Statements.h>
-#include <nc/core/ir/dflow/Dataflow.h>
-#include <nc/core/ir/dflow/DataflowAnalyzer.h>
-#include <nc/core/ir/dflow/Value.h>
-#include <nc/core/ir/misc/ArrayAccess.h>
-#include <nc/core/ir/misc/PatternRecognition.h>
 
+#include "DeadFlagEliminator.h"
 #include "InstructionAnalyzer.h"
 #include "InvalidInstructionException.h"
+#include "JumpTargetResolver.h"
+#include "NoReturnAnalyzer.h"
 
 namespace nc {
 namespace core {
@@ -68,12 +66,29 @@ IRGenerator::IRGenerator(const image::Image *image, const arch::Instructions *in
 IRGenerator::~IRGenerator() {}
 
 void IRGenerator::generate() {
-    image_->platform().architecture()->createInstructionAnalyzer()->createStatements(instructions_, program_, canceled_, log_);
+    QElapsedTimer timer;
+    timer.start();
+
+    auto templateHits = createStatements();
+
+    /* Report the throughput of the instruction analyzer. */
+    auto elapsed = timer.elapsed();
+    std::size_t statementCount = 0;
+    foreach (auto basicBlock, program_->basicBlocks()) {
+        statementCount += basicBlock->statements().size();
+    }
+    log_.debug(tr("Generated %1 statements for %2 instructions in %3 ms (%4 statements per second), "
+                  "%5 instructions instantiated from semantic templates.")
+        .arg(statementCount)
+        .arg(instructions_->size())
+        .arg(elapsed)
+        .arg(elapsed ? statementCount * 1000 / elapsed : statementCount)
+        .arg(templateHits));
 
 #ifndef NDEBUG
     /*
      * Check statements are sorted by their instructions' addresses.
-     * ir::Program::createBasicBlock(ByteAddr) relies on this while splitting basic blocks.
+     * ir::Program::createBasicBlocks() relies on this while splitting basic blocks.
      */
     foreach (auto basicBlock, program_->basicBlocks()) {
         assert((boost::is_sorted(basicBlock->statements(), [](const ir::Statement *a, const ir::Statement *b) -> bool {
@@ -83,10 +98,7 @@ void IRGenerator::generate() {
 #endif
 
     /* Compute jump targets. */
-    foreach (auto basicBlock, program_->basicBlocks()) {
-        computeJumpTargets(basicBlock);
-        canceled_.poll();
-    }
+    JumpTargetResolver(image_, instructions_, program_, canceled_, log_).resolve();
 
 #ifndef NDEBUG
     /*
@@ -101,143 +113,223 @@ void IRGenerator::generate() {
     }
 #endif
 
+    /* Cut the control flow after calls to functions which never return. */
+    NoReturnAnalyzer noReturnAnalyzer(image_, program_, canceled_);
+    noReturnAnalyzer.analyze();
+    noReturnAnalyzer.prune();
+
+    log_.debug(tr("Found %1 no-return functions, cut %2 basic blocks after calls to them, "
+                  "removed %3 unreachable basic blocks and %4 instructions.")
+        .arg(noReturnAnalyzer.noReturnAddresses().size())
+        .arg(noReturnAnalyzer.cutBasicBlocks())
+        .arg(noReturnAnalyzer.prunedBasicBlocks())
+        .arg(noReturnAnalyzer.prunedInstructions()));
+
     /* Add jumps to direct successors where necessary. */
     foreach (auto basicBlock, program_->basicBlocks()) {
         addJumpToDirectSuccessor(basicBlock);
         canceled_.poll();
     }
+
+    /* Remove assignments to flags that are never read. */
+    auto deadFlags = DeadFlagEliminator(image_->platform().architecture(), canceled_).eliminate(program_);
+    if (deadFlags) {
+        log_.debug(tr("Removed %1 dead assignments to flags.").arg(deadFlags));
+    }
 }
 
-void IRGenerator::computeJumpTargets(ir::BasicBlock *basicBlock) {
-    assert(basicBlock != nullptr);
+namespace {
 
-    /* Prepare context for quick and dirty dataflow analysis. */
-    ir::dflow::Dataflow dataflow;
-    ir::dflow::DataflowAnalyzer analyzer(dataflow, image_->platform().architecture(), canceled_, log_);
-    ir::dflow::ReachingDefinitions definitions;
-
-    foreach (auto statement, basicBlock->statements()) {
-        analyzer.execute(statement, definitions);
-
-        switch (statement->kind()) {
-            case ir::Statement::INLINE_ASSEMBLY: {
-                /*
-                 * Inline assembly can do unpredictable things.
-                 * Therefore, clear the reaching definitions.
-                 */
-                definitions.clear();
-                break;
-            }
-            case ir::Statement::CALL: {
-                auto call = statement->asCall();
-                auto addressValue = dataflow.getValue(call->target());
+/** Number of consecutive instructions analyzed together. */
+const std::size_t CHUNK_SIZE = 8192;
 
-                /* Record information about the function entry. */
-                if (addressValue->abstractValue().isConcrete()) {
-                    ByteAddr address = addressValue->abstractValue().asConcrete().value();
+} // anonymous namespace
 
-                    program_->addCalledAddress(address);
-                    program_->createBasicBlock(address);
-                } else {
-                    foreach (ByteAddr address, getJumpTableEntries(call->target(), dataflow)) {
-                        program_->addCalledAddress(address);
-                        program_->createBasicBlock(address);
-                    }
-                }
+/**
+ * Statements generated for a chunk of consecutive instructions.
+ */
+class IRGenerator::Chunk {
+public:
+    std::vector<const arch::Instruction *> instructions; ///< Instructions, sorted by address.
+    ir::Program program; ///< Program containing the statements generated for the instructions.
+    std::size_t templateHits; ///< Number of instructions instantiated from semantic templates.
 
-                /*
-                 * A call can do unpredictable things.
-                 * Therefore, clear the reaching definitions.
-                 */
-                definitions.clear();
-                break;
-            }
-            case ir::Statement::JUMP: {
-                auto jump = statement->as<ir::Jump>();
+    Chunk(): templateHits(0) {}
+
+    /**
+     * \return Address of the first instruction in the chunk.
+     */
+    ByteAddr startAddress() const { return instructions.front()->addr(); }
+
+    /**
+     * \return Address following the last instruction in the chunk.
+     */
+    ByteAddr endAddress() const { return instructions.back()->endAddr(); }
+
+    /**
+     * Generates the statements for the instructions with an instruction analyzer of its own.
+     *
+     * \param architecture Valid pointer to the architecture.
+     * \param canceled Cancellation token.
+     * \param log Log token.
+     */
+    void createStatements(const arch::Architecture *architecture, const CancellationToken &canceled, const LogToken &log) {
+        auto instructionAnalyzer = architecture->createInstructionAnalyzer();
 
-                /* If the target basic block is unknown, try to guess it. */
-                computeJumpTarget(jump->thenTarget(), dataflow);
-                computeJumpTarget(jump->elseTarget(), dataflow);
+        /* Collect the leaders while analyzing and cut the basic blocks at them afterwards. */
+        program.deferBasicBlocks();
 
-                break;
+        foreach (auto instruction, instructions) {
+            try {
+                instructionAnalyzer->createStatements(instruction, &program);
+            } catch (const InvalidInstructionException &e) {
+                log.warning(e.unicodeWhat());
             }
+            canceled.poll();
         }
 
-        if (statement->isTerminator() && statement->basicBlock()->address() && statement->instruction()) {
-            program_->createBasicBlock(statement->instruction()->endAddr());
+        program.createDeferredBasicBlocks();
+
+        templateHits = instructionAnalyzer->templateCache().hits();
+    }
+};
+
+std::size_t IRGenerator::createStatements() {
+    const auto *architecture = image_->platform().architecture();
+
+    /*
+     * Chunks do not depend on the number of threads,
+     * so that the resulting program is always the same.
+     */
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    foreach (const auto &instruction, instructions_->all()) {
+        if (chunks.empty() || chunks.back()->instructions.size() == CHUNK_SIZE) {
+            chunks.push_back(std::make_unique<Chunk>());
+            chunks.back()->instructions.reserve(CHUNK_SIZE);
         }
+        chunks.back()->instructions.push_back(instruction.get());
+    }
+
+    parallelFor(chunks.size(), [&](std::size_t i) {
+        chunks[i]->createStatements(architecture, canceled_, log_);
+    });
+
+    std::size_t templateHits = 0;
+    foreach (const auto &chunk, chunks) {
+        templateHits += chunk->templateHits;
     }
+
+    mergeChunks(chunks);
+
+    return templateHits;
 }
 
-void IRGenerator::computeJumpTarget(ir::JumpTarget &target, const ir::dflow::Dataflow &dataflow) {
-    if (target.address() && !target.basicBlock() && !target.table()) {
-        const ir::dflow::Value *addressValue = dataflow.getValue(target.address());
+void IRGenerator::mergeChunks(std::vector<std::unique_ptr<Chunk>> &chunks) {
+    /*
+     * A chunk's program contains the basic blocks covering its instructions,
+     * non-memory-bound basic blocks, and empty basic blocks created for the
+     * addresses outside the chunk, e.g. for the targets of jumps to other chunks.
+     *
+     * When analyzing the instructions sequentially, the first instruction
+     * of a chunk would be appended to the basic block of the preceding
+     * instruction, unless some instruction asked for a basic block starting
+     * at its address. Find out whether any did.
+     */
+    std::vector<char> startRequested(chunks.size());
+
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        const auto &chunk = *chunks[i];
 
-        if (addressValue->abstractValue().isConcrete()) {
-            target.setBasicBlock(program_->createBasicBlock(addressValue->abstractValue().asConcrete().value()));
-        } else {
-            auto entries = getJumpTableEntries(target.address(), dataflow);
+        for (std::size_t j = 0; j < chunks.size() && !startRequested[i]; ++j) {
+            if (j != i && chunks[j]->program.getBasicBlockStartingAt(chunk.startAddress())) {
+                startRequested[i] = true;
+            }
+        }
 
-            if (!entries.empty()) {
-                auto table = std::make_unique<ir::JumpTable>();
+        if (!startRequested[i]) {
+            auto firstBasicBlock = chunk.program.getBasicBlockStartingAt(chunk.startAddress());
 
-                foreach (ByteAddr targetAddress, entries) {
-                    table->push_back(ir::JumpTableEntry(targetAddress, program_->createBasicBlock(targetAddress)));
+            foreach (const ir::BasicBlock *basicBlock, chunk.program.basicBlocks()) {
+                if (auto jump = basicBlock->getJump()) {
+                    if (jump->thenTarget().basicBlock() == firstBasicBlock ||
+                        jump->elseTarget().basicBlock() == firstBasicBlock) {
+                        startRequested[i] = true;
+                        break;
+                    }
                 }
-                target.setTable(std::move(table));
             }
         }
     }
-}
 
-std::vector<ByteAddr> IRGenerator::getJumpTableEntries(const ir::Term *target, const ir::dflow::Dataflow &dataflow) {
-    std::vector<ByteAddr> result;
+    /* Move the basic blocks to the program, in a deterministic order. */
+    std::vector<std::unique_ptr<ir::BasicBlock>> foreignBasicBlocks;
+    std::vector<ir::Jump *> jumps;
 
-    auto arrayAccess = ir::misc::recognizeArrayAccess(target, dataflow);
-    if (!arrayAccess) {
-        return result;
-    }
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        auto &chunk = *chunks[i];
 
-    /* Safety net. */
-    const std::size_t maxTableEntries = 65536;
-    const ByteSize entrySize = target->size() / CHAR_BIT;
+        foreach (auto address, chunk.program.calledAddresses()) {
+            program_->addCalledAddress(address);
+        }
 
-    image::Reader reader(image_);
+        while (!chunk.program.basicBlocks().empty()) {
+            auto basicBlock = chunk.program.basicBlocks().pop_front();
 
-    auto byteOrder = image_->platform().architecture()->getByteOrder(ir::MemoryDomain::MEMORY);
+            if (auto jump = basicBlock->getJump()) {
+                jumps.push_back(jump);
+            }
 
-    ByteAddr address = arrayAccess.base();
-    while (auto entry = reader.readInt<ByteAddr>(address, entrySize, byteOrder)) {
-        if (!isInstructionAddress(*entry)) {
-            break;
+            if (!basicBlock->address()) {
+                program_->adoptBasicBlock(std::move(basicBlock));
+            } else if (*basicBlock->address() < chunk.startAddress() || *basicBlock->address() >= chunk.endAddress()) {
+                /* The basic block will be replaced by the one of the chunk owning the address. */
+                assert(basicBlock->statements().empty());
+                foreignBasicBlocks.push_back(std::move(basicBlock));
+            } else if (*basicBlock->address() == chunk.startAddress() && !startRequested[i]) {
+                auto predecessor = program_->getBasicBlockCovering(chunk.startAddress() - 1);
+
+                if (predecessor && predecessor->successorAddress() == chunk.startAddress()) {
+                    /* Nobody jumps to the basic block: just append its statements to the predecessor. */
+                    while (!basicBlock->statements().empty()) {
+                        predecessor->pushBack(basicBlock->erase(basicBlock->statements().front()));
+                    }
+                    program_->setSuccessorAddress(predecessor, *basicBlock->successorAddress());
+                } else {
+                    program_->adoptBasicBlock(std::move(basicBlock));
+                }
+            } else {
+                program_->adoptBasicBlock(std::move(basicBlock));
+            }
         }
-        result.push_back(*entry);
-        address += arrayAccess.stride();
 
-        if (result.size() > maxTableEntries) {
-            log_.warning(tr("Jump table at address %1 seems to have more than %2 entries.").arg(address).arg(maxTableEntries));
-            break;
-        }
+        canceled_.poll();
     }
 
-    return result;
-}
-
-bool IRGenerator::isInstructionAddress(ByteAddr address) {
-    if (instructions_->get(address)) {
-        return true;
+    /* Redirect the jumps to the basic blocks of other chunks. */
+    std::vector<ByteAddr> foreignAddresses;
+    foreignAddresses.reserve(foreignBasicBlocks.size());
+    foreach (const auto &basicBlock, foreignBasicBlocks) {
+        foreignAddresses.push_back(*basicBlock->address());
     }
+    program_->createBasicBlocks(std::move(foreignAddresses));
 
-    auto section = image_->getSectionContainingAddress(address);
-    if (!section || !section->isExecutable()) {
-        return false;
+    boost::unordered_map<const ir::BasicBlock *, ir::BasicBlock *> replacements;
+    foreach (const auto &basicBlock, foreignBasicBlocks) {
+        replacements[basicBlock.get()] = program_->getBasicBlockStartingAt(*basicBlock->address());
     }
 
-    if (!disassembler_) {
-        disassembler_ = image_->platform().architecture()->createDisassembler();
-    }
+    auto redirect = [&](ir::JumpTarget &target) {
+        if (target.basicBlock()) {
+            if (auto replacement = nc::find(replacements, target.basicBlock())) {
+                target.setBasicBlock(replacement);
+            }
+        }
+    };
 
-    return disassembler_->disassembleSingleInstruction(address, section) != nullptr;
+    foreach (auto jump, jumps) {
+        redirect(jump->thenTarget());
+        redirect(jump->elseTarget());
+    }
 }
 
 void IRGenerator::addJumpToDirectSuccessor(ir::BasicBlock *basicBlock) {
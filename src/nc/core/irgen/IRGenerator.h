@@ -28,6 +28,7 @@
 #include <QCoreApplication>
 
 #include <cassert>
+#include <memory>
 #include <vector>
 
 #include <nc/common/CancellationToken.h>
@@ -43,17 +44,10 @@ namespace image {
 
 namespace ir {
     class BasicBlock;
-    class JumpTarget;
     class Program;
-    class Term;
-
-    namespace dflow {
-        class Dataflow;
-    }
 }
 
 namespace arch {
-    class Disassembler;
     class Instructions;
 }
 
@@ -70,7 +64,6 @@ class IRGenerator {
     ir::Program *program_; ///< Program.
     const CancellationToken &canceled_; ///< Cancellation token.
     const LogToken &log_; ///< Log token.
-    std::unique_ptr<arch::Disassembler> disassembler_; ///< Disassembler.
 
 public:
     /**
@@ -97,38 +90,25 @@ public:
     void generate();
 
 private:
-    /**
-     * Computes jump targets in the basic block.
-     *
-     * \param basicBlock Valid pointer to a basic block.
-     */
-    void computeJumpTargets(ir::BasicBlock *basicBlock);
+    class Chunk;
 
     /**
-     * Sets the basic block or jump table fields in the jump target,
-     * based on the address expression and some guessing.
-     *
-     * \param[in,out] target   Jump target.
-     * \param[in]     dataflow Dataflow information collected up to the point where jump has been met.
-     */
-    void computeJumpTarget(ir::JumpTarget &target, const ir::dflow::Dataflow &dataflow);
-
-    /**
-     * Determines jump table address and recovers its entries in a form of a vector of addresses.
-     *
-     * \param[in] target Valid pointer to a term representing the jump target.
-     * \param[in] dataflow Dataflow information collected up to the point where jump has been met.
+     * Creates the statements for the instructions. Chunks of consecutive
+     * instructions are analyzed concurrently, each chunk into a program
+     * of its own, and then merged into the program.
      *
-     * \returns The entries of the jump table.
+     * \return Number of instructions instantiated from semantic templates.
      */
-    std::vector<ByteAddr> getJumpTableEntries(const ir::Term *target, const ir::dflow::Dataflow &dataflow);
+    std::size_t createStatements();
 
     /**
-     * \param address A virtual address.
+     * Moves the basic blocks of the chunks' programs into the program,
+     * joining the basic blocks continuing across chunk boundaries and
+     * redirecting the jumps to the basic blocks of other chunks.
      *
-     * \return True if the address seems to be an instruction address, false otherwise.
+     * \param chunks Chunks sorted by address.
      */
-    bool isInstructionAddress(ByteAddr address);
+    void mergeChunks(std::vector<std::unique_ptr<Chunk>> &chunks);
 
     /**
      * Adds a jump to direct successor to given basic block if the latter
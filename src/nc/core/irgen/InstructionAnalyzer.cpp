@@ -73,7 +73,7 @@ void InstructionAnalyzer::createStatements(const arch::Instruction *instruction,
 }
 
 std::unique_ptr<ir::Term> InstructionAnalyzer::createTerm(const arch::Register *reg) {
-    return std::make_unique<ir::MemoryLocationAccess>(reg->memoryLocation());
+    return std::make_unique<ir::MemoryLocationAccess>(reg->memoryLocationHandle());
 }
 
 } // namespace irgen
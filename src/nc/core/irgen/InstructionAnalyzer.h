@@ -27,6 +27,8 @@
 
 #include <memory>
 
+#include "SemanticTemplateCache.h"
+
 namespace nc {
 
 class CancellationToken;
@@ -51,7 +53,15 @@ namespace irgen {
  * Class used for producing IR code from an instruction.
  */
 class InstructionAnalyzer {
+    /** Cache of statements generated for instructions. */
+    SemanticTemplateCache templateCache_;
+
 public:
+    /**
+     * Virtual destructor.
+     */
+    virtual ~InstructionAnalyzer() {}
+
     /**
      * Creates intermediate representation of the given set of instructions.
      *
@@ -79,6 +89,19 @@ public:
      */
     static std::unique_ptr<ir::Term> createTerm(const arch::Register *reg);
 
+    /**
+     * \return Cache of statements generated for instructions.
+     *          Architectures whose analyzers can tell which instructions do not
+     *          depend on their addresses may use it to avoid generating the same
+     *          statements again and again.
+     */
+    SemanticTemplateCache &templateCache() { return templateCache_; }
+
+    /**
+     * \return Cache of statements generated for instructions.
+     */
+    const SemanticTemplateCache &templateCache() const { return templateCache_; }
+
 protected:
     /**
      * Actually creates intermediate representation of the given set of instructions.
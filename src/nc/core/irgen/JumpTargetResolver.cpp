@@ -0,0 +1,336 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "JumpTargetResolver.h"
+
+#include <cassert>
+#include <climits> /* CHAR_BIT */
+#include <memory>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
+#include <nc/common/Foreach.h>
+#include <nc/common/Parallel.h>
+#include <nc/common/make_unique.h>
+
+#include <nc/core/arch/Architecture.h>
+#include <nc/core/arch/Disassembler.h>
+#include <nc/core/arch/Instructions.h>
+#include <nc/core/image/Image.h>
+#include <nc/core/image/Reader.h>
+#include <nc/core/image/Section.h>
+#include <nc/core/ir/BasicBlock.h>
+#include <nc/core/ir/Jump.h>
+#include <nc/core/ir/Program.h>
+#include <nc/core/ir/Statements.h>
+#include <nc/core/ir/Terms.h>
+#include <nc/core/ir/dflow/Dataflow.h>
+#include <nc/core/ir/dflow/DataflowAnalyzer.h>
+#include <nc/core/ir/dflow/ReachingDefinitions.h>
+#include <nc/core/ir/dflow/Value.h>
+#include <nc/core/ir/misc/ArrayAccess.h>
+#include <nc/core/ir/misc/PatternRecognition.h>
+
+namespace nc {
+namespace core {
+namespace irgen {
+
+namespace {
+
+/** Number of basic blocks analyzed in a batch. */
+const std::size_t BATCH_SIZE = 1024;
+
+} // anonymous namespace
+
+/**
+ * Jump target whose basic blocks are not created yet.
+ */
+class JumpTargetResolver::UnresolvedTarget {
+public:
+    ir::JumpTarget *target; ///< The jump target.
+    std::vector<ByteAddr> addresses; ///< Address of the target or addresses of the jump table entries.
+    bool isTable; ///< True if the addresses are jump table entries.
+
+    UnresolvedTarget(ir::JumpTarget *target, std::vector<ByteAddr> addresses, bool isTable):
+        target(target), addresses(std::move(addresses)), isTable(isTable)
+    {}
+};
+
+/**
+ * A batch of basic blocks analyzed together, and the results of the analysis.
+ * The program is not modified while analyzing a batch.
+ */
+class JumpTargetResolver::Batch {
+    const image::Image *image_; ///< Executable image.
+    const arch::Instructions *instructions_; ///< Instructions.
+    const CancellationToken &canceled_; ///< Cancellation token.
+    const LogToken &log_; ///< Log token.
+    ir::dflow::Dataflow dataflow_; ///< Dataflow information, reused for all the basic blocks of the batch.
+    ir::dflow::DataflowAnalyzer analyzer_; ///< Dataflow analyzer.
+    ir::dflow::ReachingDefinitions definitions_; ///< Reaching definitions, reused for all the basic blocks of the batch.
+    std::unique_ptr<arch::Disassembler> disassembler_; ///< Disassembler.
+    boost::unordered_map<ByteAddr, bool> instructionAddresses_; ///< Cached results of isInstructionAddress().
+
+public:
+    std::vector<ir::BasicBlock *> basicBlocks; ///< Basic blocks to analyze.
+    std::vector<ByteAddr> leaders; ///< Addresses at which basic blocks must start.
+    std::vector<ByteAddr> calledAddresses; ///< Addresses of called functions.
+    std::vector<UnresolvedTarget> targets; ///< Computed jump targets.
+    std::size_t resolvedCalls; ///< Number of indirect calls whose targets were computed.
+
+    Batch(const image::Image *image, const arch::Instructions *instructions,
+          const CancellationToken &canceled, const LogToken &log):
+        image_(image), instructions_(instructions), canceled_(canceled), log_(log),
+        analyzer_(dataflow_, image->platform().architecture(), canceled, log),
+        resolvedCalls(0)
+    {}
+
+    /**
+     * Analyzes the basic blocks of the batch.
+     */
+    void analyze() {
+        foreach (auto basicBlock, basicBlocks) {
+            analyze(basicBlock);
+            canceled_.poll();
+        }
+    }
+
+private:
+    /**
+     * Computes jump targets in the basic block.
+     *
+     * \param basicBlock Valid pointer to a basic block.
+     */
+    void analyze(ir::BasicBlock *basicBlock) {
+        assert(basicBlock != nullptr);
+
+        /* Quick and dirty dataflow analysis of the basic block. */
+        dataflow_.clear();
+        definitions_.clear();
+
+        foreach (auto statement, basicBlock->statements()) {
+            analyzer_.execute(statement, definitions_);
+
+            switch (statement->kind()) {
+                case ir::Statement::INLINE_ASSEMBLY: {
+                    /*
+                     * Inline assembly can do unpredictable things.
+                     * Therefore, clear the reaching definitions.
+                     */
+                    definitions_.clear();
+                    break;
+                }
+                case ir::Statement::CALL: {
+                    auto call = statement->asCall();
+                    auto addressValue = dataflow_.getValue(call->target());
+
+                    std::vector<ByteAddr> addresses;
+                    if (addressValue->abstractValue().isConcrete()) {
+                        addresses.push_back(addressValue->abstractValue().asConcrete().value());
+                    } else {
+                        addresses = getJumpTableEntries(call->target());
+                    }
+
+                    /* Record information about the function entries. */
+                    calledAddresses.insert(calledAddresses.end(), addresses.begin(), addresses.end());
+                    leaders.insert(leaders.end(), addresses.begin(), addresses.end());
+
+                    if (!addresses.empty() && !call->target()->is<ir::Constant>()) {
+                        ++resolvedCalls;
+                    }
+
+                    /*
+                     * A call can do unpredictable things.
+                     * Therefore, clear the reaching definitions.
+                     */
+                    definitions_.clear();
+                    break;
+                }
+                case ir::Statement::JUMP: {
+                    auto jump = statement->as<ir::Jump>();
+
+                    /* If the target basic block is unknown, try to guess it. */
+                    computeJumpTarget(jump->thenTarget());
+                    computeJumpTarget(jump->elseTarget());
+
+                    break;
+                }
+            }
+
+            if (statement->isTerminator() && statement->basicBlock()->address() && statement->instruction()) {
+                leaders.push_back(statement->instruction()->endAddr());
+            }
+        }
+    }
+
+    /**
+     * Computes the address or the jump table entries of the jump target,
+     * based on the address expression and some guessing.
+     *
+     * \param target Jump target.
+     */
+    void computeJumpTarget(ir::JumpTarget &target) {
+        if (target.address() && !target.basicBlock() && !target.table()) {
+            const ir::dflow::Value *addressValue = dataflow_.getValue(target.address());
+
+            if (addressValue->abstractValue().isConcrete()) {
+                ByteAddr address = addressValue->abstractValue().asConcrete().value();
+
+                leaders.push_back(address);
+                targets.push_back(UnresolvedTarget(&target, std::vector<ByteAddr>(1, address), false));
+            } else {
+                auto entries = getJumpTableEntries(target.address());
+
+                if (!entries.empty()) {
+                    leaders.insert(leaders.end(), entries.begin(), entries.end());
+                    targets.push_back(UnresolvedTarget(&target, std::move(entries), true));
+                }
+            }
+        }
+    }
+
+    /**
+     * Determines jump table address and recovers its entries in a form of a vector of addresses.
+     *
+     * \param[in] target Valid pointer to a term representing the jump target.
+     *
+     * \returns The entries of the jump table.
+     */
+    std::vector<ByteAddr> getJumpTableEntries(const ir::Term *target) {
+        std::vector<ByteAddr> result;
+
+        auto arrayAccess = ir::misc::recognizeArrayAccess(target, dataflow_);
+        if (!arrayAccess) {
+            return result;
+        }
+
+        /* Safety net. */
+        const std::size_t maxTableEntries = 65536;
+        const ByteSize entrySize = target->size() / CHAR_BIT;
+
+        image::Reader reader(image_);
+
+        auto byteOrder = image_->platform().architecture()->getByteOrder(ir::MemoryDomain::MEMORY);
+
+        ByteAddr address = arrayAccess.base();
+        while (auto entry = reader.readInt<ByteAddr>(address, entrySize, byteOrder)) {
+            if (!isInstructionAddress(*entry)) {
+                break;
+            }
+            result.push_back(*entry);
+            address += arrayAccess.stride();
+
+            if (result.size() > maxTableEntries) {
+                log_.warning(tr("Jump table at address %1 seems to have more than %2 entries.").arg(address).arg(maxTableEntries));
+                break;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * \param address A virtual address.
+     *
+     * \return True if the address seems to be an instruction address, false otherwise.
+     */
+    bool isInstructionAddress(ByteAddr address) {
+        if (instructions_->get(address)) {
+            return true;
+        }
+
+        auto i = instructionAddresses_.find(address);
+        if (i != instructionAddresses_.end()) {
+            return i->second;
+        }
+
+        bool result = false;
+
+        auto section = image_->getSectionContainingAddress(address);
+        if (section && section->isExecutable()) {
+            if (!disassembler_) {
+                disassembler_ = image_->platform().architecture()->createDisassembler();
+            }
+            result = disassembler_->disassembleSingleInstruction(address, section) != nullptr;
+        }
+
+        instructionAddresses_[address] = result;
+        return result;
+    }
+};
+
+JumpTargetResolver::JumpTargetResolver(const image::Image *image, const arch::Instructions *instructions,
+    ir::Program *program, const CancellationToken &canceled, const LogToken &log):
+    image_(image), instructions_(instructions), program_(program), canceled_(canceled), log_(log),
+    resolvedJumps_(0), resolvedJumpTables_(0), resolvedCalls_(0)
+{
+    assert(image != nullptr);
+    assert(instructions != nullptr);
+    assert(program != nullptr);
+}
+
+JumpTargetResolver::~JumpTargetResolver() {}
+
+void JumpTargetResolver::resolve() {
+    /* Batches do not depend on the number of threads, so that the result is always the same. */
+    std::vector<std::unique_ptr<Batch>> batches;
+    foreach (auto basicBlock, program_->basicBlocks()) {
+        if (batches.empty() || batches.back()->basicBlocks.size() == BATCH_SIZE) {
+            batches.push_back(std::make_unique<Batch>(image_, instructions_, canceled_, log_));
+            batches.back()->basicBlocks.reserve(BATCH_SIZE);
+        }
+        batches.back()->basicBlocks.push_back(basicBlock);
+    }
+
+    parallelFor(batches.size(), [&](std::size_t i) {
+        batches[i]->analyze();
+    });
+
+    /* Create the basic blocks at all the computed addresses at once. */
+    std::vector<ByteAddr> leaders;
+    foreach (const auto &batch, batches) {
+        leaders.insert(leaders.end(), batch->leaders.begin(), batch->leaders.end());
+
+        foreach (ByteAddr address, batch->calledAddresses) {
+            program_->addCalledAddress(address);
+        }
+    }
+    program_->createBasicBlocks(std::move(leaders));
+
+    canceled_.poll();
+
+    /* Set the jump targets. */
+    foreach (const auto &batch, batches) {
+        foreach (const auto &target, batch->targets) {
+            if (target.isTable) {
+                auto table = std::make_unique<ir::JumpTable>();
+
+                foreach (ByteAddr address, target.addresses) {
+                    table->push_back(ir::JumpTableEntry(address, program_->getBasicBlockStartingAt(address)));
+                }
+                target.target->setTable(std::move(table));
+
+                ++resolvedJumpTables_;
+            } else {
+                assert(target.addresses.size() == 1);
+                target.target->setBasicBlock(program_->getBasicBlockStartingAt(target.addresses.front()));
+
+                if (!target.target->address()->is<ir::Constant>()) {
+                    ++resolvedJumps_;
+                }
+            }
+        }
+
+        resolvedCalls_ += batch->resolvedCalls;
+    }
+
+    log_.debug(tr("Resolved %1 indirect jumps, %2 jump tables, and %3 indirect calls.")
+        .arg(resolvedJumps_).arg(resolvedJumpTables_).arg(resolvedCalls_));
+}
+
+} // namespace irgen
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,103 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <QCoreApplication>
+
+#include <cstddef>
+
+#include <nc/common/CancellationToken.h>
+#include <nc/common/LogToken.h>
+
+namespace nc {
+namespace core {
+
+namespace arch {
+    class Instructions;
+}
+
+namespace image {
+    class Image;
+}
+
+namespace ir {
+    class Program;
+}
+
+namespace irgen {
+
+/**
+ * Computes the targets of jumps and calls in a freshly generated program
+ * and creates the basic blocks these targets point to.
+ *
+ * Targets are computed by a quick local dataflow analysis of each basic
+ * block. The basic blocks are analyzed in batches, in parallel if threads are
+ * enabled. Each batch reuses a single dataflow object for all its basic
+ * blocks and remembers which addresses were found to be valid instruction
+ * addresses. The program is modified only after all batches are done: the
+ * basic blocks at all the computed addresses are created at once, and then
+ * the jump targets are set.
+ */
+class JumpTargetResolver {
+    Q_DECLARE_TR_FUNCTIONS(JumpTargetResolver)
+
+    class Batch;
+    class UnresolvedTarget;
+
+    const image::Image *image_; ///< Executable image.
+    const arch::Instructions *instructions_; ///< Instructions.
+    ir::Program *program_; ///< Program.
+    const CancellationToken &canceled_; ///< Cancellation token.
+    const LogToken &log_; ///< Log token.
+
+    std::size_t resolvedJumps_; ///< Number of indirect jumps resolved to a single address.
+    std::size_t resolvedJumpTables_; ///< Number of indirect jumps resolved to jump tables.
+    std::size_t resolvedCalls_; ///< Number of indirect calls resolved to a single address or a table.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param[in] image Valid pointer to the executable image.
+     * \param[in] instructions Valid pointer to the set of instructions.
+     * \param[in,out] program Valid pointer to the program.
+     * \param[in] canceled Cancellation token.
+     * \param[in] log Log token.
+     */
+    JumpTargetResolver(const image::Image *image, const arch::Instructions *instructions, ir::Program *program,
+        const CancellationToken &canceled, const LogToken &log);
+
+    /**
+     * Destructor.
+     */
+    ~JumpTargetResolver();
+
+    /**
+     * Computes the jump targets in all the basic blocks of the program.
+     */
+    void resolve();
+
+    /**
+     * \return Number of indirect jumps resolved to a single address.
+     */
+    std::size_t resolvedJumps() const { return resolvedJumps_; }
+
+    /**
+     * \return Number of indirect jumps resolved to jump tables.
+     */
+    std::size_t resolvedJumpTables() const { return resolvedJumpTables_; }
+
+    /**
+     * \return Number of indirect calls resolved to a single address or a table of addresses.
+     */
+    std::size_t resolvedCalls() const { return resolvedCalls_; }
+};
+
+} // namespace irgen
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
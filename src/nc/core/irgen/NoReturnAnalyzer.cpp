@@ -0,0 +1,427 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "NoReturnAnalyzer.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include <nc/common/Foreach.h>
+#include <nc/common/Range.h>
+#include <nc/common/make_unique.h>
+
+#include <nc/core/arch/Instruction.h>
+#include <nc/core/image/Image.h>
+#include <nc/core/image/Symbol.h>
+#include <nc/core/ir/BasicBlock.h>
+#include <nc/core/ir/Jump.h>
+#include <nc/core/ir/Program.h>
+#include <nc/core/ir/Statements.h>
+#include <nc/core/ir/Terms.h>
+
+#include "CalleeSymbols.h"
+
+namespace nc {
+namespace core {
+namespace irgen {
+
+NoReturnAnalyzer::NoReturnAnalyzer(const image::Image *image, ir::Program *program, const CancellationToken &canceled):
+    image_(image), program_(program), canceled_(canceled),
+    cutBasicBlocks_(0), prunedBasicBlocks_(0), prunedInstructions_(0)
+{
+    assert(image != nullptr);
+    assert(program != nullptr);
+}
+
+bool NoReturnAnalyzer::isNoReturnName(const QString &name) {
+    /* Names without leading underscores and version suffixes. */
+    static const char *const noReturnNames[] = {
+        "abort",
+        "amsg_exit",
+        "assert_fail",
+        "assert_rtn",
+        "chk_fail",
+        "CxxThrowException",
+        "cxa_bad_cast",
+        "cxa_bad_typeid",
+        "cxa_pure_virtual",
+        "cxa_rethrow",
+        "cxa_throw",
+        "err",
+        "errx",
+        "exit",
+        "Exit",
+        "ExitProcess",
+        "ExitThread",
+        "FatalAppExitA",
+        "FatalAppExitW",
+        "FatalExit",
+        "fortify_fail",
+        "invalid_parameter_noinfo_noreturn",
+        "invoke_watson",
+        "longjmp",
+        "longjmp_chk",
+        "panic",
+        "pthread_exit",
+        "quick_exit",
+        "report_gsfailure",
+        "RtlExitUserProcess",
+        "RtlExitUserThread",
+        "siglongjmp",
+        "stack_chk_fail",
+        "stack_chk_fail_local",
+        "thrd_exit",
+        "Unwind_Resume",
+        "verr",
+        "verrx",
+        "ZSt9terminatev",
+    };
+
+    /* exit@plt, exit@@GLIBC_2.2.5, _ExitProcess@4 */
+    QString result = name.section('@', 0, 0);
+
+    int prefixLength = 0;
+    while (prefixLength < result.size() && (result[prefixLength] == '_' || result[prefixLength] == '.')) {
+        ++prefixLength;
+    }
+    result = result.mid(prefixLength);
+
+    if (result.isEmpty()) {
+        return false;
+    }
+
+    foreach (const char *noReturnName, noReturnNames) {
+        if (result == QLatin1String(noReturnName)) {
+            return true;
+        }
+    }
+
+    /* std::__throw_bad_alloc() and friends. */
+    return result.startsWith(QLatin1String("ZSt")) && result.contains(QLatin1String("__throw_"));
+}
+
+void NoReturnAnalyzer::analyze() {
+    noReturnAddresses_.clear();
+    noReturnByName_.clear();
+    dependents_.clear();
+
+    std::vector<ByteAddr> entries(program_->calledAddresses().begin(), program_->calledAddresses().end());
+    std::sort(entries.begin(), entries.end());
+
+    /* Optimistically assume that all the functions never return. */
+    std::vector<ByteAddr> queue;
+
+    foreach (ByteAddr entry, entries) {
+        if (isNoReturnName(getFunctionName(entry))) {
+            noReturnAddresses_.insert(entry);
+            noReturnByName_.insert(entry);
+        } else if (program_->getBasicBlockStartingAt(entry)) {
+            noReturnAddresses_.insert(entry);
+            queue.push_back(entry);
+        }
+    }
+
+    boost::unordered_set<ByteAddr> queued(queue.begin(), queue.end());
+
+    /* Exclude the functions which can return, until nothing changes. */
+    while (!queue.empty()) {
+        ByteAddr entry = queue.back();
+        queue.pop_back();
+        queued.erase(entry);
+
+        if (!nc::contains(noReturnAddresses_, entry)) {
+            continue;
+        }
+
+        std::vector<ByteAddr> dependencies;
+        if (mayReturn(entry, dependencies)) {
+            noReturnAddresses_.erase(entry);
+
+            auto i = dependents_.find(entry);
+            if (i != dependents_.end()) {
+                foreach (ByteAddr dependent, i->second) {
+                    if (queued.insert(dependent).second) {
+                        queue.push_back(dependent);
+                    }
+                }
+                dependents_.erase(i);
+            }
+        } else {
+            foreach (ByteAddr dependency, dependencies) {
+                dependents_[dependency].push_back(entry);
+            }
+        }
+
+        canceled_.poll();
+    }
+}
+
+void NoReturnAnalyzer::prune() {
+    cutBasicBlocks_ = 0;
+    prunedBasicBlocks_ = 0;
+    prunedInstructions_ = 0;
+
+    boost::unordered_set<const arch::Instruction *> prunedInstructions;
+
+    auto computeReachable = [&](const std::vector<const ir::BasicBlock *> &roots) {
+        boost::unordered_set<const ir::BasicBlock *> result(roots.begin(), roots.end());
+        std::vector<const ir::BasicBlock *> queue(roots);
+
+        while (!queue.empty()) {
+            const ir::BasicBlock *basicBlock = queue.back();
+            queue.pop_back();
+
+            foreach (const ir::BasicBlock *successor, getSuccessors(basicBlock)) {
+                if (result.insert(successor).second) {
+                    queue.push_back(successor);
+                }
+            }
+        }
+
+        return result;
+    };
+
+    /*
+     * Roots are function entries and basic blocks without predecessors:
+     * the ones the functions generator starts from.
+     */
+    boost::unordered_set<const ir::BasicBlock *> havePredecessors;
+    foreach (const ir::BasicBlock *basicBlock, program_->basicBlocks()) {
+        foreach (const ir::BasicBlock *successor, getSuccessors(basicBlock)) {
+            havePredecessors.insert(successor);
+        }
+    }
+
+    std::vector<const ir::BasicBlock *> roots;
+    foreach (const ir::BasicBlock *basicBlock, program_->basicBlocks()) {
+        if (!nc::contains(havePredecessors, basicBlock) ||
+            (basicBlock->address() && program_->isCalledAddress(*basicBlock->address()))) {
+            roots.push_back(basicBlock);
+        }
+    }
+
+    auto reachableBefore = computeReachable(roots);
+
+    /* Cut the basic blocks after no-return calls. */
+    foreach (ir::BasicBlock *basicBlock, program_->basicBlocks()) {
+        const ir::Call *noReturnCall = nullptr;
+
+        foreach (const ir::Statement *statement, basicBlock->statements()) {
+            if (auto call = statement->asCall()) {
+                if (isNoReturnCall(call, nullptr)) {
+                    noReturnCall = call;
+                    break;
+                }
+            }
+        }
+
+        if (!noReturnCall || basicBlock->statements().back()->is<ir::Halt>()) {
+            continue;
+        }
+
+        while (basicBlock->statements().back() != noReturnCall) {
+            auto statement = basicBlock->erase(basicBlock->statements().back());
+            if (statement->instruction() && statement->instruction() != noReturnCall->instruction()) {
+                prunedInstructions.insert(statement->instruction());
+            }
+        }
+
+        auto halt = std::make_unique<ir::Halt>();
+        halt->setInstruction(noReturnCall->instruction());
+        basicBlock->pushBack(std::move(halt));
+
+        if (basicBlock->address() && noReturnCall->instruction()) {
+            program_->setSuccessorAddress(basicBlock, noReturnCall->instruction()->endAddr());
+        }
+
+        ++cutBasicBlocks_;
+        canceled_.poll();
+    }
+
+    /*
+     * Remove the basic blocks which were reachable only through the cut off code.
+     * Basic blocks which were unreachable before stay, together with everything they lead to.
+     */
+    foreach (const ir::BasicBlock *basicBlock, program_->basicBlocks()) {
+        if (!nc::contains(reachableBefore, basicBlock)) {
+            roots.push_back(basicBlock);
+        }
+    }
+
+    auto reachableAfter = computeReachable(roots);
+
+    std::vector<ir::BasicBlock *> unreachable;
+    foreach (ir::BasicBlock *basicBlock, program_->basicBlocks()) {
+        if (!nc::contains(reachableAfter, basicBlock)) {
+            unreachable.push_back(basicBlock);
+        }
+    }
+
+    foreach (ir::BasicBlock *basicBlock, unreachable) {
+        foreach (const ir::Statement *statement, basicBlock->statements()) {
+            if (statement->instruction()) {
+                prunedInstructions.insert(statement->instruction());
+            }
+        }
+    }
+    program_->eraseBasicBlocks(unreachable);
+
+    prunedBasicBlocks_ = unreachable.size();
+    prunedInstructions_ = prunedInstructions.size();
+}
+
+bool NoReturnAnalyzer::isNoReturnCall(const ir::Call *call, std::vector<ByteAddr> *dependencies) const {
+    assert(call != nullptr);
+
+    if (auto address = evaluateAddress(call->target())) {
+        if (nc::contains(noReturnAddresses_, *address)) {
+            if (dependencies && !nc::contains(noReturnByName_, *address)) {
+                dependencies->push_back(*address);
+            }
+            return true;
+        }
+        if (program_->isCalledAddress(*address)) {
+            return false;
+        }
+    }
+
+    return isNoReturnName(getTargetName(call->target()));
+}
+
+bool NoReturnAnalyzer::mayReturn(ByteAddr entry, std::vector<ByteAddr> &dependencies) const {
+    const ir::BasicBlock *entryBasicBlock = program_->getBasicBlockStartingAt(entry);
+    if (!entryBasicBlock) {
+        return true;
+    }
+
+    boost::unordered_set<const ir::BasicBlock *> visited;
+    std::vector<const ir::BasicBlock *> queue;
+
+    visited.insert(entryBasicBlock);
+    queue.push_back(entryBasicBlock);
+
+    /* Returns true if going to the basic block means returning from the function. */
+    auto visit = [&](const ir::BasicBlock *basicBlock) -> bool {
+        if (basicBlock != entryBasicBlock && basicBlock->address() && program_->isCalledAddress(*basicBlock->address())) {
+            /* A tail call. */
+            if (!nc::contains(noReturnAddresses_, *basicBlock->address())) {
+                return true;
+            }
+            if (!nc::contains(noReturnByName_, *basicBlock->address())) {
+                dependencies.push_back(*basicBlock->address());
+            }
+        } else if (visited.insert(basicBlock).second) {
+            queue.push_back(basicBlock);
+        }
+        return false;
+    };
+
+    while (!queue.empty()) {
+        const ir::BasicBlock *basicBlock = queue.back();
+        queue.pop_back();
+
+        bool cut = false;
+        foreach (const ir::Statement *statement, basicBlock->statements()) {
+            if (auto call = statement->asCall()) {
+                if (isNoReturnCall(call, &dependencies)) {
+                    cut = true;
+                    break;
+                }
+            }
+        }
+        if (cut) {
+            continue;
+        }
+
+        if (auto jump = basicBlock->getJump()) {
+            const ir::JumpTarget *targets[] = {&jump->thenTarget(), &jump->elseTarget()};
+
+            foreach (const ir::JumpTarget *target, targets) {
+                if (target->basicBlock()) {
+                    if (visit(target->basicBlock())) {
+                        return true;
+                    }
+                } else if (target->table()) {
+                    foreach (const auto &tableEntry, *target->table()) {
+                        if (!tableEntry.basicBlock() || visit(tableEntry.basicBlock())) {
+                            return true;
+                        }
+                    }
+                } else if (target->address()) {
+                    /* A return, an unresolved jump, or a jump through an import table. */
+                    if (!isNoReturnName(getTargetName(target->address()))) {
+                        return true;
+                    }
+                }
+            }
+        } else if (!basicBlock->statements().empty() && basicBlock->statements().back()->is<ir::Halt>()) {
+            continue;
+        } else {
+            auto successors = getSuccessors(basicBlock);
+            if (successors.empty()) {
+                return true;
+            }
+            foreach (auto successor, successors) {
+                if (visit(successor)) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+QString NoReturnAnalyzer::getFunctionName(ByteAddr address) const {
+    auto symbol = getFunctionSymbol(*image_, *program_, address);
+    return symbol ? symbol->name() : QString();
+}
+
+QString NoReturnAnalyzer::getTargetName(const ir::Term *target) const {
+    assert(target != nullptr);
+
+    if (auto address = evaluateAddress(target)) {
+        return getFunctionName(*address);
+    } else if (auto symbol = getImportSymbol(*image_, target)) {
+        return symbol->name();
+    }
+    return QString();
+}
+
+std::vector<const ir::BasicBlock *> NoReturnAnalyzer::getSuccessors(const ir::BasicBlock *basicBlock) const {
+    assert(basicBlock != nullptr);
+
+    std::vector<const ir::BasicBlock *> result;
+
+    if (auto jump = basicBlock->getJump()) {
+        auto addTarget = [&](const ir::JumpTarget &target) {
+            if (target.basicBlock()) {
+                result.push_back(target.basicBlock());
+            } else if (target.table()) {
+                foreach (const auto &entry, *target.table()) {
+                    if (entry.basicBlock()) {
+                        result.push_back(entry.basicBlock());
+                    }
+                }
+            }
+        };
+
+        addTarget(jump->thenTarget());
+        addTarget(jump->elseTarget());
+    } else if (basicBlock->statements().empty() || !basicBlock->statements().back()->is<ir::Halt>()) {
+        /* Jumps to direct successors are not there yet. */
+        if (basicBlock->successorAddress() && basicBlock->successorAddress() != basicBlock->address()) {
+            if (auto successor = program_->getBasicBlockStartingAt(*basicBlock->successorAddress())) {
+                result.push_back(successor);
+            }
+        }
+    }
+
+    return result;
+}
+
+} // namespace irgen
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
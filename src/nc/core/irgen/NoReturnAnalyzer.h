@@ -0,0 +1,168 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <QString>
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+#include <nc/common/CancellationToken.h>
+#include <nc/common/Types.h>
+
+namespace nc {
+namespace core {
+
+namespace image {
+    class Image;
+}
+
+namespace ir {
+    class BasicBlock;
+    class Call;
+    class Program;
+    class Term;
+}
+
+namespace irgen {
+
+/**
+ * Finds functions that never return and cuts the basic blocks after calls to them.
+ *
+ * Without this, the bytes following a call to exit() or abort() are decoded
+ * as if the call returned, and become part of the calling function.
+ *
+ * Functions imported or defined under well-known names (exit, abort,
+ * __stack_chk_fail, etc.) are no-return by definition. Any other called
+ * function is no-return if none of the paths from its entry leaves the
+ * function otherwise than through a call or a tail jump to a no-return
+ * function. This is computed as the greatest fixpoint: all the functions
+ * are assumed to be no-return at first, and the ones found to return
+ * lead to rechecking their callers.
+ *
+ * The analysis must run before jumps to direct successors are added.
+ * Calls are recognized when their targets are constant addresses, possibly
+ * loaded from an import table, without any dataflow analysis.
+ */
+class NoReturnAnalyzer {
+    const image::Image *image_; ///< Executable image.
+    ir::Program *program_; ///< Program.
+    const CancellationToken &canceled_; ///< Cancellation token.
+
+    /** Entries of functions known to be no-return, by address. */
+    boost::unordered_set<ByteAddr> noReturnAddresses_;
+
+    /** Entries of functions being no-return by their names. */
+    boost::unordered_set<ByteAddr> noReturnByName_;
+
+    /** Mapping from a function entry to the entries of functions whose no-return status depends on it. */
+    boost::unordered_map<ByteAddr, std::vector<ByteAddr>> dependents_;
+
+    std::size_t cutBasicBlocks_; ///< Number of basic blocks cut after a no-return call.
+    std::size_t prunedBasicBlocks_; ///< Number of removed basic blocks.
+    std::size_t prunedInstructions_; ///< Number of instructions whose statements were removed.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param[in] image Valid pointer to the executable image.
+     * \param[in,out] program Valid pointer to the program.
+     * \param[in] canceled Cancellation token.
+     */
+    NoReturnAnalyzer(const image::Image *image, ir::Program *program, const CancellationToken &canceled);
+
+    /**
+     * Computes the set of no-return functions.
+     */
+    void analyze();
+
+    /**
+     * Removes the statements following calls to no-return functions,
+     * terminating the basic blocks with halts, and removes the basic blocks
+     * which can no longer be reached.
+     */
+    void prune();
+
+    /**
+     * \return Entries of functions which never return.
+     */
+    const boost::unordered_set<ByteAddr> &noReturnAddresses() const { return noReturnAddresses_; }
+
+    /**
+     * \return Number of basic blocks cut by prune() after a no-return call.
+     */
+    std::size_t cutBasicBlocks() const { return cutBasicBlocks_; }
+
+    /**
+     * \return Number of basic blocks removed by prune().
+     */
+    std::size_t prunedBasicBlocks() const { return prunedBasicBlocks_; }
+
+    /**
+     * \return Number of instructions whose statements were removed by prune().
+     */
+    std::size_t prunedInstructions() const { return prunedInstructions_; }
+
+    /**
+     * \param name Name of a symbol.
+     *
+     * \return True if it is a name of a well-known function never returning.
+     */
+    static bool isNoReturnName(const QString &name);
+
+private:
+    /**
+     * \param call Valid pointer to a call statement.
+     * \param dependencies If not nullptr, the address of the callee is added here
+     *                     when the callee is no-return, but this may change later.
+     *
+     * \return True if the call never returns.
+     */
+    bool isNoReturnCall(const ir::Call *call, std::vector<ByteAddr> *dependencies) const;
+
+    /**
+     * \param entry Address of a function's entry.
+     * \param[out] dependencies Entries of functions whose no-return status the result depends on.
+     *
+     * \return True if the function can return, given the current set of no-return functions.
+     */
+    bool mayReturn(ByteAddr entry, std::vector<ByteAddr> &dependencies) const;
+
+    /**
+     * \param address Address of a function's entry.
+     *
+     * \return Name of the function: the name of the symbol at this address or,
+     *         if the function is a thunk jumping to an imported function, the name
+     *         of the imported function. Empty string if unknown.
+     */
+    QString getFunctionName(ByteAddr address) const;
+
+    /**
+     * \param target Valid pointer to the term giving the target address of a call or a jump.
+     *
+     * \return Name of the function the target refers to, by its address or by the import
+     *         table entry it is loaded from. Empty string if unknown.
+     */
+    QString getTargetName(const ir::Term *target) const;
+
+    /**
+     * \param basicBlock Valid pointer to a basic block.
+     *
+     * \return Known successors of the basic block: targets of its jump or its direct successor.
+     */
+    std::vector<const ir::BasicBlock *> getSuccessors(const ir::BasicBlock *basicBlock) const;
+};
+
+} // namespace irgen
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
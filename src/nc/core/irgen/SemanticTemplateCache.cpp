@@ -0,0 +1,96 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "SemanticTemplateCache.h"
+
+#include <cassert>
+
+#include <nc/common/Foreach.h>
+#include <nc/common/make_unique.h>
+
+#include <nc/core/ir/BasicBlock.h>
+#include <nc/core/ir/Jump.h>
+#include <nc/core/ir/Statements.h>
+
+namespace nc {
+namespace core {
+namespace irgen {
+
+/**
+ * Statements generated for the first instance of an instruction.
+ */
+class SemanticTemplateCache::Template {
+public:
+    std::vector<std::unique_ptr<ir::Statement>> statements; ///< Statements without an instruction set.
+};
+
+SemanticTemplateCache::SemanticTemplateCache(): enabled_(true), hits_(0), misses_(0) {}
+
+SemanticTemplateCache::~SemanticTemplateCache() {}
+
+bool SemanticTemplateCache::instantiate(const std::string &key, const arch::Instruction *instruction,
+                                        ir::BasicBlock *basicBlock)
+{
+    assert(instruction != nullptr);
+    assert(basicBlock != nullptr);
+
+    if (!enabled_) {
+        ++misses_;
+        return false;
+    }
+
+    auto i = templates_.find(key);
+    if (i == templates_.end() || !i->second) {
+        ++misses_;
+        return false;
+    }
+
+    foreach (const auto &statement, i->second->statements) {
+        basicBlock->pushBack(statement->clone(instruction));
+    }
+
+    ++hits_;
+    return true;
+}
+
+void SemanticTemplateCache::add(const std::string &key, const ir::BasicBlock *basicBlock, const ir::Statement *after) {
+    assert(basicBlock != nullptr);
+
+    if (!enabled_ || templates_.find(key) != templates_.end()) {
+        return;
+    }
+
+    auto result = std::make_unique<Template>();
+
+    bool started = after == nullptr;
+    foreach (const ir::Statement *statement, basicBlock->statements()) {
+        if (started) {
+            if (statement->is<ir::Jump>() || statement->is<ir::Call>()) {
+                result.reset();
+                break;
+            }
+            result->statements.push_back(statement->clone(nullptr));
+        } else if (statement == after) {
+            started = true;
+        }
+    }
+
+    /* If the statements could not be found, the key must not get an empty template. */
+    if (!started) {
+        result.reset();
+    }
+
+    templates_[key] = std::move(result);
+}
+
+void SemanticTemplateCache::reject(const std::string &key) {
+    if (enabled_) {
+        templates_[key].reset();
+    }
+}
+
+} // namespace irgen
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
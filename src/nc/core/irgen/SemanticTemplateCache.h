@@ -0,0 +1,125 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
+namespace nc {
+namespace core {
+
+namespace arch {
+    class Instruction;
+}
+
+namespace ir {
+    class BasicBlock;
+    class Statement;
+}
+
+namespace irgen {
+
+/**
+ * Cache of statements generated for instructions.
+ *
+ * Programs contain many instances of the same instruction: the same opcode
+ * with the same operands at different addresses. An instruction analyzer can
+ * remember the statements generated for the first instance of such an
+ * instruction as a template and create the statements for the other
+ * instances by cloning the template, without decoding the instruction and
+ * building the statements from expressions again.
+ *
+ * The key must identify the semantics of the instruction completely,
+ * except for the instruction's address. Statements depending on the address
+ * of the instruction must not be added to the cache. Jumps and calls are
+ * never cached, as they refer to basic blocks and addresses.
+ */
+class SemanticTemplateCache {
+    class Template;
+
+    /** Templates indexed by key. nullptr means that the statements cannot be cached. */
+    boost::unordered_map<std::string, std::unique_ptr<Template>> templates_;
+
+    bool enabled_; ///< Whether the cache is used.
+    std::size_t hits_; ///< Number of instructions instantiated from templates.
+    std::size_t misses_; ///< Number of instructions not found in the cache.
+
+public:
+    /**
+     * Constructor.
+     */
+    SemanticTemplateCache();
+
+    /**
+     * Destructor.
+     */
+    ~SemanticTemplateCache();
+
+    /**
+     * \return True if the cache is used, false if all statements are generated from scratch.
+     */
+    bool enabled() const { return enabled_; }
+
+    /**
+     * Turns the cache on or off. The cache is on by default.
+     *
+     * \param enabled Whether the cache must be used.
+     */
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+
+    /**
+     * Creates statements for an instruction from the template with the given key,
+     * if there is one, and adds them to the end of the basic block.
+     *
+     * \param key Key of the instruction.
+     * \param instruction Valid pointer to the instruction.
+     * \param basicBlock Valid pointer to the basic block to add the statements to.
+     *
+     * \return True if the statements were created, false if there is no template with the given key
+     *         or the cache is off.
+     */
+    bool instantiate(const std::string &key, const arch::Instruction *instruction, ir::BasicBlock *basicBlock);
+
+    /**
+     * Remembers the statements generated for an instruction as a template.
+     * Does nothing if the key already has a template or has been rejected, or if the cache is off.
+     * Rejects the key if the statements contain a jump or a call, or if
+     * the basic block does not contain the given after statement.
+     *
+     * \param key Key of the instruction.
+     * \param basicBlock Valid pointer to the basic block containing the generated statements.
+     * \param after Pointer to the statement of the basic block after which the generated
+     *              statements start, or nullptr if they start at the beginning of the basic block.
+     */
+    void add(const std::string &key, const ir::BasicBlock *basicBlock, const ir::Statement *after);
+
+    /**
+     * Marks the key as one whose statements must always be generated from scratch.
+     *
+     * \param key Key of the instruction.
+     */
+    void reject(const std::string &key);
+
+    /**
+     * \return Number of instructions whose statements were created from templates.
+     */
+    std::size_t hits() const { return hits_; }
+
+    /**
+     * \return Number of instructions whose statements were not found in the cache.
+     */
+    std::size_t misses() const { return misses_; }
+};
+
+} // namespace irgen
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,201 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "Slicer.h"
+
+#include <nc/common/Foreach.h>
+
+#include <nc/core/arch/Architecture.h>
+#include <nc/core/arch/Disassembler.h>
+#include <nc/core/arch/Instructions.h>
+#include <nc/core/image/Image.h>
+#include <nc/core/image/Section.h>
+#include <nc/core/ir/Jump.h>
+#include <nc/core/ir/Program.h>
+#include <nc/core/ir/Statements.h>
+#include <nc/core/ir/Terms.h>
+
+#include "IRGenerator.h"
+#include "InstructionAnalyzer.h"
+#include "InvalidInstructionException.h"
+
+namespace nc {
+namespace core {
+namespace irgen {
+
+namespace {
+
+/**
+ * Appends the addresses of all basic blocks a jump target can refer to.
+ *
+ * \param[in] target Jump target.
+ * \param[out] addresses Vector to append the addresses to.
+ */
+void getTargetAddresses(const ir::JumpTarget &target, std::vector<ByteAddr> &addresses) {
+    if (target.basicBlock()) {
+        if (target.basicBlock()->address()) {
+            addresses.push_back(*target.basicBlock()->address());
+        }
+    } else if (target.address()) {
+        if (auto constant = target.address()->asConstant()) {
+            addresses.push_back(constant->value().value());
+        }
+    }
+    if (target.table()) {
+        foreach (const auto &entry, *target.table()) {
+            addresses.push_back(entry.address());
+        }
+    }
+}
+
+} // anonymous namespace
+
+Slicer::Slicer(const image::Image *image, const CancellationToken &canceled, const LogToken &log):
+    image_(image), canceled_(canceled), log_(log),
+    disassembler_(image->platform().architecture()->createDisassembler()),
+    instructionAnalyzer_(image->platform().architecture()->createInstructionAnalyzer())
+{
+    assert(image);
+}
+
+Slicer::~Slicer() {}
+
+void Slicer::slice(const std::vector<ByteAddr> &entries, int depth, arch::Instructions &instructions) {
+    boost::unordered_set<ByteAddr> sliced;
+    std::vector<ByteAddr> level = entries;
+
+    for (int currentDepth = 0; !level.empty(); ++currentDepth) {
+        std::vector<ByteAddr> callees;
+
+        foreach (ByteAddr entry, level) {
+            if (sliced.insert(entry).second) {
+                log_.debug(tr("Slicing function at address 0x%1.").arg(entry, 0, 16));
+                sliceFunction(entry, instructions, callees);
+                canceled_.poll();
+            }
+        }
+
+        if (currentDepth >= depth) {
+            break;
+        }
+
+        level.swap(callees);
+    }
+
+    log_.info(tr("Sliced %1 functions, %2 instructions in total.").arg(sliced.size()).arg(instructions.size()));
+}
+
+void Slicer::sliceFunction(ByteAddr entry, arch::Instructions &instructions, std::vector<ByteAddr> &callees) {
+    arch::Instructions functionInstructions;
+    boost::unordered_set<ByteAddr> visited;
+    std::vector<ByteAddr> targets(1, entry);
+
+    while (!targets.empty()) {
+        /* Follow direct jumps. */
+        while (!targets.empty()) {
+            ByteAddr address = targets.back();
+            targets.pop_back();
+
+            sliceSequence(address, instructions, visited, functionInstructions, targets, callees);
+        }
+
+        /*
+         * Resolve indirect jumps and calls. The IR generator does a quick
+         * dataflow analysis of each basic block for that, which direct
+         * inspection of single instructions cannot do.
+         */
+        ir::Program program;
+        IRGenerator(image_, &functionInstructions, &program, canceled_, log_).generate();
+
+        foreach (const ir::BasicBlock *basicBlock, program.basicBlocks()) {
+            if (auto jump = basicBlock->getJump()) {
+                std::vector<ByteAddr> addresses;
+                getTargetAddresses(jump->thenTarget(), addresses);
+                getTargetAddresses(jump->elseTarget(), addresses);
+
+                foreach (ByteAddr address, addresses) {
+                    if (!visited.count(address)) {
+                        targets.push_back(address);
+                    }
+                }
+            }
+        }
+
+        callees.insert(callees.end(), program.calledAddresses().begin(), program.calledAddresses().end());
+    }
+
+    foreach (const auto &instruction, functionInstructions.all()) {
+        instructions.add(instruction);
+    }
+}
+
+void Slicer::sliceSequence(ByteAddr address, const arch::Instructions &instructions,
+    boost::unordered_set<ByteAddr> &visited, arch::Instructions &functionInstructions,
+    std::vector<ByteAddr> &targets, std::vector<ByteAddr> &callees)
+{
+    while (visited.insert(address).second) {
+        auto instruction = getInstruction(address, instructions);
+        if (!instruction) {
+            break;
+        }
+
+        functionInstructions.add(instruction);
+
+        if (!analyzeInstruction(instruction.get(), targets, callees)) {
+            break;
+        }
+
+        address = instruction->endAddr();
+    }
+}
+
+bool Slicer::analyzeInstruction(const arch::Instruction *instruction, std::vector<ByteAddr> &targets, std::vector<ByteAddr> &callees) {
+    ir::Program program;
+
+    try {
+        instructionAnalyzer_->createStatements(instruction, &program);
+    } catch (const InvalidInstructionException &e) {
+        log_.warning(e.unicodeWhat());
+        return false;
+    }
+
+    foreach (const ir::BasicBlock *basicBlock, program.basicBlocks()) {
+        foreach (const ir::Statement *statement, basicBlock->statements()) {
+            if (auto jump = statement->asJump()) {
+                getTargetAddresses(jump->thenTarget(), targets);
+                getTargetAddresses(jump->elseTarget(), targets);
+            } else if (auto call = statement->asCall()) {
+                if (auto constant = call->target()->asConstant()) {
+                    callees.push_back(constant->value().value());
+                }
+            }
+        }
+    }
+
+    /*
+     * The execution falls through to the next instruction unless the basic
+     * block of the instruction ends with a terminator. In the latter case,
+     * the next instruction, if reachable, is among the jump targets.
+     */
+    auto basicBlock = program.getBasicBlockCovering(instruction->addr());
+    return !basicBlock || basicBlock->statements().empty() || !basicBlock->statements().back()->isTerminator();
+}
+
+std::shared_ptr<const arch::Instruction> Slicer::getInstruction(ByteAddr address, const arch::Instructions &instructions) {
+    if (auto instruction = instructions.get(address)) {
+        return instruction;
+    }
+
+    auto section = image_->getSectionContainingAddress(address);
+    if (!section || !section->isExecutable()) {
+        return nullptr;
+    }
+
+    return disassembler_->disassembleSingleInstruction(address, section);
+}
+
+} // namespace irgen
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
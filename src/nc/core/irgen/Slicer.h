@@ -0,0 +1,133 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <memory>
+#include <vector>
+
+#include <QCoreApplication>
+
+#include <boost/unordered_set.hpp>
+
+#include <nc/common/CancellationToken.h>
+#include <nc/common/LogToken.h>
+#include <nc/common/Types.h>
+
+namespace nc {
+namespace core {
+
+namespace image {
+    class Image;
+}
+
+namespace ir {
+    class JumpTarget;
+}
+
+namespace arch {
+    class Disassembler;
+    class Instruction;
+    class Instructions;
+}
+
+namespace irgen {
+
+class InstructionAnalyzer;
+
+/**
+ * Recursive-traversal disassembler collecting the instructions of a set of
+ * functions and of their callees up to a given call depth.
+ *
+ * Unlike the linear sweep over code sections, the amount of work done by this
+ * class is proportional to the size of the slice, not to the size of the image.
+ */
+class Slicer {
+    Q_DECLARE_TR_FUNCTIONS(Slicer)
+
+    const image::Image *image_; ///< Executable image.
+    const CancellationToken &canceled_; ///< Cancellation token.
+    const LogToken &log_; ///< Log token.
+    std::unique_ptr<arch::Disassembler> disassembler_; ///< Disassembler.
+    std::unique_ptr<InstructionAnalyzer> instructionAnalyzer_; ///< Instruction analyzer.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param[in] image Valid pointer to the executable image.
+     * \param[in] canceled Cancellation token.
+     * \param[in] log Log token.
+     */
+    Slicer(const image::Image *image, const CancellationToken &canceled, const LogToken &log);
+
+    /**
+     * Destructor.
+     */
+    ~Slicer();
+
+    /**
+     * Disassembles the functions starting at given addresses and the functions
+     * called from them, transitively, up to the given call depth.
+     *
+     * \param[in] entries Entry addresses of the functions.
+     * \param[in] depth Maximal call depth: 0 means only the given functions,
+     *                  1 means the given functions and their direct callees, etc.
+     * \param[in,out] instructions Set of instructions to add the disassembled instructions to.
+     *                             Instructions already present in the set are reused.
+     */
+    void slice(const std::vector<ByteAddr> &entries, int depth, arch::Instructions &instructions);
+
+private:
+    /**
+     * Disassembles all instructions reachable from the function's entry
+     * without following calls.
+     *
+     * \param[in] entry Entry address of the function.
+     * \param[in,out] instructions Set of instructions to add the function's instructions to.
+     * \param[out] callees Vector to append the addresses of called functions to.
+     */
+    void sliceFunction(ByteAddr entry, arch::Instructions &instructions, std::vector<ByteAddr> &callees);
+
+    /**
+     * Disassembles a straight-line sequence of instructions starting at the given address.
+     *
+     * \param[in] address Start address of the sequence.
+     * \param[in] instructions Set of instructions to look for already disassembled instructions.
+     * \param[in,out] visited Addresses visited so far.
+     * \param[in,out] functionInstructions Set of instructions to add the disassembled instructions to.
+     * \param[out] targets Vector to append the addresses of jump targets to.
+     * \param[out] callees Vector to append the addresses of called functions to.
+     */
+    void sliceSequence(ByteAddr address, const arch::Instructions &instructions,
+        boost::unordered_set<ByteAddr> &visited, arch::Instructions &functionInstructions,
+        std::vector<ByteAddr> &targets, std::vector<ByteAddr> &callees);
+
+    /**
+     * Generates the intermediate representation of a single instruction
+     * and collects the addresses to which this instruction can transfer control.
+     *
+     * \param[in] instruction Valid pointer to the instruction.
+     * \param[out] targets Vector to append the addresses of jump targets to.
+     * \param[out] callees Vector to append the addresses of called functions to.
+     *
+     * \return True if the execution can fall through to the next instruction, false otherwise.
+     */
+    bool analyzeInstruction(const arch::Instruction *instruction, std::vector<ByteAddr> &targets, std::vector<ByteAddr> &callees);
+
+    /**
+     * \param[in] address A virtual address.
+     * \param[in] instructions Set of already disassembled instructions.
+     *
+     * \return Pointer to the instruction at the given address. Can be nullptr.
+     */
+    std::shared_ptr<const arch::Instruction> getInstruction(ByteAddr address, const arch::Instructions &instructions);
+};
+
+} // namespace irgen
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -53,6 +53,7 @@ public:
         MEMBER_DECLARATION,             ///< Declaration of a struct or union member.
         STRUCT_TYPE_DECLARATION,        ///< Declaration of structural type.
         VARIABLE_DECLARATION,           ///< Variable declaration.
+        VERBATIM_DECLARATION,           ///< Declaration given by its source text.
     };
 
     /**
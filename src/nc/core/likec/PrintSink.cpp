@@ -0,0 +1,51 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "PrintSink.h"
+
+#include <QTextStream>
+
+#include "Declaration.h"
+#include "Type.h"
+
+namespace nc {
+namespace core {
+namespace likec {
+
+void TextStreamPrintSink::write(char character) {
+    out_ << character;
+}
+
+void TextStreamPrintSink::write(const char *latin1, std::size_t size) {
+    out_ << QString::fromLatin1(latin1, static_cast<int>(size));
+}
+
+void TextStreamPrintSink::write(const QString &text) {
+    out_ << text;
+}
+
+void TextStreamPrintSink::writeIdentifier(const Declaration *declaration) {
+    out_ << declaration->identifier();
+}
+
+void TextStreamPrintSink::writeType(const Type *type) {
+    out_ << *type;
+}
+
+void TextStreamPrintSink::writeIndent(int indent) {
+    out_ << QString(indent, QLatin1Char(' '));
+}
+
+void TextStreamPrintSink::writeDecimal(SignedConstantValue value) {
+    out_ << value;
+}
+
+void TextStreamPrintSink::writeHex(ConstantValue value) {
+    out_ << hex << value << dec;
+}
+
+} // namespace likec
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,154 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+#include <cstring>
+
+#include <QLatin1String>
+#include <QString>
+
+#include <nc/common/Types.h>
+
+QT_BEGIN_NAMESPACE
+class QTextStream;
+QT_END_NAMESPACE
+
+namespace nc {
+namespace core {
+namespace likec {
+
+class Declaration;
+class Type;
+
+/**
+ * Destination of the text produced by TreePrinter.
+ */
+class PrintSink {
+public:
+    /**
+     * Virtual destructor.
+     */
+    virtual ~PrintSink() {}
+
+    /**
+     * Writes a character.
+     *
+     * \param character Latin-1 character.
+     */
+    virtual void write(char character) = 0;
+
+    /**
+     * Writes a Latin-1 string.
+     *
+     * \param latin1 Pointer to the characters.
+     * \param size Number of characters.
+     */
+    virtual void write(const char *latin1, std::size_t size) = 0;
+
+    /**
+     * Writes a string.
+     *
+     * \param text String.
+     */
+    virtual void write(const QString &text) = 0;
+
+    /**
+     * Writes the identifier of a declaration. The declaration must stay
+     * alive and keep its identifier while the sink is in use, so that
+     * the sink can cache the encoded identifier.
+     *
+     * \param declaration Valid pointer to the declaration.
+     */
+    virtual void writeIdentifier(const Declaration *declaration) = 0;
+
+    /**
+     * Writes a type. The same rules as for writeIdentifier() apply.
+     *
+     * \param type Valid pointer to the type.
+     */
+    virtual void writeType(const Type *type) = 0;
+
+    /**
+     * Writes the given number of spaces.
+     *
+     * \param indent Number of spaces.
+     */
+    virtual void writeIndent(int indent) = 0;
+
+    /**
+     * Writes an integer in decimal notation.
+     *
+     * \param value Value.
+     */
+    virtual void writeDecimal(SignedConstantValue value) = 0;
+
+    /**
+     * Writes an integer in hexadecimal notation, without a prefix.
+     *
+     * \param value Value.
+     */
+    virtual void writeHex(ConstantValue value) = 0;
+
+    PrintSink &operator<<(char character) { write(character); return *this; }
+    PrintSink &operator<<(QLatin1String text) { write(text.latin1(), std::strlen(text.latin1())); return *this; }
+    PrintSink &operator<<(const QString &text) { write(text); return *this; }
+    PrintSink &operator<<(const Type &type) { writeType(&type); return *this; }
+
+    template<std::size_t N>
+    PrintSink &operator<<(const char (&text)[N]) {
+        write(text, N - 1);
+        return *this;
+    }
+
+private:
+    /*
+     * Integers would be converted to char and written as characters.
+     * Use writeDecimal() or writeHex() instead. The overloads are
+     * declared, but not defined, to catch such calls at compile time.
+     */
+    PrintSink &operator<<(bool);
+    PrintSink &operator<<(signed char);
+    PrintSink &operator<<(unsigned char);
+    PrintSink &operator<<(short);
+    PrintSink &operator<<(unsigned short);
+    PrintSink &operator<<(int);
+    PrintSink &operator<<(unsigned int);
+    PrintSink &operator<<(long);
+    PrintSink &operator<<(unsigned long);
+    PrintSink &operator<<(long long);
+    PrintSink &operator<<(unsigned long long);
+};
+
+/**
+ * Sink writing into a QTextStream.
+ */
+class TextStreamPrintSink: public PrintSink {
+    QTextStream &out_; ///< Output stream.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param out Output stream.
+     */
+    explicit TextStreamPrintSink(QTextStream &out): out_(out) {}
+
+    void write(char character) override;
+    void write(const char *latin1, std::size_t size) override;
+    void write(const QString &text) override;
+    void writeIdentifier(const Declaration *declaration) override;
+    void writeType(const Type *type) override;
+    void writeIndent(int indent) override;
+    void writeDecimal(SignedConstantValue value) override;
+    void writeHex(ConstantValue value) override;
+};
+
+} // namespace likec
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -73,6 +73,8 @@ std::unique_ptr<Declaration> Simplifier::simplify(std::unique_ptr<Declaration> n
             return node;
         case Declaration::VARIABLE_DECLARATION:
             return simplify(as<VariableDeclaration>(std::move(node)));
+        case Declaration::VERBATIM_DECLARATION:
+            return node;
     }
     unreachable();
 }
@@ -189,35 +191,36 @@ std::unique_ptr<Expression> Simplifier::simplify(std::unique_ptr<BinaryOperator>
      * rdi2 = (int32_t*)((int64_t)rdi2 + 4); -> rdi2 = (int32_t*)(int64_t)(rdi2 + 1);
      */
 
-    auto rewritePointerArithmetic = [&](Expression *left, Expression *right) -> std::unique_ptr<BinaryOperator> {
+    auto rewritePointerArithmetic = [&](Expression *left, Expression *right) -> bool {
         if (auto typecast = left->as<Typecast>()) {
             if (typecast->type()->isInteger() &&
                 typecast->type()->size() == typeCalculator_.getType(typecast->operand().get())->size()) {
                 if (auto pointerType = typeCalculator_.getType(typecast->operand().get())->as<PointerType>()) {
                     if (pointerType->pointeeType()->size() != 0 && pointerType->pointeeType()->size() % CHAR_BIT == 0) {
                         if (auto quotient = divide(right, pointerType->pointeeType()->size() / CHAR_BIT)) {
-                            return std::make_unique<BinaryOperator>(
-                                node->operatorKind(), std::move(typecast->operand()), std::move(quotient));
+                            /* The operator keeps its kind, so reuse it. */
+                            auto pointer = std::move(typecast->operand());
+                            node->left() = std::move(pointer);
+                            node->right() = std::move(quotient);
+                            return true;
                         }
                     }
                 }
             }
         }
-        return nullptr;
+        return false;
     };
 
     switch (node->operatorKind()) {
         case BinaryOperator::ADD:
-            if (auto result = rewritePointerArithmetic(node->left().get(), node->right().get())) {
-                return simplify(std::move(result));
-            }
-            if (auto result = rewritePointerArithmetic(node->right().get(), node->left().get())) {
-                return simplify(std::move(result));
+            if (rewritePointerArithmetic(node->left().get(), node->right().get()) ||
+                rewritePointerArithmetic(node->right().get(), node->left().get())) {
+                return simplify(std::move(node));
             }
             break;
         case BinaryOperator::SUB:
-            if (auto result = rewritePointerArithmetic(node->left().get(), node->right().get())) {
-                return simplify(std::move(result));
+            if (rewritePointerArithmetic(node->left().get(), node->right().get())) {
+                return simplify(std::move(node));
             }
             break;
         default:
@@ -231,35 +234,34 @@ std::unique_ptr<Expression> Simplifier::simplify(std::unique_ptr<BinaryOperator>
         case BinaryOperator::ADD: {
             if (isZero(node->left().get())) {
                 auto type = typeCalculator_.getType(node.get());
-                return simplify(std::make_unique<Typecast>(Typecast::STATIC_CAST, type, std::move(node->right())));
+                return convert(type, std::move(node->right()));
             }
             if (isZero(node->right().get())) {
                 auto type = typeCalculator_.getType(node.get());
-                return simplify(std::make_unique<Typecast>(Typecast::STATIC_CAST, type, std::move(node->left())));
+                return convert(type, std::move(node->left()));
             }
             break;
         }
         case BinaryOperator::SUB: {
             if (isZero(node->right().get())) {
                 auto type = typeCalculator_.getType(node.get());
-                return simplify(std::make_unique<Typecast>(Typecast::STATIC_CAST, type, std::move(node->left())));
+                return convert(type, std::move(node->left()));
             }
             if (isZero(node->left().get())) {
                 auto type = typeCalculator_.getType(node.get());
                 return simplify(std::make_unique<UnaryOperator>(
-                    UnaryOperator::NEGATION,
-                    std::make_unique<Typecast>(Typecast::STATIC_CAST, type, std::move(node->right()))));
+                    UnaryOperator::NEGATION, convert(type, std::move(node->right()))));
             }
             break;
         }
         case BinaryOperator::MUL: {
             if (isOne(node->left().get())) {
                 auto type = typeCalculator_.getType(node.get());
-                return simplify(std::make_unique<Typecast>(Typecast::STATIC_CAST, type, std::move(node->right())));
+                return convert(type, std::move(node->right()));
             }
             if (isOne(node->right().get())) {
                 auto type = typeCalculator_.getType(node.get());
-                return simplify(std::make_unique<Typecast>(Typecast::STATIC_CAST, type, std::move(node->left())));
+                return convert(type, std::move(node->left()));
             }
             break;
         }
@@ -267,7 +269,7 @@ std::unique_ptr<Expression> Simplifier::simplify(std::unique_ptr<BinaryOperator>
         case BinaryOperator::SHR: {
             if (isZero(node->right().get())) {
                 auto type = typeCalculator_.getType(node.get());
-                return simplify(std::make_unique<Typecast>(Typecast::STATIC_CAST, type, std::move(node->left())));
+                return convert(type, std::move(node->left()));
             }
             break;
         }
@@ -276,22 +278,22 @@ std::unique_ptr<Expression> Simplifier::simplify(std::unique_ptr<BinaryOperator>
         case BinaryOperator::LOGICAL_OR: {
             if (isZero(node->left().get())) {
                 auto type = typeCalculator_.getType(node.get());
-                return simplify(std::make_unique<Typecast>(Typecast::STATIC_CAST, type, std::move(node->right())));
+                return convert(type, std::move(node->right()));
             }
             if (isZero(node->right().get())) {
                 auto type = typeCalculator_.getType(node.get());
-                return simplify(std::make_unique<Typecast>(Typecast::STATIC_CAST, type, std::move(node->left())));
+                return convert(type, std::move(node->left()));
             }
             break;
         }
         case BinaryOperator::LOGICAL_AND: {
             if (isOne(node->right().get())) {
                 auto type = typeCalculator_.getType(node.get());
-                return simplify(std::make_unique<Typecast>(Typecast::STATIC_CAST, type, std::move(node->left())));
+                return convert(type, std::move(node->left()));
             }
             if (isOne(node->left().get())) {
                 auto type = typeCalculator_.getType(node.get());
-                return simplify(std::make_unique<Typecast>(Typecast::STATIC_CAST, type, std::move(node->right())));
+                return convert(type, std::move(node->right()));
             }
             break;
         }
@@ -430,10 +432,9 @@ std::unique_ptr<Expression> Simplifier::simplify(std::unique_ptr<Typecast> node)
                 auto ptrType = innerCast->type()->as<PointerType>();
                 assert(ptrType);
                 if (ptrType->pointeeType()->size() == node->type()->size() && ptrType->pointeeType()->isInteger()) {
-                    deref->operand() = std::make_unique<Typecast>(
-                        Typecast::REINTERPRET_CAST,
-                        typeCalculator_.tree().makePointerType(innerCast->type()->size(), node->type()),
-                        std::move(innerCast->operand()));
+                    innerCast->setCastKind(Typecast::REINTERPRET_CAST);
+                    innerCast->setType(
+                        typeCalculator_.tree().makePointerType(innerCast->type()->size(), node->type()));
                     return simplify(std::move(node->operand()));
                 }
             }
@@ -496,11 +497,12 @@ std::unique_ptr<Expression> Simplifier::simplify(std::unique_ptr<UnaryOperator>
             if (auto binary = node->operand()->as<BinaryOperator>()) {
                 if (binary->operatorKind() == BinaryOperator::ADD) {
                     if (typeCalculator_.getType(binary->left().get())->isPointer()) {
-                        return std::make_unique<BinaryOperator>(BinaryOperator::ARRAY_SUBSCRIPT,
-                                                                std::move(binary->left()), std::move(binary->right()));
+                        binary->setOperatorKind(BinaryOperator::ARRAY_SUBSCRIPT);
+                        return std::move(node->operand());
                     } else if (typeCalculator_.getType(binary->right().get())->isPointer()) {
-                        return std::make_unique<BinaryOperator>(BinaryOperator::ARRAY_SUBSCRIPT,
-                                                                std::move(binary->right()), std::move(binary->left()));
+                        binary->setOperatorKind(BinaryOperator::ARRAY_SUBSCRIPT);
+                        std::swap(binary->left(), binary->right());
+                        return std::move(node->operand());
                     }
                 }
             }
@@ -578,11 +580,10 @@ std::unique_ptr<Expression> Simplifier::simplifyBooleanExpression(std::unique_pt
             }
         } else if (binary->operatorKind() == BinaryOperator::EQ) {
             if (isZero(binary->right().get())) {
-                return simplify(std::make_unique<UnaryOperator>(UnaryOperator::LOGICAL_NOT, std::move(binary->left())));
+                return negate(std::move(binary->left()));
             }
             if (isZero(binary->left().get())) {
-                return simplify(
-                    std::make_unique<UnaryOperator>(UnaryOperator::LOGICAL_NOT, std::move(binary->right())));
+                return negate(std::move(binary->right()));
             }
         }
     }
@@ -590,6 +591,59 @@ std::unique_ptr<Expression> Simplifier::simplifyBooleanExpression(std::unique_pt
     return node;
 }
 
+std::unique_ptr<Expression> Simplifier::convert(const Type *type, std::unique_ptr<Expression> node) {
+    /*
+     * A typecast to the expression's own type would be dropped by simplify(),
+     * so do not allocate it at all. Dereferences are left to simplify(),
+     * which may retype the pointer cast under them.
+     */
+    if (typeCalculator_.getType(node.get()) == type) {
+        auto unary = node->as<UnaryOperator>();
+        if (!unary || unary->operatorKind() != UnaryOperator::DEREFERENCE) {
+            return node;
+        }
+    }
+    return simplify(std::make_unique<Typecast>(Typecast::STATIC_CAST, type, std::move(node)));
+}
+
+std::unique_ptr<Expression> Simplifier::negate(std::unique_ptr<Expression> node) {
+    node = simplifyBooleanExpression(std::move(node));
+
+    if (auto binary = node->as<BinaryOperator>()) {
+        switch (binary->operatorKind()) {
+            case BinaryOperator::EQ:
+                binary->setOperatorKind(BinaryOperator::NEQ);
+                return node;
+            case BinaryOperator::NEQ:
+                binary->setOperatorKind(BinaryOperator::EQ);
+                return node;
+            case BinaryOperator::LT:
+                binary->setOperatorKind(BinaryOperator::GEQ);
+                return node;
+            case BinaryOperator::LEQ:
+                binary->setOperatorKind(BinaryOperator::GT);
+                return node;
+            case BinaryOperator::GT:
+                binary->setOperatorKind(BinaryOperator::LEQ);
+                return node;
+            case BinaryOperator::GEQ:
+                binary->setOperatorKind(BinaryOperator::LT);
+                return node;
+            default:
+                break;
+        }
+    }
+    if (auto unary = node->as<UnaryOperator>()) {
+        if (unary->operatorKind() == UnaryOperator::LOGICAL_NOT) {
+            if (typeCalculator_.getType(unary->operand().get())->size() == 1) {
+                return std::move(unary->operand());
+            }
+        }
+    }
+
+    return std::make_unique<UnaryOperator>(UnaryOperator::LOGICAL_NOT, std::move(node));
+}
+
 std::unique_ptr<Statement> Simplifier::simplify(std::unique_ptr<Statement> node) {
     switch (node->statementKind()) {
         case Statement::BLOCK:
@@ -649,6 +703,8 @@ std::unique_ptr<Goto> Simplifier::simplify(std::unique_ptr<Goto> node) {
 std::unique_ptr<If> Simplifier::simplify(std::unique_ptr<If> node) {
     node->thenStatement() = simplify(std::move(node->thenStatement()));
 
+    bool negated = false;
+
     if (node->elseStatement()) {
         node->elseStatement() = simplify(std::move(node->elseStatement()));
 
@@ -662,8 +718,7 @@ std::unique_ptr<If> Simplifier::simplify(std::unique_ptr<If> node) {
             if (auto block = node->thenStatement()->as<Block>()) {
                 if (block->statements().empty()) {
                     node->thenStatement() = std::move(node->elseStatement());
-                    node->condition() = simplify(
-                        std::make_unique<UnaryOperator>(UnaryOperator::LOGICAL_NOT, std::move(node->condition())));
+                    negated = true;
                 }
             }
         }
@@ -671,6 +726,10 @@ std::unique_ptr<If> Simplifier::simplify(std::unique_ptr<If> node) {
 
     node->condition() = simplifyBooleanExpression(simplify(std::move(node->condition())));
 
+    if (negated) {
+        node->condition() = simplifyBooleanExpression(negate(std::move(node->condition())));
+    }
+
     return node;
 }
 
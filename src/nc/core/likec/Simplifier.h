@@ -32,6 +32,7 @@ class Return;
 class Statement;
 class Switch;
 class Tree;
+class Type;
 class Typecast;
 class UnaryOperator;
 class VariableDeclaration;
@@ -82,6 +83,24 @@ private:
     std::unique_ptr<Switch> simplify(std::unique_ptr<Switch> node);
     std::unique_ptr<Expression> simplifyBooleanExpression(std::unique_ptr<Expression> node);
 
+    /**
+     * \param type Valid pointer to a type.
+     * \param node Valid pointer to a simplified expression.
+     *
+     * \return The expression converted to the given type: the expression itself
+     *         if it already has the type, or a new typecast of it otherwise.
+     */
+    std::unique_ptr<Expression> convert(const Type *type, std::unique_ptr<Expression> node);
+
+    /**
+     * \param node Valid pointer to a simplified expression used as a boolean.
+     *
+     * \return Logical negation of the expression. Comparisons are inverted
+     *         and negations are dropped in place; a new node is created only
+     *         if there is nothing to invert.
+     */
+    std::unique_ptr<Expression> negate(std::unique_ptr<Expression> node);
+
     /**
      * Simplifies all the nodes in the given range.
      * Removes nodes that simplify to nothing.
@@ -25,6 +25,7 @@
 #include "Tree.h"
 
 #include <nc/common/Foreach.h>
+#include <nc/common/make_unique.h>
 
 #include "Simplifier.h"
 #include "TreePrinter.h"
@@ -34,8 +35,33 @@ namespace nc {
 namespace core {
 namespace likec {
 
+Arena *Tree::makeArena() {
+    arenas_.push_back(std::make_unique<Arena>());
+    return arenas_.back().get();
+}
+
+std::size_t Tree::arenaBytesReserved() const {
+    std::size_t result = 0;
+    foreach (const auto &arena, arenas_) {
+        result += arena->bytesReserved();
+    }
+    return result;
+}
+
+std::size_t Tree::arenaBytesReleased() const {
+    std::size_t result = 0;
+    foreach (const auto &arena, arenas_) {
+        result += arena->bytesReleased();
+    }
+    return result;
+}
+
 void Tree::rewriteRoot() {
     if (root_) {
+        /*
+         * Many of the nodes created by the simplifier are thrown away by it.
+         * They are allocated from the heap, so that their memory is freed then.
+         */
         root_ = Simplifier(*this).simplify(std::move(root_));
     }
 }
@@ -44,6 +70,10 @@ void Tree::print(QTextStream &out, PrintCallback<const TreeNode *> *callback) co
     TreePrinter(out, callback).print(root());
 }
 
+void Tree::print(PrintSink &out, PrintCallback<const TreeNode *> *callback) const {
+    TreePrinter(out, callback).print(root());
+}
+
 const VoidType *Tree::makeVoidType() {
     return &voidType_;
 }
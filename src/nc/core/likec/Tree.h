@@ -32,9 +32,11 @@
 
 #include <boost/noncopyable.hpp>
 
+#include <nc/common/Arena.h>
 #include <nc/common/PrintCallback.h>
 
 #include "CompilationUnit.h"
+#include "PrintSink.h"
 #include "Types.h"
 
 namespace nc {
@@ -45,6 +47,9 @@ namespace likec {
  * Abstract syntax tree of high-level program in a C-like language.
  */
 class Tree: boost::noncopyable {
+    /** Arenas holding the nodes. Declared before root_ to outlive the nodes. */
+    std::vector<std::unique_ptr<Arena>> arenas_;
+
     std::unique_ptr<CompilationUnit> root_; ///< Tree root node.
 
     SmallBitSize intSize_; ///< Size of int in bits for target platform.
@@ -117,6 +122,26 @@ public:
      */
     void setRoot(std::unique_ptr<CompilationUnit> node) { root_ = std::move(node); }
 
+    /**
+     * Creates an arena living as long as the tree. Nodes of the tree
+     * can be allocated from it using TreeNode::ArenaScope. The memory
+     * of the nodes deleted before the tree stays in the arena.
+     *
+     * \return Valid pointer to the arena.
+     */
+    Arena *makeArena();
+
+    /**
+     * \return Total number of bytes taken from the heap by the arenas of the tree.
+     */
+    std::size_t arenaBytesReserved() const;
+
+    /**
+     * \return Number of bytes in the arenas of the tree taken by the nodes
+     *         deleted before the tree.
+     */
+    std::size_t arenaBytesReleased() const;
+
     /**
      * Rewrites the whole tree.
      *
@@ -132,6 +157,14 @@ public:
      */
     void print(QTextStream &out, PrintCallback<const TreeNode *> *callback = 0) const;
 
+    /**
+     * Prints the whole tree into a sink.
+     *
+     * \param[in] out Output sink.
+     * \param[in] callback Print callback.
+     */
+    void print(PrintSink &out, PrintCallback<const TreeNode *> *callback = 0) const;
+
     /**
      * \return Void type.
      */
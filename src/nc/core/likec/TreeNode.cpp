@@ -24,14 +24,92 @@
 
 #include "TreeNode.h"
 
+#include <cstdint>
+#include <new>
+
+#include <QThreadStorage>
+
+#include <nc/common/Arena.h>
+
 #include "TreePrinter.h"
 
 namespace nc {
 namespace core {
 namespace likec {
 
+namespace {
+
+/**
+ * Prefix of every node's memory telling where the memory came from.
+ * The union makes the node following it suitably aligned, and its size
+ * is used as the alignment of the allocation.
+ */
+union AllocationHeader {
+    Arena *arena; ///< Arena the memory came from, or nullptr if from the heap.
+    std::uint64_t alignInteger; ///< Member forcing the alignment of 64-bit integers.
+    double alignDouble; ///< Member forcing the alignment of doubles.
+};
+
+/**
+ * Arena the nodes created in a thread are allocated from.
+ */
+struct CurrentArena {
+    Arena *arena; ///< Pointer to the arena, or nullptr if nodes are allocated from the heap.
+
+    CurrentArena(): arena(nullptr) {}
+};
+
+/** Current arenas of the threads. The storage deletes them when threads finish. */
+QThreadStorage<CurrentArena *> currentArenas;
+
+/**
+ * \return Reference to the pointer to the arena of the current thread.
+ */
+Arena *&currentArena() {
+    if (!currentArenas.hasLocalData()) {
+        currentArenas.setLocalData(new CurrentArena());
+    }
+    return currentArenas.localData()->arena;
+}
+
+} // anonymous namespace
+
 TreeNode::~TreeNode() {}
 
+void *TreeNode::operator new(std::size_t size) {
+    auto arena = currentArena();
+
+    AllocationHeader *header;
+    if (arena) {
+        header = static_cast<AllocationHeader *>(
+            arena->allocate(sizeof(AllocationHeader) + size, sizeof(AllocationHeader)));
+    } else {
+        header = static_cast<AllocationHeader *>(::operator new(sizeof(AllocationHeader) + size));
+    }
+    header->arena = arena;
+    return header + 1;
+}
+
+void TreeNode::operator delete(void *pointer, std::size_t size) {
+    if (pointer) {
+        auto header = static_cast<AllocationHeader *>(pointer) - 1;
+        if (header->arena) {
+            header->arena->release(sizeof(AllocationHeader) + size);
+        } else {
+            ::operator delete(header);
+        }
+    }
+}
+
+TreeNode::ArenaScope::ArenaScope(Arena *arena): previousArena_(currentArena()) {
+    assert(arena != nullptr);
+    currentArena() = arena;
+}
+
+TreeNode::ArenaScope::~ArenaScope() {
+    currentArena() = previousArena_;
+}
+
 void TreeNode::print(QTextStream &out) const {
     TreePrinter(out, nullptr).print(this);
 }
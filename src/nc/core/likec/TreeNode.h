@@ -25,12 +25,18 @@
 
 #include <nc/config.h>
 
+#include <cstddef>
 #include <functional>
 
+#include <boost/noncopyable.hpp>
+
 #include <nc/common/Printable.h>
 #include <nc/common/Subclass.h>
 
 namespace nc {
+
+class Arena;
+
 namespace core {
 namespace likec {
 
@@ -65,6 +71,52 @@ public:
      */
     virtual ~TreeNode();
 
+    /**
+     * Allocates memory for a node from the arena of the current
+     * ArenaScope, or from the heap if there is none.
+     *
+     * \param size Size of the node in bytes.
+     *
+     * \return Pointer to the allocated memory.
+     */
+    static void *operator new(std::size_t size);
+
+    /**
+     * Frees the memory of a node. Memory taken from an arena
+     * is only released together with the arena: the arena
+     * merely counts it as released.
+     *
+     * \param pointer Pointer returned by operator new().
+     * \param size Size of the node in bytes.
+     */
+    static void operator delete(void *pointer, std::size_t size);
+
+    /**
+     * While an object of this class is alive, nodes created
+     * in the current thread are allocated from the given arena.
+     *
+     * The arena only makes allocation and deallocation cheap:
+     * deleting a node still runs its destructor, which frees
+     * the strings and containers owned by the node.
+     */
+    class ArenaScope: boost::noncopyable {
+        Arena *previousArena_; ///< Arena in use before the scope was entered.
+
+    public:
+        /**
+         * Constructor.
+         *
+         * \param arena Valid pointer to the arena. It must outlive all
+         *              the nodes allocated in it.
+         */
+        explicit ArenaScope(Arena *arena);
+
+        /**
+         * Destructor. Restores the previously used arena.
+         */
+        ~ArenaScope();
+    };
+
     /**
      * Calls a given function on all the children of this node.
      *
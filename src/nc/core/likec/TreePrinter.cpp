@@ -8,6 +8,7 @@
 #include <nc/common/Foreach.h>
 #include <nc/common/Escaping.h>
 #include <nc/common/Unreachable.h>
+#include <nc/common/make_unique.h>
 
 #include "ArgumentDeclaration.h"
 #include "BinaryOperator.h"
@@ -38,6 +39,7 @@
 #include "UnaryOperator.h"
 #include "UndeclaredIdentifier.h"
 #include "VariableDeclaration.h"
+#include "VerbatimDeclaration.h"
 #include "While.h"
 
 namespace nc {
@@ -167,6 +169,10 @@ int getPrecedence(const UnaryOperator *node) {
 } // anonymous namespace
 
 TreePrinter::TreePrinter(QTextStream &out, PrintCallback<const TreeNode *> *callback):
+    ownSink_(std::make_unique<TextStreamPrintSink>(out)), out_(*ownSink_), callback_(callback), indentStep_(4), indent_(0)
+{}
+
+TreePrinter::TreePrinter(PrintSink &out, PrintCallback<const TreeNode *> *callback):
     out_(out), callback_(callback), indentStep_(4), indent_(0)
 {}
 
@@ -184,6 +190,13 @@ void TreePrinter::print(const TreeNode *node) {
     }
 }
 
+void TreePrinter::printPrototype(const FunctionDeclaration *node) {
+    assert(node);
+
+    printSignature(node);
+    out_ << ';';
+}
+
 void TreePrinter::doPrint(const TreeNode *node) {
     switch (node->nodeKind()) {
         case TreeNode::COMPILATION_UNIT:
@@ -205,10 +218,10 @@ void TreePrinter::doPrint(const TreeNode *node) {
 
 void TreePrinter::doPrint(const CompilationUnit *node) {
     foreach (const auto &declaration, node->declarations()) {
-        out_ << endl;
+        out_ << '\n';
         printIndent();
         print(declaration);
-        out_ << endl;
+        out_ << '\n';
     }
 }
 
@@ -231,6 +244,9 @@ void TreePrinter::doPrint(const Declaration *node) {
         case Declaration::VARIABLE_DECLARATION:
             doPrint(node->as<VariableDeclaration>());
             break;
+        case Declaration::VERBATIM_DECLARATION:
+            doPrint(node->as<VerbatimDeclaration>());
+            break;
         default:
             unreachable();
     }
@@ -276,16 +292,20 @@ void TreePrinter::printSignature(const FunctionDeclaration *node) {
 }
 
 void TreePrinter::doPrint(const MemberDeclaration *node) {
-    out_ << *node->type() << ' ' << node->identifier() << ';';
+    out_ << *node->type() << ' ';
+    out_.writeIdentifier(node);
+    out_ << ';';
 }
 
 void TreePrinter::doPrint(const StructTypeDeclaration *node) {
-    out_ << "struct " << node->identifier() << " {" << endl;
+    out_ << "struct ";
+    out_.writeIdentifier(node);
+    out_ << " {\n";
     indentMore();
     foreach (const auto &member, node->type()->members()) {
         printIndent();
         print(member);
-        out_ << endl;
+        out_ << '\n';
     }
     indentLess();
     out_ << "};";
@@ -303,6 +323,10 @@ void TreePrinter::doPrint(const VariableDeclaration *node) {
     out_ << ';';
 }
 
+void TreePrinter::doPrint(const VerbatimDeclaration *node) {
+    out_ << node->text();
+}
+
 void TreePrinter::doPrint(const Expression *node) {
     switch (node->expressionKind()) {
         case Expression::BINARY_OPERATOR:
@@ -462,21 +486,22 @@ void TreePrinter::doPrint(const CallOperator *node) {
 }
 
 void TreePrinter::doPrint(const FunctionIdentifier *node) {
-    out_ << node->declaration()->identifier();
+    out_.writeIdentifier(node->declaration());
 }
 
 void TreePrinter::doPrint(const IntegerConstant *node) {
     SignedConstantValue val = node->value().size() > 1 ? node->value().signedValue() : node->value().value();
 
     if ((0 <= val && val <= 100) || (-100 <= val && val < 0 && !node->type()->isUnsigned())) {
-        out_ << val;
+        out_.writeDecimal(val);
     } else {
-        out_ << hex << "0x" << node->value().value() << dec;
+        out_ << "0x";
+        out_.writeHex(node->value().value());
     }
 }
 
 void TreePrinter::doPrint(const LabelIdentifier *node) {
-    out_ << node->declaration()->identifier();
+    out_.writeIdentifier(node->declaration());
 }
 
 void TreePrinter::doPrint(const MemberAccessOperator *node) {
@@ -504,7 +529,7 @@ void TreePrinter::doPrint(const MemberAccessOperator *node) {
             break;
     }
 
-    out_ << node->member()->identifier();
+    out_.writeIdentifier(node->member());
 }
 
 void TreePrinter::doPrint(const String *node) {
@@ -607,7 +632,7 @@ void TreePrinter::doPrint(const UnaryOperator *node) {
 }
 
 void TreePrinter::doPrint(const VariableIdentifier *node) {
-    out_ << node->declaration()->identifier();
+    out_.writeIdentifier(node->declaration());
 }
 
 void TreePrinter::doPrint(const UndeclaredIdentifier *node) {
@@ -664,17 +689,17 @@ void TreePrinter::doPrint(const Statement *node) {
 }
 
 void TreePrinter::doPrint(const Block *node) {
-    out_ << "{" << endl;
+    out_ << "{\n";
     indentMore();
 
     foreach (const auto &declaration, node->declarations()) {
         printIndent();
         print(declaration);
-        out_ << endl;
+        out_ << '\n';
     }
 
     if (!node->declarations().empty() && !node->statements().empty()) {
-        out_ << endl;
+        out_ << '\n';
     }
 
     foreach (const auto &statement, node->statements()) {
@@ -688,7 +713,7 @@ void TreePrinter::doPrint(const Block *node) {
 
         printIndent();
         print(statement);
-        out_ << endl;
+        out_ << '\n';
 
         if (isCaseLabel) {
             indentMore();
@@ -785,7 +810,7 @@ void TreePrinter::printNestedStatement(const Statement *statement) {
     if (statement->is<Block>()) {
         print(statement);
     } else {
-        out_ << endl;
+        out_ << '\n';
         indentMore();
         printIndent();
         print(statement);
@@ -801,14 +826,14 @@ void TreePrinter::printComment(const Commentable *node) {
     QStringList lines = node->comment().split('\n');
 
     if (lines.size() == 1) {
-        out_ << "/* " << lines.first() << " */" << endl;
+        out_ << "/* " << lines.first() << " */\n";
     } else {
-        out_ << "/*" << endl;
+        out_ << "/*\n";
         foreach (const QString &line, lines) {
             printIndent();
-            out_ << " * " << line << endl;
+            out_ << " * " << line << '\n';
         }
-        out_ << " */" << endl;
+        out_ << " */\n";
     }
 }
 
@@ -822,7 +847,7 @@ void TreePrinter::indentLess() {
 }
 
 void TreePrinter::printIndent() {
-    out_ << QString(indent_, ' ');
+    out_.writeIndent(indent_);
 }
 
 } // namespace likec
@@ -5,10 +5,14 @@
 
 #include <nc/config.h>
 
+#include <memory>
+
 #include <QTextStream>
 
 #include <nc/common/PrintCallback.h>
 
+#include "PrintSink.h"
+
 namespace nc {
 namespace core {
 namespace likec {
@@ -48,13 +52,15 @@ class UnaryOperator;
 class UndeclaredIdentifier;
 class VariableDeclaration;
 class VariableIdentifier;
+class VerbatimDeclaration;
 class While;
 
 /**
- * This class can print tree nodes into a stream.
+ * This class can print tree nodes into a stream or another sink.
  */
 class TreePrinter {
-    QTextStream &out_; ///< Output stream.
+    std::unique_ptr<PrintSink> ownSink_; ///< Sink created by the printer, if any.
+    PrintSink &out_; ///< Output sink.
     PrintCallback<const TreeNode *> *callback_; ///< Print callback.
     int indentStep_; ///< Size of a single indentation step.
     int indent_; ///< Current indentation.
@@ -67,12 +73,26 @@ public:
     TreePrinter(QTextStream &out, PrintCallback<const TreeNode *> *callback);
 
     /**
-     * Prints the given node to the stream passed to the constructor.
+     * \param out Output sink.
+     * \param callback Pointer to the print callback. Can be NULL.
+     */
+    TreePrinter(PrintSink &out, PrintCallback<const TreeNode *> *callback);
+
+    /**
+     * Prints the given node to the stream or sink passed to the constructor.
      *
      * \param node Valid pointer to a node.
      */
     void print(const TreeNode *node);
 
+    /**
+     * Prints the declaration of a function without its body,
+     * even if the node is a function definition.
+     *
+     * \param node Valid pointer to a function declaration.
+     */
+    void printPrototype(const FunctionDeclaration *node);
+
 private:
     void doPrint(const TreeNode *node);
 
@@ -85,6 +105,7 @@ private:
     void doPrint(const MemberDeclaration *node);
     void doPrint(const StructTypeDeclaration *node);
     void doPrint(const VariableDeclaration *node);
+    void doPrint(const VerbatimDeclaration *node);
 
     void doPrint(const Expression *node);
     void doPrint(const BinaryOperator *node);
@@ -68,11 +68,25 @@ public:
      */
     CastKind castKind() const { return castKind_; }
 
+    /**
+     * Sets the kind of the cast.
+     *
+     * \param[in] castKind Kind of cast.
+     */
+    void setCastKind(CastKind castKind) { castKind_ = castKind; }
+
     /**
      * \return Type to cast to.
      */
     const Type *type() const { return type_; }
 
+    /**
+     * Sets the type to cast to.
+     *
+     * \param[in] type Valid pointer to the type.
+     */
+    void setType(const Type *type) { assert(type); type_ = type; }
+
     /**
      * \return Operand.
      */
@@ -0,0 +1,173 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "Utf8PrintSink.h"
+
+#include <cassert>
+#include <iterator>
+
+#include <QIODevice>
+#include <QTextStream>
+
+#include <nc/common/Exception.h>
+
+#include "Declaration.h"
+#include "Type.h"
+
+namespace nc {
+namespace core {
+namespace likec {
+
+namespace {
+
+/** Spaces copied by writeIndent(). */
+const char spaces[] = "                                                                ";
+
+/**
+ * Encodes a Latin-1 character in UTF-8.
+ *
+ * \param character Character.
+ * \param out Output iterator.
+ */
+template<class OutputIterator>
+void encodeLatin1(unsigned char character, OutputIterator &out) {
+    if (character < 0x80) {
+        *out++ = static_cast<char>(character);
+    } else {
+        *out++ = static_cast<char>(0xC0 | (character >> 6));
+        *out++ = static_cast<char>(0x80 | (character & 0x3F));
+    }
+}
+
+} // anonymous namespace
+
+Utf8PrintSink::Utf8PrintSink(QIODevice *device, std::size_t flushThreshold):
+    device_(device), flushThreshold_(flushThreshold), position_(0)
+{
+    buffer_.reserve(device ? flushThreshold + flushThreshold / 4 : flushThreshold);
+}
+
+void Utf8PrintSink::flush() {
+    if (!device_ || buffer_.empty()) {
+        return;
+    }
+
+    auto size = static_cast<qint64>(buffer_.size());
+    if (device_->write(buffer_.data(), size) != size) {
+        throw nc::Exception(tr("could not write to the output device: %1").arg(device_->errorString()));
+    }
+
+    buffer_.clear();
+}
+
+void Utf8PrintSink::clear() {
+    buffer_.clear();
+    position_ = 0;
+    identifiers_.clear();
+    types_.clear();
+}
+
+void Utf8PrintSink::write(const char *latin1, std::size_t size) {
+    auto out = std::back_inserter(buffer_);
+    for (std::size_t i = 0; i < size; ++i) {
+        encodeLatin1(static_cast<unsigned char>(latin1[i]), out);
+    }
+    position_ += static_cast<qint64>(size);
+    checkFlush();
+}
+
+void Utf8PrintSink::write(const QString &text) {
+    auto begin = text.constData();
+    auto end = begin + text.size();
+
+    for (auto i = begin; i != end; ++i) {
+        if (i->unicode() >= 0x80) {
+            append(std::make_pair(text.toUtf8(), text.size()));
+            return;
+        }
+    }
+
+    /* Fast path: the string is ASCII. */
+    for (auto i = begin; i != end; ++i) {
+        buffer_.push_back(static_cast<char>(i->unicode()));
+    }
+    position_ += text.size();
+    checkFlush();
+}
+
+void Utf8PrintSink::writeIdentifier(const Declaration *declaration) {
+    assert(declaration != nullptr);
+
+    auto &encoded = identifiers_[declaration];
+    if (encoded.first.isNull()) {
+        encoded.first = declaration->identifier().toUtf8();
+        encoded.second = declaration->identifier().size();
+    }
+    append(encoded);
+}
+
+void Utf8PrintSink::writeType(const Type *type) {
+    assert(type != nullptr);
+
+    auto &encoded = types_[type];
+    if (encoded.first.isNull()) {
+        QString text;
+        QTextStream out(&text);
+        out << *type;
+        out.flush();
+        encoded = std::make_pair(text.toUtf8(), text.size());
+    }
+    append(encoded);
+}
+
+void Utf8PrintSink::writeIndent(int indent) {
+    assert(indent >= 0);
+
+    const auto step = static_cast<int>(sizeof(spaces) - 1);
+    while (indent > step) {
+        buffer_.insert(buffer_.end(), spaces, spaces + step);
+        position_ += step;
+        indent -= step;
+    }
+    append(spaces, static_cast<std::size_t>(indent));
+}
+
+void Utf8PrintSink::writeDecimal(SignedConstantValue value) {
+    char digits[24];
+    char *end = digits + sizeof(digits);
+    char *begin = end;
+
+    /* Negate in unsigned arithmetic, so that the minimal value is handled too. */
+    ConstantValue magnitude = value < 0 ? ~static_cast<ConstantValue>(value) + 1 : static_cast<ConstantValue>(value);
+    do {
+        *--begin = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    if (value < 0) {
+        *--begin = '-';
+    }
+
+    append(begin, static_cast<std::size_t>(end - begin));
+}
+
+void Utf8PrintSink::writeHex(ConstantValue value) {
+    static const char hexDigits[] = "0123456789abcdef";
+
+    char digits[16];
+    char *end = digits + sizeof(digits);
+    char *begin = end;
+
+    do {
+        *--begin = hexDigits[value & 0xF];
+        value >>= 4;
+    } while (value != 0);
+
+    append(begin, static_cast<std::size_t>(end - begin));
+}
+
+} // namespace likec
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,146 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <utility> /* For std::pair. */
+#include <vector>
+
+#include <QByteArray>
+#include <QCoreApplication>
+
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "PrintSink.h"
+
+QT_BEGIN_NAMESPACE
+class QIODevice;
+QT_END_NAMESPACE
+
+namespace nc {
+namespace core {
+namespace likec {
+
+/**
+ * Sink encoding the text in UTF-8 into a byte buffer.
+ *
+ * The buffer is written to the output device whenever it grows over
+ * the flush threshold, and its memory is reused afterwards. Identifiers
+ * and types are encoded once and copied as bytes after that.
+ *
+ * Print callbacks can use position() to learn the current offset
+ * in the output in UTF-16 code units, i.e. the offset in a QString
+ * holding the decoded text.
+ */
+class Utf8PrintSink: public PrintSink, boost::noncopyable {
+    Q_DECLARE_TR_FUNCTIONS(Utf8PrintSink)
+
+    QIODevice *device_; ///< Output device, or nullptr.
+    std::size_t flushThreshold_; ///< Buffer size at which the buffer is written to the device.
+    std::vector<char> buffer_; ///< Encoded text not yet written to the device.
+    qint64 position_; ///< Number of UTF-16 code units in the text written so far.
+    boost::unordered_map<const Declaration *, std::pair<QByteArray, int>> identifiers_; ///< Encoded identifiers and their lengths in UTF-16 code units.
+    boost::unordered_map<const Type *, std::pair<QByteArray, int>> types_; ///< Encoded types and their lengths in UTF-16 code units.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param device Pointer to the output device. Can be nullptr, then the text
+     *               stays in the buffer until clear() is called.
+     * \param flushThreshold Buffer size in bytes at which the buffer is written
+     *                       to the device.
+     */
+    explicit Utf8PrintSink(QIODevice *device = nullptr, std::size_t flushThreshold = 4 << 20);
+
+    /**
+     * \return Pointer to the text in the buffer.
+     */
+    const char *data() const { return buffer_.data(); }
+
+    /**
+     * \return Size of the text in the buffer in bytes.
+     */
+    std::size_t size() const { return buffer_.size(); }
+
+    /**
+     * \return Number of UTF-16 code units in the text written since
+     *         construction or clear(), including the text still in the buffer.
+     */
+    qint64 position() const { return position_; }
+
+    /**
+     * Writes the buffer to the output device, if any, and empties it.
+     * Must be called after printing, as the destructor does not write anything.
+     *
+     * \throws nc::Exception If writing to the device failed.
+     */
+    void flush();
+
+    /**
+     * Discards the buffered text and the cached encodings, so that
+     * the sink can be reused for printing another tree.
+     * The memory of the buffer is kept.
+     */
+    void clear();
+
+    void write(char character) override {
+        if (static_cast<unsigned char>(character) < 0x80) {
+            buffer_.push_back(character);
+            ++position_;
+            checkFlush();
+        } else {
+            write(&character, 1);
+        }
+    }
+
+    void write(const char *latin1, std::size_t size) override;
+    void write(const QString &text) override;
+    void writeIdentifier(const Declaration *declaration) override;
+    void writeType(const Type *type) override;
+    void writeIndent(int indent) override;
+    void writeDecimal(SignedConstantValue value) override;
+    void writeHex(ConstantValue value) override;
+
+private:
+    /**
+     * Appends ASCII characters to the buffer.
+     *
+     * \param data Pointer to the characters.
+     * \param size Number of characters.
+     */
+    void append(const char *data, std::size_t size) {
+        buffer_.insert(buffer_.end(), data, data + size);
+        position_ += static_cast<qint64>(size);
+        checkFlush();
+    }
+
+    /**
+     * Appends encoded text to the buffer.
+     *
+     * \param text Text encoded in UTF-8 and its length in UTF-16 code units.
+     */
+    void append(const std::pair<QByteArray, int> &text) {
+        buffer_.insert(buffer_.end(), text.first.constData(), text.first.constData() + text.first.size());
+        position_ += text.second;
+        checkFlush();
+    }
+
+    /**
+     * Flushes the buffer if it has grown over the threshold.
+     */
+    void checkFlush() {
+        if (device_ && buffer_.size() >= flushThreshold_) {
+            flush();
+        }
+    }
+};
+
+} // namespace likec
+} // namespace core
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
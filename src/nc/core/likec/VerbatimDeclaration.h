@@ -0,0 +1,46 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <QString>
+
+#include "Declaration.h"
+
+namespace nc {
+namespace core {
+namespace likec {
+
+/**
+ * Declaration given by its ready source text, e.g. a function
+ * definition taken from a cache of previous decompilations.
+ */
+class VerbatimDeclaration: public Declaration {
+    QString text_; ///< Source text of the declaration.
+
+public:
+    /**
+     * Class constructor.
+     *
+     * \param[in] identifier Name of the declared entity.
+     * \param[in] text Source text of the declaration.
+     */
+    VerbatimDeclaration(QString identifier, QString text):
+        Declaration(VERBATIM_DECLARATION, std::move(identifier)), text_(std::move(text))
+    {}
+
+    /**
+     * \return Source text of the declaration.
+     */
+    const QString &text() const { return text_; }
+};
+
+} // namespace likec
+} // namespace core
+} // namespace nc
+
+NC_SUBCLASS(nc::core::likec::Declaration, nc::core::likec::VerbatimDeclaration, nc::core::likec::Declaration::VERBATIM_DECLARATION)
+
+/* vim:set et sts=4 sw=4: */
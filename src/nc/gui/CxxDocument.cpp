@@ -25,7 +25,6 @@
 #include "CxxDocument.h"
 
 #include <QPlainTextDocumentLayout>
-#include <QTextStream>
 
 #include <nc/core/Context.h>
 
@@ -41,6 +40,7 @@
 #include <nc/core/likec/LabelStatement.h>
 #include <nc/core/likec/Statement.h>
 #include <nc/core/likec/Tree.h>
+#include <nc/core/likec/Utf8PrintSink.h>
 #include <nc/core/likec/VariableDeclaration.h>
 #include <nc/core/likec/VariableIdentifier.h>
 
@@ -53,26 +53,26 @@ namespace {
 QString printTree(const core::likec::Tree &tree, RangeTree &rangeTree) {
     class Callback: public PrintCallback<const core::likec::TreeNode *> {
         RangeTreeBuilder builder_;
-        const QString &out_;
+        const core::likec::Utf8PrintSink &sink_;
 
     public:
-        Callback(RangeTree &tree, const QString &out) : builder_(tree), out_(out) {}
+        Callback(RangeTree &tree, const core::likec::Utf8PrintSink &sink) : builder_(tree), sink_(sink) {}
 
         void onStartPrinting(const core::likec::TreeNode *node) override {
-            builder_.onStart((void *)(node), out_.size());
+            builder_.onStart((void *)(node), static_cast<int>(sink_.position()));
         }
         void onEndPrinting(const core::likec::TreeNode *node) override {
-            builder_.onEnd((void *)(node), out_.size());
+            builder_.onEnd((void *)(node), static_cast<int>(sink_.position()));
         }
     };
 
-    QString result;
-    QTextStream stream(&result);
-    Callback callback(rangeTree, result);
+    /* The sink counts positions in UTF-16 code units, i.e. in the characters of the resulting QString. */
+    core::likec::Utf8PrintSink sink;
+    Callback callback(rangeTree, sink);
 
-    tree.print(stream, &callback);
+    tree.print(sink, &callback);
 
-    return result;
+    return QString::fromUtf8(sink.data(), static_cast<int>(sink.size()));
 }
 
 inline const core::likec::TreeNode *getNode(const RangeNode *rangeNode) {
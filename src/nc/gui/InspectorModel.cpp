@@ -202,7 +202,7 @@ void expand(InspectorItem *item, const core::ir::Term *term, const core::Context
             InspectorItem *definitionsItem = item->addChild(tr("definitions"));
 
             foreach (auto &chunk, dataflow.getDefinitions(term).chunks()) {
-                auto chunkItem = definitionsItem->addChild(chunk.location().toString());
+                auto chunkItem = definitionsItem->addChild(dataflow.memoryLocations().get(chunk.location()).toString());
                 foreach (auto definition, chunk.definitions()) {
                     chunkItem->addChild("", definition);
                 }
@@ -290,6 +290,10 @@ void expand(InspectorItem *item, const core::likec::Declaration *declaration) {
             item->addChild(tr("type"), variableDeclaration->type());
             break;
         }
+        case core::likec::Declaration::VERBATIM_DECLARATION: {
+            item->addComment(tr("Verbatim Declaration"));
+            break;
+        }
         default: {
             item->addComment(tr("declaration kind = %1").arg(declaration->declarationKind()));
             break;
@@ -176,6 +176,13 @@ void MainWindow::createActions() {
     openAction_->setShortcuts(QKeySequence::Open);
     connect(openAction_, SIGNAL(triggered()), this, SLOT(open()));
 
+    openSessionAction_ = new QAction(tr("Open &Session..."), this);
+    connect(openSessionAction_, SIGNAL(triggered()), this, SLOT(openSession()));
+
+    saveSessionAction_ = new QAction(tr("Sa&ve Session..."), this);
+    saveSessionAction_->setShortcuts(QKeySequence::Save);
+    connect(saveSessionAction_, SIGNAL(triggered()), this, SLOT(saveSession()));
+
     exportCfgAction_ = new QAction(tr("&Export CFG..."), this);
     connect(exportCfgAction_, SIGNAL(triggered()), this, SLOT(exportCfg()));
 
@@ -240,6 +247,8 @@ void MainWindow::createActions() {
 void MainWindow::createMenus() {
     QMenu *fileMenu = menuBar()->addMenu(tr("&File"));
     fileMenu->addAction(openAction_);
+    fileMenu->addAction(openSessionAction_);
+    fileMenu->addAction(saveSessionAction_);
     fileMenu->addSeparator();
     fileMenu->addAction(exportCfgAction_);
     fileMenu->addSeparator();
@@ -311,6 +320,7 @@ void MainWindow::saveSettings() {
 }
 
 void MainWindow::updateGuiState() {
+    saveSessionAction_->setEnabled(project() != nullptr);
     exportCfgAction_->setEnabled(project() != nullptr);
     disassembleAction_->setEnabled(project() != nullptr);
     decompileAction_->setEnabled(project() != nullptr);
@@ -370,6 +380,7 @@ void MainWindow::open(const QStringList &filenames) {
 
     auto project = std::make_unique<gui::Project>();
     project->setName(QFileInfo(filenames.front()).fileName());
+    project->setInputFiles(filenames);
     project->setContext(context);
     project->setImage(context->image());
     project->setInstructions(context->instructions());
@@ -385,6 +396,52 @@ void MainWindow::open(const QStringList &filenames) {
     }
 }
 
+void MainWindow::openSession() {
+    QString filename = QFileDialog::getOpenFileName(this, tr("Which session should I open?"), QString(), tr("Snowman Sessions (*.nss);;All Files (*)"));
+
+    if (!filename.isEmpty()) {
+        openSession(filename);
+    }
+}
+
+void MainWindow::openSession(const QString &filename) {
+    auto project = std::make_unique<gui::Project>();
+    project->setName(QFileInfo(filename).fileName());
+    project->setLogToken(logToken_);
+
+    try {
+        project->loadSession(filename);
+    } catch (const nc::Exception &e) {
+        QMessageBox::critical(this, tr("Error"), e.unicodeWhat());
+        return;
+    }
+
+    open(std::move(project));
+
+    if (project_->instructions()->empty()) {
+        project_->disassemble();
+    }
+
+    if (decompileAutomatically()) {
+        project_->decompile();
+    }
+}
+
+void MainWindow::saveSession() {
+    if (!project()) {
+        return;
+    }
+
+    QString filename = QFileDialog::getSaveFileName(this, tr("Where should I save the session?"), QString(), tr("Snowman Sessions (*.nss);;All Files (*)"));
+    if (!filename.isEmpty()) {
+        try {
+            project()->saveSession(filename);
+        } catch (const nc::Exception &e) {
+            QMessageBox::critical(this, tr("Error"), e.unicodeWhat());
+        }
+    }
+}
+
 void MainWindow::open(std::unique_ptr<Project> project) {
     assert(project);
 
@@ -78,6 +78,8 @@ class MainWindow: public QMainWindow {
     QProgressBar *statusProgressBar_; ///< Progress bar in the status bar.
 
     QAction *openAction_; ///< Action for opening a file.
+    QAction *openSessionAction_; ///< Action for opening a saved session.
+    QAction *saveSessionAction_; ///< Action for saving the session.
     QAction *exportCfgAction_; ///< Action for exporting CFG in DOT format.
     QAction *quitAction_; ///< Action for closing the main window.
     QAction *disassembleAction_; ///< Action for opening disassembly dialog.
@@ -165,6 +167,18 @@ public Q_SLOTS:
      */
     void open(const QStringList &filenames);
 
+    /**
+     * Opens a dialog for selecting a session file and opens the session.
+     */
+    void openSession();
+
+    /**
+     * Opens a session saved in a given file and starts decompiling it.
+     *
+     * \param filename Name of the session file.
+     */
+    void openSession(const QString &filename);
+
 public: 
     /**
      * Opens a project.
@@ -286,6 +300,11 @@ private Q_SLOTS:
      */
     void populateSymbolsContextMenu(QMenu *menu);
 
+    /**
+     * Saves the session to a file selected by the user.
+     */
+    void saveSession();
+
     /**
      * Export CFG in DOT format.
      */
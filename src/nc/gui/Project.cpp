@@ -26,10 +26,13 @@
 
 #include <cassert>
 
+#include <QFile>
+
 #include <nc/common/make_unique.h>
 #include <nc/common/Foreach.h>
 
 #include <nc/core/Context.h>
+#include <nc/core/Session.h>
 #include <nc/core/arch/Instructions.h>
 #include <nc/core/image/Image.h>
 #include <nc/core/image/Section.h>
@@ -136,6 +139,36 @@ void Project::decompile(const std::shared_ptr<const core::arch::Instructions> &i
     commandQueue()->push(std::make_unique<Decompile>(this, instructions));
 }
 
+void Project::saveSession(const QString &filename) const {
+    core::Session session;
+    session.setInputFiles(inputFiles());
+    session.capture(*context());
+    session.save(filename);
+
+    logToken().info(tr("Session saved to %1.").arg(filename));
+}
+
+void Project::loadSession(const QString &filename) {
+    auto session = core::Session::load(filename);
+
+    bool filesExist = !session->inputFiles().empty();
+    foreach (const QString &inputFile, session->inputFiles()) {
+        filesExist = filesExist && QFile::exists(inputFile);
+    }
+    if (filesExist && !session->matches(session->inputFiles())) {
+        logToken().warning(tr("The input files of session %1 have changed since it was saved.").arg(filename));
+    }
+
+    auto context = std::make_shared<core::Context>();
+    context->setLogToken(logToken());
+    session->restore(*context);
+
+    setInputFiles(session->inputFiles());
+    setContext(context);
+    setImage(context->image());
+    setInstructions(context->instructions());
+}
+
 void Project::cancelAll() {
     commandQueue()->clear();
 }
@@ -26,6 +26,7 @@
 #include <nc/config.h>
 
 #include <QObject>
+#include <QStringList>
 
 #include <cassert>
 #include <memory>
@@ -64,6 +65,9 @@ class Project: public QObject {
     /** Name of the project. */
     QString name_;
 
+    /** Names of the files the image was parsed from. */
+    QStringList inputFiles_;
+
     /** Executable image being decompiled. */
     std::shared_ptr<core::image::Image> image_;
 
@@ -105,6 +109,18 @@ class Project: public QObject {
      */
     void setName(const QString &name);
 
+    /**
+     * \return Names of the files the image was parsed from.
+     */
+    const QStringList &inputFiles() const { return inputFiles_; }
+
+    /**
+     * Sets the names of the files the image was parsed from.
+     *
+     * \param filenames Names of the files.
+     */
+    void setInputFiles(const QStringList &filenames) { inputFiles_ = filenames; }
+
     /**
      * \return Valid pointer to the executable image being decompiled.
      */
@@ -188,6 +204,28 @@ class Project: public QObject {
      */
     void decompile(const std::shared_ptr<const core::arch::Instructions> &instructions);
 
+    /**
+     * Saves the image, the instructions and the code generated by the
+     * last decompilation to a session file.
+     *
+     * \param filename Name of the session file.
+     *
+     * \throws nc::Exception If the session could not be saved.
+     */
+    void saveSession(const QString &filename) const;
+
+    /**
+     * Takes the image and the instructions from a session file.
+     * The analyses are not stored in the session and are redone.
+     * Logs a warning if the input files of the session have changed
+     * since the session was saved.
+     *
+     * \param filename Name of the session file.
+     *
+     * \throws nc::Exception If the session could not be loaded.
+     */
+    void loadSession(const QString &filename);
+
     public Q_SLOTS:
 
     /**
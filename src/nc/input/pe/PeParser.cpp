@@ -358,7 +358,8 @@ private:
                 image_->addRelocation(std::make_unique<core::image::Relocation>(
                     entryAddress,
                     image_->addSymbol(std::make_unique<core::image::Symbol>(
-                        core::image::SymbolType::FUNCTION, tr("%1:%2").arg(dllName).arg(entry.Name), boost::none)),
+                        core::image::SymbolType::FUNCTION, tr("%1:%2").arg(dllName).arg(entry.Name), boost::none,
+                        nullptr, dllName)),
                     sizeof(IMPORT_LOOKUP_TABLE_ENTRY)));
             } else {
                 auto name = reader.readAsciizString(
@@ -368,7 +369,8 @@ private:
 
                 image_->addRelocation(std::make_unique<core::image::Relocation>(
                     entryAddress, image_->addSymbol(std::make_unique<core::image::Symbol>(
-                                      core::image::SymbolType::FUNCTION, std::move(name), boost::none)),
+                                      core::image::SymbolType::FUNCTION, std::move(name), boost::none,
+                                      nullptr, dllName)),
                     sizeof(IMPORT_LOOKUP_TABLE_ENTRY)));
             }
         }
@@ -0,0 +1,472 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "Server.h"
+
+#include <cctype>
+#include <sstream>
+
+#include <QStringList>
+#include <QTextStream>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <nc/common/Exception.h>
+#include <nc/common/Foreach.h>
+#include <nc/common/Parallel.h>
+#include <nc/common/Range.h>
+#include <nc/common/StringToInt.h>
+
+#include <nc/core/Context.h>
+#include <nc/core/Driver.h>
+#include <nc/core/MasterAnalyzer.h>
+#include <nc/core/arch/Architecture.h>
+#include <nc/core/arch/Instructions.h>
+#include <nc/core/image/Image.h>
+#include <nc/core/image/Symbol.h>
+#include <nc/core/ir/BasicBlock.h>
+#include <nc/core/ir/Function.h>
+#include <nc/core/ir/Functions.h>
+#include <nc/core/ir/Statements.h>
+#include <nc/core/ir/Term.h>
+#include <nc/core/ir/calling/Signatures.h>
+#include <nc/core/ir/cgen/NameGenerator.h>
+#include <nc/core/likec/Tree.h>
+
+namespace nc {
+namespace nocode {
+
+namespace {
+
+/* JSON-RPC error codes. */
+const int PARSE_ERROR = -32700;
+const int INVALID_REQUEST = -32600;
+const int METHOD_NOT_FOUND = -32601;
+const int SERVER_ERROR = -32000;
+const int REQUEST_CANCELED = -32800;
+
+/**
+ * \param string String.
+ *
+ * \return JSON string literal with the given value.
+ */
+QString quote(const QString &string) {
+    QString result;
+    result.reserve(string.size() + 2);
+    result += '"';
+    foreach (QChar c, string) {
+        switch (c.unicode()) {
+            case '"':  result += QLatin1String("\\\""); break;
+            case '\\': result += QLatin1String("\\\\"); break;
+            case '\n': result += QLatin1String("\\n"); break;
+            case '\r': result += QLatin1String("\\r"); break;
+            case '\t': result += QLatin1String("\\t"); break;
+            default:
+                if (c.unicode() < 0x20) {
+                    result += QString(QLatin1String("\\u%1")).arg(c.unicode(), 4, 16, QChar('0'));
+                } else {
+                    result += c;
+                }
+                break;
+        }
+    }
+    result += '"';
+    return result;
+}
+
+/**
+ * \param addr Address.
+ *
+ * \return JSON string literal with the address in hexadecimal notation.
+ */
+QString quote(ByteAddr addr) {
+    return quote(QString(QLatin1String("0x%1")).arg(addr, 0, 16));
+}
+
+/**
+ * \param json JSON text.
+ * \param pos Position in the text.
+ *
+ * \return Position of the first non-whitespace character at or after the given one.
+ */
+std::size_t skipSpace(const std::string &json, std::size_t pos) {
+    while (pos < json.size() && std::isspace(static_cast<unsigned char>(json[pos]))) {
+        ++pos;
+    }
+    return pos;
+}
+
+/**
+ * \param json Well-formed JSON text.
+ * \param pos Position of the first character of a value in the text.
+ *
+ * \return Position right after the value.
+ */
+std::size_t skipValue(const std::string &json, std::size_t pos) {
+    int depth = 0;
+    bool inString = false;
+
+    for (; pos < json.size(); ++pos) {
+        char c = json[pos];
+        if (inString) {
+            if (c == '\\') {
+                ++pos;
+            } else if (c == '"') {
+                inString = false;
+                if (depth == 0) {
+                    return pos + 1;
+                }
+            }
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '{' || c == '[') {
+            ++depth;
+        } else if (c == '}' || c == ']') {
+            if (depth == 0) {
+                return pos;
+            }
+            if (--depth == 0) {
+                return pos + 1;
+            }
+        } else if (depth == 0 && (c == ',' || c == ':' || std::isspace(static_cast<unsigned char>(c)))) {
+            return pos;
+        }
+    }
+    return pos;
+}
+
+/**
+ * \param json Well-formed JSON text of an object.
+ * \param key Name of the member.
+ *
+ * \return Text of the value of the member, exactly as given in the object,
+ *         or an empty string if there is no such member.
+ */
+std::string getRawMember(const std::string &json, const char *key) {
+    auto pos = skipSpace(json, 0);
+    if (pos >= json.size() || json[pos] != '{') {
+        return std::string();
+    }
+
+    pos = skipSpace(json, pos + 1);
+    while (pos < json.size() && json[pos] == '"') {
+        auto nameEnd = skipValue(json, pos);
+        auto name = json.substr(pos + 1, nameEnd - pos - 2);
+
+        pos = skipSpace(json, nameEnd);
+        if (pos >= json.size() || json[pos] != ':') {
+            break;
+        }
+
+        pos = skipSpace(json, pos + 1);
+        auto valueEnd = skipValue(json, pos);
+        if (name == key) {
+            return json.substr(pos, valueEnd - pos);
+        }
+
+        pos = skipSpace(json, valueEnd);
+        if (pos >= json.size() || json[pos] != ',') {
+            break;
+        }
+        pos = skipSpace(json, pos + 1);
+    }
+
+    return std::string();
+}
+
+/**
+ * \param value Text of the id of a request, as given in the request.
+ *
+ * \return JSON representation of the id. A string id stays a string,
+ *         and a numeric one stays a number, as JSON-RPC requires.
+ */
+QString idToJson(const std::string &value) {
+    if (value.empty()) {
+        return QLatin1String("null");
+    }
+    return QString::fromUtf8(value.c_str());
+}
+
+} // anonymous namespace
+
+/**
+ * Parsed request.
+ */
+class Server::Request {
+public:
+    QString id; ///< JSON representation of the request id.
+    QString method; ///< Name of the method.
+    QString function; ///< Function parameter.
+    QString cancelId; ///< JSON representation of the id of the request to cancel.
+    CancellationToken cancellationToken; ///< Cancellation token of the request.
+};
+
+/**
+ * Results of decompilation of a function.
+ */
+class Server::FunctionResult {
+public:
+    QString name; ///< Name of the function.
+    QString code; ///< Generated code.
+    QString signature; ///< JSON representation of the signature.
+};
+
+Server::Server(core::Context &context, int depth, QTextStream &out):
+    context_(context), depth_(depth), out_(out), stopped_(false), programReady_(false)
+{}
+
+Server::~Server() {
+    threadPool_.waitForDone();
+}
+
+void Server::serve(QTextStream &in) {
+    while (!stopped_) {
+        QString line = in.readLine();
+        if (line.isNull()) {
+            break;
+        }
+        if (!line.trimmed().isEmpty()) {
+            handle(line);
+        }
+    }
+    threadPool_.waitForDone();
+}
+
+void Server::handle(const QString &line) {
+    auto request = std::make_shared<Request>();
+
+    try {
+        boost::property_tree::ptree tree;
+        std::istringstream stream(line.toUtf8().constData());
+        boost::property_tree::read_json(stream, tree);
+
+        /* The property tree keeps no value types, so ids are taken from the text. */
+        auto json = std::string(line.toUtf8().constData());
+        request->id = idToJson(getRawMember(json, "id"));
+        request->method = QString::fromUtf8(tree.get<std::string>("method", std::string()).c_str());
+        request->function = QString::fromUtf8(tree.get<std::string>("params.function", std::string()).c_str());
+        request->cancelId = idToJson(getRawMember(getRawMember(json, "params"), "id"));
+    } catch (const boost::property_tree::ptree_error &e) {
+        respondError(QLatin1String("null"), PARSE_ERROR, QString::fromLocal8Bit(e.what()));
+        return;
+    }
+
+    if (request->method.isEmpty()) {
+        respondError(request->id, INVALID_REQUEST, tr("No method given."));
+    } else if (request->method == QLatin1String("cancel")) {
+        bool found = false;
+        {
+            QMutexLocker locker(&mutex_);
+            auto i = runningRequests_.find(request->cancelId);
+            if (i != runningRequests_.end()) {
+                i->second.cancel();
+                found = true;
+            }
+        }
+        respond(request->id, found ? QLatin1String("true") : QLatin1String("false"));
+    } else if (request->method == QLatin1String("shutdown")) {
+        threadPool_.waitForDone();
+        stopped_ = true;
+        respond(request->id, QLatin1String("null"));
+    } else if (request->method == QLatin1String("listFunctions") ||
+               request->method == QLatin1String("decompile") ||
+               request->method == QLatin1String("signature") ||
+               request->method == QLatin1String("cfg"))
+    {
+        {
+            QMutexLocker locker(&mutex_);
+            if (!runningRequests_.insert(std::make_pair(request->id, request->cancellationToken)).second) {
+                locker.unlock();
+                respondError(request->id, INVALID_REQUEST, tr("A request with id %1 is already running.").arg(request->id));
+                return;
+            }
+        }
+
+        startInThreadPool(threadPool_, [this, request]() { execute(*request); });
+    } else {
+        respondError(request->id, METHOD_NOT_FOUND, tr("Unknown method: %1.").arg(request->method));
+    }
+}
+
+void Server::execute(const Request &request) {
+    try {
+        request.cancellationToken.poll();
+
+        QString result;
+
+        if (request.method == QLatin1String("listFunctions")) {
+            prepareProgram(request.cancellationToken);
+
+            core::ir::cgen::NameGenerator nameGenerator(*context_.image());
+
+            QStringList functions;
+            foreach (const core::ir::Function *function, context_.functions()->list()) {
+                if (function->entry() && function->entry()->address()) {
+                    ByteAddr addr = *function->entry()->address();
+                    functions << QString(QLatin1String("{\"address\":%1,\"name\":%2}"))
+                        .arg(quote(addr))
+                        .arg(quote(nameGenerator.getFunctionName(addr).name()));
+                }
+            }
+            result = QLatin1Char('[') + functions.join(QLatin1String(",")) + QLatin1Char(']');
+        } else if (request.method == QLatin1String("decompile")) {
+            ByteAddr addr = resolveFunction(request.function);
+            auto functionResult = decompile(addr, request.cancellationToken);
+
+            result = QString(QLatin1String("{\"address\":%1,\"name\":%2,\"code\":%3}"))
+                .arg(quote(addr)).arg(quote(functionResult->name)).arg(quote(functionResult->code));
+        } else if (request.method == QLatin1String("signature")) {
+            result = decompile(resolveFunction(request.function), request.cancellationToken)->signature;
+        } else if (request.method == QLatin1String("cfg")) {
+            ByteAddr addr = resolveFunction(request.function);
+
+            prepareProgram(request.cancellationToken);
+
+            QString dot;
+            QTextStream out(&dot);
+
+            foreach (const core::ir::Function *function, context_.functions()->list()) {
+                if (function->entry() && function->entry()->address() && *function->entry()->address() == addr) {
+                    out << "digraph Functions { compound = true" << endl << *function << "}" << endl;
+                    break;
+                }
+            }
+            out.flush();
+
+            if (dot.isEmpty()) {
+                throw nc::Exception(tr("No function starts at 0x%1.").arg(addr, 0, 16));
+            }
+
+            result = QString(QLatin1String("{\"address\":%1,\"dot\":%2}")).arg(quote(addr)).arg(quote(dot));
+        }
+
+        respond(request.id, result);
+    } catch (const CancellationException &) {
+        respondError(request.id, REQUEST_CANCELED, tr("Request canceled."));
+    } catch (const nc::Exception &e) {
+        respondError(request.id, SERVER_ERROR, e.unicodeWhat());
+    } catch (const std::exception &e) {
+        respondError(request.id, SERVER_ERROR, QString::fromLocal8Bit(e.what()));
+    }
+
+    QMutexLocker locker(&mutex_);
+    runningRequests_.erase(request.id);
+}
+
+void Server::prepareProgram(const CancellationToken &cancellationToken) {
+    QMutexLocker locker(&programMutex_);
+
+    if (programReady_) {
+        return;
+    }
+
+    context_.logToken().info(tr("Building the intermediate representation of the whole program."));
+
+    /*
+     * context_ is only polled for cancellation here, under programMutex_.
+     * If the request is canceled, the next request needing the program
+     * builds it again under its own token.
+     */
+    auto savedToken = context_.cancellationToken();
+    context_.setCancellationToken(cancellationToken);
+
+    try {
+        if (context_.instructions()->empty()) {
+            core::Driver::disassemble(context_);
+        }
+
+        auto masterAnalyzer = context_.image()->platform().architecture()->masterAnalyzer();
+        masterAnalyzer->createProgram(context_);
+        masterAnalyzer->createFunctions(context_);
+    } catch (...) {
+        context_.setCancellationToken(savedToken);
+        throw;
+    }
+
+    context_.setCancellationToken(savedToken);
+    programReady_ = true;
+}
+
+std::shared_ptr<const Server::FunctionResult> Server::decompile(ByteAddr addr, const CancellationToken &cancellationToken) {
+    {
+        QMutexLocker locker(&mutex_);
+        if (auto result = nc::find(functionResults_, addr)) {
+            return result;
+        }
+    }
+
+    core::Context context;
+    context.setImage(context_.image());
+    context.setFunctionCache(context_.functionCache());
+    context.setSignatureDatabase(context_.signatureDatabase());
+    context.setBudget(context_.budget());
+    context.setLogToken(context_.logToken());
+    context.setCancellationToken(cancellationToken);
+
+    std::vector<ByteAddr> entries(1, addr);
+
+    core::Driver::disassemble(context, entries, depth_);
+    cancellationToken.poll();
+
+    context.setSelectedFunctions(entries);
+    core::Driver::decompile(context);
+
+    auto result = std::make_shared<FunctionResult>();
+
+    result->name = core::ir::cgen::NameGenerator(*context.image()).getFunctionName(addr).name();
+
+    {
+        QTextStream out(&result->code);
+        context.tree()->print(out);
+    }
+
+    if (auto signature = context.signatures()->getSignature(addr)) {
+        QStringList arguments;
+        foreach (const auto &argument, signature->arguments()) {
+            arguments << quote(argument->toString());
+        }
+        result->signature = QString(QLatin1String(
+            "{\"address\":%1,\"name\":%2,\"arguments\":[%3],\"returnValue\":%4,\"variadic\":%5}"))
+            .arg(quote(addr))
+            .arg(quote(result->name))
+            .arg(arguments.join(QLatin1String(",")))
+            .arg(signature->returnValue() ? quote(signature->returnValue()->toString()) : QString(QLatin1String("null")))
+            .arg(signature->variadic() ? QLatin1String("true") : QLatin1String("false"));
+    } else {
+        result->signature = QLatin1String("null");
+    }
+
+    QMutexLocker locker(&mutex_);
+    functionResults_[addr] = result;
+
+    return result;
+}
+
+ByteAddr Server::resolveFunction(const QString &function) const {
+    if (auto address = nc::stringToInt<ByteAddr>(function, 0)) {
+        return *address;
+    }
+    foreach (const auto *symbol, context_.image()->symbols()) {
+        if (symbol->value() && symbol->name() == function) {
+            return *symbol->value();
+        }
+    }
+    throw nc::Exception(tr("No function with address or name '%1'.").arg(function));
+}
+
+void Server::respond(const QString &id, const QString &result) {
+    QMutexLocker locker(&outputMutex_);
+    out_ << "{\"jsonrpc\":\"2.0\",\"id\":" << id << ",\"result\":" << result << "}" << endl;
+}
+
+void Server::respondError(const QString &id, int code, const QString &message) {
+    QMutexLocker locker(&outputMutex_);
+    out_ << "{\"jsonrpc\":\"2.0\",\"id\":" << id << ",\"error\":{\"code\":" << code
+         << ",\"message\":" << quote(message) << "}}" << endl;
+}
+
+} // namespace nocode
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,164 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <map>
+#include <memory>
+
+#include <QCoreApplication>
+#include <QMutex>
+#include <QString>
+#include <QThreadPool>
+
+#include <nc/common/CancellationToken.h>
+#include <nc/common/Types.h>
+
+QT_BEGIN_NAMESPACE
+class QTextStream;
+QT_END_NAMESPACE
+
+namespace nc {
+
+namespace core {
+    class Context;
+}
+
+namespace nocode {
+
+/**
+ * JSON-RPC 2.0 server answering questions about a single executable.
+ *
+ * Requests are read from the input stream, one JSON object per line,
+ * and the responses are written to the output stream, one per line,
+ * in the order of completion. Supported methods:
+ *
+ *  - listFunctions: entry addresses and names of all functions;
+ *  - decompile {function}: C code of the function;
+ *  - signature {function}: reconstructed signature of the function;
+ *  - cfg {function}: intermediate representation of the function in DOT language;
+ *  - cancel {id}: cancels the request with the given id;
+ *  - shutdown: waits for the running requests and stops the server.
+ *
+ * A function is given by its entry address or symbol name. Ids of the running
+ * requests must be distinct: a request reusing the id of a running one is rejected.
+ *
+ * The image is parsed once. The whole-program intermediate representation is
+ * built on the first request needing it and kept for the following ones.
+ * A function is decompiled together with its callees up to the given depth,
+ * independently of the rest of the program; the results are remembered.
+ * Requests are served concurrently by a thread pool. Without NC_USE_THREADS,
+ * each request is served before the next line is read, so there is never
+ * a running request to cancel and cancel always returns false.
+ */
+class Server {
+    Q_DECLARE_TR_FUNCTIONS(Server)
+
+    class Request;
+    class FunctionResult;
+
+    core::Context &context_; ///< Context with the parsed image.
+    int depth_; ///< Depth of the callees to analyze together with a decompiled function.
+    QTextStream &out_; ///< Stream for writing responses.
+    bool stopped_; ///< True if the shutdown was requested.
+
+    QThreadPool threadPool_; ///< Threads serving the requests.
+
+    QMutex outputMutex_; ///< Mutex protecting out_.
+
+    QMutex programMutex_; ///< Mutex protecting the construction of the whole-program IR in context_.
+    bool programReady_; ///< True if the whole-program IR in context_ has been built.
+
+    QMutex mutex_; ///< Mutex protecting the fields below.
+    std::map<QString, CancellationToken> runningRequests_; ///< Cancellation tokens of running requests by their ids.
+    std::map<ByteAddr, std::shared_ptr<const FunctionResult>> functionResults_; ///< Results of decompilation of functions.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param context Context with the parsed image. Its function cache and
+     *                log token are used for all the requests.
+     * \param depth Depth of the callees to analyze together with a decompiled function.
+     * \param out Stream for writing responses.
+     */
+    Server(core::Context &context, int depth, QTextStream &out);
+
+    /**
+     * Destructor. Waits for the running requests to finish.
+     */
+    ~Server();
+
+    /**
+     * Serves the requests from the given stream until the end of the stream
+     * or a shutdown request.
+     *
+     * \param in Input stream.
+     */
+    void serve(QTextStream &in);
+
+private:
+    /**
+     * Handles a single request line.
+     *
+     * \param line Text of the request.
+     */
+    void handle(const QString &line);
+
+    /**
+     * Executes a request and writes the response.
+     *
+     * \param request Request.
+     */
+    void execute(const Request &request);
+
+    /**
+     * Builds the whole-program IR in context_, if it has not been built yet.
+     *
+     * \param cancellationToken Cancellation token of the request.
+     */
+    void prepareProgram(const CancellationToken &cancellationToken);
+
+    /**
+     * Decompiles a function with its callees, or returns the remembered result.
+     *
+     * \param addr Entry address of the function.
+     * \param cancellationToken Cancellation token of the request.
+     *
+     * \return Valid pointer to the result.
+     */
+    std::shared_ptr<const FunctionResult> decompile(ByteAddr addr, const CancellationToken &cancellationToken);
+
+    /**
+     * \param function Entry address or symbol name of a function.
+     *
+     * \return Entry address of the function.
+     *
+     * \throws nc::Exception If there is no such function.
+     */
+    ByteAddr resolveFunction(const QString &function) const;
+
+    /**
+     * Writes a response.
+     *
+     * \param id JSON representation of the request id.
+     * \param result JSON representation of the result.
+     */
+    void respond(const QString &id, const QString &result);
+
+    /**
+     * Writes an error response.
+     *
+     * \param id JSON representation of the request id.
+     * \param code JSON-RPC error code.
+     * \param message Error message.
+     */
+    void respondError(const QString &id, int code, const QString &message);
+};
+
+} // namespace nocode
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -25,19 +25,26 @@
 #include <nc/config.h>
 
 #include <nc/common/Branding.h>
+#include <nc/common/Budget.h>
 #include <nc/common/Exception.h>
 #include <nc/common/Foreach.h>
 #include <nc/common/StreamLogger.h>
+#include <nc/common/StringToInt.h>
 #include <nc/common/Unreachable.h>
+#include <nc/common/make_unique.h>
 
 #include <nc/core/Context.h>
 #include <nc/core/Driver.h>
+#include <nc/core/FunctionCache.h>
+#include <nc/core/SignatureDatabase.h>
+#include <nc/core/Session.h>
 #include <nc/core/arch/Architecture.h>
 #include <nc/core/arch/ArchitectureRepository.h>
 #include <nc/core/arch/Instruction.h>
 #include <nc/core/arch/Instructions.h>
 #include <nc/core/image/Image.h>
 #include <nc/core/image/Section.h>
+#include <nc/core/image/Symbol.h>
 #include <nc/core/input/Parser.h>
 #include <nc/core/input/ParserRepository.h>
 #include <nc/core/ir/BasicBlock.h>
@@ -48,12 +55,16 @@
 #include <nc/core/ir/Terms.h>
 #include <nc/core/ir/cflow/Graphs.h>
 #include <nc/core/likec/Tree.h>
+#include <nc/core/likec/Utf8PrintSink.h>
 
 #include <QCoreApplication>
 #include <QFile>
+#include <QFileInfo>
 #include <QStringList>
 #include <QTextStream>
 
+#include "Server.h"
+
 const char *self = "nocode";
 
 QTextStream qin(stdin, QIODevice::ReadOnly);
@@ -128,6 +139,26 @@ void printRegionGraphs(nc::core::Context &context, QTextStream &out) {
     out << "}" << endl;
 }
 
+nc::ByteAddr resolveFunction(nc::core::Context &context, const QString &function) {
+    if (auto address = nc::stringToInt<nc::ByteAddr>(function, 0)) {
+        return *address;
+    }
+    foreach (const auto *symbol, context.image()->symbols()) {
+        if (symbol->value() && symbol->name() == function) {
+            return *symbol->value();
+        }
+    }
+    throw nc::Exception(QString("no function with address or name '%1'").arg(function));
+}
+
+qlonglong parseLimit(const QString &limit) {
+    auto value = nc::stringToInt<qlonglong>(limit);
+    if (!value || *value < 0) {
+        throw nc::Exception(QString("invalid limit: %1").arg(limit));
+    }
+    return *value;
+}
+
 void help() {
     auto branding = nc::branding();
     branding.setApplicationName("Nocode");
@@ -143,7 +174,33 @@ void help() {
          << "  --print-cfg[=FILE]          Print control flow graph in DOT language to the file." << endl
          << "  --print-ir[=FILE]           Print intermediate representation in DOT language to the file." << endl
          << "  --print-regions[=FILE]      Print results of structural analysis in DOT language to the file." << endl
-         << "  --print-cxx[=FILE]          Print reconstructed program into given file." << endl
+         << "  --print-cxx[=FILE]          Print reconstructed program into given file, in UTF-8." << endl
+         << "  --function=ADDR|SYMBOL      Decompile only the function with the given address or name." << endl
+         << "                              Can be given multiple times." << endl
+         << "  --depth=N                   With --function, also analyze the functions called from" << endl
+         << "                              the given ones up to N calls deep (default: 1)." << endl
+         << "  --load-session=FILE         Reuse the results saved in the session file instead of" << endl
+         << "                              parsing and disassembling the input files again." << endl
+         << "  --save-session=FILE         Save the results of the analysis to the session file." << endl
+         << "  --function-cache=DIR        Reuse the results of the analysis of identical functions" << endl
+         << "                              stored in the directory, and store new ones there." << endl
+         << "  --signatures=FILE           Take signatures of known library functions from the" << endl
+         << "                              signature database file built by sigdb." << endl
+         << "  --time-limit=MS             Limit the time spent by each analysis of a function." << endl
+         << "  --size-limit=N              Do not restructure the functions with more than N" << endl
+         << "                              statements, and keep dead code in them." << endl
+         << "  --iteration-limit=N         Limit the iterations of the fixpoint computations" << endl
+         << "                              done for each function." << endl
+         << "                              Functions exceeding a limit are decompiled partially," << endl
+         << "                              with a comment naming the exceeded limit." << endl
+         << "  --serve                     Answer JSON-RPC requests read from stdin, one per line," << endl
+         << "                              about the given files. Methods: listFunctions, decompile," << endl
+         << "                              signature, cfg (with parameter function=ADDR|SYMBOL)," << endl
+         << "                              cancel (with parameter id), shutdown." << endl
+#ifndef NC_USE_THREADS
+         << "                              This build serves requests one at a time, so they" << endl
+         << "                              cannot be canceled." << endl
+#endif
          << endl
          << branding.applicationName() << " is a command-line native code to C/C++ decompiler." << endl
          << "It parses given files, decompiles them, and prints the requested" << endl
@@ -182,6 +239,18 @@ int main(int argc, char *argv[]) {
         bool autoDefault = true;
         bool verbose = false;
 
+        QStringList functions;
+        int depth = 1;
+
+        QString loadSessionFile;
+        QString saveSessionFile;
+        QString functionCacheDirectory;
+        QString signatureDatabaseFile;
+        qlonglong timeLimit = 0;
+        qlonglong sizeLimit = 0;
+        qlonglong iterationLimit = 0;
+        bool serve = false;
+
         std::vector<nc::ByteAddr> functionAddresses;
         std::vector<nc::ByteAddr> callAddresses;
 
@@ -215,6 +284,30 @@ int main(int argc, char *argv[]) {
 
             #undef FILE_OPTION
 
+            } else if (arg.startsWith("--function=")) {
+                functions.append(arg.section('=', 1));
+            } else if (arg.startsWith("--depth=")) {
+                auto value = nc::stringToInt<int>(arg.section('=', 1));
+                if (!value || *value < 0) {
+                    throw nc::Exception(QString("invalid depth: %1").arg(arg.section('=', 1)));
+                }
+                depth = *value;
+            } else if (arg.startsWith("--load-session=")) {
+                loadSessionFile = arg.section('=', 1);
+            } else if (arg.startsWith("--save-session=")) {
+                saveSessionFile = arg.section('=', 1);
+            } else if (arg.startsWith("--function-cache=")) {
+                functionCacheDirectory = arg.section('=', 1);
+            } else if (arg.startsWith("--signatures=")) {
+                signatureDatabaseFile = arg.section('=', 1);
+            } else if (arg.startsWith("--time-limit=")) {
+                timeLimit = parseLimit(arg.section('=', 1));
+            } else if (arg.startsWith("--size-limit=")) {
+                sizeLimit = parseLimit(arg.section('=', 1));
+            } else if (arg.startsWith("--iteration-limit=")) {
+                iterationLimit = parseLimit(arg.section('=', 1));
+            } else if (arg == "--serve") {
+                serve = true;
             } else if (arg == "--") {
                 while (++i < args.size()) {
                     files.append(args[i]);
@@ -230,7 +323,7 @@ int main(int argc, char *argv[]) {
             cxxFile = "-";
         }
 
-        if (files.empty()) {
+        if (files.empty() && loadSessionFile.isEmpty()) {
             throw nc::Exception("no input files");
         }
 
@@ -240,31 +333,143 @@ int main(int argc, char *argv[]) {
             context.setLogToken(nc::LogToken(std::make_shared<nc::StreamLogger>(qerr)));
         }
 
-        foreach (const QString &filename, files) {
-            try {
-                nc::core::Driver::parse(context, filename);
-            } catch (const nc::Exception &e) {
-                throw nc::Exception(filename + ":" + e.unicodeWhat());
-            } catch (const std::exception &e) {
-                throw nc::Exception(filename + ":" + e.what());
+        if (!functionCacheDirectory.isEmpty()) {
+            context.setFunctionCache(std::make_shared<nc::core::FunctionCache>(functionCacheDirectory));
+        }
+
+        if (!signatureDatabaseFile.isEmpty()) {
+            context.setSignatureDatabase(std::make_shared<nc::core::SignatureDatabase>(signatureDatabaseFile));
+        }
+
+        context.setBudget(nc::Budget(timeLimit, static_cast<std::size_t>(sizeLimit), static_cast<std::size_t>(iterationLimit)));
+
+        /* Options affecting the generated code: saved code is reused only if they are the same. */
+        QStringList outputOptions;
+        if (!functionCacheDirectory.isEmpty()) {
+            outputOptions.append("function-cache=" + QFileInfo(functionCacheDirectory).absoluteFilePath());
+        }
+        if (!signatureDatabaseFile.isEmpty()) {
+            outputOptions.append("signatures=" + QString::fromLatin1(nc::core::Session::hashFiles(QStringList(signatureDatabaseFile)).toHex()));
+        }
+        if (timeLimit) {
+            outputOptions.append(QString("time-limit=%1").arg(timeLimit));
+        }
+        if (sizeLimit) {
+            outputOptions.append(QString("size-limit=%1").arg(sizeLimit));
+        }
+        if (iterationLimit) {
+            outputOptions.append(QString("iteration-limit=%1").arg(iterationLimit));
+        }
+
+        std::unique_ptr<nc::core::Session> session;
+
+        if (!loadSessionFile.isEmpty()) {
+            session = nc::core::Session::load(loadSessionFile);
+
+            if (!files.empty() && !session->matches(files)) {
+                qerr << self << ": warning: session file " << loadSessionFile
+                     << " was saved for different input files, ignoring it" << endl;
+                session.reset();
+            }
+        }
+
+        /* True if the loaded session contains everything computed in this run. */
+        bool sessionUpToDate = session != nullptr;
+
+        if (session) {
+            context.setImage(session->image());
+        } else {
+            foreach (const QString &filename, files) {
+                try {
+                    nc::core::Driver::parse(context, filename);
+                } catch (const nc::Exception &e) {
+                    throw nc::Exception(filename + ":" + e.unicodeWhat());
+                } catch (const std::exception &e) {
+                    throw nc::Exception(filename + ":" + e.what());
+                }
+            }
+        }
+
+        if (serve) {
+            /* Instructions disassembled for the whole program can be reused. */
+            if (session && session->isReusableFor(std::vector<nc::ByteAddr>(), depth)) {
+                session->restore(context);
             }
+            nc::nocode::Server(context, depth, qout).serve(qin);
+            return 0;
+        }
+
+        foreach (const QString &function, functions) {
+            functionAddresses.push_back(resolveFunction(context, function));
         }
 
         openFileForWritingAndCall(sectionsFile, [&](QTextStream &out) { printSections(context, out); });
         openFileForWritingAndCall(symbolsFile, [&](QTextStream &out) { printSymbols(context, out); });
 
         if (!instructionsFile.isEmpty() || !cfgFile.isEmpty() || !irFile.isEmpty() || !regionsFile.isEmpty() || !cxxFile.isEmpty()) {
-            nc::core::Driver::disassemble(context);
+            /* The instructions are reusable if they were disassembled for the same functions and depth. */
+            bool reuseSession = session && session->isReusableFor(functionAddresses, depth);
+
+            /*
+             * The saved code, if it was generated with the same options, can be
+             * printed without decoding the instructions at all.
+             */
+            bool reuseCode = reuseSession && instructionsFile.isEmpty() && cfgFile.isEmpty() && irFile.isEmpty() &&
+                             regionsFile.isEmpty() && session->isCodeReusableFor(functionAddresses, depth, outputOptions);
+
+            if (reuseSession) {
+                if (!reuseCode) {
+                    session->restore(context);
+                }
+            } else {
+                if (functionAddresses.empty()) {
+                    nc::core::Driver::disassemble(context);
+                } else {
+                    nc::core::Driver::disassemble(context, functionAddresses, depth);
+                    context.setSelectedFunctions(functionAddresses);
+                }
+                sessionUpToDate = false;
+            }
             openFileForWritingAndCall(instructionsFile, [&](QTextStream &out) { context.instructions()->print(out); });
 
-            if (!cfgFile.isEmpty() || !irFile.isEmpty() || !regionsFile.isEmpty() || !cxxFile.isEmpty()) {
+            if (reuseCode) {
+                openFileForWritingAndCall(cxxFile, [&](QTextStream &out) {
+                    out.flush();
+                    out.device()->write(session->code().toUtf8());
+                });
+            } else if (!cfgFile.isEmpty() || !irFile.isEmpty() || !regionsFile.isEmpty() || !cxxFile.isEmpty()) {
                 nc::core::Driver::decompile(context);
+                sessionUpToDate = false;
+
+                if (!context.budgetHits().empty()) {
+                    qerr << self << ": " << context.budgetHits().size() << " analyses exceeded their limits, "
+                         << "the affected functions are decompiled partially" << endl;
+                }
 
                 openFileForWritingAndCall(cfgFile,     [&](QTextStream &out) { context.program()->print(out); });
                 openFileForWritingAndCall(irFile,      [&](QTextStream &out) { context.functions()->print(out); });
                 openFileForWritingAndCall(regionsFile, [&](QTextStream &out) { printRegionGraphs(context, out); });
-                openFileForWritingAndCall(cxxFile,     [&](QTextStream &out) { context.tree()->print(out); });
+                openFileForWritingAndCall(cxxFile,     [&](QTextStream &out) {
+                    /* The sink encodes the text itself and writes it to the device directly. */
+                    out.flush();
+                    nc::core::likec::Utf8PrintSink sink(out.device());
+                    context.tree()->print(sink);
+                    sink.flush();
+                });
+            }
+        }
+
+        if (!saveSessionFile.isEmpty()) {
+            if (!session) {
+                session = std::make_unique<nc::core::Session>();
+                session->setInputFiles(files);
+            }
+            if (!sessionUpToDate) {
+                session->capture(context);
+                session->setDepth(depth);
+                session->setOptions(outputOptions);
             }
+            session->save(saveSessionFile);
         }
     } catch (const nc::Exception &e) {
         qerr << self << ": " << e.unicodeWhat() << endl;
@@ -0,0 +1,523 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include "HeaderParser.h"
+
+#include <nc/common/Foreach.h>
+
+namespace nc {
+namespace sigdb {
+
+namespace {
+
+bool isIdentifier(const QString &token) {
+    return !token.isEmpty() && (token[0].isLetter() || token[0] == QChar('_'));
+}
+
+bool isTypeKeyword(const QString &token) {
+    static const char *const keywords[] = {
+        "void", "char", "short", "int", "long", "float", "double", "signed", "unsigned",
+        "_Bool", "bool", "__int8", "__int16", "__int32", "__int64",
+    };
+
+    foreach (const char *keyword, keywords) {
+        if (token == QLatin1String(keyword)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \return True if the token is a calling convention macro meaning stdcall.
+ */
+bool isStdcallWord(const QString &token) {
+    static const char *const words[] = {
+        "__stdcall", "_stdcall", "WINAPI", "APIENTRY", "CALLBACK", "NTAPI", "PASCAL",
+        "STDAPICALLTYPE", "STDMETHODCALLTYPE",
+    };
+
+    foreach (const char *word, words) {
+        if (token == QLatin1String(word)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \return True if the token is a storage class, a linkage or a calling
+ *         convention macro, or an annotation, which does not affect the
+ *         way arguments are passed.
+ */
+bool isIgnoredWord(const QString &token) {
+    static const char *const words[] = {
+        "extern", "static", "inline", "register", "_Noreturn", "noreturn",
+        "cdecl", "_cdecl", "CDECL", "WINAPIV",
+        "WINBASEAPI", "WINUSERAPI", "WINADVAPI", "WINGDIAPI", "WINSHELLAPI", "NTSYSAPI", "NTSYSCALLAPI",
+        "DECLSPEC_IMPORT", "DECLSPEC_NORETURN", "DECLSPEC_ALLOCATOR",
+        "_ACRTIMP", "_CRTIMP", "_CRTIMP2", "_DCRTIMP", "_CRT_STDIO_INLINE",
+    };
+
+    foreach (const char *word, words) {
+        if (token == QLatin1String(word)) {
+            return true;
+        }
+    }
+
+    /* __attribute__, __THROW, __wur, __nonnull, but not __int64. */
+    if (token.startsWith(QLatin1String("__")) && !isTypeKeyword(token) && !isStdcallWord(token)) {
+        return true;
+    }
+
+    /* SAL annotations: _In_, _Out_opt_, _In_reads_bytes_(n). */
+    if (token.size() > 2 && token[0] == QChar('_') && token[1].isUpper() && token.endsWith(QChar('_'))) {
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * \param tokens Tokens.
+ * \param open Index of an opening parenthesis.
+ *
+ * \return Index of the matching closing parenthesis, or the number of tokens if there is none.
+ */
+int findClosingParenthesis(const QStringList &tokens, int open) {
+    int depth = 0;
+    for (int i = open; i < tokens.size(); ++i) {
+        if (tokens[i] == QLatin1String("(")) {
+            ++depth;
+        } else if (tokens[i] == QLatin1String(")")) {
+            if (--depth == 0) {
+                return i;
+            }
+        }
+    }
+    return tokens.size();
+}
+
+/**
+ * Splits tokens at the commas not enclosed in parentheses or brackets.
+ */
+std::vector<QStringList> splitAtCommas(const QStringList &tokens) {
+    std::vector<QStringList> result(1);
+
+    int depth = 0;
+    foreach (const QString &token, tokens) {
+        if (token == QLatin1String("(") || token == QLatin1String("[")) {
+            ++depth;
+        } else if (token == QLatin1String(")") || token == QLatin1String("]")) {
+            --depth;
+        } else if (token == QLatin1String(",") && depth == 0) {
+            result.emplace_back();
+            continue;
+        }
+        result.back().push_back(token);
+    }
+
+    return result;
+}
+
+} // anonymous namespace
+
+HeaderParser::HeaderParser(SmallBitSize pointerSize, SmallBitSize longSize):
+    pointerSize_(pointerSize), longSize_(longSize), skipped_(0)
+{}
+
+void HeaderParser::parse(const QString &text) {
+    QStringList declaration;
+
+    /*
+     * For each open brace, whether it belongs to an extern "C" or a namespace
+     * block, whose contents are declarations, or to a function or a structure body.
+     */
+    std::vector<bool> braces;
+    int bodyDepth = 0;
+
+    foreach (const QString &token, tokenize(text)) {
+        if (token == QLatin1String("{")) {
+            bool block = bodyDepth == 0 &&
+                ((declaration.size() == 1 && declaration.front() == QLatin1String("extern")) ||
+                 (!declaration.empty() && declaration.size() <= 2 && declaration.front() == QLatin1String("namespace")));
+
+            braces.push_back(block);
+            if (block) {
+                declaration.clear();
+            } else {
+                ++bodyDepth;
+            }
+        } else if (token == QLatin1String("}")) {
+            if (braces.empty()) {
+                continue;
+            }
+
+            bool block = braces.back();
+            braces.pop_back();
+
+            if (!block && --bodyDepth == 0 && !declaration.empty() && declaration.back() == QLatin1String(")")) {
+                /* A function definition. */
+                parseDeclaration(declaration);
+                declaration.clear();
+            }
+        } else if (bodyDepth > 0) {
+            continue;
+        } else if (token == QLatin1String(";")) {
+            parseDeclaration(declaration);
+            declaration.clear();
+        } else {
+            declaration.push_back(token);
+        }
+    }
+}
+
+QStringList HeaderParser::tokenize(const QString &text) {
+    QStringList result;
+
+    int size = text.size();
+    bool lineStart = true;
+
+    for (int i = 0; i < size;) {
+        QChar c = text[i];
+
+        if (c == QChar('\n')) {
+            lineStart = true;
+            ++i;
+        } else if (c.isSpace()) {
+            ++i;
+        } else if (c == QChar('/') && i + 1 < size && text[i + 1] == QChar('/')) {
+            while (i < size && text[i] != QChar('\n')) {
+                ++i;
+            }
+        } else if (c == QChar('/') && i + 1 < size && text[i + 1] == QChar('*')) {
+            int end = text.indexOf(QLatin1String("*/"), i + 2);
+            i = end == -1 ? size : end + 2;
+        } else if (c == QChar('#') && lineStart) {
+            /* A preprocessor directive, possibly continued on the next lines. */
+            while (i < size && text[i] != QChar('\n')) {
+                if (text[i] == QChar('\\') && i + 1 < size && text[i + 1].isSpace()) {
+                    i = text.indexOf(QChar('\n'), i + 1);
+                    if (i == -1) {
+                        i = size;
+                        break;
+                    }
+                }
+                ++i;
+            }
+        } else if (c == QChar('"') || c == QChar('\'')) {
+            lineStart = false;
+            ++i;
+            while (i < size && text[i] != c) {
+                if (text[i] == QChar('\\')) {
+                    ++i;
+                }
+                ++i;
+            }
+            ++i;
+        } else {
+            lineStart = false;
+
+            int start = i;
+            if (c.isLetterOrNumber() || c == QChar('_')) {
+                while (i < size && (text[i].isLetterOrNumber() || text[i] == QChar('_') || (c.isDigit() && text[i] == QChar('.')))) {
+                    ++i;
+                }
+            } else if (text.mid(i, 3) == QLatin1String("...")) {
+                i += 3;
+            } else {
+                ++i;
+            }
+            result.push_back(text.mid(start, i - start));
+        }
+    }
+
+    return result;
+}
+
+void HeaderParser::parseDeclaration(QStringList tokens) {
+    if (tokens.empty()) {
+        return;
+    }
+
+    /* DECLARE_HANDLE(HWND) */
+    if (tokens.size() == 4 && tokens[0] == QLatin1String("DECLARE_HANDLE") && tokens[1] == QLatin1String("(")) {
+        typedefs_[tokens[2]] = ArgumentType(ArgumentType::INTEGER, pointerSize_);
+        return;
+    }
+
+    bool stdcall = false;
+
+    QStringList filtered;
+    for (int i = 0; i < tokens.size(); ++i) {
+        const QString &token = tokens[i];
+
+        if (isStdcallWord(token)) {
+            stdcall = true;
+        } else if (token == QLatin1String("STDAPI")) {
+            stdcall = true;
+            filtered.push_back(QLatin1String("HRESULT"));
+        } else if (isIgnoredWord(token)) {
+            /* __attribute__((...)), _In_reads_(n) */
+            if (i + 1 < tokens.size() && tokens[i + 1] == QLatin1String("(")) {
+                i = findClosingParenthesis(tokens, i + 1);
+            }
+        } else {
+            filtered.push_back(token);
+        }
+    }
+
+    if (filtered.empty()) {
+        return;
+    }
+
+    if (filtered.front() == QLatin1String("typedef")) {
+        filtered.pop_front();
+
+        auto declarators = splitAtCommas(filtered);
+
+        /* The base type is the first declarator without the declared name and the stars. */
+        QStringList base = declarators.front();
+        if (!base.empty()) {
+            base.pop_back();
+        }
+        while (!base.empty() && base.back() == QLatin1String("*")) {
+            base.pop_back();
+        }
+
+        for (std::size_t i = 0; i < declarators.size(); ++i) {
+            QStringList declarator = i == 0 ? declarators[i] : base + declarators[i];
+            int open = declarator.indexOf(QLatin1String("("));
+
+            if (open != -1) {
+                /* typedef int (CALLBACK *PROC)(void) */
+                if (open + 2 < declarator.size() && declarator[open + 1] == QLatin1String("*") &&
+                    isIdentifier(declarator[open + 2]))
+                {
+                    typedefs_[declarator[open + 2]] = ArgumentType(ArgumentType::INTEGER, pointerSize_);
+                }
+            } else if (declarator.size() > 1 && isIdentifier(declarator.back())) {
+                if (auto type = parseType(declarator, true)) {
+                    typedefs_[declarator.back()] = *type;
+                }
+            }
+        }
+        return;
+    }
+
+    int open = filtered.indexOf(QLatin1String("("));
+    if (open == -1) {
+        /* Not a function. */
+        return;
+    }
+
+    int close = findClosingParenthesis(filtered, open);
+    if (open < 2 || !isIdentifier(filtered[open - 1]) || close != filtered.size() - 1) {
+        /* int (*signal(int, void (*)(int)))(int), int f(void) = 0, MACRO(x) */
+        ++skipped_;
+        return;
+    }
+
+    Prototype prototype;
+    prototype.name = filtered[open - 1];
+    prototype.stdcall = stdcall;
+
+    auto returnType = parseType(filtered.mid(0, open - 1), false);
+    if (!returnType) {
+        ++skipped_;
+        return;
+    }
+    prototype.returnType = *returnType;
+
+    auto parameters = splitAtCommas(filtered.mid(open + 1, close - open - 1));
+    if (parameters.size() == 1 &&
+        (parameters.front().empty() ||
+         (parameters.front().size() == 1 && parameters.front().front() == QLatin1String("void"))))
+    {
+        parameters.clear();
+    }
+
+    foreach (const QStringList &parameter, parameters) {
+        if (parameter.size() == 1 && parameter.front() == QLatin1String("...")) {
+            prototype.variadic = true;
+            continue;
+        }
+
+        auto type = parseType(parameter, true);
+        if (!type || type->kind == ArgumentType::VOID) {
+            ++skipped_;
+            return;
+        }
+        prototype.arguments.push_back(*type);
+    }
+
+    prototypes_.push_back(std::move(prototype));
+}
+
+boost::optional<ArgumentType> HeaderParser::parseType(QStringList tokens, bool named) const {
+    /* Arrays and functions are passed as pointers. */
+    if (tokens.contains(QLatin1String("*")) || tokens.contains(QLatin1String("[")) ||
+        tokens.contains(QLatin1String("(")) || tokens.contains(QLatin1String("&")))
+    {
+        return ArgumentType(ArgumentType::INTEGER, pointerSize_);
+    }
+
+    tokens.removeAll(QLatin1String("const"));
+    tokens.removeAll(QLatin1String("volatile"));
+    tokens.removeAll(QLatin1String("restrict"));
+
+    if (named && tokens.size() > 1 && !isTypeKeyword(tokens.back())) {
+        tokens.pop_back();
+    }
+
+    if (tokens.empty()) {
+        return boost::none;
+    }
+
+    if (tokens.front() == QLatin1String("enum")) {
+        return ArgumentType(ArgumentType::INTEGER, 32);
+    }
+
+    if (tokens.size() == 1 && !isTypeKeyword(tokens.front())) {
+        auto i = typedefs_.find(tokens.front());
+        if (i != typedefs_.end()) {
+            return i->second;
+        }
+        return getWellKnownType(tokens.front());
+    }
+
+    foreach (const QString &token, tokens) {
+        if (!isTypeKeyword(token)) {
+            /* struct tm, or something unknown. */
+            return boost::none;
+        }
+    }
+
+    auto longs = tokens.count(QLatin1String("long"));
+
+    if (tokens.contains(QLatin1String("void"))) {
+        return ArgumentType(ArgumentType::VOID, 0);
+    } else if (tokens.contains(QLatin1String("float"))) {
+        return ArgumentType(ArgumentType::FLOAT, 32);
+    } else if (tokens.contains(QLatin1String("double"))) {
+        if (longs) {
+            /* long double is passed differently everywhere. */
+            return boost::none;
+        }
+        return ArgumentType(ArgumentType::FLOAT, 64);
+    } else if (tokens.contains(QLatin1String("char")) || tokens.contains(QLatin1String("_Bool")) ||
+               tokens.contains(QLatin1String("bool")) || tokens.contains(QLatin1String("__int8"))) {
+        return ArgumentType(ArgumentType::INTEGER, 8);
+    } else if (tokens.contains(QLatin1String("short")) || tokens.contains(QLatin1String("__int16"))) {
+        return ArgumentType(ArgumentType::INTEGER, 16);
+    } else if (longs >= 2 || tokens.contains(QLatin1String("__int64"))) {
+        return ArgumentType(ArgumentType::INTEGER, 64);
+    } else if (longs == 1) {
+        return ArgumentType(ArgumentType::INTEGER, longSize_);
+    } else {
+        return ArgumentType(ArgumentType::INTEGER, 32);
+    }
+}
+
+boost::optional<ArgumentType> HeaderParser::getWellKnownType(const QString &name) const {
+    struct WellKnownType {
+        const char *name;
+        ArgumentType::Kind kind;
+        SmallBitSize size; ///< Size in bits, or zero for the size of a pointer, or -1 for the size of long.
+    };
+
+    static const WellKnownType types[] = {
+        {"size_t", ArgumentType::INTEGER, 0},
+        {"ssize_t", ArgumentType::INTEGER, 0},
+        {"ptrdiff_t", ArgumentType::INTEGER, 0},
+        {"intptr_t", ArgumentType::INTEGER, 0},
+        {"uintptr_t", ArgumentType::INTEGER, 0},
+        {"va_list", ArgumentType::INTEGER, 0},
+        {"off_t", ArgumentType::INTEGER, -1},
+        {"time_t", ArgumentType::INTEGER, -1},
+        {"clock_t", ArgumentType::INTEGER, -1},
+        {"int8_t", ArgumentType::INTEGER, 8},
+        {"uint8_t", ArgumentType::INTEGER, 8},
+        {"int16_t", ArgumentType::INTEGER, 16},
+        {"uint16_t", ArgumentType::INTEGER, 16},
+        {"int32_t", ArgumentType::INTEGER, 32},
+        {"uint32_t", ArgumentType::INTEGER, 32},
+        {"int64_t", ArgumentType::INTEGER, 64},
+        {"uint64_t", ArgumentType::INTEGER, 64},
+        {"off64_t", ArgumentType::INTEGER, 64},
+        {"pid_t", ArgumentType::INTEGER, 32},
+        {"uid_t", ArgumentType::INTEGER, 32},
+        {"gid_t", ArgumentType::INTEGER, 32},
+        {"mode_t", ArgumentType::INTEGER, 32},
+        {"socklen_t", ArgumentType::INTEGER, 32},
+        {"wchar_t", ArgumentType::INTEGER, 32},
+        {"wint_t", ArgumentType::INTEGER, 32},
+        {"SIZE_T", ArgumentType::INTEGER, 0},
+        {"SSIZE_T", ArgumentType::INTEGER, 0},
+        {"INT_PTR", ArgumentType::INTEGER, 0},
+        {"UINT_PTR", ArgumentType::INTEGER, 0},
+        {"LONG_PTR", ArgumentType::INTEGER, 0},
+        {"ULONG_PTR", ArgumentType::INTEGER, 0},
+        {"DWORD_PTR", ArgumentType::INTEGER, 0},
+        {"WPARAM", ArgumentType::INTEGER, 0},
+        {"LPARAM", ArgumentType::INTEGER, 0},
+        {"LRESULT", ArgumentType::INTEGER, 0},
+        {"BYTE", ArgumentType::INTEGER, 8},
+        {"CHAR", ArgumentType::INTEGER, 8},
+        {"UCHAR", ArgumentType::INTEGER, 8},
+        {"BOOLEAN", ArgumentType::INTEGER, 8},
+        {"WORD", ArgumentType::INTEGER, 16},
+        {"SHORT", ArgumentType::INTEGER, 16},
+        {"USHORT", ArgumentType::INTEGER, 16},
+        {"WCHAR", ArgumentType::INTEGER, 16},
+        {"ATOM", ArgumentType::INTEGER, 16},
+        {"LANGID", ArgumentType::INTEGER, 16},
+        {"DWORD", ArgumentType::INTEGER, 32},
+        {"BOOL", ArgumentType::INTEGER, 32},
+        {"INT", ArgumentType::INTEGER, 32},
+        {"UINT", ArgumentType::INTEGER, 32},
+        {"LONG", ArgumentType::INTEGER, 32},
+        {"ULONG", ArgumentType::INTEGER, 32},
+        {"LCID", ArgumentType::INTEGER, 32},
+        {"HRESULT", ArgumentType::INTEGER, 32},
+        {"NTSTATUS", ArgumentType::INTEGER, 32},
+        {"COLORREF", ArgumentType::INTEGER, 32},
+        {"LONGLONG", ArgumentType::INTEGER, 64},
+        {"ULONGLONG", ArgumentType::INTEGER, 64},
+        {"DWORD64", ArgumentType::INTEGER, 64},
+        {"LONG64", ArgumentType::INTEGER, 64},
+        {"ULONG64", ArgumentType::INTEGER, 64},
+        {"INT64", ArgumentType::INTEGER, 64},
+        {"UINT64", ArgumentType::INTEGER, 64},
+        {"FLOAT", ArgumentType::FLOAT, 32},
+        {"DOUBLE", ArgumentType::FLOAT, 64},
+    };
+
+    foreach (const auto &type, types) {
+        if (name == QLatin1String(type.name)) {
+            switch (type.size) {
+                case 0:
+                    return ArgumentType(type.kind, pointerSize_);
+                case -1:
+                    return ArgumentType(type.kind, longSize_);
+                default:
+                    return ArgumentType(type.kind, type.size);
+            }
+        }
+    }
+
+    /* Windows pointer and handle types: LPCSTR, PVOID, HWND. */
+    if (name.size() > 2 && name == name.toUpper() &&
+        (name.startsWith(QLatin1String("LP")) ||
+         ((name[0] == QChar('P') || name[0] == QChar('H')) && name[1].isLetter())))
+    {
+        return ArgumentType(ArgumentType::INTEGER, pointerSize_);
+    }
+
+    return boost::none;
+}
+
+} // namespace sigdb
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
@@ -0,0 +1,137 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#pragma once
+
+#include <nc/config.h>
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QString>
+#include <QStringList>
+
+#include <boost/optional.hpp>
+
+#include <nc/common/Types.h>
+
+namespace nc {
+namespace sigdb {
+
+/**
+ * C type, as far as passing it as an argument is concerned.
+ */
+class ArgumentType {
+public:
+    enum Kind {
+        VOID,    ///< No value.
+        INTEGER, ///< Integer, enumeration, or pointer.
+        FLOAT    ///< Floating-point number.
+    };
+
+    Kind kind; ///< Kind of the type.
+    SmallBitSize size; ///< Size of the type in bits.
+
+    ArgumentType(Kind kind = VOID, SmallBitSize size = 0): kind(kind), size(size) {}
+};
+
+/**
+ * Declaration of a function.
+ */
+class Prototype {
+public:
+    QString name; ///< Name of the function.
+    ArgumentType returnType; ///< Type of the return value.
+    std::vector<ArgumentType> arguments; ///< Types of the arguments.
+    bool variadic; ///< True if the function takes a variable number of arguments.
+    bool stdcall; ///< True if the function is declared with __stdcall or WINAPI.
+
+    Prototype(): variadic(false), stdcall(false) {}
+};
+
+/**
+ * Parser of function declarations in C headers.
+ *
+ * This is not a C parser: the text is not preprocessed, macros are not
+ * expanded, and declarations the parser does not understand are skipped.
+ * It is just good enough for the prototypes in system headers, where most
+ * functions take and return integers, pointers, and typedefs thereof.
+ * Functions taking or returning structures by value are skipped.
+ */
+class HeaderParser {
+    Q_DECLARE_TR_FUNCTIONS(HeaderParser)
+
+    SmallBitSize pointerSize_; ///< Size of pointers in bits.
+    SmallBitSize longSize_; ///< Size of long in bits.
+    std::map<QString, ArgumentType> typedefs_; ///< Types defined by typedefs seen so far.
+    std::vector<Prototype> prototypes_; ///< Parsed prototypes.
+    std::size_t skipped_; ///< Number of skipped function declarations.
+
+public:
+    /**
+     * Constructor.
+     *
+     * \param pointerSize Size of pointers in bits.
+     * \param longSize Size of long in bits.
+     */
+    HeaderParser(SmallBitSize pointerSize, SmallBitSize longSize);
+
+    /**
+     * Parses the text of a header, adding the declared functions to the list of prototypes.
+     *
+     * \param text Text of the header.
+     */
+    void parse(const QString &text);
+
+    /**
+     * \return Prototypes of the functions declared in the parsed headers.
+     */
+    const std::vector<Prototype> &prototypes() const { return prototypes_; }
+
+    /**
+     * \return Number of function declarations which could not be understood.
+     */
+    std::size_t skipped() const { return skipped_; }
+
+private:
+    /**
+     * Splits a text into tokens, dropping comments, preprocessor directives,
+     * and string literals.
+     *
+     * \param text Text.
+     *
+     * \return Identifiers, numbers, ellipses, and punctuation characters of the text.
+     */
+    static QStringList tokenize(const QString &text);
+
+    /**
+     * Parses a declaration or a definition.
+     *
+     * \param tokens Tokens of the declaration, without the final semicolon.
+     */
+    void parseDeclaration(QStringList tokens);
+
+    /**
+     * Parses the type of a parameter, of a return value, or of a typedef.
+     *
+     * \param tokens Tokens of the type.
+     * \param named True if the tokens can end with a declared name.
+     *
+     * \return The type, if understood.
+     */
+    boost::optional<ArgumentType> parseType(QStringList tokens, bool named) const;
+
+    /**
+     * \param name Name of a type defined in standard or Windows headers.
+     *
+     * \return The type, if known.
+     */
+    boost::optional<ArgumentType> getWellKnownType(const QString &name) const;
+};
+
+} // namespace sigdb
+} // namespace nc
+
+/* vim:set et sts=4 sw=4: */
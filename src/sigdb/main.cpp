@@ -0,0 +1,290 @@
+/* The file is part of Snowman decompiler. */
+/* See doc/licenses.asciidoc for the licensing information. */
+
+#include <nc/config.h>
+
+#include <climits> /* CHAR_BIT */
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+
+#include <nc/common/Branding.h>
+#include <nc/common/Exception.h>
+#include <nc/common/Foreach.h>
+
+#include <nc/core/SignatureDatabase.h>
+#include <nc/core/arch/Architecture.h>
+#include <nc/core/arch/ArchitectureRepository.h>
+#include <nc/core/arch/Register.h>
+#include <nc/core/arch/Registers.h>
+#include <nc/core/ir/MemoryDomain.h>
+#include <nc/core/ir/calling/Convention.h>
+
+#include "HeaderParser.h"
+
+const char *self = "sigdb";
+
+QTextStream qout(stdout, QIODevice::WriteOnly);
+QTextStream qerr(stderr, QIODevice::WriteOnly);
+
+/**
+ * \param location Location of a register argument or return value.
+ * \param type Type of the argument or of the return value.
+ *
+ * \return The low part of the register, as large as the type. x87 registers
+ *         hold floating-point values of any size in extended precision,
+ *         so they are returned as is.
+ */
+nc::core::ir::MemoryLocation fitToType(const nc::core::ir::MemoryLocation &location, const nc::sigdb::ArgumentType &type) {
+    if (location.size() == 80 || type.size == 0 || type.size >= location.size()) {
+        return location;
+    }
+    return nc::core::ir::MemoryLocation(location.domain(), location.addr(), type.size);
+}
+
+/**
+ * \param architecture Valid pointer to the architecture.
+ * \param low Location of the register returning integers.
+ *
+ * \return Location of the register returning the high half of integers twice as large,
+ *         like edx for eax on i386, or an invalid location if there is no such register.
+ */
+nc::core::ir::MemoryLocation getHighHalfLocation(const nc::core::arch::Architecture *architecture,
+                                                 const nc::core::ir::MemoryLocation &low)
+{
+    auto reg = architecture->registers()->getRegister(low);
+    if (!reg) {
+        return nc::core::ir::MemoryLocation();
+    }
+
+    QString highName;
+    if (reg->lowercaseName() == QLatin1String("eax")) {
+        highName = QLatin1String("edx");
+    } else if (reg->lowercaseName() == QLatin1String("ax")) {
+        highName = QLatin1String("dx");
+    } else {
+        return nc::core::ir::MemoryLocation();
+    }
+
+    foreach (auto high, architecture->registers()->registers()) {
+        if (high->lowercaseName() == highName) {
+            return high->memoryLocation();
+        }
+    }
+    return nc::core::ir::MemoryLocation();
+}
+
+/**
+ * Computes the locations of the arguments and the return value of a function
+ * declared in C.
+ *
+ * The argument groups of the conventions do not tell how the registers are
+ * assigned, so this is done here for the known conventions: amd64 fills its
+ * integer and floating-point registers independently, microsoft64 assigns
+ * the registers by the position of the argument, and the 32-bit and 16-bit
+ * conventions pass C arguments on the stack. Register locations are as large
+ * as the C types. Integers twice as large as the return value register are
+ * returned in a pair of registers, like edx:eax on i386.
+ *
+ * \param architecture Valid pointer to the architecture.
+ * \param prototype Prototype of the function.
+ * \param convention Calling convention.
+ *
+ * \return Entry of the signature database.
+ */
+nc::core::SignatureDatabase::Entry computeEntry(const nc::core::arch::Architecture *architecture,
+                                                const nc::sigdb::Prototype &prototype,
+                                                const nc::core::ir::calling::Convention *convention)
+{
+    using nc::core::ir::MemoryLocation;
+    using nc::sigdb::ArgumentType;
+
+    nc::core::SignatureDatabase::Entry entry;
+    entry.name = prototype.name;
+    entry.convention = convention->name();
+    entry.variadic = prototype.variadic;
+
+    bool independent = convention->name() == QLatin1String("amd64");
+    bool positional = convention->name() == QLatin1String("microsoft64");
+
+    const auto &groups = convention->argumentGroups();
+    std::vector<std::size_t> usedRegisters(groups.size());
+    nc::BitSize stackOffset = 0;
+
+    for (std::size_t i = 0; i < prototype.arguments.size(); ++i) {
+        const auto &argument = prototype.arguments[i];
+        std::size_t group = argument.kind == ArgumentType::FLOAT ? 1 : 0;
+
+        if (independent && group < groups.size() && usedRegisters[group] < groups[group].size()) {
+            entry.arguments.push_back(fitToType(groups[group][usedRegisters[group]++], argument));
+            continue;
+        }
+        if (positional) {
+            if (group < groups.size() && i < groups[group].size()) {
+                entry.arguments.push_back(fitToType(groups[group][i], argument));
+            } else {
+                /* Stack slots are reserved for the register arguments too. */
+                entry.arguments.push_back(MemoryLocation(nc::core::ir::MemoryDomain::STACK,
+                    convention->firstArgumentOffset() + i * convention->argumentAlignment(),
+                    convention->argumentAlignment()));
+            }
+            continue;
+        }
+
+        auto alignment = convention->argumentAlignment();
+        auto size = alignment ? (argument.size + alignment - 1) / alignment * alignment : argument.size;
+
+        entry.arguments.push_back(MemoryLocation(nc::core::ir::MemoryDomain::STACK,
+            convention->firstArgumentOffset() + stackOffset, size));
+        stackOffset += size;
+    }
+
+    if (prototype.returnType.kind != ArgumentType::VOID) {
+        std::size_t index = prototype.returnType.kind == ArgumentType::FLOAT ? 1 : 0;
+        if (index < convention->returnValueLocations().size()) {
+            const auto &location = convention->returnValueLocations()[index];
+            const auto &type = prototype.returnType;
+
+            if (type.kind == ArgumentType::INTEGER && type.size == 2 * location.size()) {
+                entry.returnValueHigh = getHighHalfLocation(architecture, location);
+            }
+            entry.returnValue = entry.returnValueHigh ? location : fitToType(location, type);
+        }
+    }
+
+    if (convention->calleeCleanup()) {
+        entry.stackArgumentsSize = stackOffset / CHAR_BIT;
+    }
+
+    return entry;
+}
+
+void help() {
+    auto branding = nc::branding();
+    branding.setApplicationName("Sigdb");
+
+    qout << "Usage: " << self << " [options] [--dll=NAME] header... [--dll=NAME header...]..." << endl
+         << endl
+         << "Options:" << endl
+         << "  --help, -h                  Produce this help message and quit." << endl
+         << "  --output=FILE               Write the signature database to the file (required)." << endl
+         << "  --architecture=NAME         Architecture of the functions (default: x86-64)." << endl
+         << "  --convention=NAME           Calling convention of the functions (default: the first" << endl
+         << "                              convention of the architecture). Functions declared" << endl
+         << "                              WINAPI or __stdcall use stdcall32 on i386." << endl
+         << "  --dll=NAME                  The functions declared in the headers that follow" << endl
+         << "                              are imported from the given DLL." << endl
+         << endl
+         << branding.applicationName() << " builds a database of signatures of library functions" << endl
+         << "from the function declarations in the given C headers, for use with" << endl
+         << "nocode --signatures. The headers are not preprocessed: declarations" << endl
+         << "using unknown types or macros are skipped." << endl
+         << endl;
+
+    qout << "Available architectures:";
+    foreach (auto architecture, nc::core::arch::ArchitectureRepository::instance()->architectures()) {
+        qout << " " << architecture->name();
+    }
+    qout << endl;
+    qout << "Report bugs to: " << branding.reportBugsTo() << endl;
+    qout << "License: " << branding.licenseName() << " <" << branding.licenseUrl() << ">" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    try {
+        QString outputFile;
+        QString architectureName = QLatin1String("x86-64");
+        QString conventionName;
+
+        /* Header files, each with the DLL given before it. */
+        std::vector<std::pair<QString, QString>> headers;
+        QString dll;
+
+        auto args = QCoreApplication::arguments();
+
+        for (int i = 1; i < args.size(); ++i) {
+            QString arg = args[i];
+            if (arg == "--help" || arg == "-h") {
+                help();
+                return 1;
+            } else if (arg.startsWith("--output=")) {
+                outputFile = arg.section('=', 1);
+            } else if (arg.startsWith("--architecture=")) {
+                architectureName = arg.section('=', 1);
+            } else if (arg.startsWith("--convention=")) {
+                conventionName = arg.section('=', 1);
+            } else if (arg.startsWith("--dll=")) {
+                dll = arg.section('=', 1);
+            } else if (arg == "--") {
+                while (++i < args.size()) {
+                    headers.push_back(std::make_pair(args[i], dll));
+                }
+            } else if (arg.startsWith("-")) {
+                throw nc::Exception(QString("unknown argument: %1").arg(arg));
+            } else {
+                headers.push_back(std::make_pair(arg, dll));
+            }
+        }
+
+        if (outputFile.isEmpty()) {
+            throw nc::Exception("no output file");
+        }
+        if (headers.empty()) {
+            throw nc::Exception("no input files");
+        }
+
+        auto architecture = nc::core::arch::ArchitectureRepository::instance()->getArchitecture(architectureName);
+        if (!architecture) {
+            throw nc::Exception(QString("unknown architecture: %1").arg(architectureName));
+        }
+
+        auto convention = conventionName.isEmpty() && !architecture->conventions().empty()
+                        ? architecture->conventions().front()
+                        : architecture->getCallingConvention(conventionName);
+        if (!convention) {
+            throw nc::Exception(QString("unknown calling convention: %1").arg(conventionName));
+        }
+        auto stdcall = architecture->getCallingConvention(QLatin1String("stdcall32"));
+
+        /* Windows is LLP64, 32-bit platforms are ILP32, others are LP64. */
+        auto longSize = convention->name() == QLatin1String("microsoft64") ? 32 : architecture->bitness();
+
+        /* Typedefs of a header are used by the headers following it. */
+        nc::sigdb::HeaderParser parser(architecture->bitness(), longSize);
+        std::vector<nc::core::SignatureDatabase::Entry> entries;
+
+        foreach (const auto &header, headers) {
+            QFile file(header.first);
+            if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+                throw nc::Exception(QString("could not open file %1").arg(header.first));
+            }
+
+            auto first = parser.prototypes().size();
+            parser.parse(QString::fromUtf8(file.readAll()));
+
+            for (auto i = first; i < parser.prototypes().size(); ++i) {
+                const auto &prototype = parser.prototypes()[i];
+                auto functionConvention = prototype.stdcall && !prototype.variadic && stdcall ? stdcall : convention;
+
+                entries.push_back(computeEntry(architecture, prototype, functionConvention));
+                entries.back().dll = header.second;
+            }
+        }
+
+        nc::core::SignatureDatabase::write(outputFile, entries);
+
+        qerr << self << ": " << entries.size() << " functions found, "
+             << parser.skipped() << " declarations skipped" << endl;
+    } catch (const nc::Exception &e) {
+        qerr << self << ": " << e.unicodeWhat() << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/* vim:set et sts=4 sw=4: */